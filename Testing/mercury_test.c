@@ -341,6 +341,10 @@ HG_Test_init(int argc, char *argv[], struct hg_test_info *hg_test_info)
         hg_init_info.na_init_info.max_contexts =
             hg_test_info->na_test_info.max_contexts;
 
+    /* Set RMA stripes */
+    hg_init_info.na_init_info.rma_stripe_count =
+        hg_test_info->na_test_info.rma_stripes;
+
     /* Set auto SM mode */
     if (hg_test_info->auto_sm)
         hg_init_info.auto_sm = HG_TRUE;
@@ -90,6 +90,7 @@ na_test_usage(const char *execname)
     printf("    -k, --key           Pass auth key\n");
     printf("    -l, --loop          Number of loops (default: 1)\n");
     printf("    -b, --busy          Busy wait\n");
+    printf("    -X, --stripes       Number of endpoints used to stripe RMA\n");
     printf("    -V, --verbose       Print verbose output\n");
 }
 
@@ -152,6 +153,10 @@ na_test_parse_options(int argc, char *argv[],
                 na_test_info->max_contexts =
                     (na_uint8_t) atoi(na_test_opt_arg_g);
                 break;
+            case 'X': /* number of RMA stripes */
+                na_test_info->rma_stripes =
+                    (na_uint8_t) atoi(na_test_opt_arg_g);
+                break;
             case 'V': /* verbose */
                 na_test_info->verbose = NA_TRUE;
                 break;
@@ -410,6 +415,7 @@ NA_Test_init(int argc, char *argv[], struct na_test_info *na_test_info)
         na_init_info.progress_mode = NA_DEFAULT;
     na_init_info.auth_key = na_test_info->key;
     na_init_info.max_contexts = na_test_info->max_contexts;
+    na_init_info.rma_stripe_count = na_test_info->rma_stripes;
 
     printf("# Using info string: %s\n", info_string);
     na_test_info->na_class = NA_Initialize_opt(info_string,
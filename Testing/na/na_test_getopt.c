@@ -17,7 +17,7 @@
 
 int na_test_opt_ind_g = 1; /* token pointer */
 const char *na_test_opt_arg_g = NULL; /* flag argument (or value) */
-const char *na_test_short_opt_g = "hc:p:H:LsSak:l:t:bmC:V";
+const char *na_test_short_opt_g = "hc:p:H:LsSak:l:t:bmC:X:V";
 const struct na_test_opt na_test_opt_g[] = {
     { "help", no_arg, 'h'},
     { "comm", require_arg, 'c' },
@@ -33,6 +33,7 @@ const struct na_test_opt na_test_opt_g[] = {
     { "busy", no_arg, 'b'},
     { "memory", no_arg, 'm'},
     { "contexts", require_arg, 'C'},
+    { "stripes", require_arg, 'X'},
     { "verbose", no_arg, 'V' },
     { NULL, 0, '\0' } /* Must add this at the end */
 };
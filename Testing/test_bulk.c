@@ -23,6 +23,14 @@ struct forward_cb_args {
     hg_return_t ret;
 };
 
+struct stream_cb_args {
+    hg_request_t *request;
+    hg_bool_t ordered;
+    hg_size_t next_offset;
+    hg_size_t transferred;
+    hg_return_t ret;
+};
+
 //#define HG_TEST_DEBUG
 #ifdef HG_TEST_DEBUG
 #define HG_TEST_LOG_DEBUG(...)                                \
@@ -375,6 +383,477 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+/**
+ * HG_Bulk_transfer_stream chunk callback
+ */
+static hg_return_t
+hg_test_bulk_stream_chunk_cb(const struct hg_cb_info *callback_info)
+{
+    struct stream_cb_args *args = (struct stream_cb_args *) callback_info->arg;
+
+    if (callback_info->ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Return from callback info is not HG_SUCCESS");
+        args->ret = callback_info->ret;
+        goto done;
+    }
+
+    if (args->ordered && callback_info->info.bulk.offset != args->next_offset) {
+        HG_TEST_LOG_ERROR("Chunk at offset %zu, was expecting %zu",
+            (size_t) callback_info->info.bulk.offset,
+            (size_t) args->next_offset);
+        args->ret = HG_PROTOCOL_ERROR;
+    }
+    args->next_offset = callback_info->info.bulk.offset
+        + callback_info->info.bulk.size;
+    args->transferred += callback_info->info.bulk.size;
+
+done:
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+ * HG_Bulk_transfer_stream callback
+ */
+static hg_return_t
+hg_test_bulk_stream_cb(const struct hg_cb_info *callback_info)
+{
+    struct stream_cb_args *args = (struct stream_cb_args *) callback_info->arg;
+
+    if (callback_info->ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Return from callback info is not HG_SUCCESS");
+        args->ret = callback_info->ret;
+    }
+
+    hg_request_complete(args->request);
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_stream(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_size_t transfer_size,
+    hg_size_t chunk_size, unsigned int window, hg_bool_t ordered)
+{
+    hg_request_t *request = NULL;
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    hg_bulk_t origin_handle = HG_BULK_NULL, local_handle = HG_BULK_NULL;
+    struct stream_cb_args stream_cb_args;
+    char *origin_buf = NULL, *local_buf = NULL;
+    void *origin_ptr, *local_ptr;
+    hg_return_t ret = HG_SUCCESS;
+    size_t i;
+
+    /* Prepare bufs */
+    origin_buf = (char *) malloc(transfer_size);
+    local_buf = (char *) calloc(transfer_size, sizeof(char));
+    if (!origin_buf || !local_buf) {
+        HG_TEST_LOG_ERROR("Could not allocate bufs");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    for (i = 0; i < transfer_size; i++)
+        origin_buf[i] = (char) i;
+    origin_ptr = origin_buf;
+    local_ptr = local_buf;
+
+    /* Transfer between two local handles */
+    ret = HG_Addr_self(hg_class, &self_addr);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not get self addr");
+        goto done;
+    }
+
+    /* Register memory */
+    ret = HG_Bulk_create(hg_class, 1, &origin_ptr, &transfer_size,
+        HG_BULK_READ_ONLY, &origin_handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not create bulk handle");
+        goto done;
+    }
+    ret = HG_Bulk_create(hg_class, 1, &local_ptr, &transfer_size,
+        HG_BULK_READWRITE, &local_handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not create bulk handle");
+        goto done;
+    }
+
+    request = hg_request_create(request_class);
+    stream_cb_args.request = request;
+    stream_cb_args.ordered = ordered;
+    stream_cb_args.next_offset = 0;
+    stream_cb_args.transferred = 0;
+    stream_cb_args.ret = HG_SUCCESS;
+
+    ret = HG_Bulk_transfer_stream(context, hg_test_bulk_stream_chunk_cb,
+        hg_test_bulk_stream_cb, &stream_cb_args, HG_BULK_PULL, self_addr, 0,
+        origin_handle, 0, local_handle, 0, transfer_size, chunk_size, window,
+        ordered, HG_OP_ID_IGNORE);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not start bulk stream");
+        goto done;
+    }
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+    ret = stream_cb_args.ret;
+    if (ret != HG_SUCCESS)
+        goto done;
+
+    if (stream_cb_args.transferred != transfer_size) {
+        HG_TEST_LOG_ERROR("Transferred: %zu bytes, was expecting %zu",
+            (size_t) stream_cb_args.transferred, (size_t) transfer_size);
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+
+    for (i = 0; i < transfer_size; i++) {
+        if (local_buf[i] != origin_buf[i]) {
+            HG_TEST_LOG_ERROR("Error detected in transferred data, "
+                "buf[%zu] = %d, was expecting %d", i, local_buf[i],
+                origin_buf[i]);
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+
+done:
+    if (request)
+        hg_request_destroy(request);
+    HG_Bulk_free(origin_handle);
+    HG_Bulk_free(local_handle);
+    if (self_addr != HG_ADDR_NULL)
+        HG_Addr_free(hg_class, self_addr);
+    free(origin_buf);
+    free(local_buf);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+ * HG_Bulk_transfer_batch callback
+ */
+static hg_return_t
+hg_test_bulk_batch_cb(const struct hg_cb_info *callback_info)
+{
+    struct forward_cb_args *args =
+        (struct forward_cb_args *) callback_info->arg;
+
+    if (callback_info->ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Return from callback info is not HG_SUCCESS");
+        args->ret = callback_info->ret;
+    } else if (callback_info->info.bulk.size != args->expected_bytes) {
+        HG_TEST_LOG_ERROR("Transferred: %zu bytes, was expecting %zu",
+            (size_t) callback_info->info.bulk.size, args->expected_bytes);
+        args->ret = HG_SIZE_ERROR;
+    }
+
+    hg_request_complete(args->request);
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_batch(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_uint32_t count,
+    hg_size_t record_size)
+{
+    hg_request_t *request = NULL;
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    hg_bulk_t *origin_handles = NULL, local_handle = HG_BULK_NULL;
+    struct hg_bulk_transfer_desc *descs = NULL;
+    struct forward_cb_args batch_cb_args;
+    hg_size_t transfer_size = count * record_size;
+    char *origin_buf = NULL, *local_buf = NULL;
+    void *local_ptr;
+    hg_return_t ret = HG_SUCCESS;
+    size_t i;
+
+    /* Prepare bufs */
+    origin_buf = (char *) malloc(transfer_size);
+    local_buf = (char *) calloc(transfer_size, sizeof(char));
+    origin_handles = (hg_bulk_t *) calloc(count, sizeof(hg_bulk_t));
+    descs = (struct hg_bulk_transfer_desc *) malloc(
+        count * sizeof(struct hg_bulk_transfer_desc));
+    if (!origin_buf || !local_buf || !origin_handles || !descs) {
+        HG_TEST_LOG_ERROR("Could not allocate bufs");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    for (i = 0; i < transfer_size; i++)
+        origin_buf[i] = (char) i;
+    local_ptr = local_buf;
+
+    /* Transfer between local handles */
+    ret = HG_Addr_self(hg_class, &self_addr);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not get self addr");
+        goto done;
+    }
+
+    /* One handle per record, gathered into a single local handle */
+    for (i = 0; i < count; i++) {
+        void *origin_ptr = origin_buf + i * record_size;
+
+        ret = HG_Bulk_create(hg_class, 1, &origin_ptr, &record_size,
+            HG_BULK_READ_ONLY, &origin_handles[i]);
+        if (ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not create bulk handle");
+            goto done;
+        }
+    }
+    ret = HG_Bulk_create(hg_class, 1, &local_ptr, &transfer_size,
+        HG_BULK_READWRITE, &local_handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not create bulk handle");
+        goto done;
+    }
+
+    /* Records are gathered in reverse order */
+    for (i = 0; i < count; i++) {
+        descs[i].origin_handle = origin_handles[i];
+        descs[i].origin_offset = 0;
+        descs[i].local_handle = local_handle;
+        descs[i].local_offset = (count - i - 1) * record_size;
+        descs[i].size = record_size;
+    }
+
+    request = hg_request_create(request_class);
+    batch_cb_args.request = request;
+    batch_cb_args.expected_bytes = transfer_size;
+    batch_cb_args.ret = HG_SUCCESS;
+
+    ret = HG_Bulk_transfer_batch(context, hg_test_bulk_batch_cb,
+        &batch_cb_args, HG_BULK_PULL, self_addr, 0, descs, count,
+        HG_OP_ID_IGNORE);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not start bulk batch");
+        goto done;
+    }
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+    ret = batch_cb_args.ret;
+    if (ret != HG_SUCCESS)
+        goto done;
+
+    for (i = 0; i < transfer_size; i++) {
+        size_t j = (count - i / record_size - 1) * record_size
+            + i % record_size;
+
+        if (local_buf[i] != origin_buf[j]) {
+            HG_TEST_LOG_ERROR("Error detected in transferred data, "
+                "buf[%zu] = %d, was expecting %d", i, local_buf[i],
+                origin_buf[j]);
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+
+done:
+    if (request)
+        hg_request_destroy(request);
+    if (origin_handles) {
+        for (i = 0; i < count; i++)
+            HG_Bulk_free(origin_handles[i]);
+    }
+    HG_Bulk_free(local_handle);
+    if (self_addr != HG_ADDR_NULL)
+        HG_Addr_free(hg_class, self_addr);
+    free(origin_handles);
+    free(descs);
+    free(origin_buf);
+    free(local_buf);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_staging(hg_class_t *hg_class, hg_size_t size)
+{
+    struct hg_bulk_staging_info before, after;
+    hg_bulk_t handle = HG_BULK_NULL;
+    void *buf_ptr = NULL;
+    hg_uint32_t i;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Make sure that at least one buffer of that size class is free */
+    ret = HG_Bulk_create(hg_class, 1, NULL, &size, HG_BULK_READWRITE, &handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not create bulk handle");
+        goto done;
+    }
+    HG_Bulk_free(handle);
+    handle = HG_BULK_NULL;
+
+    for (i = 0; i < HG_BULK_STAGING_CLASS_COUNT; i++) {
+        ret = HG_Bulk_get_staging_info(hg_class, i, &before);
+        if (ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not get staging info");
+            goto done;
+        }
+        if (before.buf_size >= size)
+            break;
+    }
+    if (i == HG_BULK_STAGING_CLASS_COUNT || !before.free_count) {
+        HG_TEST_LOG_ERROR("No free staging buffer for size %zu",
+            (size_t) size);
+        ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    /* Buffer must be reused */
+    ret = HG_Bulk_create(hg_class, 1, NULL, &size, HG_BULK_READWRITE, &handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not create bulk handle");
+        goto done;
+    }
+    HG_Bulk_access(handle, 0, size, HG_BULK_READWRITE, 1, &buf_ptr, NULL,
+        NULL);
+    if (HG_Bulk_get_size(handle) != size || !buf_ptr) {
+        HG_TEST_LOG_ERROR("Invalid staging handle");
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+    HG_Bulk_get_staging_info(hg_class, i, &after);
+    if (after.hit_count != before.hit_count + 1
+        || after.free_count != before.free_count - 1
+        || after.used_count != before.used_count + 1) {
+        HG_TEST_LOG_ERROR("Staging buffer was not reused");
+        ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+done:
+    HG_Bulk_free(handle);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_view(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t target_addr,
+    hg_size_t view_offset, hg_size_t view_size, hg_size_t transfer_size,
+    hg_size_t origin_offset, hg_size_t target_offset,
+    hg_uint32_t origin_segment_count)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handle;
+    hg_bulk_t bulk_handle = HG_BULK_NULL, view_handle = HG_BULK_NULL;
+    hg_return_t ret = HG_SUCCESS;
+    struct forward_cb_args forward_cb_args;
+    bulk_write_in_t bulk_write_in_struct;
+    void **buf_ptrs;
+    hg_size_t *buf_sizes;
+    hg_size_t bulk_size = BUFSIZE;
+    size_t i;
+
+    if (view_offset + view_size > bulk_size
+        || origin_offset + transfer_size > view_size) {
+        HG_LOG_ERROR("Exceeding bulk size");
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+
+    /* Prepare bulk_buf */
+    buf_ptrs = (void **) malloc(origin_segment_count * sizeof(void *));
+    buf_sizes = (hg_size_t *) malloc(origin_segment_count * sizeof(hg_size_t));
+    for (i = 0; i < origin_segment_count; i++) {
+        hg_size_t j;
+
+        buf_sizes[i] = bulk_size / origin_segment_count;
+        buf_ptrs[i] = malloc(buf_sizes[i]);
+        for (j = 0; j < buf_sizes[i]; j++) {
+            ((char **) buf_ptrs)[i][j] = (char) (i * buf_sizes[i] + j);
+        }
+    }
+
+    request = hg_request_create(request_class);
+
+    ret = HG_Create(context, target_addr, hg_test_bulk_write_id_g, &handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not create handle");
+        goto done;
+    }
+
+    /* Register memory */
+    ret = HG_Bulk_create(hg_class, origin_segment_count, buf_ptrs,
+        buf_sizes, HG_BULK_READ_ONLY, &bulk_handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not create bulk handle");
+        goto done;
+    }
+
+    /* Expose only part of it, the view keeps the handle alive */
+    ret = HG_Bulk_view(bulk_handle, view_offset, view_size, &view_handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not create bulk view");
+        goto done;
+    }
+    /* Segments outside of the view are not encoded */
+    if (HG_Bulk_get_size(view_handle) != view_size
+        || (origin_segment_count > 1
+            && HG_Bulk_get_serialize_size(view_handle, HG_FALSE)
+                >= HG_Bulk_get_serialize_size(bulk_handle, HG_FALSE))) {
+        HG_TEST_LOG_ERROR("Invalid bulk view");
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+    ret = HG_Bulk_free(bulk_handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not destroy bulk handle");
+        goto done;
+    }
+
+    /* Fill input structure, view offset keeps data pattern unchanged */
+    bulk_write_in_struct.fildes = 0;
+    bulk_write_in_struct.transfer_size = transfer_size;
+    bulk_write_in_struct.origin_offset = origin_offset;
+    bulk_write_in_struct.target_offset = target_offset;
+    bulk_write_in_struct.bulk_handle = view_handle;
+
+    forward_cb_args.request = request;
+    forward_cb_args.expected_bytes = transfer_size;
+    forward_cb_args.ret = HG_SUCCESS;
+    ret = HG_Forward(handle, hg_test_bulk_forward_cb, &forward_cb_args,
+            &bulk_write_in_struct);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not forward call");
+        goto done;
+    }
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+    /* Free view */
+    ret = HG_Bulk_free(view_handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not destroy bulk view");
+        goto done;
+    }
+
+    /* Complete */
+    ret = HG_Destroy(handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not destroy handle");
+        goto done;
+    }
+
+    hg_request_destroy(request);
+
+    /* Free bulk data */
+    for (i = 0; i < origin_segment_count; i++)
+        free(buf_ptrs[i]);
+    free(buf_ptrs);
+    free(buf_sizes);
+
+    /* Assign ret from CB */
+    ret = forward_cb_args.ret;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 int main(int argc, char *argv[])
 {
@@ -502,6 +981,70 @@ int main(int argc, char *argv[])
     }
     HG_PASSED();
 
+    HG_TEST("streamed bulk (size BUFSIZE, chunks BUFSIZE/16, window 4, ordered)");
+    hg_ret = hg_test_bulk_stream(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, BUFSIZE, BUFSIZE/16, 4, HG_TRUE);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    HG_TEST("streamed bulk (size BUFSIZE + 1, chunks BUFSIZE/16, window 4, any order)");
+    hg_ret = hg_test_bulk_stream(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, BUFSIZE + 1, BUFSIZE/16, 4, HG_FALSE);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    HG_TEST("batched bulk (64 records of size 1000)");
+    hg_ret = hg_test_bulk_batch(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, 64, 1000);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    HG_TEST("large self bulk copies (3 records of size 8M + 1)");
+    hg_ret = hg_test_bulk_batch(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, 3, 8 * 1024 * 1024 + 1);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    HG_TEST("staging bulk buffer reuse (size 1000)");
+    hg_ret = hg_test_bulk_staging(hg_test_info.hg_class, 1000);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    HG_TEST("contiguous RPC bulk view (view BUFSIZE/4 + 256, BUFSIZE/2, size BUFSIZE/4, offsets 1, 0)");
+    hg_ret = hg_test_bulk_view(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        BUFSIZE/4 + 256, BUFSIZE/2, BUFSIZE/4, 1, 0, 1);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    HG_TEST("segmented RPC bulk view (view BUFSIZE/4 + 256, BUFSIZE/2, size BUFSIZE/4, offsets 1, 0)");
+    hg_ret = hg_test_bulk_view(hg_test_info.hg_class, hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        BUFSIZE/4 + 256, BUFSIZE/2, BUFSIZE/4, 1, 0, 16);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
 done:
     if (ret != EXIT_SUCCESS)
         HG_FAILED();
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_test.h"
+#include "mercury_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCHMARK_NAME "Bulk transfer setup time (self pull at random offsets)"
+#define STRING(s) #s
+#define XSTRING(s) STRING(s)
+#define VERSION_NAME \
+    XSTRING(HG_VERSION_MAJOR) \
+    "." \
+    XSTRING(HG_VERSION_MINOR) \
+    "." \
+    XSTRING(HG_VERSION_PATCH)
+
+#define SKIP 20
+#define LOOP_FACTOR 1000
+
+#define NDIGITS 3
+#define NWIDTH 20
+#define SEGMENT_SIZE 64
+#define TRANSFER_SIZE 8
+#define MAX_SEGMENTS (64 * 1024)
+
+static hg_return_t
+hg_test_bulk_setup_cb(const struct hg_cb_info *callback_info)
+{
+    hg_request_t *request = (hg_request_t *) callback_info->arg;
+
+    hg_request_complete(request);
+
+    return HG_SUCCESS;
+}
+
+static hg_return_t
+measure_bulk_setup(struct hg_test_info *hg_test_info, hg_addr_t self_addr,
+    hg_uint32_t segment_count)
+{
+    hg_size_t total_size = (hg_size_t) segment_count * SEGMENT_SIZE;
+    hg_size_t local_size = TRANSFER_SIZE;
+    size_t loop = (size_t) hg_test_info->na_test_info.loop * LOOP_FACTOR;
+    size_t skip = SKIP;
+    char *origin_buf = NULL, *local_buf = NULL;
+    void **buf_ptrs = NULL;
+    hg_size_t *buf_sizes = NULL;
+    void *local_ptr;
+    hg_bulk_t origin_handle = HG_BULK_NULL, local_handle = HG_BULK_NULL;
+    hg_request_t *request = NULL;
+    unsigned int seed = 1;
+    double time_setup = 0;
+    hg_return_t ret = HG_SUCCESS;
+    size_t i;
+
+    /* Prepare bufs, one segment every SEGMENT_SIZE bytes */
+    origin_buf = (char *) malloc(total_size);
+    local_buf = (char *) malloc(local_size);
+    buf_ptrs = (void **) malloc(segment_count * sizeof(void *));
+    buf_sizes = (hg_size_t *) malloc(segment_count * sizeof(hg_size_t));
+    if (!origin_buf || !local_buf || !buf_ptrs || !buf_sizes) {
+        fprintf(stderr, "Could not allocate bufs\n");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    for (i = 0; i < total_size; i++)
+        origin_buf[i] = (char) (i * 7);
+    for (i = 0; i < segment_count; i++) {
+        buf_ptrs[i] = origin_buf + i * SEGMENT_SIZE;
+        buf_sizes[i] = SEGMENT_SIZE;
+    }
+    local_ptr = local_buf;
+
+    ret = HG_Bulk_create(hg_test_info->hg_class, segment_count, buf_ptrs,
+        buf_sizes, HG_BULK_READ_ONLY, &origin_handle);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not create bulk data handle\n");
+        goto done;
+    }
+    ret = HG_Bulk_create(hg_test_info->hg_class, 1, &local_ptr, &local_size,
+        HG_BULK_READWRITE, &local_handle);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not create bulk data handle\n");
+        goto done;
+    }
+
+    request = hg_request_create(hg_test_info->request_class);
+
+    /* Each transfer starts at a different offset of the origin handle */
+    for (i = 0; i < skip + loop; i++) {
+        hg_size_t origin_offset;
+        hg_time_t t1, t2;
+
+        seed = seed * 1103515245 + 12345;
+        origin_offset = (hg_size_t) (seed % (total_size - TRANSFER_SIZE + 1));
+
+        hg_time_get_current(&t1);
+        ret = HG_Bulk_transfer(hg_test_info->context, hg_test_bulk_setup_cb,
+            request, HG_BULK_PULL, self_addr, origin_handle, origin_offset,
+            local_handle, 0, TRANSFER_SIZE, HG_OP_ID_IGNORE);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Could not transfer bulk data\n");
+            goto done;
+        }
+        hg_time_get_current(&t2);
+        if (i >= skip)
+            time_setup += hg_time_to_double(hg_time_subtract(t2, t1));
+
+        hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+        hg_request_reset(request);
+
+        /* Offset must have been translated to the right segment */
+        if (memcmp(local_buf, origin_buf + origin_offset, TRANSFER_SIZE)) {
+            fprintf(stderr, "Data does not match at offset %zu (%u "
+                "segment(s))\n", (size_t) origin_offset, segment_count);
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+        fprintf(stdout, "%-*u%*.*f\n", 10, segment_count, NWIDTH, NDIGITS,
+            time_setup * 1e6 / (double) loop);
+
+done:
+    if (request)
+        hg_request_destroy(request);
+    HG_Bulk_free(origin_handle);
+    HG_Bulk_free(local_handle);
+    free(origin_buf);
+    free(local_buf);
+    free(buf_ptrs);
+    free(buf_sizes);
+    return ret;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info = { 0 };
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    hg_uint32_t segment_count;
+    int ret = EXIT_SUCCESS;
+
+    HG_Test_init(argc, argv, &hg_test_info);
+
+    if (HG_Addr_self(hg_test_info.hg_class, &self_addr) != HG_SUCCESS) {
+        fprintf(stderr, "Could not get self addr\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    if (hg_test_info.na_test_info.mpi_comm_rank == 0) {
+        fprintf(stdout, "# %s v%s\n", BENCHMARK_NAME, VERSION_NAME);
+        fprintf(stdout, "# Loop %d times from 1 to %d segment(s) of %d "
+            "byte(s), %d byte(s) per transfer\n",
+            hg_test_info.na_test_info.loop * LOOP_FACTOR, MAX_SEGMENTS,
+            SEGMENT_SIZE, TRANSFER_SIZE);
+        fprintf(stdout, "%-*s%*s\n", 10, "# Segments", NWIDTH,
+            "Avg setup time (us)");
+        fflush(stdout);
+    }
+
+    for (segment_count = 1; segment_count <= MAX_SEGMENTS; segment_count *= 4) {
+        if (measure_bulk_setup(&hg_test_info, self_addr, segment_count)
+            != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
+done:
+    if (self_addr != HG_ADDR_NULL)
+        HG_Addr_free(hg_test_info.hg_class, self_addr);
+    HG_Test_finalize(&hg_test_info);
+
+    return ret;
+}
@@ -333,6 +333,7 @@ main(int argc, char *argv[])
     int *read_buf = NULL;
     int *write_buf = NULL;
     size_t n_ints = 1024*1024;
+    size_t n_small_ints = 256;
     unsigned int i;
     int error = 0;
     int rank;
@@ -421,6 +422,39 @@ main(int argc, char *argv[])
     }
     if (!error) printf("(%d) Successfully transferred %zd bytes!\n", rank, nbyte);
 
+    /* Small reads may have data sent back with the response */
+    printf("(%d) Reading small data...\n", rank);
+
+    fd = open(filename, O_RDONLY, mode);
+    if (fd < 0) {
+        fprintf(stderr, "Error in fs_open\n");
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < n_small_ints; i++)
+        read_buf[i] = 0;
+    nbyte = read(fd, read_buf, sizeof(int) * n_small_ints);
+    if (nbyte < 0) {
+        fprintf(stderr, "Error detected in client_posix_read\n");
+        return EXIT_FAILURE;
+    }
+
+    ret = close(fd);
+    if (ret < 0) {
+        fprintf(stderr, "Error detected in client_posix_close\n");
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < n_small_ints; i++) {
+        if (read_buf[i] != write_buf[i]) {
+            printf("(%d) Error detected in small bulk transfer, read_buf[%u] = %d, was expecting %d!\n",
+                    rank, i, read_buf[i], write_buf[i]);
+            error = 1;
+            break;
+        }
+    }
+    if (!error) printf("(%d) Successfully transferred %zd bytes!\n", rank, nbyte);
+
     /* Free bulk data */
     free(write_buf);
     free(read_buf);
@@ -431,5 +465,5 @@ main(int argc, char *argv[])
     HG_Test_finalize(&hg_test_info);
 #endif
 
-    return EXIT_SUCCESS;
+    return (error) ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_test.h"
+#include "mercury_time.h"
+#include "mercury_proc_array.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCHMARK_NAME "Proc encode/decode bandwidth of uint64 arrays"
+#define STRING(s) #s
+#define XSTRING(s) STRING(s)
+#define VERSION_NAME \
+    XSTRING(HG_VERSION_MAJOR) \
+    "." \
+    XSTRING(HG_VERSION_MINOR) \
+    "." \
+    XSTRING(HG_VERSION_PATCH)
+
+#define SKIP 5
+#define LOOP_FACTOR 10
+
+#define NDIGITS 2
+#define NWIDTH 20
+#define MAX_COUNT (1024 * 1024)
+#define BUF_SIZE (MAX_COUNT * sizeof(hg_uint64_t) + 64)
+
+#define ARRAY_LOOP      0
+#define ARRAY_COPY      1
+#define ARRAY_BORROW    2
+
+/* Array encoded one element at a time, as done without array procs */
+static hg_return_t
+hg_proc_array_loop(hg_proc_t proc, void *data)
+{
+    hg_array_uint64_t *array = (hg_array_uint64_t *) data;
+    hg_return_t ret;
+    hg_uint64_t i;
+
+    ret = hg_proc_hg_uint64_t(proc, &array->count);
+    if (ret != HG_SUCCESS)
+        return ret;
+    switch (hg_proc_get_op(proc)) {
+        case HG_DECODE:
+            array->data = (hg_uint64_t *) malloc(
+                array->count * sizeof(hg_uint64_t));
+            array->borrowed = HG_FALSE;
+            if (!array->data)
+                return HG_NOMEM_ERROR;
+            HG_FALLTHROUGH();
+        case HG_ENCODE:
+            for (i = 0; i < array->count; i++) {
+                ret = hg_proc_hg_uint64_t(proc, &array->data[i]);
+                if (ret != HG_SUCCESS)
+                    return ret;
+            }
+            break;
+        case HG_FREE:
+            free(array->data);
+            break;
+        default:
+            break;
+    }
+
+    return ret;
+}
+
+static hg_return_t
+measure_proc_array(struct hg_test_info *hg_test_info, hg_uint64_t *values,
+    hg_uint64_t count, const char *name, int mode)
+{
+    size_t loop = (size_t) hg_test_info->na_test_info.loop * LOOP_FACTOR *
+        (size_t) (MAX_COUNT / count);
+    size_t skip = SKIP;
+    hg_proc_cb_t proc_cb = (mode == ARRAY_LOOP) ? hg_proc_array_loop :
+        hg_proc_hg_array_uint64_t;
+    hg_array_uint64_t in_array, out_array;
+    char *buf = NULL;
+    hg_proc_t proc = HG_PROC_NULL;
+    hg_time_t t1 = {0, 0}, t2, t3 = {0, 0}, t4;
+    double time_encode, time_decode;
+    double size = (double) (count * sizeof(hg_uint64_t));
+    hg_return_t ret = HG_SUCCESS;
+    size_t i;
+
+    buf = (char *) malloc(BUF_SIZE);
+    if (!buf) {
+        fprintf(stderr, "Could not allocate buf\n");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    in_array.count = count;
+    in_array.data = values;
+    in_array.borrowed = HG_FALSE;
+
+    ret = hg_proc_create(hg_test_info->hg_class, HG_NOHASH, &proc);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not create proc\n");
+        goto done;
+    }
+    hg_proc_set_array_borrow(proc, (hg_bool_t) (mode == ARRAY_BORROW));
+
+    /* Encode */
+    for (i = 0; i < skip + loop; i++) {
+        if (i == skip)
+            hg_time_get_current(&t1);
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_ENCODE);
+        ret = proc_cb(proc, &in_array);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Could not encode array\n");
+            goto done;
+        }
+        hg_proc_flush(proc);
+    }
+    hg_time_get_current(&t2);
+
+    /* Decode, including release of the decoded array */
+    for (i = 0; i < skip + loop; i++) {
+        if (i == skip)
+            hg_time_get_current(&t3);
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_DECODE);
+        ret = proc_cb(proc, &out_array);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Could not decode array\n");
+            goto done;
+        }
+        hg_proc_flush(proc);
+        if (i == 0 && (out_array.count != count || memcmp(out_array.data,
+            values, count * sizeof(hg_uint64_t))
+            || (out_array.borrowed && mode != ARRAY_BORROW))) {
+            fprintf(stderr, "Decoded array does not match\n");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+        hg_proc_reset(proc, NULL, 0, HG_FREE);
+        proc_cb(proc, &out_array);
+    }
+    hg_time_get_current(&t4);
+    time_encode = hg_time_to_double(hg_time_subtract(t2, t1));
+    time_decode = hg_time_to_double(hg_time_subtract(t4, t3));
+
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+        fprintf(stdout, "%-*s%-*llu%*.*f%*.*f\n", 10, name, 10,
+            (unsigned long long) count,
+            NWIDTH, NDIGITS, size * (double) loop / (time_encode * 1e6),
+            NWIDTH, NDIGITS, size * (double) loop / (time_decode * 1e6));
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    free(buf);
+    return ret;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info = { 0 };
+    hg_uint64_t *values = NULL;
+    hg_uint64_t count;
+    int ret = EXIT_SUCCESS;
+
+    HG_Test_init(argc, argv, &hg_test_info);
+
+    values = (hg_uint64_t *) malloc(MAX_COUNT * sizeof(hg_uint64_t));
+    if (!values) {
+        fprintf(stderr, "Could not allocate values\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (count = 0; count < MAX_COUNT; count++)
+        values[count] = count * 0x0101010101010101ULL;
+
+    if (hg_test_info.na_test_info.mpi_comm_rank == 0) {
+        fprintf(stdout, "# %s v%s\n", BENCHMARK_NAME, VERSION_NAME);
+        fprintf(stdout, "# Loop %d times %d element(s) in total, from 1 to %d "
+            "element(s)\n", hg_test_info.na_test_info.loop * LOOP_FACTOR,
+            MAX_COUNT, MAX_COUNT);
+        fprintf(stdout, "%-*s%-*s%*s%*s\n", 10, "# Proc", 10, "Elements",
+            NWIDTH, "Encode (MB/s)", NWIDTH, "Decode (MB/s)");
+        fflush(stdout);
+    }
+
+    for (count = 1; count <= MAX_COUNT; count *= 32) {
+        /* One proc call per element */
+        if (measure_proc_array(&hg_test_info, values, count, "loop",
+            ARRAY_LOOP) != HG_SUCCESS)
+            ret = EXIT_FAILURE;
+        /* Array proc, decoded array is allocated */
+        if (measure_proc_array(&hg_test_info, values, count, "array",
+            ARRAY_COPY) != HG_SUCCESS)
+            ret = EXIT_FAILURE;
+        /* Array proc, decoded array points into buffer */
+        if (measure_proc_array(&hg_test_info, values, count, "borrow",
+            ARRAY_BORROW) != HG_SUCCESS)
+            ret = EXIT_FAILURE;
+    }
+
+done:
+    free(values);
+    HG_Test_finalize(&hg_test_info);
+
+    return ret;
+}
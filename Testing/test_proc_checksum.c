@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_test.h"
+#include "mercury_time.h"
+#include "mercury_crc32c.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCHMARK_NAME "Proc encode/decode cost with payload checksum"
+#define STRING(s) #s
+#define XSTRING(s) STRING(s)
+#define VERSION_NAME \
+    XSTRING(HG_VERSION_MAJOR) \
+    "." \
+    XSTRING(HG_VERSION_MINOR) \
+    "." \
+    XSTRING(HG_VERSION_PATCH)
+
+#define SKIP 20
+#define LOOP_FACTOR 1000
+
+#define NDIGITS 3
+#define NWIDTH 20
+#define MAX_RECORDS 256
+#define BUF_SIZE (MAX_RECORDS * 16)
+
+/* Record of small fields (15 bytes encoded) */
+struct record {
+    hg_uint8_t type;
+    hg_uint16_t flags;
+    hg_uint32_t id;
+    hg_uint64_t offset;
+};
+
+struct records {
+    hg_uint32_t count;
+    struct record records[MAX_RECORDS];
+};
+
+/* Checksum update called for each field, as done before checksums were
+ * computed over the encoded buffer */
+typedef hg_uint32_t (*checksum_update_t)(hg_uint32_t, const void *, size_t);
+static checksum_update_t field_checksum_update_g = NULL;
+static hg_uint32_t field_checksum_g = 0;
+
+static HG_INLINE hg_return_t
+hg_proc_field(hg_proc_t proc, void *data, hg_size_t size)
+{
+    hg_return_t ret = hg_proc_memcpy(proc, data, size);
+
+    if (field_checksum_update_g)
+        field_checksum_g = field_checksum_update_g(field_checksum_g, data,
+            (size_t) size);
+
+    return ret;
+}
+
+static hg_return_t
+hg_proc_records(hg_proc_t proc, void *data)
+{
+    struct records *records = (struct records *) data;
+    hg_return_t ret;
+    hg_uint32_t i;
+
+    ret = hg_proc_field(proc, &records->count, sizeof(hg_uint32_t));
+    if (ret != HG_SUCCESS)
+        return ret;
+    for (i = 0; i < records->count; i++) {
+        struct record *record = &records->records[i];
+
+        hg_proc_field(proc, &record->type, sizeof(hg_uint8_t));
+        hg_proc_field(proc, &record->flags, sizeof(hg_uint16_t));
+        hg_proc_field(proc, &record->id, sizeof(hg_uint32_t));
+        ret = hg_proc_field(proc, &record->offset, sizeof(hg_uint64_t));
+        if (ret != HG_SUCCESS)
+            return ret;
+    }
+
+    return ret;
+}
+
+static hg_bool_t
+records_match(const struct records *in_records,
+    const struct records *out_records)
+{
+    hg_uint32_t i;
+
+    if (in_records->count != out_records->count)
+        return HG_FALSE;
+    for (i = 0; i < in_records->count; i++) {
+        const struct record *in = &in_records->records[i];
+        const struct record *out = &out_records->records[i];
+
+        if (in->type != out->type || in->flags != out->flags
+            || in->id != out->id || in->offset != out->offset)
+            return HG_FALSE;
+    }
+
+    return HG_TRUE;
+}
+
+static hg_return_t
+measure_proc_checksum(struct hg_test_info *hg_test_info, hg_uint32_t count,
+    const char *name, hg_proc_hash_t hash, checksum_update_t field_update)
+{
+    size_t loop = (size_t) hg_test_info->na_test_info.loop * LOOP_FACTOR;
+    size_t skip = SKIP;
+    struct records *in_records = NULL, *out_records = NULL;
+    char *buf = NULL;
+    hg_proc_t proc = HG_PROC_NULL;
+    double time_encode = 0, time_decode = 0;
+    hg_size_t size = 0;
+    hg_return_t ret = HG_SUCCESS;
+    size_t i;
+
+    in_records = (struct records *) malloc(sizeof(struct records));
+    out_records = (struct records *) malloc(sizeof(struct records));
+    buf = (char *) malloc(BUF_SIZE);
+    if (!in_records || !out_records || !buf) {
+        fprintf(stderr, "Could not allocate bufs\n");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    in_records->count = count;
+    for (i = 0; i < count; i++) {
+        in_records->records[i].type = (hg_uint8_t) i;
+        in_records->records[i].flags = (hg_uint16_t) (i * 3);
+        in_records->records[i].id = (hg_uint32_t) (i * 7);
+        in_records->records[i].offset = (hg_uint64_t) i << 32;
+    }
+
+    ret = hg_proc_create(hg_test_info->hg_class, hash, &proc);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not create proc\n");
+        goto done;
+    }
+    field_checksum_update_g = field_update;
+
+    for (i = 0; i < skip + loop; i++) {
+#ifdef HG_HAS_CHECKSUMS
+        hg_uint32_t checksum = 0;
+#endif
+        hg_time_t t1, t2, t3;
+
+        hg_time_get_current(&t1);
+
+        /* Encode */
+        field_checksum_g = 0;
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_ENCODE);
+        ret = hg_proc_records(proc, in_records);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Could not encode records\n");
+            goto done;
+        }
+        hg_proc_flush(proc);
+#ifdef HG_HAS_CHECKSUMS
+        if (hash != HG_NOHASH)
+            hg_proc_checksum_get(proc, &checksum, sizeof(checksum));
+#endif
+        size = hg_proc_get_size_used(proc);
+
+        hg_time_get_current(&t2);
+
+        /* Decode */
+        field_checksum_g = 0;
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_DECODE);
+        ret = hg_proc_records(proc, out_records);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Could not decode records\n");
+            goto done;
+        }
+        hg_proc_flush(proc);
+#ifdef HG_HAS_CHECKSUMS
+        if (hash != HG_NOHASH) {
+            ret = hg_proc_checksum_verify(proc, &checksum, sizeof(checksum));
+            if (ret != HG_SUCCESS) {
+                fprintf(stderr, "Checksum does not match\n");
+                goto done;
+            }
+        }
+#endif
+
+        hg_time_get_current(&t3);
+
+        if (i >= skip) {
+            time_encode += hg_time_to_double(hg_time_subtract(t2, t1));
+            time_decode += hg_time_to_double(hg_time_subtract(t3, t2));
+        }
+    }
+
+    if (!records_match(in_records, out_records)) {
+        fprintf(stderr, "Decoded records do not match\n");
+        ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+#ifdef HG_HAS_CHECKSUMS
+    /* Corrupted payload must be detected */
+    if (hash != HG_NOHASH) {
+        hg_uint32_t checksum = 0;
+
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_ENCODE);
+        hg_proc_records(proc, in_records);
+        hg_proc_flush(proc);
+        hg_proc_checksum_get(proc, &checksum, sizeof(checksum));
+        buf[size - 1] ^= 1;
+
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_DECODE);
+        hg_proc_records(proc, out_records);
+        hg_proc_flush(proc);
+        if (hg_proc_checksum_verify(proc, &checksum, sizeof(checksum))
+            == HG_SUCCESS) {
+            fprintf(stderr, "Corrupted payload was not detected\n");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+#endif
+
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+        fprintf(stdout, "%-*s%-*u%*.*f%*.*f\n", 12, name, 10, (unsigned) size,
+            NWIDTH, NDIGITS, time_encode * 1e9 / (double) (loop * size),
+            NWIDTH, NDIGITS, time_decode * 1e9 / (double) (loop * size));
+
+done:
+    field_checksum_update_g = NULL;
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    free(in_records);
+    free(out_records);
+    free(buf);
+    return ret;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info = { 0 };
+    hg_uint32_t count;
+    int ret = EXIT_SUCCESS;
+
+    HG_Test_init(argc, argv, &hg_test_info);
+
+    if (hg_test_info.na_test_info.mpi_comm_rank == 0) {
+        fprintf(stdout, "# %s v%s\n", BENCHMARK_NAME, VERSION_NAME);
+        fprintf(stdout, "# Loop %d times from 1 to %d record(s) of 4 fields\n",
+            hg_test_info.na_test_info.loop * LOOP_FACTOR, MAX_RECORDS);
+#ifndef HG_HAS_CHECKSUMS
+        fprintf(stdout, "# Checksums are disabled, crc32c does not "
+            "checksum\n");
+#endif
+        fprintf(stdout, "%-*s%-*s%*s%*s\n", 12, "# Checksum", 10, "Bytes",
+            NWIDTH, "Encode (ns/byte)", NWIDTH, "Decode (ns/byte)");
+        fflush(stdout);
+    }
+
+    for (count = 1; count <= MAX_RECORDS; count *= 4) {
+        /* No checksum */
+        if (measure_proc_checksum(&hg_test_info, count, "none", HG_NOHASH,
+            NULL) != HG_SUCCESS)
+            ret = EXIT_FAILURE;
+        /* Checksum updated for each field */
+        if (measure_proc_checksum(&hg_test_info, count, "per-field",
+            HG_NOHASH, hg_crc32c) != HG_SUCCESS)
+            ret = EXIT_FAILURE;
+        /* Checksum of encoded buffer on flush */
+        if (measure_proc_checksum(&hg_test_info, count, "crc32c", HG_CRC32,
+            NULL) != HG_SUCCESS)
+            ret = EXIT_FAILURE;
+    }
+
+    HG_Test_finalize(&hg_test_info);
+
+    return ret;
+}
@@ -0,0 +1,443 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_test.h"
+#include "mercury_time.h"
+#include "mercury_proc_plan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCHMARK_NAME "Proc encode/decode rate of structs with plans"
+#define STRING(s) #s
+#define XSTRING(s) STRING(s)
+#define VERSION_NAME \
+    XSTRING(HG_VERSION_MAJOR) \
+    "." \
+    XSTRING(HG_VERSION_MINOR) \
+    "." \
+    XSTRING(HG_VERSION_PATCH)
+
+#define SKIP 5
+#define LOOP_FACTOR 10000
+
+#define NDIGITS 2
+#define NWIDTH 20
+#define MAX_COUNT 1024
+#define BUF_SIZE (MAX_COUNT * sizeof(hg_uint64_t) + 1024)
+
+typedef struct {
+    hg_uint32_t id;
+    hg_int32_t flags;
+} plan_header_t;
+
+typedef struct {
+    plan_header_t header;
+    hg_uint64_t offset;
+    hg_uint64_t len;
+    hg_uint32_t count;
+    hg_uint64_t *values;
+    hg_string_t name;
+} plan_struct_t;
+
+static const struct hg_field plan_header_fields_g[] = {
+    HG_FIELD_DESC_FIXED(plan_header_t, id),
+    HG_FIELD_DESC_FIXED(plan_header_t, flags),
+    HG_FIELD_DESC_END
+};
+
+static const struct hg_field plan_struct_fields_g[] = {
+    HG_FIELD_DESC_STRUCT(plan_struct_t, header, plan_header_fields_g),
+    HG_FIELD_DESC_FIXED(plan_struct_t, offset),
+    HG_FIELD_DESC_FIXED(plan_struct_t, len),
+    HG_FIELD_DESC_FIXED(plan_struct_t, count),
+    HG_FIELD_DESC_ARRAY(plan_struct_t, values, 3),
+    HG_FIELD_DESC_PROC(plan_struct_t, name, hg_proc_hg_string_t),
+    HG_FIELD_DESC_END
+};
+
+/* Field whose decoding fails, after an array was already decoded */
+static hg_return_t
+hg_proc_plan_fail_t(hg_proc_t proc, void *data)
+{
+    if (hg_proc_get_op(proc) == HG_DECODE)
+        return HG_PROTOCOL_ERROR;
+    return hg_proc_hg_uint32_t(proc, data);
+}
+
+static const struct hg_field plan_fail_fields_g[] = {
+    HG_FIELD_DESC_FIXED(plan_struct_t, count),
+    HG_FIELD_DESC_ARRAY(plan_struct_t, values, 0),
+    HG_FIELD_DESC_PROC(plan_struct_t, header.id, hg_proc_plan_fail_t),
+    HG_FIELD_DESC_END
+};
+
+/* Same struct processed one field at a time, as done by generated procs */
+static hg_return_t
+hg_proc_plan_struct_t(hg_proc_t proc, void *data)
+{
+    plan_struct_t *struct_data = (plan_struct_t *) data;
+    hg_return_t ret;
+    hg_uint32_t i;
+
+    ret = hg_proc_hg_uint32_t(proc, &struct_data->header.id);
+    if (ret != HG_SUCCESS)
+        return ret;
+    ret = hg_proc_hg_int32_t(proc, &struct_data->header.flags);
+    if (ret != HG_SUCCESS)
+        return ret;
+    ret = hg_proc_hg_uint64_t(proc, &struct_data->offset);
+    if (ret != HG_SUCCESS)
+        return ret;
+    ret = hg_proc_hg_uint64_t(proc, &struct_data->len);
+    if (ret != HG_SUCCESS)
+        return ret;
+    ret = hg_proc_hg_uint32_t(proc, &struct_data->count);
+    if (ret != HG_SUCCESS)
+        return ret;
+    switch (hg_proc_get_op(proc)) {
+        case HG_DECODE:
+            struct_data->values = (hg_uint64_t *) malloc(
+                struct_data->count * sizeof(hg_uint64_t));
+            if (struct_data->count && !struct_data->values)
+                return HG_NOMEM_ERROR;
+            HG_FALLTHROUGH();
+        case HG_ENCODE:
+        case HG_SIZE:
+            for (i = 0; i < struct_data->count; i++) {
+                ret = hg_proc_hg_uint64_t(proc, &struct_data->values[i]);
+                if (ret != HG_SUCCESS)
+                    return ret;
+            }
+            break;
+        case HG_FREE:
+            free(struct_data->values);
+            break;
+        default:
+            break;
+    }
+
+    return hg_proc_hg_string_t(proc, &struct_data->name);
+}
+
+static hg_return_t
+proc_plan_process(hg_proc_t proc, hg_proc_plan_t plan, plan_struct_t *data)
+{
+    return plan ? hg_proc_plan_process(proc, plan, data) :
+        hg_proc_plan_struct_t(proc, data);
+}
+
+static int
+proc_plan_compare(const plan_struct_t *s1, const plan_struct_t *s2)
+{
+    return s1->header.id != s2->header.id
+        || s1->header.flags != s2->header.flags
+        || s1->offset != s2->offset || s1->len != s2->len
+        || s1->count != s2->count
+        || (s1->count && memcmp(s1->values, s2->values,
+            s1->count * sizeof(hg_uint64_t)))
+        || strcmp(s1->name, s2->name);
+}
+
+/* Encode with one of proc or plan, decode with the other */
+static hg_return_t
+check_proc_plan(struct hg_test_info *hg_test_info, hg_proc_plan_t plan,
+    plan_struct_t *in_struct)
+{
+    plan_struct_t out_struct;
+    char *buf = NULL;
+    hg_proc_t proc = HG_PROC_NULL;
+    hg_size_t size_used[2] = { 0, 0 };
+    hg_return_t ret = HG_SUCCESS;
+    int i;
+
+    buf = (char *) malloc(BUF_SIZE);
+    if (!buf) {
+        fprintf(stderr, "Could not allocate buf\n");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    ret = hg_proc_create(hg_test_info->hg_class, HG_NOHASH, &proc);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not create proc\n");
+        goto done;
+    }
+
+    for (i = 0; i < 2; i++) {
+        hg_proc_plan_t encode_plan = i ? plan : NULL;
+        hg_proc_plan_t decode_plan = i ? NULL : plan;
+
+#ifndef HG_HAS_XDR
+        /* XDR does not support HG_SIZE */
+        hg_proc_reset(proc, NULL, 0, HG_SIZE);
+        ret = proc_plan_process(proc, encode_plan, in_struct);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Could not size struct\n");
+            goto done;
+        }
+        size_used[i] = hg_proc_get_size_used(proc);
+        if (encode_plan) {
+            hg_size_t plan_size = 0;
+
+            /* Plan computes size from its field table */
+            hg_proc_reset(proc, NULL, 0, HG_SIZE);
+            ret = hg_proc_plan_get_size(proc, encode_plan, in_struct,
+                &plan_size);
+            if (ret != HG_SUCCESS || plan_size != size_used[i]) {
+                fprintf(stderr, "Plan size does not match\n");
+                ret = HG_PROTOCOL_ERROR;
+                goto done;
+            }
+        }
+#endif
+
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_ENCODE);
+        ret = proc_plan_process(proc, encode_plan, in_struct);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Could not encode struct\n");
+            goto done;
+        }
+#ifdef HG_HAS_XDR
+        size_used[i] = hg_proc_get_size_used(proc);
+#endif
+        if (hg_proc_get_size_used(proc) != size_used[i]) {
+            fprintf(stderr, "Sized and encoded sizes do not match\n");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+        hg_proc_flush(proc);
+
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_DECODE);
+        ret = proc_plan_process(proc, decode_plan, &out_struct);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Could not decode struct\n");
+            goto done;
+        }
+        hg_proc_flush(proc);
+        if (proc_plan_compare(in_struct, &out_struct)) {
+            fprintf(stderr, "Decoded struct does not match\n");
+            ret = HG_PROTOCOL_ERROR;
+        }
+        hg_proc_reset(proc, NULL, 0, HG_FREE);
+        proc_plan_process(proc, decode_plan, &out_struct);
+        if (ret != HG_SUCCESS)
+            goto done;
+    }
+    if (size_used[0] != size_used[1]) {
+        fprintf(stderr, "Proc and plan sizes do not match\n");
+        ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    free(buf);
+    return ret;
+}
+
+/* Fields already decoded are released when decoding fails */
+static hg_return_t
+check_proc_plan_fail(struct hg_test_info *hg_test_info,
+    plan_struct_t *in_struct)
+{
+    plan_struct_t out_struct;
+    char *buf = NULL;
+    hg_proc_t proc = HG_PROC_NULL;
+    hg_proc_plan_t plan = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    buf = (char *) malloc(BUF_SIZE);
+    if (!buf) {
+        fprintf(stderr, "Could not allocate buf\n");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    ret = hg_proc_create(hg_test_info->hg_class, HG_NOHASH, &proc);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not create proc\n");
+        goto done;
+    }
+    ret = hg_proc_plan_create(plan_fail_fields_g, &plan);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not create plan\n");
+        goto done;
+    }
+
+    hg_proc_reset(proc, buf, BUF_SIZE, HG_ENCODE);
+    ret = hg_proc_plan_process(proc, plan, in_struct);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not encode struct\n");
+        goto done;
+    }
+    hg_proc_flush(proc);
+
+    hg_proc_reset(proc, buf, BUF_SIZE, HG_DECODE);
+    if (hg_proc_plan_process(proc, plan, &out_struct) == HG_SUCCESS
+        || out_struct.values != NULL) {
+        fprintf(stderr, "Decoded array was not released on failure\n");
+        ret = HG_PROTOCOL_ERROR;
+    }
+
+done:
+    if (plan)
+        hg_proc_plan_free(plan);
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    free(buf);
+    return ret;
+}
+
+static hg_return_t
+measure_proc_plan(struct hg_test_info *hg_test_info, hg_proc_plan_t plan,
+    plan_struct_t *in_struct, const char *name)
+{
+    size_t loop = (size_t) hg_test_info->na_test_info.loop * LOOP_FACTOR /
+        (in_struct->count / 64 + 1);
+    size_t skip = SKIP;
+    plan_struct_t out_struct;
+    char *buf = NULL;
+    hg_proc_t proc = HG_PROC_NULL;
+    hg_time_t t1 = {0, 0}, t2, t3 = {0, 0}, t4;
+    double time_encode, time_decode;
+    hg_return_t ret = HG_SUCCESS;
+    size_t i;
+
+    buf = (char *) malloc(BUF_SIZE);
+    if (!buf) {
+        fprintf(stderr, "Could not allocate buf\n");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    ret = hg_proc_create(hg_test_info->hg_class, HG_NOHASH, &proc);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not create proc\n");
+        goto done;
+    }
+
+    /* Encode */
+    for (i = 0; i < skip + loop; i++) {
+        if (i == skip)
+            hg_time_get_current(&t1);
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_ENCODE);
+        ret = proc_plan_process(proc, plan, in_struct);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Could not encode struct\n");
+            goto done;
+        }
+        hg_proc_flush(proc);
+    }
+    hg_time_get_current(&t2);
+
+    /* Decode, including release of the decoded struct */
+    for (i = 0; i < skip + loop; i++) {
+        if (i == skip)
+            hg_time_get_current(&t3);
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_DECODE);
+        ret = proc_plan_process(proc, plan, &out_struct);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Could not decode struct\n");
+            goto done;
+        }
+        hg_proc_flush(proc);
+        hg_proc_reset(proc, NULL, 0, HG_FREE);
+        proc_plan_process(proc, plan, &out_struct);
+    }
+    hg_time_get_current(&t4);
+    time_encode = hg_time_to_double(hg_time_subtract(t2, t1));
+    time_decode = hg_time_to_double(hg_time_subtract(t4, t3));
+
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+        fprintf(stdout, "%-*s%-*u%*.*f%*.*f\n", 10, name, 10,
+            (unsigned int) in_struct->count,
+            NWIDTH, NDIGITS, (double) loop / (time_encode * 1e6),
+            NWIDTH, NDIGITS, (double) loop / (time_decode * 1e6));
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    free(buf);
+    return ret;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info = { 0 };
+    hg_proc_plan_t plan = NULL;
+    plan_struct_t in_struct;
+    hg_uint64_t *values = NULL;
+    char name[] = "/scratch/hg/plan_struct";
+    hg_uint32_t count;
+    int ret = EXIT_SUCCESS;
+
+    HG_Test_init(argc, argv, &hg_test_info);
+
+    if (hg_proc_plan_create(plan_struct_fields_g, &plan) != HG_SUCCESS) {
+        fprintf(stderr, "Could not create plan\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    values = (hg_uint64_t *) malloc(MAX_COUNT * sizeof(hg_uint64_t));
+    if (!values) {
+        fprintf(stderr, "Could not allocate values\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (count = 0; count < MAX_COUNT; count++)
+        values[count] = count * 0x0101010101010101ULL;
+    in_struct.header.id = 0x12345678;
+    in_struct.header.flags = -2;
+    in_struct.offset = 0x0123456789abcdefULL;
+    in_struct.len = 4096;
+    in_struct.values = values;
+    in_struct.name = name;
+
+    /* Check that proc and plan encodings are interchangeable */
+    for (count = 0; count <= MAX_COUNT; count = count ? count * 32 : 1) {
+        in_struct.count = count;
+        if (check_proc_plan(&hg_test_info, plan, &in_struct) != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
+    in_struct.count = 32;
+    if (check_proc_plan_fail(&hg_test_info, &in_struct) != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    if (hg_test_info.na_test_info.mpi_comm_rank == 0) {
+        fprintf(stdout, "# %s v%s\n", BENCHMARK_NAME, VERSION_NAME);
+        fprintf(stdout, "# Loop %d times\n",
+            hg_test_info.na_test_info.loop * LOOP_FACTOR);
+        fprintf(stdout, "%-*s%-*s%*s%*s\n", 10, "# Proc", 10, "Elements",
+            NWIDTH, "Encode (M/s)", NWIDTH, "Decode (M/s)");
+        fflush(stdout);
+    }
+
+    for (count = 0; count <= MAX_COUNT; count = count ? count * 32 : 1) {
+        in_struct.count = count;
+        /* One proc call per field and element */
+        measure_proc_plan(&hg_test_info, NULL, &in_struct, "proc");
+        /* Table-driven plan */
+        measure_proc_plan(&hg_test_info, plan, &in_struct, "plan");
+    }
+
+done:
+    free(values);
+    if (plan)
+        hg_proc_plan_free(plan);
+    HG_Test_finalize(&hg_test_info);
+
+    return ret;
+}
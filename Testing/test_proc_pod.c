@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_test.h"
+#include "mercury_time.h"
+#include "test_rpc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCHMARK_NAME "Proc encode/decode cost of generated struct procs"
+#define STRING(s) #s
+#define XSTRING(s) STRING(s)
+#define VERSION_NAME \
+    XSTRING(HG_VERSION_MAJOR) \
+    "." \
+    XSTRING(HG_VERSION_MINOR) \
+    "." \
+    XSTRING(HG_VERSION_PATCH)
+
+#define SKIP 20
+#define LOOP_FACTOR 100
+
+#define NDIGITS 3
+#define NWIDTH 20
+#define NSTRUCTS 256
+#define BUF_SIZE (NSTRUCTS * 64)
+
+#ifdef HG_HAS_BOOST
+/* Same structs as test_rpc.h, always processed one field at a time */
+typedef rpc_handle_t rpc_handle_fields_t;
+typedef rpc_open_out_t rpc_open_out_fields_t;
+HG_GEN_STRUCT_PROC_FIELDS( rpc_handle_fields_t, ((hg_uint64_t)(cookie)) )
+HG_GEN_STRUCT_PROC_FIELDS( rpc_open_out_fields_t,
+    ((hg_int32_t)(ret)) ((hg_int32_t)(event_id)) )
+#else
+/* Without Boost, test_rpc.h procs are already written one field at a time */
+#define hg_proc_rpc_handle_fields_t hg_proc_rpc_handle_t
+#define hg_proc_rpc_open_out_fields_t hg_proc_rpc_open_out_t
+#endif
+
+static hg_return_t
+measure_proc_pod(struct hg_test_info *hg_test_info, const char *name,
+    hg_proc_cb_t proc_cb, void *in_structs, void *out_structs,
+    size_t struct_size)
+{
+    size_t loop = (size_t) hg_test_info->na_test_info.loop * LOOP_FACTOR;
+    size_t skip = SKIP;
+    char *buf = NULL;
+    hg_proc_t proc = HG_PROC_NULL;
+    double time_encode = 0, time_decode = 0;
+    hg_return_t ret = HG_SUCCESS;
+    size_t i, j;
+
+    buf = (char *) malloc(BUF_SIZE);
+    if (!buf) {
+        fprintf(stderr, "Could not allocate buf\n");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+
+    ret = hg_proc_create(hg_test_info->hg_class, HG_NOHASH, &proc);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not create proc\n");
+        goto done;
+    }
+
+    for (i = 0; i < skip + loop; i++) {
+        hg_time_t t1, t2, t3;
+
+        hg_time_get_current(&t1);
+
+        /* Encode */
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_ENCODE);
+        for (j = 0; j < NSTRUCTS; j++) {
+            ret = proc_cb(proc, (char *) in_structs + j * struct_size);
+            if (ret != HG_SUCCESS) {
+                fprintf(stderr, "Could not encode struct\n");
+                goto done;
+            }
+        }
+        hg_proc_flush(proc);
+
+        hg_time_get_current(&t2);
+
+        /* Decode */
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_DECODE);
+        for (j = 0; j < NSTRUCTS; j++) {
+            ret = proc_cb(proc, (char *) out_structs + j * struct_size);
+            if (ret != HG_SUCCESS) {
+                fprintf(stderr, "Could not decode struct\n");
+                goto done;
+            }
+        }
+        hg_proc_flush(proc);
+
+        hg_time_get_current(&t3);
+
+        if (i >= skip) {
+            time_encode += hg_time_to_double(hg_time_subtract(t2, t1));
+            time_decode += hg_time_to_double(hg_time_subtract(t3, t2));
+        }
+    }
+
+    if (memcmp(in_structs, out_structs, NSTRUCTS * struct_size)) {
+        fprintf(stderr, "Decoded structs do not match\n");
+        ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+        fprintf(stdout, "%-*s%*.*f%*.*f\n", 24, name,
+            NWIDTH, NDIGITS, time_encode * 1e9 / (double) (loop * NSTRUCTS),
+            NWIDTH, NDIGITS, time_decode * 1e9 / (double) (loop * NSTRUCTS));
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    free(buf);
+    return ret;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info = { 0 };
+    rpc_handle_t *in_handles = NULL, *out_handles = NULL;
+    rpc_open_out_t *in_outs = NULL, *out_outs = NULL;
+    rpc_open_in_t *in_ins = NULL, *out_ins = NULL;
+    int ret = EXIT_SUCCESS;
+    int i;
+
+    HG_Test_init(argc, argv, &hg_test_info);
+
+    in_handles = (rpc_handle_t *) calloc(NSTRUCTS, sizeof(rpc_handle_t));
+    out_handles = (rpc_handle_t *) calloc(NSTRUCTS, sizeof(rpc_handle_t));
+    in_outs = (rpc_open_out_t *) calloc(NSTRUCTS, sizeof(rpc_open_out_t));
+    out_outs = (rpc_open_out_t *) calloc(NSTRUCTS, sizeof(rpc_open_out_t));
+    in_ins = (rpc_open_in_t *) calloc(NSTRUCTS, sizeof(rpc_open_in_t));
+    out_ins = (rpc_open_in_t *) calloc(NSTRUCTS, sizeof(rpc_open_in_t));
+    if (!in_handles || !out_handles || !in_outs || !out_outs || !in_ins
+        || !out_ins) {
+        fprintf(stderr, "Could not allocate structs\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < NSTRUCTS; i++) {
+        in_handles[i].cookie = (hg_uint64_t) i << 32 | (hg_uint64_t) i;
+        in_outs[i].ret = -i;
+        in_outs[i].event_id = i;
+        in_ins[i].handle.cookie = (hg_uint64_t) i;
+    }
+
+    if (hg_test_info.na_test_info.mpi_comm_rank == 0) {
+        fprintf(stdout, "# %s v%s\n", BENCHMARK_NAME, VERSION_NAME);
+        fprintf(stdout, "# Loop %d times over %d struct(s)\n",
+            hg_test_info.na_test_info.loop * LOOP_FACTOR, NSTRUCTS);
+#ifndef HG_HAS_BOOST
+        fprintf(stdout, "# Boost is disabled, procs are written by hand\n");
+#endif
+        fprintf(stdout, "%-*s%*s%*s\n", 24, "# Struct", NWIDTH,
+            "Encode (ns/struct)", NWIDTH, "Decode (ns/struct)");
+        fflush(stdout);
+    }
+
+    if (measure_proc_pod(&hg_test_info, "rpc_handle_t (fields)",
+        hg_proc_rpc_handle_fields_t, in_handles, out_handles,
+        sizeof(rpc_handle_t)) != HG_SUCCESS)
+        ret = EXIT_FAILURE;
+    if (measure_proc_pod(&hg_test_info, "rpc_handle_t",
+        hg_proc_rpc_handle_t, in_handles, out_handles, sizeof(rpc_handle_t))
+        != HG_SUCCESS)
+        ret = EXIT_FAILURE;
+    if (measure_proc_pod(&hg_test_info, "rpc_open_out_t (fields)",
+        hg_proc_rpc_open_out_fields_t, in_outs, out_outs,
+        sizeof(rpc_open_out_t)) != HG_SUCCESS)
+        ret = EXIT_FAILURE;
+    if (measure_proc_pod(&hg_test_info, "rpc_open_out_t",
+        hg_proc_rpc_open_out_t, in_outs, out_outs, sizeof(rpc_open_out_t))
+        != HG_SUCCESS)
+        ret = EXIT_FAILURE;
+    /* Mixed struct, path is NULL so that nothing is allocated on decode */
+    if (measure_proc_pod(&hg_test_info, "rpc_open_in_t",
+        hg_proc_rpc_open_in_t, in_ins, out_ins, sizeof(rpc_open_in_t))
+        != HG_SUCCESS)
+        ret = EXIT_FAILURE;
+
+done:
+    free(in_handles);
+    free(out_handles);
+    free(in_outs);
+    free(out_outs);
+    free(in_ins);
+    free(out_ins);
+    HG_Test_finalize(&hg_test_info);
+
+    return ret;
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_test.h"
+#include "mercury_time.h"
+#include "mercury_proc_string.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCHMARK_NAME "Proc decode rate of strings"
+#define STRING(s) #s
+#define XSTRING(s) STRING(s)
+#define VERSION_NAME \
+    XSTRING(HG_VERSION_MAJOR) \
+    "." \
+    XSTRING(HG_VERSION_MINOR) \
+    "." \
+    XSTRING(HG_VERSION_PATCH)
+
+#define SKIP 5
+#define LOOP_FACTOR 10000
+
+#define NDIGITS 2
+#define NWIDTH 20
+#define MAX_LEN 4096
+#define BUF_SIZE (MAX_LEN + 1024)
+
+#define STRING_COPY     0
+#define STRING_SMALL    1
+#define STRING_BORROW   2
+
+/* Decode as hg_string_t or hg_small_string_t, return decoded string */
+static hg_return_t
+proc_string_decode(hg_proc_t proc, int mode, hg_string_t *string,
+    hg_small_string_t *small_string, const char **s)
+{
+    hg_return_t ret;
+
+    if (mode == STRING_COPY) {
+        ret = hg_proc_hg_string_t(proc, string);
+        *s = *string;
+    } else {
+        ret = hg_proc_hg_small_string_t(proc, small_string);
+        *s = hg_small_string_get(small_string);
+    }
+
+    return ret;
+}
+
+static hg_return_t
+measure_proc_string(struct hg_test_info *hg_test_info, const char *in_string,
+    size_t len, const char *name, int mode)
+{
+    size_t loop = (size_t) hg_test_info->na_test_info.loop * LOOP_FACTOR;
+    size_t skip = SKIP;
+    hg_string_t string = (hg_string_t) in_string, out_string = NULL;
+    hg_small_string_t out_small_string;
+    const char *s;
+    char *buf = NULL;
+    hg_proc_t proc = HG_PROC_NULL;
+    hg_time_t t1 = {0, 0}, t2;
+    double time_decode;
+    hg_return_t ret = HG_SUCCESS;
+    size_t i;
+
+    buf = (char *) malloc(BUF_SIZE);
+    if (!buf) {
+        fprintf(stderr, "Could not allocate buf\n");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+
+    ret = hg_proc_create(hg_test_info->hg_class, HG_NOHASH, &proc);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not create proc\n");
+        goto done;
+    }
+    hg_proc_set_array_borrow(proc, (hg_bool_t) (mode == STRING_BORROW));
+
+    /* Strings are always encoded as hg_string_t */
+    hg_proc_reset(proc, buf, BUF_SIZE, HG_ENCODE);
+    ret = hg_proc_hg_string_t(proc, &string);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not encode string\n");
+        goto done;
+    }
+    hg_proc_flush(proc);
+
+    /* Decode, including release of the decoded string */
+    for (i = 0; i < skip + loop; i++) {
+        if (i == skip)
+            hg_time_get_current(&t1);
+        hg_proc_reset(proc, buf, BUF_SIZE, HG_DECODE);
+        ret = proc_string_decode(proc, mode, &out_string, &out_small_string,
+            &s);
+        if (ret != HG_SUCCESS) {
+            fprintf(stderr, "Could not decode string\n");
+            goto done;
+        }
+        hg_proc_flush(proc);
+        if (i == 0 && (strlen(s) != len || strcmp(s, in_string))) {
+            fprintf(stderr, "Decoded string does not match\n");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+        hg_proc_reset(proc, NULL, 0, HG_FREE);
+        proc_string_decode(proc, mode, &out_string, &out_small_string, &s);
+    }
+    hg_time_get_current(&t2);
+    time_decode = hg_time_to_double(hg_time_subtract(t2, t1));
+
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+        fprintf(stdout, "%-*s%-*u%*.*f\n", 10, name, 10, (unsigned int) len,
+            NWIDTH, NDIGITS, (double) loop / (time_decode * 1e6));
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    free(buf);
+    return ret;
+}
+
+/* Small strings encode as hg_string_t, including NULL strings */
+static hg_return_t
+check_proc_small_string(struct hg_test_info *hg_test_info, const char *s)
+{
+    hg_small_string_t small_string;
+    hg_string_t string = NULL;
+    char buf[256];
+    hg_proc_t proc = HG_PROC_NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    ret = hg_proc_create(hg_test_info->hg_class, HG_NOHASH, &proc);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not create proc\n");
+        goto done;
+    }
+
+    hg_small_string_set(&small_string, s);
+    hg_proc_reset(proc, buf, sizeof(buf), HG_ENCODE);
+    ret = hg_proc_hg_small_string_t(proc, &small_string);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not encode small string\n");
+        goto done;
+    }
+    hg_proc_flush(proc);
+
+    hg_proc_reset(proc, buf, sizeof(buf), HG_DECODE);
+    ret = hg_proc_hg_string_t(proc, &string);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not decode string\n");
+        goto done;
+    }
+    hg_proc_flush(proc);
+    if (s ? (!string || strcmp(s, string)) : (string != NULL)) {
+        fprintf(stderr, "Decoded string does not match\n");
+        ret = HG_PROTOCOL_ERROR;
+    }
+    hg_proc_reset(proc, NULL, 0, HG_FREE);
+    hg_proc_hg_string_t(proc, &string);
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+    return ret;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info = { 0 };
+    char *in_string = NULL;
+    size_t len;
+    int ret = EXIT_SUCCESS;
+
+    HG_Test_init(argc, argv, &hg_test_info);
+
+    in_string = (char *) malloc(MAX_LEN + 1);
+    if (!in_string) {
+        fprintf(stderr, "Could not allocate string\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (len = 0; len < MAX_LEN; len++)
+        in_string[len] = (char) ('a' + len % 26);
+    in_string[MAX_LEN] = '\0';
+
+    if (check_proc_small_string(&hg_test_info, NULL) != HG_SUCCESS
+        || check_proc_small_string(&hg_test_info, "/hg/small") != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    if (hg_test_info.na_test_info.mpi_comm_rank == 0) {
+        fprintf(stdout, "# %s v%s\n", BENCHMARK_NAME, VERSION_NAME);
+        fprintf(stdout, "# Loop %d times\n",
+            hg_test_info.na_test_info.loop * LOOP_FACTOR);
+        fprintf(stdout, "%-*s%-*s%*s\n", 10, "# Proc", 10, "Length",
+            NWIDTH, "Decode (M/s)");
+        fflush(stdout);
+    }
+
+    for (len = 16; len <= MAX_LEN; len *= 16) {
+        const char *s = in_string + MAX_LEN - len;
+
+        /* Decoded string is allocated */
+        if (measure_proc_string(&hg_test_info, s, len, "string", STRING_COPY)
+            != HG_SUCCESS)
+            ret = EXIT_FAILURE;
+        /* Decoded string is inline or allocated from proc arena */
+        if (measure_proc_string(&hg_test_info, s, len, "small", STRING_SMALL)
+            != HG_SUCCESS)
+            ret = EXIT_FAILURE;
+        /* Decoded string is inline or points into buffer */
+        if (measure_proc_string(&hg_test_info, s, len, "borrow",
+            STRING_BORROW) != HG_SUCCESS)
+            ret = EXIT_FAILURE;
+    }
+
+done:
+    free(in_string);
+    HG_Test_finalize(&hg_test_info);
+
+    return ret;
+}
@@ -1,4 +1,6 @@
 #include "mercury_atomic_queue.h"
+#include "mercury_atomic_seg_queue.h"
+#include "mercury_thread.h"
 
 #include "mercury_test_config.h"
 
@@ -11,6 +13,130 @@ struct my_entry {
 
 #define HG_TEST_QUEUE_SIZE 16
 
+/* Small segments so that the stress test keeps appending and reclaiming
+ * segments, each producer pushes many more entries than a segment holds */
+#define HG_TEST_SEG_SIZE 8
+#define HG_TEST_NUM_PRODUCERS 4
+#define HG_TEST_NUM_CONSUMERS 4
+#define HG_TEST_NUM_ENTRIES (1 << 16)
+
+static struct hg_atomic_seg_queue *hg_atomic_seg_queue;
+static struct my_entry stress_entries[HG_TEST_NUM_PRODUCERS][HG_TEST_NUM_ENTRIES];
+static hg_atomic_int32_t stress_popped[HG_TEST_NUM_PRODUCERS][HG_TEST_NUM_ENTRIES];
+static hg_atomic_int32_t stress_pop_count;
+static hg_atomic_int32_t stress_error;
+
+static HG_THREAD_RETURN_TYPE
+stress_produce(void *arg)
+{
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+    struct my_entry *entries = (struct my_entry *) arg;
+    int i;
+
+    for (i = 0; i < HG_TEST_NUM_ENTRIES; i++) {
+        /* Push some entries one by one and others by batch */
+        if (i % 4 == 0 && i + 4 <= HG_TEST_NUM_ENTRIES) {
+            void *batch[4] = { &entries[i], &entries[i + 1], &entries[i + 2],
+                &entries[i + 3] };
+
+            if (hg_atomic_seg_queue_push_n(hg_atomic_seg_queue, batch, 4)
+                != 4)
+                hg_atomic_incr32(&stress_error);
+            i += 3;
+        } else if (hg_atomic_seg_queue_push(hg_atomic_seg_queue, &entries[i])
+            != HG_UTIL_SUCCESS)
+            hg_atomic_incr32(&stress_error);
+    }
+
+    return thread_ret;
+}
+
+static HG_THREAD_RETURN_TYPE
+stress_consume(void *arg)
+{
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+    int last[HG_TEST_NUM_PRODUCERS];
+    int i;
+    (void) arg;
+
+    for (i = 0; i < HG_TEST_NUM_PRODUCERS; i++)
+        last[i] = -1;
+
+    while (hg_atomic_get32(&stress_pop_count)
+        < HG_TEST_NUM_PRODUCERS * HG_TEST_NUM_ENTRIES) {
+        void *entries[HG_TEST_QUEUE_SIZE];
+        unsigned int count, j;
+
+        count = hg_atomic_seg_queue_pop_n(hg_atomic_seg_queue, entries,
+            HG_TEST_QUEUE_SIZE);
+        if (!count) {
+            hg_thread_yield();
+            continue;
+        }
+        for (j = 0; j < count; j++) {
+            struct my_entry *my_entry_ptr = entries[j];
+            int producer = my_entry_ptr->value / HG_TEST_NUM_ENTRIES;
+            int index = my_entry_ptr->value % HG_TEST_NUM_ENTRIES;
+
+            /* Each entry is popped once and entries of a producer are
+             * popped in order by a given consumer */
+            if (hg_atomic_incr32(&stress_popped[producer][index]) != 1
+                || index <= last[producer])
+                hg_atomic_incr32(&stress_error);
+            last[producer] = index;
+        }
+        hg_atomic_fence();
+        for (j = 0; j < count; j++)
+            hg_atomic_incr32(&stress_pop_count);
+    }
+
+    return thread_ret;
+}
+
+static int
+test_seg_queue_stress(void)
+{
+    hg_thread_t producers[HG_TEST_NUM_PRODUCERS];
+    hg_thread_t consumers[HG_TEST_NUM_CONSUMERS];
+    int ret = EXIT_SUCCESS;
+    int i, j;
+
+    hg_atomic_seg_queue = hg_atomic_seg_queue_alloc(HG_TEST_SEG_SIZE);
+    if (!hg_atomic_seg_queue) {
+        fprintf(stderr, "Error: could not allocate queue\n");
+        return EXIT_FAILURE;
+    }
+    hg_atomic_init32(&stress_pop_count, 0);
+    hg_atomic_init32(&stress_error, 0);
+    for (i = 0; i < HG_TEST_NUM_PRODUCERS; i++)
+        for (j = 0; j < HG_TEST_NUM_ENTRIES; j++) {
+            stress_entries[i][j].value = i * HG_TEST_NUM_ENTRIES + j;
+            hg_atomic_init32(&stress_popped[i][j], 0);
+        }
+
+    for (i = 0; i < HG_TEST_NUM_CONSUMERS; i++)
+        hg_thread_create(&consumers[i], stress_consume, NULL);
+    for (i = 0; i < HG_TEST_NUM_PRODUCERS; i++)
+        hg_thread_create(&producers[i], stress_produce, stress_entries[i]);
+    for (i = 0; i < HG_TEST_NUM_PRODUCERS; i++)
+        hg_thread_join(producers[i]);
+    for (i = 0; i < HG_TEST_NUM_CONSUMERS; i++)
+        hg_thread_join(consumers[i]);
+
+    if (hg_atomic_get32(&stress_error)) {
+        fprintf(stderr, "Error: %d entries lost, duplicated or reordered\n",
+            hg_atomic_get32(&stress_error));
+        ret = EXIT_FAILURE;
+    } else if (!hg_atomic_seg_queue_is_empty(hg_atomic_seg_queue)) {
+        fprintf(stderr, "Error: queue should be empty\n");
+        ret = EXIT_FAILURE;
+    }
+
+    hg_atomic_seg_queue_free(hg_atomic_seg_queue);
+    hg_atomic_seg_queue = NULL;
+    return ret;
+}
+
 int
 main(void)
 {
@@ -20,6 +146,10 @@ main(void)
     struct my_entry my_entry1 = { .value = value1 };
     struct my_entry my_entry2 = { .value = value2 };
     struct my_entry *my_entry_ptr;
+    struct my_entry my_entries[HG_TEST_QUEUE_SIZE];
+    void *entries[HG_TEST_QUEUE_SIZE];
+    unsigned int count;
+    int i;
 
     hg_atomic_queue = hg_atomic_queue_alloc(HG_TEST_QUEUE_SIZE);
     if (!hg_atomic_queue) {
@@ -47,7 +177,87 @@ main(void)
         goto done;
     }
 
+    /* Batch push / pop (queue can hold at most size - 1 entries) */
+    for (i = 0; i < HG_TEST_QUEUE_SIZE; i++) {
+        my_entries[i].value = i;
+        entries[i] = &my_entries[i];
+    }
+    count = hg_atomic_queue_push_n(hg_atomic_queue, entries,
+        HG_TEST_QUEUE_SIZE);
+    if (count != HG_TEST_QUEUE_SIZE - 1) {
+        fprintf(stderr, "Error: pushed %u entries, expected %d\n", count,
+            HG_TEST_QUEUE_SIZE - 1);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (hg_atomic_queue_push_n(hg_atomic_queue, entries, 1) != 0) {
+        fprintf(stderr, "Error: push to full queue should fail\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    count = hg_atomic_queue_pop_mc_n(hg_atomic_queue, entries,
+        HG_TEST_QUEUE_SIZE);
+    if (count != HG_TEST_QUEUE_SIZE - 1) {
+        fprintf(stderr, "Error: popped %u entries, expected %d\n", count,
+            HG_TEST_QUEUE_SIZE - 1);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < (int) count; i++) {
+        my_entry_ptr = entries[i];
+        if (i != my_entry_ptr->value) {
+            fprintf(stderr, "Error: values do not match, expected %d, got %d\n",
+                i, my_entry_ptr->value);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+    if (!hg_atomic_queue_is_empty(hg_atomic_queue)) {
+        fprintf(stderr, "Error: queue should be empty\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Unbounded queue keeps accepting entries past its segment size */
+    hg_atomic_seg_queue = hg_atomic_seg_queue_alloc(HG_TEST_SEG_SIZE);
+    if (!hg_atomic_seg_queue) {
+        fprintf(stderr, "Error: could not allocate queue\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    count = hg_atomic_seg_queue_push_n(hg_atomic_seg_queue, entries,
+        HG_TEST_QUEUE_SIZE);
+    if (count != HG_TEST_QUEUE_SIZE) {
+        fprintf(stderr, "Error: pushed %u entries, expected %d\n", count,
+            HG_TEST_QUEUE_SIZE);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    hg_atomic_seg_queue_push(hg_atomic_seg_queue, &my_entry1);
+    for (i = 0; i <= HG_TEST_QUEUE_SIZE; i++) {
+        my_entry_ptr = hg_atomic_seg_queue_pop(hg_atomic_seg_queue);
+        if (!my_entry_ptr || my_entry_ptr != ((i < HG_TEST_QUEUE_SIZE) ?
+            &my_entries[i] : &my_entry1)) {
+            fprintf(stderr, "Error: unexpected entry popped at %d\n", i);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+    if (!hg_atomic_seg_queue_is_empty(hg_atomic_seg_queue)
+        || hg_atomic_seg_queue_pop(hg_atomic_seg_queue)) {
+        fprintf(stderr, "Error: queue should be empty\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    hg_atomic_seg_queue_free(hg_atomic_seg_queue);
+    hg_atomic_seg_queue = NULL;
+
+    /* Concurrent producers and consumers overflowing many segments */
+    ret = test_seg_queue_stress();
+
 done:
     hg_atomic_queue_free(hg_atomic_queue);
+    hg_atomic_seg_queue_free(hg_atomic_seg_queue);
     return ret;
 }
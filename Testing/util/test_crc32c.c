@@ -0,0 +1,104 @@
+#include "mercury_crc32c.h"
+
+#include "mercury_test_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BUF_SIZE 1024
+
+/* Bitwise reference */
+static hg_util_uint32_t
+crc32c_ref(const unsigned char *buf, size_t size)
+{
+    hg_util_uint32_t crc = 0xFFFFFFFF;
+    size_t i;
+    int j;
+
+    for (i = 0; i < size; i++) {
+        crc ^= buf[i];
+        for (j = 0; j < 8; j++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+    }
+
+    return ~crc;
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *check = "123456789";
+    unsigned char buf[BUF_SIZE];
+    hg_util_uint32_t crc;
+    size_t i, offset, size;
+    int ret = EXIT_SUCCESS;
+
+    (void) argc;
+    (void) argv;
+
+    /* Check value of CRC32C */
+    crc = hg_crc32c(0, check, strlen(check));
+    if (crc != 0xE3069283) {
+        fprintf(stderr, "Error: checksum is 0x%08X, expected 0xE3069283\n",
+            crc);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* iSCSI (RFC 3720) vectors */
+    memset(buf, 0, 32);
+    crc = hg_crc32c(0, buf, 32);
+    if (crc != 0x8A9136AA) {
+        fprintf(stderr, "Error: checksum is 0x%08X, expected 0x8A9136AA\n",
+            crc);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < 32; i++)
+        buf[i] = (unsigned char) i;
+    crc = hg_crc32c(0, buf, 32);
+    if (crc != 0x46DD794E) {
+        fprintf(stderr, "Error: checksum is 0x%08X, expected 0x46DD794E\n",
+            crc);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Unaligned data and sizes, checksummed at once and in two parts */
+    for (i = 0; i < BUF_SIZE; i++)
+        buf[i] = (unsigned char) (i * 31 + 7);
+    for (offset = 0; offset < 8; offset++) {
+        for (size = 0; size <= 64; size++) {
+            size_t split = size / 3;
+            hg_util_uint32_t expected = crc32c_ref(buf + offset, size);
+
+            crc = hg_crc32c(0, buf + offset, size);
+            if (crc != expected) {
+                fprintf(stderr, "Error: checksum of %zu bytes at offset %zu "
+                    "is 0x%08X, expected 0x%08X\n", size, offset, crc,
+                    expected);
+                ret = EXIT_FAILURE;
+                goto done;
+            }
+            crc = hg_crc32c(hg_crc32c(0, buf + offset, split),
+                buf + offset + split, size - split);
+            if (crc != expected) {
+                fprintf(stderr, "Error: checksum of %zu bytes in two parts "
+                    "is 0x%08X, expected 0x%08X\n", size, crc, expected);
+                ret = EXIT_FAILURE;
+                goto done;
+            }
+        }
+    }
+    if (hg_crc32c(0, buf + 1, BUF_SIZE - 1)
+        != crc32c_ref(buf + 1, BUF_SIZE - 1)) {
+        fprintf(stderr, "Error: checksum of %d bytes does not match\n",
+            BUF_SIZE - 1);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+done:
+    return ret;
+}
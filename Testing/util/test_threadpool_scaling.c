@@ -0,0 +1,148 @@
+#include "mercury_thread_pool.h"
+#include "mercury_atomic.h"
+#include "mercury_time.h"
+
+#include "mercury_test_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_THREADS 64
+#define NUM_POSTS (1 << 16)
+#define TREE_DEPTH 15 /* 2^(TREE_DEPTH + 1) - 1 works */
+#define WORK_ITER 100
+
+struct tree_work {
+    struct hg_thread_work work;
+    hg_thread_pool_t *pool;
+    unsigned int depth;
+};
+
+static hg_atomic_int32_t ncalls;
+static hg_atomic_int32_t nworks;
+static struct tree_work works[NUM_POSTS * 2];
+
+static void
+do_work(void)
+{
+    volatile unsigned int sum = 0;
+    unsigned int i;
+
+    for (i = 0; i < WORK_ITER; i++)
+        sum += i;
+}
+
+static HG_THREAD_RETURN_TYPE
+flat_func(void *args)
+{
+    hg_thread_ret_t ret = 0;
+    (void) args;
+
+    do_work();
+    hg_atomic_incr32(&ncalls);
+
+    return ret;
+}
+
+/* Each work posts two children from within the pool */
+static HG_THREAD_RETURN_TYPE
+tree_func(void *args)
+{
+    hg_thread_ret_t ret = 0;
+    struct tree_work *parent = (struct tree_work *) args;
+    int i;
+
+    if (parent->depth) {
+        for (i = 0; i < 2; i++) {
+            struct tree_work *child =
+                &works[hg_atomic_incr32(&nworks) - 1];
+
+            child->work.func = tree_func;
+            child->work.args = child;
+            child->pool = parent->pool;
+            child->depth = parent->depth - 1;
+            hg_thread_pool_post(parent->pool, &child->work);
+        }
+    }
+    do_work();
+    hg_atomic_incr32(&ncalls);
+
+    return ret;
+}
+
+static int
+measure_pool(unsigned int thread_count, int tree)
+{
+    hg_thread_pool_t *thread_pool = NULL;
+    int expected = tree ? (1 << (TREE_DEPTH + 1)) - 1 : NUM_POSTS;
+    hg_time_t t1, t2;
+    double time_read;
+    int i, ret = EXIT_SUCCESS;
+
+    hg_atomic_set32(&ncalls, 0);
+    hg_atomic_set32(&nworks, 0);
+    if (hg_thread_pool_init(thread_count, &thread_pool) != HG_UTIL_SUCCESS) {
+        fprintf(stderr, "Could not create thread pool\n");
+        return EXIT_FAILURE;
+    }
+
+    hg_time_get_current(&t1);
+    if (tree) {
+        struct tree_work *root = &works[hg_atomic_incr32(&nworks) - 1];
+
+        root->work.func = tree_func;
+        root->work.args = root;
+        root->pool = thread_pool;
+        root->depth = TREE_DEPTH;
+        hg_thread_pool_post(thread_pool, &root->work);
+    } else {
+        for (i = 0; i < NUM_POSTS; i++) {
+            works[i].work.func = flat_func;
+            works[i].work.args = NULL;
+            hg_thread_pool_post(thread_pool, &works[i].work);
+        }
+    }
+    while (hg_atomic_get32(&ncalls) < expected)
+        hg_thread_yield();
+    hg_time_get_current(&t2);
+    time_read = hg_time_to_double(hg_time_subtract(t2, t1));
+
+    hg_thread_pool_destroy(thread_pool);
+
+    if (hg_atomic_get32(&ncalls) != expected) {
+        fprintf(stderr, "Did not execute all the operations posted (%d/%d)\n",
+            hg_atomic_get32(&ncalls), expected);
+        ret = EXIT_FAILURE;
+    }
+
+    fprintf(stdout, "%-10s%-10u%20.2f\n", tree ? "tree" : "flat", thread_count,
+        (double) expected / (time_read * 1e6));
+    fflush(stdout);
+
+    return ret;
+}
+
+int
+main(int argc, char *argv[])
+{
+    unsigned int thread_count;
+    int ret = EXIT_SUCCESS;
+
+    (void) argc;
+    (void) argv;
+
+    fprintf(stdout, "# Thread pool throughput, from 1 to %d threads\n",
+        MAX_THREADS);
+    fprintf(stdout, "%-10s%-10s%20s\n", "# Posts", "Threads", "Works (M/s)");
+
+    for (thread_count = 1; thread_count <= MAX_THREADS; thread_count *= 2) {
+        /* All works posted by the main thread */
+        if (measure_pool(thread_count, 0) != EXIT_SUCCESS)
+            ret = EXIT_FAILURE;
+        /* Works posted by workers */
+        if (measure_pool(thread_count, 1) != EXIT_SUCCESS)
+            ret = EXIT_FAILURE;
+    }
+
+    return ret;
+}
@@ -13,8 +13,12 @@
 #include "mercury_core.h"
 #include "mercury_header.h"
 #include "mercury_proc.h"
+#include "mercury_proc_plan.h"
+#include "mercury_proc_private.h"
+#include "mercury_private.h"
 #include "mercury_error.h"
 
+#include "mercury_atomic.h"
 #include "mercury_hash_string.h"
 #include "mercury_mem.h"
 
@@ -39,24 +43,40 @@
 struct hg_proc_info {
     hg_proc_cb_t in_proc_cb;        /* Input proc callback */
     hg_proc_cb_t out_proc_cb;       /* Output proc callback */
+    hg_proc_plan_t in_plan;         /* Input plan (instead of callback) */
+    hg_proc_plan_t out_plan;        /* Output plan (instead of callback) */
     hg_bool_t no_response;          /* RPC response not expected */
+    hg_proc_hash_t hash;            /* Hash method of payload checksum */
+    hg_atomic_int32_t in_overflow;  /* Last input did not fit into buffer */
+    hg_atomic_int32_t out_overflow; /* Last output did not fit into buffer */
+    hg_bool_t array_borrow;         /* Decoded arrays point into buffer */
+    hg_bool_t proc_sizing;          /* Procs support HG_SIZE */
     void *data;                     /* User data */
     void (*free_callback)(void *);  /* User data free callback */
 };
 
 /* Private handle data */
 struct hg_private_data {
+    hg_class_t *hg_class;           /* HG class */
     hg_cb_t forward_cb;             /* Forward callback */
     void *forward_arg;              /* Forward callback args */
     hg_cb_t respond_cb;             /* Respond callback */
     void *respond_arg;              /* Respond callback args */
     struct hg_header hg_header;     /* Header for input/output */
-    hg_proc_t in_proc;              /* Proc for input */
-    hg_proc_t out_proc;             /* Proc for output */
+    hg_proc_t in_proc;              /* Proc for input (created on use) */
+    hg_proc_t out_proc;             /* Proc for output (created on use) */
     void *extra_bulk_buf;           /* Extra bulk buffer */
     size_t extra_bulk_buf_size;     /* Extra bulk buffer size */
     hg_bulk_t extra_bulk_handle;    /* Extra bulk handle */
+    hg_bulk_t extra_bulk_staging;   /* Staging handle of extra bulk buffer */
     hg_return_t (*extra_bulk_transfer_cb)(hg_handle_t); /* Bulk transfer callback */
+#ifdef HG_HAS_EAGER_BULK
+    hg_uint32_t eager_push_mask;    /* Input bulk handles accepting push data */
+    hg_bool_t eager_push_input;     /* Input bulk handles point to eager_push */
+    hg_size_t eager_push_recv_size; /* Size of push data in response */
+    struct hg_bulk_eager_push eager_push; /* Push data to add to response */
+#endif
+    hg_uint64_t proc_mem[];         /* Memory of input and output procs */
 };
 
 /***********************/
@@ -72,6 +92,39 @@ hg_core_get_rpc_data(
         struct hg_handle *hg_handle
         );
 
+#ifdef HG_HAS_EAGER_BULK
+/**
+ * Can handle receive eager push data (local and writable).
+ */
+extern hg_bool_t
+hg_bulk_eager_push_accept(
+        hg_bulk_t handle
+        );
+
+/**
+ * Let pushes to a handle decoded from RPC input be added to the response,
+ * passing NULL detaches the handle.
+ */
+extern void
+hg_bulk_eager_push_set(
+        hg_bulk_t handle,
+        struct hg_bulk_eager_push *eager_push,
+        hg_uint32_t index
+        );
+
+/**
+ * Copy eager push data received with the RPC response to local handles.
+ */
+extern hg_return_t
+hg_bulk_eager_push_apply(
+        hg_bulk_t *handles,
+        hg_uint32_t count,
+        hg_uint32_t mask,
+        void *buf,
+        hg_size_t buf_size
+        );
+#endif
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -101,6 +154,16 @@ hg_private_data_free(
         void *arg
         );
 
+/**
+ * Get input/output proc of handle, created on first use.
+ */
+static hg_return_t
+hg_private_data_get_proc(
+        struct hg_private_data *hg_private_data,
+        hg_op_t op,
+        hg_proc_t *proc
+        );
+
 /**
  * More data callback.
  */
@@ -118,6 +181,17 @@ hg_more_data_free_cb(
         hg_handle_t handle
         );
 
+/**
+ * Process input/output structure with plan or proc callback.
+ */
+static HG_INLINE hg_return_t
+hg_proc_struct(
+        hg_proc_t proc,
+        hg_proc_cb_t proc_cb,
+        hg_proc_plan_t plan,
+        void *struct_ptr
+        );
+
 /**
  * Decode and get input/output structure.
  */
@@ -182,6 +256,63 @@ hg_free_extra_input(
         struct hg_private_data *hg_private_data
         );
 
+/**
+ * Get flags for serializing bulk handles sent to handle's peer.
+ */
+static hg_uint8_t
+hg_get_bulk_flags(
+        hg_handle_t handle
+        );
+
+#ifdef HG_HAS_EAGER_BULK
+/**
+ * Get mask of input bulk handles that can receive eager push data.
+ */
+static hg_uint32_t
+hg_get_eager_push_mask(
+        hg_proc_t proc
+        );
+
+/**
+ * Let target add data pushed to input bulk handles to the response.
+ */
+static hg_return_t
+hg_set_eager_push_input(
+        hg_handle_t handle,
+        struct hg_private_data *hg_private_data
+        );
+
+/**
+ * Detach input bulk handles from eager push data so that they no longer
+ * reference the handle once input is freed (target).
+ */
+static void
+hg_reset_eager_push_input(
+        struct hg_private_data *hg_private_data
+        );
+
+/**
+ * Copy eager push data into output buffer (target) and return whether the
+ * origin expects the output header.
+ */
+static hg_bool_t
+hg_set_eager_push_output(
+        struct hg_private_data *hg_private_data,
+        void *buf,
+        hg_size_t buf_size,
+        hg_size_t *header_offset
+        );
+
+/**
+ * Copy eager push data from response to local bulk handles (origin).
+ */
+static hg_return_t
+hg_get_eager_push_output(
+        hg_handle_t handle,
+        struct hg_private_data *hg_private_data
+        );
+#endif
+
 /**
  * Forward callback.
  */
@@ -213,6 +344,8 @@ hg_proc_info_free(void *arg)
 
     if (hg_proc_info->free_callback)
         hg_proc_info->free_callback(hg_proc_info->data);
+    hg_proc_plan_free(hg_proc_info->in_plan);
+    hg_proc_plan_free(hg_proc_info->out_plan);
     free(hg_proc_info);
 }
 
@@ -221,30 +354,23 @@ static hg_return_t
 hg_private_data_alloc(hg_class_t *hg_class, hg_handle_t handle)
 {
     struct hg_private_data *hg_private_data;
-    hg_return_t ret;
+    hg_return_t ret = HG_SUCCESS;
 
-    /* Create private data to wrap callbacks etc */
+    /* Create private data to wrap callbacks etc, procs are only created when
+     * payload is processed but share the same allocation */
     hg_private_data = (struct hg_private_data *) malloc(
-        sizeof(struct hg_private_data));
+        sizeof(struct hg_private_data) + 2 * hg_proc_get_struct_size());
     if (!hg_private_data) {
         HG_LOG_ERROR("Could not allocate private data");
         ret = HG_NOMEM_ERROR;
         goto done;
     }
     memset(hg_private_data, 0, sizeof(struct hg_private_data));
+    hg_private_data->hg_class = hg_class;
     hg_header_init(&hg_private_data->hg_header, HG_UNDEF);
-
-    /* CRC32 is enough for small size buffers */
-    ret = hg_proc_create(hg_class, HG_CRC32, &hg_private_data->in_proc);
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Cannot create HG proc");
-        goto done;
-    }
-    ret = hg_proc_create(hg_class, HG_CRC32, &hg_private_data->out_proc);
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Cannot create HG proc");
-        goto done;
-    }
+#ifdef HG_HAS_EAGER_BULK
+    hg_thread_spin_init(&hg_private_data->eager_push.lock);
+#endif
     HG_Core_set_data(handle, hg_private_data, hg_private_data_free);
 
 done:
@@ -257,15 +383,50 @@ hg_private_data_free(void *arg)
 {
     struct hg_private_data *hg_private_data = (struct hg_private_data *) arg;
 
+#ifdef HG_HAS_EAGER_BULK
+    /* Input was not freed, user may still hold references to its handles */
+    hg_reset_eager_push_input(hg_private_data);
+#endif
     if (hg_private_data->in_proc != HG_PROC_NULL)
-        hg_proc_free(hg_private_data->in_proc);
+        hg_proc_finalize(hg_private_data->in_proc);
     if (hg_private_data->out_proc != HG_PROC_NULL)
-        hg_proc_free(hg_private_data->out_proc);
+        hg_proc_finalize(hg_private_data->out_proc);
+    hg_free_extra_input(hg_private_data);
     hg_mem_aligned_free(hg_private_data->extra_bulk_buf);
     hg_header_finalize(&hg_private_data->hg_header);
+#ifdef HG_HAS_EAGER_BULK
+    free(hg_private_data->eager_push.buf);
+    hg_thread_spin_destroy(&hg_private_data->eager_push.lock);
+#endif
     free(hg_private_data);
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_private_data_get_proc(struct hg_private_data *hg_private_data,
+    hg_op_t op, hg_proc_t *proc)
+{
+    hg_proc_t *proc_ptr = (op == HG_INPUT) ? &hg_private_data->in_proc :
+        &hg_private_data->out_proc;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (*proc_ptr == HG_PROC_NULL) {
+        void *mem = (char *) hg_private_data->proc_mem +
+            ((op == HG_INPUT) ? 0 : hg_proc_get_struct_size());
+
+        ret = hg_proc_init(hg_private_data->hg_class, HG_CRC32, mem, proc_ptr);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Cannot create HG proc");
+            *proc_ptr = HG_PROC_NULL;
+            goto done;
+        }
+    }
+    *proc = *proc_ptr;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_more_data_cb(hg_handle_t handle, hg_return_t (*done_cb)(hg_handle_t))
@@ -320,6 +481,15 @@ done:
     return;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_proc_struct(hg_proc_t proc, hg_proc_cb_t proc_cb, hg_proc_plan_t plan,
+    void *struct_ptr)
+{
+    return plan ? hg_proc_plan_process(proc, plan, struct_ptr) :
+        proc_cb(proc, struct_ptr);
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_get_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
@@ -327,6 +497,7 @@ hg_get_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
 {
     hg_proc_t proc = HG_PROC_NULL;
     hg_proc_cb_t proc_cb = NULL;
+    hg_proc_plan_t plan = NULL;
     void *buf;
     hg_size_t buf_size;
     struct hg_header *hg_header = &hg_private_data->hg_header;
@@ -339,8 +510,8 @@ hg_get_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
     switch (op) {
         case HG_INPUT:
             /* Set input proc */
-            proc = hg_private_data->in_proc;
             proc_cb = hg_proc_info->in_proc_cb;
+            plan = hg_proc_info->in_plan;
 #ifdef HG_HAS_CHECKSUMS
             hg_header_hash = &hg_header->msg.input.hash;
 #endif
@@ -359,8 +530,8 @@ hg_get_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
                 goto done;
             }
             /* Set output proc */
-            proc = hg_private_data->out_proc;
             proc_cb = hg_proc_info->out_proc_cb;
+            plan = hg_proc_info->out_plan;
 #ifdef HG_HAS_CHECKSUMS
             hg_header_hash = &hg_header->msg.output.hash;
 #endif
@@ -376,12 +547,19 @@ hg_get_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
             ret = HG_INVALID_PARAM;
             goto done;
     }
-    if (!proc_cb) {
+    if (!proc_cb && !plan) {
         HG_LOG_ERROR("No proc set, proc must be set in HG_Register()");
         ret = HG_PROTOCOL_ERROR;
         goto done;
     }
 
+    /* Get proc */
+    ret = hg_private_data_get_proc(hg_private_data, op, &proc);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not get proc");
+        goto done;
+    }
+
     /* Reset header */
     hg_header_reset(hg_header, op);
 
@@ -392,6 +570,16 @@ hg_get_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
         goto done;
     }
 
+    /* Skip eager push data sent with the response */
+    if (op == HG_OUTPUT) {
+        if (hg_header->msg.output.eager_push_size > buf_size - header_offset) {
+            HG_LOG_ERROR("Invalid eager push size");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+        header_offset += hg_header->msg.output.eager_push_size;
+    }
+
     /* If the payload did not fit into the core buffer and we have an extra
      * buffer set, use that buffer directly */
     if (hg_private_data->extra_bulk_buf) {
@@ -404,14 +592,27 @@ hg_get_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
     }
 
     /* Reset proc */
+    ret = hg_proc_set_hash(proc, hg_proc_info->hash);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not set proc hash");
+        goto done;
+    }
     ret = hg_proc_reset(proc, buf, buf_size, HG_DECODE);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not reset proc");
         goto done;
     }
+    hg_proc_set_array_borrow(proc, hg_proc_info->array_borrow);
+#ifdef HG_HAS_EAGER_BULK
+    /* Handles of a previous decode are no longer tracked after this */
+    if (op == HG_INPUT)
+        hg_reset_eager_push_input(hg_private_data);
+#endif
 
     /* Decode parameters */
-    ret = proc_cb(proc, struct_ptr);
+    hg_proc_set_bulk_track(proc, (hg_bool_t) (op == HG_INPUT));
+    ret = hg_proc_struct(proc, proc_cb, plan, struct_ptr);
+    hg_proc_set_bulk_track(proc, HG_FALSE);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not decode parameters");
         goto done;
@@ -434,6 +635,16 @@ hg_get_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
     }
 #endif
 
+#ifdef HG_HAS_EAGER_BULK
+    if (op == HG_INPUT && !hg_proc_info->no_response) {
+        ret = hg_set_eager_push_input(handle, hg_private_data);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not set eager push");
+            goto done;
+        }
+    }
+#endif
+
     /* Increment ref count on handle so that it remains valid until free_struct
      * is called */
     HG_Core_ref_incr(handle);
@@ -450,8 +661,10 @@ hg_set_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
 {
     hg_proc_t proc = HG_PROC_NULL;
     hg_proc_cb_t proc_cb = NULL;
+    hg_proc_plan_t plan = NULL;
+    hg_atomic_int32_t *overflow = NULL;
     void *buf;
-    hg_size_t buf_size;
+    hg_size_t buf_size, size_hint = 0;
     struct hg_header *hg_header = &hg_private_data->hg_header;
 #ifdef HG_HAS_CHECKSUMS
     struct hg_header_hash *hg_header_hash = NULL;
@@ -462,8 +675,9 @@ hg_set_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
     switch (op) {
         case HG_INPUT:
             /* Set input proc */
-            proc = hg_private_data->in_proc;
             proc_cb = hg_proc_info->in_proc_cb;
+            plan = hg_proc_info->in_plan;
+            overflow = &hg_proc_info->in_overflow;
 #ifdef HG_HAS_CHECKSUMS
             hg_header_hash = &hg_header->msg.input.hash;
 #endif
@@ -482,8 +696,9 @@ hg_set_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
                 goto done;
             }
             /* Set output proc */
-            proc = hg_private_data->out_proc;
             proc_cb = hg_proc_info->out_proc_cb;
+            plan = hg_proc_info->out_plan;
+            overflow = &hg_proc_info->out_overflow;
 #ifdef HG_HAS_CHECKSUMS
             hg_header_hash = &hg_header->msg.output.hash;
 #endif
@@ -499,32 +714,112 @@ hg_set_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
             ret = HG_INVALID_PARAM;
             goto done;
     }
-    if (!proc_cb || !struct_ptr) {
+#ifdef HG_HAS_EAGER_BULK
+    if (op == HG_INPUT) {
+        hg_private_data->eager_push_mask = 0;
+        hg_private_data->eager_push_recv_size = 0;
+    }
+#endif
+
+    /* Reset header */
+    hg_header_reset(hg_header, op);
+
+#ifdef HG_HAS_EAGER_BULK
+    /* Eager push data is placed right after the output header */
+    if (op == HG_OUTPUT
+        && hg_set_eager_push_output(hg_private_data, buf, buf_size,
+            &header_offset) && ((!proc_cb && !plan) || !struct_ptr)) {
+        /* Origin expects a header even if there is no output */
+        ret = hg_header_proc(HG_ENCODE, buf, buf_size, hg_header);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not process header");
+            goto done;
+        }
+        *payload_size = header_offset;
+        goto done;
+    }
+#endif
+
+    if ((!proc_cb && !plan) || !struct_ptr) {
         /* Silently skip */
         *payload_size = 0;
         goto done;
     }
 
-    /* Reset header */
-    hg_header_reset(hg_header, op);
+    /* Get proc */
+    ret = hg_private_data_get_proc(hg_private_data, op, &proc);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not get proc");
+        goto done;
+    }
 
     /* Include our own header offset */
     buf = (char *) buf + header_offset;
     buf_size -= header_offset;
 
     /* Reset proc */
+    ret = hg_proc_set_hash(proc, hg_proc_info->hash);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not set proc hash");
+        goto done;
+    }
+
+    /* Bulk handles are only registered for the transport used by the peer */
+    hg_proc_set_bulk_flags(proc, hg_get_bulk_flags(handle));
+
+#ifndef HG_HAS_XDR
+    /* Plans without proc callback fields give the exact size from their
+     * field table at little cost. Otherwise if the last payload of that RPC
+     * did not fit and its procs were registered as supporting HG_SIZE,
+     * compute the size of this one first so that the extra buffer is
+     * allocated once */
+    if (plan && !hg_proc_plan_has_proc(plan)) {
+        if (hg_proc_plan_get_size(HG_PROC_NULL, plan, struct_ptr, &size_hint)
+            != HG_SUCCESS)
+            size_hint = 0;
+    } else if (hg_proc_info->proc_sizing && hg_atomic_get32(overflow)
+        && hg_proc_reset(proc, NULL, 0, HG_SIZE) == HG_SUCCESS) {
+        hg_return_t size_ret = plan ?
+            hg_proc_plan_get_size(proc, plan, struct_ptr, &size_hint) :
+            proc_cb(proc, struct_ptr);
+
+        if (size_ret != HG_SUCCESS)
+            size_hint = 0;
+        else if (!plan)
+            size_hint = hg_proc_get_size_used(proc);
+    }
+#endif
+
     ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not reset proc");
         goto done;
     }
+    if (size_hint > buf_size) {
+        ret = hg_proc_set_size(proc, size_hint);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not set proc size");
+            goto done;
+        }
+    }
 
     /* Encode parameters */
-    ret = proc_cb(proc, struct_ptr);
+    hg_proc_set_bulk_track(proc, (hg_bool_t) (op == HG_INPUT));
+    ret = hg_proc_struct(proc, proc_cb, plan, struct_ptr);
+    hg_proc_set_bulk_track(proc, HG_FALSE);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not encode parameters");
         goto done;
     }
+    hg_atomic_set32(overflow, hg_proc_get_extra_buf(proc) ? 1 : 0);
+
+#ifdef HG_HAS_EAGER_BULK
+    /* Let target send small pushes back with the response */
+    if (op == HG_INPUT && !hg_proc_info->no_response) {
+        hg_private_data->eager_push_mask = hg_get_eager_push_mask(proc);
+        hg_header->msg.input.eager_push = hg_private_data->eager_push_mask;
+    }
+#endif
 
     /* Flush proc */
     ret = hg_proc_flush(proc);
@@ -552,11 +847,6 @@ hg_set_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
     if (hg_proc_get_extra_buf(proc)) {
         const struct hg_info *hg_info = HG_Core_get_info(handle);
 
-#ifdef HG_HAS_XDR
-        HG_LOG_ERROR("Extra encoding using XDR is not yet supported");
-        ret = HG_SIZE_ERROR;
-        goto done;
-#endif
         /* Create a bulk descriptor only of the size that is used */
         hg_private_data->extra_bulk_buf = hg_proc_get_extra_buf(proc);
         hg_private_data->extra_bulk_buf_size = hg_proc_get_size_used(proc);
@@ -628,30 +918,44 @@ hg_free_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
 {
     hg_proc_t proc = HG_PROC_NULL;
     hg_proc_cb_t proc_cb = NULL;
+    hg_proc_plan_t plan = NULL;
     hg_return_t ret = HG_SUCCESS;
 
     switch (op) {
         case HG_INPUT:
             /* Set input proc */
-            proc = hg_private_data->in_proc;
             proc_cb = hg_proc_info->in_proc_cb;
+            plan = hg_proc_info->in_plan;
             break;
         case HG_OUTPUT:
             /* Set output proc */
-            proc = hg_private_data->out_proc;
             proc_cb = hg_proc_info->out_proc_cb;
+            plan = hg_proc_info->out_plan;
             break;
         default:
             HG_LOG_ERROR("Invalid HG op");
             ret = HG_INVALID_PARAM;
             goto done;
     }
-    if (!proc_cb) {
+    if (!proc_cb && !plan) {
         HG_LOG_ERROR("No proc set, proc must be set in HG_Register()");
         ret = HG_PROTOCOL_ERROR;
         goto done;
     }
 
+    /* Get proc */
+    ret = hg_private_data_get_proc(hg_private_data, op, &proc);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not get proc");
+        goto done;
+    }
+
+#ifdef HG_HAS_EAGER_BULK
+    /* Input handles may outlive the RPC handle if user holds a reference */
+    if (op == HG_INPUT)
+        hg_reset_eager_push_input(hg_private_data);
+#endif
+
     /* Reset proc */
     ret = hg_proc_reset(proc, NULL, 0, HG_FREE);
     if (ret != HG_SUCCESS) {
@@ -660,7 +964,7 @@ hg_free_struct(hg_handle_t handle, struct hg_private_data *hg_private_data,
     }
 
     /* Free memory allocated during decode operation */
-    ret = proc_cb(proc, struct_ptr);
+    ret = hg_proc_struct(proc, proc_cb, plan, struct_ptr);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not free allocated parameters");
         goto done;
@@ -682,13 +986,12 @@ static hg_return_t
 hg_get_extra_input(hg_handle_t handle, struct hg_private_data *hg_private_data,
     hg_return_t (*done_cb)(hg_handle_t handle))
 {
-    hg_proc_t proc = hg_private_data->in_proc;
+    hg_proc_t proc = HG_PROC_NULL;
     void *in_buf;
     hg_size_t in_buf_size;
     hg_size_t header_offset = hg_header_get_size(HG_INPUT);
     const struct hg_info *hg_info = HG_Core_get_info(handle);
-    hg_size_t page_size = (hg_size_t) hg_mem_get_page_size();
-    hg_bulk_t local_in_handle = HG_BULK_NULL;
+    hg_size_t extra_bulk_buf_size;
     hg_return_t ret = HG_SUCCESS;
 
     /* Get core input buffer */
@@ -702,6 +1005,13 @@ hg_get_extra_input(hg_handle_t handle, struct hg_private_data *hg_private_data,
     in_buf = (char *) in_buf + header_offset;
     in_buf_size -= header_offset;
 
+    /* Get proc */
+    ret = hg_private_data_get_proc(hg_private_data, HG_INPUT, &proc);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not get proc");
+        goto done;
+    }
+
     ret = hg_proc_reset(proc, in_buf, in_buf_size, HG_DECODE);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not reset proc");
@@ -721,31 +1031,26 @@ hg_get_extra_input(hg_handle_t handle, struct hg_private_data *hg_private_data,
         goto done;
     }
 
-    /* Create a new local handle to read the data */
-    hg_private_data->extra_bulk_buf_size = HG_Bulk_get_size(
-        hg_private_data->extra_bulk_handle);
-    hg_private_data->extra_bulk_buf = hg_mem_aligned_alloc(page_size,
-        hg_private_data->extra_bulk_buf_size);
-    if (!hg_private_data->extra_bulk_buf) {
-        HG_LOG_ERROR("Could not allocate extra input buffer");
-        ret = HG_NOMEM_ERROR;
-        goto done;
-    }
-
-    ret = HG_Bulk_create(hg_info->hg_class, 1, &hg_private_data->extra_bulk_buf,
-        &hg_private_data->extra_bulk_buf_size, HG_BULK_READWRITE,
-        &local_in_handle);
+    /* Create a new local handle to read the data, its buffer is taken from
+     * the registered staging pool and kept until the input is freed */
+    extra_bulk_buf_size = HG_Bulk_get_size(hg_private_data->extra_bulk_handle);
+    ret = HG_Bulk_create(hg_info->hg_class, 1, NULL, &extra_bulk_buf_size,
+        HG_BULK_READWRITE, &hg_private_data->extra_bulk_staging);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not create HG bulk handle");
         goto done;
     }
+    HG_Bulk_access(hg_private_data->extra_bulk_staging, 0,
+        extra_bulk_buf_size, HG_BULK_READWRITE, 1,
+        &hg_private_data->extra_bulk_buf, NULL, NULL);
+    hg_private_data->extra_bulk_buf_size = (size_t) extra_bulk_buf_size;
 
     /* Read bulk data here and wait for the data to be here  */
     hg_private_data->extra_bulk_transfer_cb = done_cb;
     ret = HG_Bulk_transfer_id(hg_info->context, hg_get_extra_input_cb, handle,
         HG_BULK_PULL, hg_info->addr, hg_info->context_id,
-        hg_private_data->extra_bulk_handle, 0, local_in_handle, 0,
-        hg_private_data->extra_bulk_buf_size,
+        hg_private_data->extra_bulk_handle, 0,
+        hg_private_data->extra_bulk_staging, 0, extra_bulk_buf_size,
         HG_OP_ID_IGNORE /* TODO not used for now */);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not transfer bulk data");
@@ -753,7 +1058,6 @@ hg_get_extra_input(hg_handle_t handle, struct hg_private_data *hg_private_data,
     }
 
 done:
-    HG_Bulk_free(local_in_handle);
     HG_Bulk_free(hg_private_data->extra_bulk_handle);
     hg_private_data->extra_bulk_handle = HG_BULK_NULL;
     return ret;
@@ -789,20 +1093,202 @@ done:
 static void
 hg_free_extra_input(struct hg_private_data *hg_private_data)
 {
-    /* Free extra bulk buf if there was any */
-    if (hg_private_data->extra_bulk_buf) {
-        hg_mem_aligned_free(hg_private_data->extra_bulk_buf);
+    /* Return extra bulk buf to staging pool if there was any */
+    if (hg_private_data->extra_bulk_staging != HG_BULK_NULL) {
+        HG_Bulk_free(hg_private_data->extra_bulk_staging);
+        hg_private_data->extra_bulk_staging = HG_BULK_NULL;
         hg_private_data->extra_bulk_buf = NULL;
         hg_private_data->extra_bulk_buf_size = 0;
     }
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_uint8_t
+hg_get_bulk_flags(hg_handle_t handle)
+{
+#ifdef HG_HAS_SM_ROUTING
+    const struct hg_info *hg_info = HG_Core_get_info(handle);
+
+    if (hg_info->addr != HG_ADDR_NULL
+        && HG_Core_addr_get_na_class(hg_info->addr)
+            == HG_Core_class_get_na_sm(hg_info->hg_class))
+        return HG_BULK_SERIALIZE_SM;
+#else
+    (void) handle;
+#endif
+
+    return HG_BULK_SERIALIZE_NA;
+}
+
+#ifdef HG_HAS_EAGER_BULK
+/*---------------------------------------------------------------------------*/
+static hg_uint32_t
+hg_get_eager_push_mask(hg_proc_t proc)
+{
+    hg_uint32_t i, count = hg_proc_get_bulk_count(proc), mask = 0;
+
+    for (i = 0; i < count; i++)
+        if (hg_bulk_eager_push_accept(hg_proc_get_bulk(proc, i)))
+            mask |= (1U << i);
+
+    return mask;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_set_eager_push_input(hg_handle_t handle,
+    struct hg_private_data *hg_private_data)
+{
+    struct hg_bulk_eager_push *eager_push = &hg_private_data->eager_push;
+    hg_uint32_t mask = hg_private_data->hg_header.msg.input.eager_push;
+    hg_proc_t proc = hg_private_data->in_proc;
+    hg_uint32_t i, count = (proc != HG_PROC_NULL) ?
+        hg_proc_get_bulk_count(proc) : 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_thread_spin_lock(&eager_push->lock);
+    eager_push->size = 0;
+    eager_push->active = HG_FALSE;
+    if (!mask)
+        goto unlock;
+
+    if (!eager_push->buf) {
+        const struct hg_info *hg_info = HG_Core_get_info(handle);
+
+        /* Leave at least half of the response to the output itself */
+        eager_push->max_size =
+            HG_Class_get_output_eager_size(hg_info->hg_class) / 2;
+        if (!eager_push->max_size)
+            goto unlock;
+        eager_push->buf = (char *) malloc(eager_push->max_size);
+        if (!eager_push->buf) {
+            HG_LOG_ERROR("Could not allocate eager push buffer");
+            ret = HG_NOMEM_ERROR;
+            goto unlock;
+        }
+    }
+    eager_push->active = HG_TRUE;
+
+unlock:
+    hg_thread_spin_unlock(&eager_push->lock);
+    if (!eager_push->active)
+        goto done;
+
+    /* Pushes to these handles can now be added to the response */
+    for (i = 0; i < count; i++)
+        if (mask & (1U << i))
+            hg_bulk_eager_push_set(hg_proc_get_bulk(proc, i), eager_push, i);
+    hg_private_data->eager_push_input = HG_TRUE;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_reset_eager_push_input(struct hg_private_data *hg_private_data)
+{
+    hg_proc_t proc = hg_private_data->in_proc;
+    hg_uint32_t i, count;
+
+    if (!hg_private_data->eager_push_input)
+        return;
+
+    /* Handles were tracked when input was decoded and are still alive, header
+     * mask may have been overwritten by the response */
+    count = hg_proc_get_bulk_count(proc);
+    for (i = 0; i < count; i++)
+        hg_bulk_eager_push_set(hg_proc_get_bulk(proc, i), NULL, 0);
+    hg_private_data->eager_push_input = HG_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_set_eager_push_output(struct hg_private_data *hg_private_data, void *buf,
+    hg_size_t buf_size, hg_size_t *header_offset)
+{
+    struct hg_bulk_eager_push *eager_push = &hg_private_data->eager_push;
+    hg_bool_t ret;
+
+    hg_thread_spin_lock(&eager_push->lock);
+    ret = eager_push->active;
+    if (eager_push->active && eager_push->size
+        && (*header_offset + eager_push->size <= buf_size)) {
+        memcpy((char *) buf + *header_offset, eager_push->buf,
+            eager_push->size);
+        hg_private_data->hg_header.msg.output.eager_push_size =
+            (hg_uint32_t) eager_push->size;
+        *header_offset += eager_push->size;
+    }
+    /* Later pushes must go through RMA */
+    eager_push->active = HG_FALSE;
+    eager_push->size = 0;
+    hg_thread_spin_unlock(&eager_push->lock);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_get_eager_push_output(hg_handle_t handle,
+    struct hg_private_data *hg_private_data)
+{
+    struct hg_header *hg_header = &hg_private_data->hg_header;
+    hg_bulk_t handles[HG_PROC_BULK_TRACK_MAX];
+    hg_size_t header_offset = hg_header_get_size(HG_OUTPUT);
+    hg_uint32_t i, count = (hg_private_data->in_proc != HG_PROC_NULL) ?
+        hg_proc_get_bulk_count(hg_private_data->in_proc) : 0;
+    hg_size_t buf_size, eager_push_size;
+    void *buf;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Get core output buffer */
+    ret = HG_Core_get_output(handle, &buf, &buf_size);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not get output buffer");
+        goto done;
+    }
+
+    /* Get header */
+    hg_header_reset(hg_header, HG_OUTPUT);
+    ret = hg_header_proc(HG_DECODE, buf, buf_size, hg_header);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not process header");
+        goto done;
+    }
+    eager_push_size = hg_header->msg.output.eager_push_size;
+    if (!eager_push_size)
+        goto done;
+    if (eager_push_size > buf_size - header_offset) {
+        HG_LOG_ERROR("Invalid eager push size");
+        ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    /* Copy data into the handles that were sent with the input */
+    for (i = 0; i < count; i++)
+        handles[i] = hg_proc_get_bulk(hg_private_data->in_proc, i);
+    ret = hg_bulk_eager_push_apply(handles, count,
+        hg_private_data->eager_push_mask, (char *) buf + header_offset,
+        eager_push_size);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not copy eager push data");
+        goto done;
+    }
+    hg_private_data->eager_push_recv_size = eager_push_size;
+
+done:
+    return ret;
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_forward_cb(const struct hg_cb_info *callback_info)
 {
     struct hg_private_data *hg_private_data =
             (struct hg_private_data *) callback_info->arg;
+    hg_return_t cb_ret = callback_info->ret;
     hg_return_t ret = HG_SUCCESS;
 
     /* Free eventual extra input buffer and handle */
@@ -814,12 +1300,22 @@ hg_forward_cb(const struct hg_cb_info *callback_info)
         hg_private_data->extra_bulk_buf_size = 0;
     }
 
+#ifdef HG_HAS_EAGER_BULK
+    /* Data pushed by the target must be in place before the callback */
+    if (cb_ret == HG_SUCCESS && hg_private_data->eager_push_mask) {
+        cb_ret = hg_get_eager_push_output(callback_info->info.forward.handle,
+            hg_private_data);
+        if (cb_ret != HG_SUCCESS)
+            HG_LOG_ERROR("Could not get eager push data");
+    }
+#endif
+
     /* Execute callback */
     if (hg_private_data->forward_cb) {
         struct hg_cb_info hg_cb_info;
 
         hg_cb_info.arg = hg_private_data->forward_arg;
-        hg_cb_info.ret = callback_info->ret;
+        hg_cb_info.ret = cb_ret;
         hg_cb_info.type = callback_info->type;
         hg_cb_info.info = callback_info->info;
 
@@ -1171,6 +1667,8 @@ HG_Register(hg_class_t *hg_class, hg_id_t id, hg_proc_cb_t in_proc_cb,
         memset(hg_proc_info, 0, sizeof(struct hg_proc_info));
         hg_proc_info->in_proc_cb = in_proc_cb;
         hg_proc_info->out_proc_cb = out_proc_cb;
+        /* CRC32 is enough for small size buffers */
+        hg_proc_info->hash = HG_CRC32;
 
         /* Attach proc info to RPC ID */
         ret = HG_Core_register_data(hg_class, id, hg_proc_info,
@@ -1189,6 +1687,10 @@ HG_Register(hg_class_t *hg_class, hg_id_t id, hg_proc_cb_t in_proc_cb,
         }
         hg_proc_info->in_proc_cb = in_proc_cb;
         hg_proc_info->out_proc_cb = out_proc_cb;
+        hg_proc_plan_free(hg_proc_info->in_plan);
+        hg_proc_info->in_plan = NULL;
+        hg_proc_plan_free(hg_proc_info->out_plan);
+        hg_proc_info->out_plan = NULL;
     }
 
 done:
@@ -1198,6 +1700,57 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Register_plan(hg_class_t *hg_class, hg_id_t id,
+    const struct hg_field *in_fields, const struct hg_field *out_fields,
+    hg_rpc_cb_t rpc_cb)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_proc_plan_t in_plan = NULL, out_plan = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Compile plans first so that nothing is registered on error */
+    if (in_fields) {
+        ret = hg_proc_plan_create(in_fields, &in_plan);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not create input plan");
+            goto done;
+        }
+    }
+    if (out_fields) {
+        ret = hg_proc_plan_create(out_fields, &out_plan);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not create output plan");
+            goto done;
+        }
+    }
+
+    ret = HG_Register(hg_class, id, NULL, NULL, rpc_cb);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not register RPC id");
+        goto done;
+    }
+
+    /* Retrieve proc info from function map */
+    hg_proc_info =
+        (struct hg_proc_info *) HG_Core_registered_data(hg_class, id);
+    if (!hg_proc_info) {
+        HG_LOG_ERROR("Could not get registered data");
+        ret = HG_NO_MATCH;
+        goto done;
+    }
+    hg_proc_info->in_plan = in_plan;
+    hg_proc_info->out_plan = out_plan;
+    in_plan = NULL;
+    out_plan = NULL;
+
+done:
+    hg_proc_plan_free(in_plan);
+    hg_proc_plan_free(out_plan);
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Registered(hg_class_t *hg_class, hg_id_t id, hg_bool_t *flag)
@@ -1273,6 +1826,81 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_set_checksum(hg_class_t *hg_class, hg_id_t id,
+    hg_proc_hash_t hash)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (hash != HG_CRC16 && hash != HG_CRC32 && hash != HG_NOHASH) {
+        HG_LOG_ERROR("Hash method does not fit in header");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    /* Retrieve proc function from function map */
+    hg_proc_info =
+        (struct hg_proc_info *) HG_Core_registered_data(hg_class, id);
+    if (!hg_proc_info) {
+        HG_LOG_ERROR("Could not get registered data");
+        ret = HG_NO_MATCH;
+        goto done;
+    }
+
+    hg_proc_info->hash = hash;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_set_array_borrow(hg_class_t *hg_class, hg_id_t id,
+    hg_bool_t borrow)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Retrieve proc function from function map */
+    hg_proc_info =
+        (struct hg_proc_info *) HG_Core_registered_data(hg_class, id);
+    if (!hg_proc_info) {
+        HG_LOG_ERROR("Could not get registered data");
+        ret = HG_NO_MATCH;
+        goto done;
+    }
+
+    hg_proc_info->array_borrow = borrow;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_set_proc_sizing(hg_class_t *hg_class, hg_id_t id,
+    hg_bool_t sizing)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Retrieve proc function from function map */
+    hg_proc_info =
+        (struct hg_proc_info *) HG_Core_registered_data(hg_class, id);
+    if (!hg_proc_info) {
+        HG_LOG_ERROR("Could not get registered data");
+        ret = HG_NO_MATCH;
+        goto done;
+    }
+
+    hg_proc_info->proc_sizing = sizing;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Addr_lookup(hg_context_t *context, hg_cb_t callback, void *arg,
@@ -1607,6 +2235,11 @@ HG_Get_output_buf(hg_handle_t handle, void **out_buf, hg_size_t *out_buf_size)
         void *buf;
         hg_size_t buf_size, header_offset = hg_header_get_size(HG_OUTPUT);
 
+#ifdef HG_HAS_EAGER_BULK
+        /* Skip eager push data sent with the response */
+        header_offset += hg_private_data->eager_push_recv_size;
+#endif
+
         /* Get core output buffer */
         ret = HG_Core_get_output(handle, &buf, &buf_size);
         if (ret != HG_SUCCESS) {
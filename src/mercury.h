@@ -359,6 +359,32 @@ HG_Register(
         hg_rpc_cb_t rpc_cb
         );
 
+/**
+ * Same as HG_Register() but input and output are described by field tables
+ * (see mercury_proc_plan.h), which are compiled into serialization plans.
+ * Plans process runs of fixed-width fields at once and give the exact size
+ * of the payload before it is encoded, fields processed by proc callbacks
+ * are only sized if enabled with HG_Registered_set_proc_sizing(). Tables
+ * are not referenced once registered. NULL tables mean no input or no
+ * output.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               ID to use to register RPC
+ * \param in_fields [IN]        input field table
+ * \param out_fields [IN]       output field table
+ * \param rpc_cb [IN]           RPC callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Register_plan(
+        hg_class_t *hg_class,
+        hg_id_t id,
+        const struct hg_field *in_fields,
+        const struct hg_field *out_fields,
+        hg_rpc_cb_t rpc_cb
+        );
+
 /**
  * Indicate whether HG_Register() has been called.
  *
@@ -431,6 +457,69 @@ HG_Registered_disable_response(
         hg_bool_t disable
         );
 
+/**
+ * Set hash method used for the checksum of the input and output payload of a
+ * given RPC ID. The checksum is computed over the encoded payload once it has
+ * been encoded or decoded, HG_NOHASH disables it. Origin and target must use
+ * the same method. By default, HG_CRC32 (CRC32C) is used. Checksums are only
+ * computed if mercury was built with checksums enabled.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param hash [IN]             hash method: HG_CRC16, HG_CRC32, HG_NOHASH
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Registered_set_checksum(
+        hg_class_t *hg_class,
+        hg_id_t id,
+        hg_proc_hash_t hash
+        );
+
+/**
+ * Let array procs (see mercury_proc_array.h) and small string procs (see
+ * mercury_proc_string.h) point decoded input and output arrays and strings of
+ * a given RPC ID into the received buffer instead of copying them. They are
+ * then only valid until the input or output is freed and must not be used
+ * once the handle is forwarded again. By default, arrays are copied.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param borrow [IN]           boolean
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Registered_set_array_borrow(
+        hg_class_t *hg_class,
+        hg_id_t id,
+        hg_bool_t borrow
+        );
+
+/**
+ * Indicate that the input and output proc callbacks of a given RPC ID handle
+ * the HG_SIZE operation (see hg_proc_reset()). Once a payload of that RPC has
+ * not fit into the default buffer, the next ones are then sized first so that
+ * the extra buffer is allocated once. By default, proc callbacks are only run
+ * to encode, decode and free, and the extra buffer is grown while encoding.
+ * RPCs registered with HG_Register_plan() are always sized when none of their
+ * fields are processed by proc callbacks.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param sizing [IN]           boolean
+ *
+ * 
+eturn HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Registered_set_proc_sizing(
+        hg_class_t *hg_class,
+        hg_id_t id,
+        hg_bool_t sizing
+        );
+
 /**
  * Lookup an addr from a peer address/name. Addresses need to be
  * freed by calling HG_Addr_free(). After completion, user callback is
@@ -16,9 +16,16 @@
 #include "na_private.h"
 
 #include "mercury_atomic.h"
+#include "mercury_thread_spin.h"
+#include "mercury_thread_mutex.h"
+#include "mercury_thread_pool.h"
+#include "mercury_mem.h"
 
 #include <stdlib.h>
 #include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 /****************/
 /* Local Macros */
@@ -26,6 +33,51 @@
 #define HG_BULK_MIN(a, b) \
     (a < b) ? a : b
 
+/* Version of the serialized bulk descriptor format */
+#define HG_BULK_DESC_VERSION 1
+
+/* Serialized bulk descriptor flags */
+#define HG_BULK_DESC_EAGER  (1 << 0) /* Segment data follows descriptor */
+#define HG_BULK_DESC_SM     (1 << 1) /* SM memory handles are present */
+#define HG_BULK_DESC_VIEW   (1 << 2) /* Offset in first NA handle is present */
+
+/* Number of segments/memory handles kept inline in the bulk handle */
+#define HG_BULK_STATIC_MAX 8
+
+/* Max number of free bulk handles kept in the pool */
+#define HG_BULK_POOL_MAX 64
+
+/* Min number of segments for offsets to be translated with an index */
+#define HG_BULK_OFFSET_INDEX_MIN 32
+
+/* Size of smallest staging buffers, each class is 4 times larger */
+#define HG_BULK_STAGING_MIN_SIZE 4096
+
+/* Max number of free staging buffers kept per size class */
+#define HG_BULK_STAGING_POOL_MAX 16
+
+/* Max total size of free staging buffers that remain registered */
+#define HG_BULK_STAGING_POOL_MAX_SIZE (8 << 20)
+
+/* Number of NA operation IDs kept inline in the bulk op ID */
+#define HG_BULK_OP_STATIC_MAX 4
+
+/* Max number of free bulk op IDs kept in a context pool */
+#define HG_BULK_OP_POOL_MAX 256
+
+/* Number of copy workers used for large self copies */
+#define HG_BULK_COPY_THREADS 4
+
+/* Min size copied by each copy worker, smaller copies are done in place */
+#define HG_BULK_COPY_PART_MIN (512 * 1024)
+
+/* Min size of copies that bypass the cache with non-temporal stores */
+#define HG_BULK_COPY_NT_MIN (8 * 1024 * 1024)
+
+/* Size of eager push record header (index, offset, size) */
+#define HG_BULK_EAGER_PUSH_HEADER_SIZE \
+    (sizeof(hg_uint32_t) + 2 * sizeof(hg_uint64_t))
+
 /* Remove warnings when plugin does not use callback arguments */
 #if defined(__cplusplus)
     #define HG_BULK_UNUSED
@@ -49,14 +101,62 @@ struct hg_bulk_op_id {
     void *arg;                            /* Callback arguments */
     hg_atomic_int32_t completed;          /* Operation completed TODO needed ? */
     hg_atomic_int32_t canceled;           /* Operation canceled */
-    unsigned int op_count;                /* Number of ongoing operations */
-    hg_atomic_int32_t op_completed_count; /* Number of operations completed */
+    unsigned int op_count;                /* Number of NA operations issued */
+    hg_atomic_int32_t op_pending_count;   /* Operations not completed yet */
     hg_bulk_op_t op;                      /* Operation type */
+    hg_size_t size;                       /* Size of data transferred */
+    struct hg_bulk_stream *stream;        /* Stream (stream op ID only) */
     struct hg_bulk *hg_bulk_origin;       /* Origin handle */
     struct hg_bulk *hg_bulk_local;        /* Local handle */
+    struct hg_bulk_range *batch;          /* Ranges (batch op ID only) */
+    hg_uint32_t batch_count;              /* Number of ranges */
     na_op_id_t *na_op_ids ;               /* NA operations IDs */
     hg_bool_t is_self;                    /* Is self operation */
+    hg_bool_t eager_mode;                 /* Pulled from eager data only */
     struct hg_completion_entry hg_completion_entry; /* Entry in completion queue */
+    na_op_id_t na_op_id_static[HG_BULK_OP_STATIC_MAX]; /* Inline NA op IDs */
+    struct hg_bulk_op_pool *pool;         /* Pool op ID is returned to */
+    HG_QUEUE_ENTRY(hg_bulk_op_id) entry;  /* Entry in op ID pool */
+};
+
+/* Pool of free bulk op IDs (per context) */
+struct hg_bulk_op_pool {
+    HG_QUEUE_HEAD(hg_bulk_op_id) free_list; /* Free op IDs */
+    unsigned int count;                   /* Number of free op IDs */
+    hg_thread_spin_t lock;                /* Pool lock */
+};
+
+/* Chunk of a streamed transfer */
+struct hg_bulk_stream_chunk {
+    struct hg_bulk_stream *stream;        /* Stream chunk belongs to */
+    hg_size_t index;                      /* Index of chunk in stream */
+    hg_op_id_t op_id;                     /* Op ID of chunk transfer */
+    hg_bool_t completed;                  /* Chunk transfer completed */
+};
+
+/* Streamed transfer, chunks are issued within a window of slots */
+struct hg_bulk_stream {
+    struct hg_bulk_op_id *hg_bulk_op_id;  /* Op ID of stream */
+    hg_cb_t chunk_callback;               /* Chunk callback */
+    struct hg_addr *origin_addr;          /* Origin address (duplicated) */
+    hg_uint8_t origin_id;                 /* Context ID of origin */
+    hg_size_t origin_offset;              /* Origin offset of stream */
+    hg_size_t local_offset;               /* Local offset of stream */
+    hg_size_t chunk_size;                 /* Size of chunks */
+    hg_size_t chunk_count;                /* Number of chunks */
+    hg_size_t next_issue;                 /* Index of next chunk to issue */
+    hg_size_t delivered;                  /* Number of chunks delivered */
+    unsigned int window;                  /* Number of chunk slots */
+    unsigned int in_flight;               /* Chunk transfers not completed */
+    unsigned int delivering;              /* Chunk callbacks being executed */
+    unsigned int free_count;              /* Number of free slots */
+    unsigned int *free_slots;             /* Free slots (unordered) */
+    struct hg_bulk_stream_chunk *chunks;  /* Chunk slots */
+    hg_bool_t ordered;                    /* Deliver chunks in order */
+    hg_bool_t canceled;                   /* Stop issuing chunks */
+    hg_bool_t finished;                   /* Stream completion added */
+    hg_return_t ret;                      /* First error */
+    hg_thread_mutex_t mutex;              /* Stream mutex */
 };
 
 /* Segment used to transfer data and map to NA layer */
@@ -89,22 +189,154 @@ struct hg_bulk {
     hg_size_t total_size;                /* Total size of data abstracted */
     hg_uint32_t segment_count;           /* Number of segments */
     struct hg_bulk_segment *segments;    /* Array of segments */
+    hg_size_t *segment_ends;             /* Prefix sums of segment sizes */
+    hg_atomic_int32_t segment_ends_ready; /* Prefix sums are built */
     na_mem_handle_t *na_mem_handles;     /* Array of NA memory handles */
 #ifdef HG_HAS_SM_ROUTING
     na_mem_handle_t *na_sm_mem_handles;  /* Array of NA SM memory handles */
 #endif
     hg_uint32_t na_mem_handle_count;     /* Number of handles */
-    hg_bool_t segment_published;         /* NA memory handles published */
+    hg_uint8_t na_registered;            /* NA classes registered with */
+    hg_uint8_t na_published;             /* NA classes published with */
+    hg_thread_spin_t register_lock;      /* Lock for lazy registration */
     hg_bool_t segment_alloc;             /* Allocated memory to mirror data */
     hg_uint8_t flags;                    /* Permission flags */
     hg_bool_t eager_mode;                /* Eager transfer */
+    hg_bool_t remote;                    /* Deserialized from remote */
     hg_atomic_int32_t ref_count;         /* Reference count */
+    void *eager_buf;                     /* Received eager data */
+    struct hg_bulk_eager_push *eager_push; /* Response pushed data is added to */
+    struct hg_bulk_staging *staging;     /* Staging class of buffer */
+    hg_uint32_t eager_push_index;        /* Index of handle in RPC input */
+    struct hg_bulk *parent;              /* Handle viewed (views only) */
+    hg_size_t view_offset;               /* Offset of view in parent */
+    hg_size_t na_mem_handle_offset;      /* Offset of data in first NA handle */
+    struct hg_bulk_segment segment_static[HG_BULK_STATIC_MAX];
+    na_mem_handle_t na_mem_handle_static[HG_BULK_STATIC_MAX];
+#ifdef HG_HAS_SM_ROUTING
+    na_mem_handle_t na_sm_mem_handle_static[HG_BULK_STATIC_MAX];
+#endif
+    HG_QUEUE_ENTRY(hg_bulk) entry;       /* Entry in bulk pool */
+};
+
+/* Range transferred between two handles, set up before being issued */
+struct hg_bulk_range {
+    struct hg_bulk *hg_bulk_origin;      /* Origin handle */
+    hg_size_t origin_offset;             /* Origin offset */
+    struct hg_bulk *hg_bulk_local;       /* Local handle */
+    hg_size_t local_offset;              /* Local offset */
+    hg_size_t size;                      /* Size of range */
+    na_bulk_op_t na_bulk_op;             /* NA operation */
+    unsigned int na_op_count;            /* Max number of NA operations */
+    hg_bool_t scatter_gather;            /* Use scatter/gather */
+    hg_bool_t eager_push;                /* Pushed with RPC response */
+};
+
+/* Range of segments and NA memory handles covered by a handle */
+struct hg_bulk_window {
+    struct hg_bulk *hg_bulk;             /* Handle owning segments */
+    hg_uint32_t segment_start;           /* First segment */
+    hg_uint32_t segment_count;           /* Number of segments */
+    hg_size_t start_offset;              /* Offset in first segment */
+    hg_size_t end_offset;                /* End offset in last segment */
+    hg_uint32_t na_mem_handle_start;     /* First NA memory handle */
+    hg_uint32_t na_mem_handle_count;     /* Number of NA memory handles */
+    hg_size_t na_mem_handle_offset;      /* Offset of data in first handle */
+};
+
+/* Size class of registered staging buffers */
+struct hg_bulk_staging {
+    /* Free staging handles, per permission as they are registered with it */
+    HG_QUEUE_HEAD(hg_bulk) free_list[HG_BULK_READWRITE];
+    hg_size_t buf_size;                  /* Size of buffers */
+    unsigned int free_count;             /* Number of free handles */
+    unsigned int used_count;             /* Number of handles in use */
+    hg_uint64_t hit_count;               /* Number of reused handles */
+    hg_uint64_t miss_count;              /* Number of new handles */
+};
+
+/* Pool of free bulk handles */
+struct hg_bulk_pool {
+    HG_QUEUE_HEAD(hg_bulk) free_list;    /* Free bulk handles */
+    unsigned int count;                  /* Number of free handles */
+    struct hg_bulk_staging staging[HG_BULK_STAGING_CLASS_COUNT];
+    hg_size_t staging_free_size;         /* Size of free staging buffers */
+#ifdef HG_HAS_SELF_FORWARD
+    hg_thread_pool_t *copy_pool;         /* Copy workers (created on use) */
+#endif
+    hg_thread_spin_t lock;               /* Pool lock */
+};
+
+#ifdef HG_HAS_SELF_FORWARD
+/* Part of a copy done by a copy worker */
+struct hg_bulk_copy_part {
+    struct hg_thread_work thread_work;   /* Work posted to copy pool */
+    struct hg_bulk_copy *copy;           /* Copy part belongs to */
+    char *dest;                          /* Destination of part */
+    const char *src;                     /* Source of part */
+    hg_size_t size;                      /* Size of part */
+};
+
+/* Copy split across copy workers, callback is called by the last part */
+struct hg_bulk_copy {
+    na_cb_t callback;                    /* NA callback */
+    void *arg;                           /* NA callback arguments */
+    hg_atomic_int32_t pending_count;     /* Parts not completed yet */
+    hg_bool_t non_temporal;              /* Use non-temporal stores */
+    struct hg_bulk_copy_part parts[HG_BULK_COPY_THREADS];
 };
+#endif
 
 /********************/
 /* Local Prototypes */
 /********************/
 
+/**
+ * Get handle from pool and set up segment/memory handle arrays.
+ */
+static struct hg_bulk *
+hg_bulk_alloc(
+        struct hg_class *hg_class,
+        hg_uint32_t segment_count,
+        hg_uint32_t na_mem_handle_count,
+        hg_bool_t use_sm
+        );
+
+/**
+ * Return handle to pool.
+ */
+static void
+hg_bulk_release(
+        struct hg_bulk *hg_bulk
+        );
+
+/**
+ * Get single segment handle backed by a registered staging buffer.
+ */
+static struct hg_bulk *
+hg_bulk_staging_get(
+        struct hg_class *hg_class,
+        hg_size_t size,
+        hg_uint8_t flags,
+        hg_bool_t use_sm
+        );
+
+/**
+ * Return handle to its staging class, HG_FALSE if the class is full.
+ */
+static hg_bool_t
+hg_bulk_staging_put(
+        struct hg_bulk *hg_bulk
+        );
+
+/**
+ * Deregister and free NA memory handles.
+ */
+static void
+hg_bulk_deregister(
+        struct hg_bulk *hg_bulk
+        );
+
 /**
  * Create handle.
  */
@@ -126,6 +358,45 @@ hg_bulk_free(
         struct hg_bulk *hg_bulk
         );
 
+/**
+ * Create and register NA memory handles of NA class (HG_BULK_SERIALIZE_NA
+ * or HG_BULK_SERIALIZE_SM) if not done yet, and publish them if requested.
+ */
+static hg_return_t
+hg_bulk_register(
+        struct hg_bulk *hg_bulk,
+        hg_uint8_t na_flag,
+        hg_bool_t publish
+        );
+
+/**
+ * Get segments and NA memory handles covered by handle or view.
+ */
+static void
+hg_bulk_window_get(
+        struct hg_bulk *hg_bulk,
+        struct hg_bulk_window *hg_bulk_window
+        );
+
+/**
+ * Get segment i of window, clipped to the window.
+ */
+static HG_INLINE void
+hg_bulk_window_segment(
+        const struct hg_bulk_window *hg_bulk_window,
+        hg_uint32_t i,
+        struct hg_bulk_segment *segment
+        );
+
+/**
+ * Get prefix sums of segment sizes, built on first use. Return NULL if they
+ * could not be built.
+ */
+static const hg_size_t *
+hg_bulk_offset_index_get(
+        struct hg_bulk *hg_bulk
+        );
+
 /**
  * Get info for bulk transfer.
  */
@@ -152,6 +423,47 @@ hg_bulk_access(
         hg_uint32_t *actual_count
         );
 
+/**
+ * Copy data between a contiguous buffer and bulk handle segments.
+ */
+static void
+hg_bulk_memcpy_segments(
+        struct hg_bulk *hg_bulk,
+        hg_size_t offset,
+        void *buf,
+        hg_size_t size,
+        hg_bool_t to_bulk
+        );
+
+/**
+ * Append pushed data to the RPC response if it fits.
+ */
+static hg_bool_t
+hg_bulk_eager_push_add(
+        struct hg_bulk *hg_bulk_origin,
+        hg_size_t origin_offset,
+        struct hg_bulk *hg_bulk_local,
+        hg_size_t local_offset,
+        hg_size_t size
+        );
+
+/**
+ * Get op ID from context pool and set up NA op ID array.
+ */
+static struct hg_bulk_op_id *
+hg_bulk_op_id_alloc(
+        hg_context_t *context,
+        unsigned int na_op_count
+        );
+
+/**
+ * Return op ID to its pool.
+ */
+static void
+hg_bulk_op_id_release(
+        struct hg_bulk_op_id *hg_bulk_op_id
+        );
+
 /**
  * Transfer callback.
  */
@@ -177,8 +489,53 @@ hg_bulk_transfer_pieces(
         hg_size_t local_segment_start_offset,
         hg_size_t size,
         hg_bool_t scatter_gather,
+        struct hg_bulk_op_id *hg_bulk_op_id
+        );
+
+/**
+ * Resolve views, select NA operation and register memory for range.
+ */
+static hg_return_t
+hg_bulk_range_prepare(
+        hg_bulk_op_t op,
+        hg_bool_t is_self,
+        hg_bool_t use_sm,
+        hg_bool_t scatter_gather,
+        struct hg_bulk_range *hg_bulk_range
+        );
+
+/**
+ * Issue NA operations of range.
+ */
+static hg_return_t
+hg_bulk_range_issue(
         struct hg_bulk_op_id *hg_bulk_op_id,
-        unsigned int *na_op_count
+        na_addr_t na_origin_addr,
+        hg_uint8_t origin_id,
+        hg_bool_t use_sm,
+        const struct hg_bulk_range *hg_bulk_range
+        );
+
+/**
+ * Get op ID for transfer.
+ */
+static struct hg_bulk_op_id *
+hg_bulk_transfer_op_id_alloc(
+        hg_context_t *context,
+        hg_cb_t callback,
+        void *arg,
+        hg_bulk_op_t op,
+        struct hg_class *hg_class,
+        hg_bool_t use_sm,
+        unsigned int na_op_count
+        );
+
+/**
+ * Release pending count held while issuing operations.
+ */
+static hg_return_t
+hg_bulk_transfer_issued(
+        struct hg_bulk_op_id *hg_bulk_op_id
         );
 
 /**
@@ -201,111 +558,310 @@ hg_bulk_transfer(
         );
 
 /**
- * Complete operation ID.
+ * Transfer ranges with a single op ID.
  */
 static hg_return_t
-hg_bulk_complete(
-        struct hg_bulk_op_id *hg_bulk_op_id
+hg_bulk_transfer_batch(
+        hg_context_t *context,
+        hg_cb_t callback,
+        void *arg,
+        hg_bulk_op_t op,
+        struct hg_addr *origin_addr,
+        hg_uint8_t origin_id,
+        const struct hg_bulk_transfer_desc *descs,
+        hg_uint32_t count,
+        hg_op_id_t *op_id
         );
 
 /**
- * Add entry to completion queue.
+ * Release handles of batch op ID.
  */
-extern hg_return_t
-hg_core_completion_add(
-        struct hg_context *context,
-        struct hg_completion_entry *hg_completion_entry,
-        hg_bool_t self_notify
+static void
+hg_bulk_batch_free(
+        struct hg_bulk_op_id *hg_bulk_op_id
         );
 
 /**
- * Trigger callback from bulk op ID.
+ * Copy data, bypassing the cache if non_temporal is set.
  */
-hg_return_t
-hg_bulk_trigger_entry(
-        struct hg_bulk_op_id *hg_bulk_op_id
+static void
+hg_bulk_copy_data(
+        void *dest,
+        const void *src,
+        hg_size_t size,
+        hg_bool_t non_temporal
         );
 
+#ifdef HG_HAS_SELF_FORWARD
 /**
- * NA_Put wrapper
+ * Copy worker.
  */
-static HG_INLINE na_return_t
-hg_bulk_na_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
-    void *arg, na_mem_handle_t local_mem_handle,
-    na_ptr_t HG_BULK_UNUSED local_address, na_offset_t local_offset,
-    na_mem_handle_t remote_mem_handle, na_ptr_t HG_BULK_UNUSED remote_address,
-    na_offset_t remote_offset, na_size_t data_size, na_addr_t remote_addr,
-    na_uint8_t remote_id, na_op_id_t *op_id)
-{
-    return NA_Put(na_class, context, callback, arg, local_mem_handle,
-            local_offset, remote_mem_handle, remote_offset, data_size,
-            remote_addr, remote_id, op_id);
-}
+static HG_THREAD_RETURN_TYPE
+hg_bulk_copy_thread(
+        void *arg
+        );
+#endif
 
 /**
- * NA_Get wrapper
+ * Copy data of self/eager transfers and call NA callback. Large copies are
+ * split across copy workers and the callback is called by the last one,
+ * completion then wakes up progress through self notification.
  */
-static HG_INLINE na_return_t
-hg_bulk_na_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
-    void *arg, na_mem_handle_t local_mem_handle,
-    na_ptr_t HG_BULK_UNUSED local_address, na_offset_t local_offset,
-    na_mem_handle_t remote_mem_handle, na_ptr_t HG_BULK_UNUSED remote_address,
-    na_offset_t remote_offset, na_size_t data_size, na_addr_t remote_addr,
-    na_uint8_t remote_id, na_op_id_t *op_id)
-{
-    return NA_Get(na_class, context, callback, arg, local_mem_handle,
-            local_offset, remote_mem_handle, remote_offset, data_size,
-            remote_addr, remote_id, op_id);
-}
+static void
+hg_bulk_memcpy(
+        void *dest,
+        const void *src,
+        hg_size_t size,
+        na_cb_t callback,
+        void *arg
+        );
 
 /**
- * Memcpy
+ * Complete operation ID.
  */
-static HG_INLINE na_return_t
-hg_bulk_memcpy_put(na_class_t HG_BULK_UNUSED *na_class,
-    na_context_t HG_BULK_UNUSED *context, na_cb_t callback, void *arg,
-    na_mem_handle_t HG_BULK_UNUSED local_mem_handle, na_ptr_t local_address,
-    na_offset_t local_offset, na_mem_handle_t HG_BULK_UNUSED remote_mem_handle,
-    na_ptr_t remote_address, na_offset_t remote_offset, na_size_t data_size,
-    na_addr_t HG_BULK_UNUSED remote_addr, na_uint8_t HG_BULK_UNUSED remote_id,
-    na_op_id_t HG_BULK_UNUSED *op_id)
-{
-    struct na_cb_info na_cb_info;
+static hg_return_t
+hg_bulk_complete(
+        struct hg_bulk_op_id *hg_bulk_op_id
+        );
 
-    na_cb_info.arg = arg;
-    na_cb_info.ret = NA_SUCCESS;
-    memcpy((void *) (remote_address + remote_offset),
-            (const void *) (local_address + local_offset), data_size);
-    callback(&na_cb_info);
-    return NA_SUCCESS;
-}
+/**
+ * Check handles and permissions before transfer.
+ */
+static hg_return_t
+hg_bulk_transfer_check(
+        hg_bulk_op_t op,
+        struct hg_bulk *hg_bulk_origin,
+        struct hg_bulk *hg_bulk_local,
+        hg_size_t size
+        );
 
 /**
- * Memcpy
+ * Issue chunks of stream until window is full (stream mutex must be held).
  */
-static HG_INLINE na_return_t
-hg_bulk_memcpy_get(na_class_t HG_BULK_UNUSED *na_class,
-    na_context_t HG_BULK_UNUSED *context, na_cb_t callback, void *arg,
-    na_mem_handle_t HG_BULK_UNUSED local_mem_handle, na_ptr_t local_address,
-    na_offset_t local_offset, na_mem_handle_t HG_BULK_UNUSED remote_mem_handle,
-    na_ptr_t remote_address, na_offset_t remote_offset, na_size_t data_size,
-    na_addr_t HG_BULK_UNUSED remote_addr, na_uint8_t HG_BULK_UNUSED remote_id,
-    na_op_id_t HG_BULK_UNUSED *op_id)
-{
-    struct na_cb_info na_cb_info;
+static hg_return_t
+hg_bulk_stream_issue(
+        struct hg_bulk_stream *hg_bulk_stream
+        );
 
-    na_cb_info.arg = arg;
-    na_cb_info.ret = NA_SUCCESS;
-    memcpy((void *) (local_address + local_offset),
-            (const void *) (remote_address + remote_offset), data_size);
-    callback(&na_cb_info);
-    return NA_SUCCESS;
-}
+/**
+ * Execute chunk callback.
+ */
+static void
+hg_bulk_stream_deliver(
+        struct hg_bulk_stream *hg_bulk_stream,
+        struct hg_bulk_stream_chunk *hg_bulk_stream_chunk
+        );
 
 /**
- * Serialize memcpy
+ * Chunk transfer callback.
  */
-static HG_INLINE hg_return_t
+static hg_return_t
+hg_bulk_stream_chunk_cb(
+        const struct hg_cb_info *callback_info
+        );
+
+/**
+ * Cancel chunks in flight (stream mutex must be held).
+ */
+static void
+hg_bulk_stream_cancel_chunks(
+        struct hg_bulk_stream *hg_bulk_stream
+        );
+
+/**
+ * Check whether all chunks are done (stream mutex must be held). Return
+ * HG_TRUE only once, stream op ID must then be completed.
+ */
+static hg_bool_t
+hg_bulk_stream_check_finish(
+        struct hg_bulk_stream *hg_bulk_stream
+        );
+
+/**
+ * Cancel stream.
+ */
+static hg_return_t
+hg_bulk_stream_cancel(
+        struct hg_bulk_stream *hg_bulk_stream
+        );
+
+/**
+ * Free stream.
+ */
+static void
+hg_bulk_stream_free(
+        struct hg_bulk_stream *hg_bulk_stream
+        );
+
+/**
+ * Get bulk handle pool from class.
+ */
+extern struct hg_bulk_pool *
+hg_core_class_get_bulk_pool(
+        const struct hg_class *hg_class
+        );
+
+/**
+ * Create bulk handle pool.
+ */
+struct hg_bulk_pool *
+hg_bulk_pool_create(
+        void
+        );
+
+/**
+ * Destroy bulk handle pool.
+ */
+void
+hg_bulk_pool_destroy(
+        struct hg_bulk_pool *hg_bulk_pool
+        );
+
+/**
+ * Get bulk op ID pool from context.
+ */
+extern struct hg_bulk_op_pool *
+hg_core_context_get_bulk_op_pool(
+        const struct hg_context *context
+        );
+
+/**
+ * Create bulk op ID pool.
+ */
+struct hg_bulk_op_pool *
+hg_bulk_op_pool_create(
+        void
+        );
+
+/**
+ * Destroy bulk op ID pool.
+ */
+void
+hg_bulk_op_pool_destroy(
+        struct hg_bulk_op_pool *hg_bulk_op_pool
+        );
+
+/**
+ * Add entry to completion queue.
+ */
+extern hg_return_t
+hg_core_completion_add(
+        struct hg_context *context,
+        struct hg_completion_entry *hg_completion_entry,
+        hg_bool_t self_notify
+        );
+
+/**
+ * Trigger callback from bulk op ID.
+ */
+hg_return_t
+hg_bulk_trigger_entry(
+        struct hg_bulk_op_id *hg_bulk_op_id
+        );
+
+/**
+ * Can handle receive eager push data (local and writable).
+ */
+hg_bool_t
+hg_bulk_eager_push_accept(
+        hg_bulk_t handle
+        );
+
+/**
+ * Let pushes to a handle decoded from RPC input be added to the response,
+ * passing NULL detaches the handle.
+ */
+void
+hg_bulk_eager_push_set(
+        hg_bulk_t handle,
+        struct hg_bulk_eager_push *eager_push,
+        hg_uint32_t index
+        );
+
+/**
+ * Copy eager push data received with the RPC response to local handles.
+ */
+hg_return_t
+hg_bulk_eager_push_apply(
+        hg_bulk_t *handles,
+        hg_uint32_t count,
+        hg_uint32_t mask,
+        void *buf,
+        hg_size_t buf_size
+        );
+
+/**
+ * NA_Put wrapper
+ */
+static HG_INLINE na_return_t
+hg_bulk_na_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t local_mem_handle,
+    na_ptr_t HG_BULK_UNUSED local_address, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_ptr_t HG_BULK_UNUSED remote_address,
+    na_offset_t remote_offset, na_size_t data_size, na_addr_t remote_addr,
+    na_uint8_t remote_id, na_op_id_t *op_id)
+{
+    return NA_Put(na_class, context, callback, arg, local_mem_handle,
+            local_offset, remote_mem_handle, remote_offset, data_size,
+            remote_addr, remote_id, op_id);
+}
+
+/**
+ * NA_Get wrapper
+ */
+static HG_INLINE na_return_t
+hg_bulk_na_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t local_mem_handle,
+    na_ptr_t HG_BULK_UNUSED local_address, na_offset_t local_offset,
+    na_mem_handle_t remote_mem_handle, na_ptr_t HG_BULK_UNUSED remote_address,
+    na_offset_t remote_offset, na_size_t data_size, na_addr_t remote_addr,
+    na_uint8_t remote_id, na_op_id_t *op_id)
+{
+    return NA_Get(na_class, context, callback, arg, local_mem_handle,
+            local_offset, remote_mem_handle, remote_offset, data_size,
+            remote_addr, remote_id, op_id);
+}
+
+/**
+ * Memcpy
+ */
+static HG_INLINE na_return_t
+hg_bulk_memcpy_put(na_class_t HG_BULK_UNUSED *na_class,
+    na_context_t HG_BULK_UNUSED *context, na_cb_t callback, void *arg,
+    na_mem_handle_t HG_BULK_UNUSED local_mem_handle, na_ptr_t local_address,
+    na_offset_t local_offset, na_mem_handle_t HG_BULK_UNUSED remote_mem_handle,
+    na_ptr_t remote_address, na_offset_t remote_offset, na_size_t data_size,
+    na_addr_t HG_BULK_UNUSED remote_addr, na_uint8_t HG_BULK_UNUSED remote_id,
+    na_op_id_t HG_BULK_UNUSED *op_id)
+{
+    hg_bulk_memcpy((void *) (remote_address + remote_offset),
+            (const void *) (local_address + local_offset), data_size,
+            callback, arg);
+    return NA_SUCCESS;
+}
+
+/**
+ * Memcpy
+ */
+static HG_INLINE na_return_t
+hg_bulk_memcpy_get(na_class_t HG_BULK_UNUSED *na_class,
+    na_context_t HG_BULK_UNUSED *context, na_cb_t callback, void *arg,
+    na_mem_handle_t HG_BULK_UNUSED local_mem_handle, na_ptr_t local_address,
+    na_offset_t local_offset, na_mem_handle_t HG_BULK_UNUSED remote_mem_handle,
+    na_ptr_t remote_address, na_offset_t remote_offset, na_size_t data_size,
+    na_addr_t HG_BULK_UNUSED remote_addr, na_uint8_t HG_BULK_UNUSED remote_id,
+    na_op_id_t HG_BULK_UNUSED *op_id)
+{
+    hg_bulk_memcpy((void *) (local_address + local_offset),
+            (const void *) (remote_address + remote_offset), data_size,
+            callback, arg);
+    return NA_SUCCESS;
+}
+
+/**
+ * Serialize memcpy
+ */
+static HG_INLINE hg_return_t
 hg_bulk_serialize_memcpy(char **dest, ssize_t *dest_left, const void *src,
     size_t n)
 {
@@ -344,10 +900,333 @@ done:
     return ret;
 }
 
+/**
+ * Get encoded size of varint
+ */
+static HG_INLINE hg_size_t
+hg_bulk_varint_size(hg_uint64_t val)
+{
+    hg_size_t n = 1;
+
+    while (val >= 0x80) {
+        val >>= 7;
+        n++;
+    }
+
+    return n;
+}
+
+/**
+ * Serialize varint (7 bits per byte, high bit set on all but last byte)
+ */
+static HG_INLINE hg_return_t
+hg_bulk_serialize_varint(char **dest, ssize_t *dest_left, hg_uint64_t val)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if ((*dest_left -= (ssize_t) hg_bulk_varint_size(val)) < 0) {
+        HG_LOG_ERROR("Buffer size too small");
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+    while (val >= 0x80) {
+        *(*dest)++ = (char) ((val & 0x7f) | 0x80);
+        val >>= 7;
+    }
+    *(*dest)++ = (char) val;
+
+done:
+    return ret;
+}
+
+/**
+ * Deserialize varint
+ */
+static HG_INLINE hg_return_t
+hg_bulk_deserialize_varint(const char **src, ssize_t *src_left,
+    hg_uint64_t *val)
+{
+    hg_uint64_t res = 0;
+    unsigned int shift = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    do {
+        if (--(*src_left) < 0 || shift > 63) {
+            HG_LOG_ERROR("Invalid varint encoding");
+            ret = HG_SIZE_ERROR;
+            goto done;
+        }
+        res |= (hg_uint64_t) (**src & 0x7f) << shift;
+        shift += 7;
+    } while (*(*src)++ & 0x80);
+
+    *val = res;
+
+done:
+    return ret;
+}
+
+/**
+ * Zigzag encode signed delta so that small negative values stay small
+ */
+static HG_INLINE hg_uint64_t
+hg_bulk_zigzag_encode(hg_int64_t val)
+{
+    return ((hg_uint64_t) val << 1) ^ (hg_uint64_t) (val >> 63);
+}
+
+/**
+ * Zigzag decode
+ */
+static HG_INLINE hg_int64_t
+hg_bulk_zigzag_decode(hg_uint64_t val)
+{
+    return (hg_int64_t) (val >> 1) ^ -(hg_int64_t) (val & 1);
+}
+
 /*******************/
 /* Local Variables */
 /*******************/
 
+/*---------------------------------------------------------------------------*/
+struct hg_bulk_pool *
+hg_bulk_pool_create(void)
+{
+    struct hg_bulk_pool *hg_bulk_pool = NULL;
+    unsigned int i;
+
+    hg_bulk_pool = (struct hg_bulk_pool *) malloc(sizeof(struct hg_bulk_pool));
+    if (!hg_bulk_pool) {
+        HG_LOG_ERROR("Could not allocate bulk pool");
+        goto done;
+    }
+    HG_QUEUE_INIT(&hg_bulk_pool->free_list);
+    hg_bulk_pool->count = 0;
+    for (i = 0; i < HG_BULK_STAGING_CLASS_COUNT; i++) {
+        struct hg_bulk_staging *hg_bulk_staging = &hg_bulk_pool->staging[i];
+        unsigned int j;
+
+        for (j = 0; j < HG_BULK_READWRITE; j++)
+            HG_QUEUE_INIT(&hg_bulk_staging->free_list[j]);
+        hg_bulk_staging->buf_size =
+            (hg_size_t) HG_BULK_STAGING_MIN_SIZE << (2 * i);
+        hg_bulk_staging->free_count = 0;
+        hg_bulk_staging->used_count = 0;
+        hg_bulk_staging->hit_count = 0;
+        hg_bulk_staging->miss_count = 0;
+    }
+    hg_bulk_pool->staging_free_size = 0;
+#ifdef HG_HAS_SELF_FORWARD
+    hg_bulk_pool->copy_pool = NULL;
+#endif
+    hg_thread_spin_init(&hg_bulk_pool->lock);
+
+done:
+    return hg_bulk_pool;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_bulk_pool_destroy(struct hg_bulk_pool *hg_bulk_pool)
+{
+    unsigned int i;
+
+    if (!hg_bulk_pool)
+        return;
+
+#ifdef HG_HAS_SELF_FORWARD
+    /* Wait for copies still being done */
+    hg_thread_pool_destroy(hg_bulk_pool->copy_pool);
+#endif
+
+    /* Staging buffers are still registered */
+    for (i = 0; i < HG_BULK_STAGING_CLASS_COUNT; i++) {
+        struct hg_bulk_staging *hg_bulk_staging = &hg_bulk_pool->staging[i];
+        unsigned int j;
+
+        for (j = 0; j < HG_BULK_READWRITE; j++) {
+            while (!HG_QUEUE_IS_EMPTY(&hg_bulk_staging->free_list[j])) {
+                struct hg_bulk *hg_bulk =
+                    HG_QUEUE_FIRST(&hg_bulk_staging->free_list[j]);
+                HG_QUEUE_POP_HEAD(&hg_bulk_staging->free_list[j], entry);
+                hg_bulk_deregister(hg_bulk);
+                hg_mem_aligned_free((void *) hg_bulk->segments[0].address);
+                hg_thread_spin_destroy(&hg_bulk->register_lock);
+                free(hg_bulk);
+            }
+        }
+    }
+
+    while (!HG_QUEUE_IS_EMPTY(&hg_bulk_pool->free_list)) {
+        struct hg_bulk *hg_bulk = HG_QUEUE_FIRST(&hg_bulk_pool->free_list);
+        HG_QUEUE_POP_HEAD(&hg_bulk_pool->free_list, entry);
+        free(hg_bulk);
+    }
+    hg_thread_spin_destroy(&hg_bulk_pool->lock);
+    free(hg_bulk_pool);
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_bulk_op_pool *
+hg_bulk_op_pool_create(void)
+{
+    struct hg_bulk_op_pool *hg_bulk_op_pool = NULL;
+
+    hg_bulk_op_pool = (struct hg_bulk_op_pool *) malloc(
+        sizeof(struct hg_bulk_op_pool));
+    if (!hg_bulk_op_pool) {
+        HG_LOG_ERROR("Could not allocate bulk op pool");
+        goto done;
+    }
+    HG_QUEUE_INIT(&hg_bulk_op_pool->free_list);
+    hg_bulk_op_pool->count = 0;
+    hg_thread_spin_init(&hg_bulk_op_pool->lock);
+
+done:
+    return hg_bulk_op_pool;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_bulk_op_pool_destroy(struct hg_bulk_op_pool *hg_bulk_op_pool)
+{
+    if (!hg_bulk_op_pool)
+        return;
+
+    while (!HG_QUEUE_IS_EMPTY(&hg_bulk_op_pool->free_list)) {
+        struct hg_bulk_op_id *hg_bulk_op_id =
+            HG_QUEUE_FIRST(&hg_bulk_op_pool->free_list);
+        HG_QUEUE_POP_HEAD(&hg_bulk_op_pool->free_list, entry);
+        free(hg_bulk_op_id);
+    }
+    hg_thread_spin_destroy(&hg_bulk_op_pool->lock);
+    free(hg_bulk_op_pool);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_bulk *
+hg_bulk_alloc(struct hg_class *hg_class, hg_uint32_t segment_count,
+    hg_uint32_t na_mem_handle_count, hg_bool_t HG_BULK_UNUSED use_sm)
+{
+    struct hg_bulk_pool *hg_bulk_pool = hg_core_class_get_bulk_pool(hg_class);
+    struct hg_bulk *hg_bulk = NULL;
+    hg_uint32_t i;
+
+    /* Reuse a free handle if there is one */
+    if (hg_bulk_pool) {
+        hg_thread_spin_lock(&hg_bulk_pool->lock);
+        hg_bulk = HG_QUEUE_FIRST(&hg_bulk_pool->free_list);
+        if (hg_bulk) {
+            HG_QUEUE_POP_HEAD(&hg_bulk_pool->free_list, entry);
+            hg_bulk_pool->count--;
+        }
+        hg_thread_spin_unlock(&hg_bulk_pool->lock);
+    }
+    if (!hg_bulk) {
+        hg_bulk = (struct hg_bulk *) malloc(sizeof(struct hg_bulk));
+        if (!hg_bulk) {
+            HG_LOG_ERROR("Could not allocate handle");
+            goto error;
+        }
+    }
+    memset(hg_bulk, 0, sizeof(struct hg_bulk));
+    hg_thread_spin_init(&hg_bulk->register_lock);
+    hg_bulk->hg_class = hg_class;
+    hg_bulk->segment_count = segment_count;
+    hg_bulk->na_mem_handle_count = na_mem_handle_count;
+    hg_atomic_set32(&hg_bulk->ref_count, 1);
+
+    /* Segments and memory handles are kept inline when possible */
+    if (segment_count <= HG_BULK_STATIC_MAX)
+        hg_bulk->segments = hg_bulk->segment_static;
+    else {
+        hg_bulk->segments = (struct hg_bulk_segment *) calloc(
+            segment_count, sizeof(struct hg_bulk_segment));
+        if (!hg_bulk->segments) {
+            HG_LOG_ERROR("Could not allocate segment array");
+            goto error;
+        }
+    }
+    if (na_mem_handle_count <= HG_BULK_STATIC_MAX)
+        hg_bulk->na_mem_handles = hg_bulk->na_mem_handle_static;
+    else {
+        hg_bulk->na_mem_handles = (na_mem_handle_t *) malloc(
+            na_mem_handle_count * sizeof(na_mem_handle_t));
+        if (!hg_bulk->na_mem_handles) {
+            HG_LOG_ERROR("Could not allocate mem handle array");
+            goto error;
+        }
+    }
+#ifdef HG_HAS_SM_ROUTING
+    if (use_sm) {
+        if (na_mem_handle_count <= HG_BULK_STATIC_MAX)
+            hg_bulk->na_sm_mem_handles = hg_bulk->na_sm_mem_handle_static;
+        else {
+            hg_bulk->na_sm_mem_handles = (na_mem_handle_t *) malloc(
+                na_mem_handle_count * sizeof(na_mem_handle_t));
+            if (!hg_bulk->na_sm_mem_handles) {
+                HG_LOG_ERROR("Could not allocate SM mem handle array");
+                goto error;
+            }
+        }
+    }
+#endif
+    for (i = 0; i < na_mem_handle_count; i++) {
+        hg_bulk->na_mem_handles[i] = NA_MEM_HANDLE_NULL;
+#ifdef HG_HAS_SM_ROUTING
+        if (hg_bulk->na_sm_mem_handles)
+            hg_bulk->na_sm_mem_handles[i] = NA_MEM_HANDLE_NULL;
+#endif
+    }
+
+    return hg_bulk;
+
+error:
+    if (hg_bulk) {
+        if (hg_bulk->segments != hg_bulk->segment_static)
+            free(hg_bulk->segments);
+        if (hg_bulk->na_mem_handles != hg_bulk->na_mem_handle_static)
+            free(hg_bulk->na_mem_handles);
+#ifdef HG_HAS_SM_ROUTING
+        if (hg_bulk->na_sm_mem_handles != hg_bulk->na_sm_mem_handle_static)
+            free(hg_bulk->na_sm_mem_handles);
+#endif
+        free(hg_bulk);
+    }
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_release(struct hg_bulk *hg_bulk)
+{
+    struct hg_bulk_pool *hg_bulk_pool =
+        hg_core_class_get_bulk_pool(hg_bulk->hg_class);
+
+    if (hg_bulk->segments != hg_bulk->segment_static)
+        free(hg_bulk->segments);
+    if (hg_bulk->na_mem_handles != hg_bulk->na_mem_handle_static)
+        free(hg_bulk->na_mem_handles);
+#ifdef HG_HAS_SM_ROUTING
+    if (hg_bulk->na_sm_mem_handles != hg_bulk->na_sm_mem_handle_static)
+        free(hg_bulk->na_sm_mem_handles);
+#endif
+    free(hg_bulk->eager_buf);
+    free(hg_bulk->segment_ends);
+    hg_thread_spin_destroy(&hg_bulk->register_lock);
+
+    if (hg_bulk_pool) {
+        hg_thread_spin_lock(&hg_bulk_pool->lock);
+        if (hg_bulk_pool->count < HG_BULK_POOL_MAX) {
+            HG_QUEUE_PUSH_TAIL(&hg_bulk_pool->free_list, hg_bulk, entry);
+            hg_bulk_pool->count++;
+            hg_bulk = NULL;
+        }
+        hg_thread_spin_unlock(&hg_bulk_pool->lock);
+    }
+    free(hg_bulk);
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_create(struct hg_class *hg_class, hg_uint32_t count,
@@ -356,39 +1235,41 @@ hg_bulk_create(struct hg_class *hg_class, hg_uint32_t count,
 {
     struct hg_bulk *hg_bulk = NULL;
     hg_return_t ret = HG_SUCCESS;
-    na_return_t na_ret;
     na_class_t *na_class = HG_Core_class_get_na(hg_class);
+    hg_size_t staging_max_size = (hg_size_t) HG_BULK_STAGING_MIN_SIZE
+        << (2 * (HG_BULK_STAGING_CLASS_COUNT - 1));
 #ifdef HG_HAS_SM_ROUTING
     na_class_t *na_sm_class = HG_Core_class_get_na_sm(hg_class);
 #endif
     hg_bool_t use_register_segments = (hg_bool_t)
         (na_class->mem_handle_create_segments && count > 1);
+    hg_bool_t use_sm = HG_FALSE;
     unsigned int i;
 
-    hg_bulk = (struct hg_bulk *) malloc(sizeof(struct hg_bulk));
-    if (!hg_bulk) {
-        HG_LOG_ERROR("Could not allocate handle");
-        ret = HG_NOMEM_ERROR;
+#ifdef HG_HAS_SM_ROUTING
+    use_sm = (hg_bool_t) (na_sm_class != NULL);
+#endif
+
+    /* Library-allocated single segments come from the staging pool */
+    if (!buf_ptrs && count == 1 && buf_sizes[0]
+        && buf_sizes[0] <= staging_max_size) {
+        hg_bulk = hg_bulk_staging_get(hg_class, buf_sizes[0], flags, use_sm);
+        if (!hg_bulk) {
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        *hg_bulk_ptr = hg_bulk;
         goto done;
     }
-    memset(hg_bulk, 0, sizeof(struct hg_bulk));
-    hg_bulk->hg_class = hg_class;
-    hg_bulk->segment_count = count;
-    hg_bulk->na_mem_handle_count = (use_register_segments) ? 1 : count;
-    hg_bulk->segment_alloc = (!buf_ptrs);
-    hg_bulk->flags = flags;
-    hg_atomic_set32(&hg_bulk->ref_count, 1);
 
-    /* Allocate segments */
-    hg_bulk->segments = (struct hg_bulk_segment *) malloc(
-        hg_bulk->segment_count * sizeof(struct hg_bulk_segment));
-    if (!hg_bulk->segments) {
-        HG_LOG_ERROR("Could not allocate segment array");
+    hg_bulk = hg_bulk_alloc(hg_class, count,
+        (use_register_segments) ? 1 : count, use_sm);
+    if (!hg_bulk) {
         ret = HG_NOMEM_ERROR;
         goto done;
     }
-    memset(hg_bulk->segments, 0,
-           hg_bulk->segment_count * sizeof(struct hg_bulk_segment));
+    hg_bulk->segment_alloc = (!buf_ptrs);
+    hg_bulk->flags = flags;
 
     /* Loop over the list of segments */
     for (i = 0; i < hg_bulk->segment_count; i++) {
@@ -409,204 +1290,428 @@ hg_bulk_create(struct hg_class *hg_class, hg_uint32_t count,
         }
     }
 
-    /* Allocate NA memory handles */
-    hg_bulk->na_mem_handles = (na_mem_handle_t *) malloc(
-        hg_bulk->na_mem_handle_count * sizeof(na_mem_handle_t));
-    if (!hg_bulk->na_mem_handles) {
-        HG_LOG_ERROR("Could not allocate mem handle array");
-        ret = HG_NOMEM_ERROR;
+    /* NA memory handles are created and registered once the handle is
+     * serialized for, or used with, a given NA class */
+
+    *hg_bulk_ptr = hg_bulk;
+
+done:
+    if (ret != HG_SUCCESS) {
+        hg_bulk_free(hg_bulk);
+    }
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_free(struct hg_bulk *hg_bulk)
+{
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    if (!hg_bulk) goto done;
+
+    if (hg_atomic_decr32(&hg_bulk->ref_count)) {
+        /* Cannot free yet */
         goto done;
     }
-#ifdef HG_HAS_SM_ROUTING
-    if (na_sm_class) {
-        hg_bulk->na_sm_mem_handles = (na_mem_handle_t *) malloc(
-            hg_bulk->na_mem_handle_count * sizeof(na_mem_handle_t));
-        if (!hg_bulk->na_sm_mem_handles) {
-            HG_LOG_ERROR("Could not allocate SM mem handle array");
-            ret = HG_NOMEM_ERROR;
-            goto done;
-        }
+
+    /* Views only hold a reference to the handle they view */
+    if (hg_bulk->parent) {
+        ret = hg_bulk_free(hg_bulk->parent);
+        hg_bulk_release(hg_bulk);
+        goto done;
     }
-#endif
-    for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
-        hg_bulk->na_mem_handles[i] = NA_MEM_HANDLE_NULL;
-#ifdef HG_HAS_SM_ROUTING
-        if (hg_bulk->na_sm_mem_handles)
-            hg_bulk->na_sm_mem_handles[i] = NA_MEM_HANDLE_NULL;
-#endif
+
+    /* Keep registered staging buffer for reuse */
+    if (hg_bulk->staging && hg_bulk_staging_put(hg_bulk))
+        goto done;
+
+    hg_bulk_deregister(hg_bulk);
+
+    /* Free segments */
+    if (hg_bulk->segment_alloc) {
+        for (i = 0; i < hg_bulk->segment_count; i++) {
+            free((void *) hg_bulk->segments[i].address);
+        }
     }
+    if (hg_bulk->staging)
+        hg_mem_aligned_free((void *) hg_bulk->segments[0].address);
+    hg_bulk_release(hg_bulk);
 
-    /* Create and register NA memory handles */
-    for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
-        /* na_mem_handle_count always <= segment_count */
-        if (!hg_bulk->segments[i].address)
-            continue;
-
-        if (use_register_segments) {
-            struct na_segment *na_segments =
-                (struct na_segment *) hg_bulk->segments;
-            na_size_t na_segment_count = (na_size_t) hg_bulk->segment_count;
-            na_ret = NA_Mem_handle_create_segments(na_class, na_segments,
-                na_segment_count, flags, &hg_bulk->na_mem_handles[i]);
-            if (na_ret != NA_SUCCESS) {
-                HG_LOG_ERROR("NA_Mem_handle_create_segments failed");
-                ret = HG_NA_ERROR;
-                goto done;
-            }
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_deregister(struct hg_bulk *hg_bulk)
+{
+    unsigned int i;
+
+    if (hg_bulk->na_mem_handles) {
+        na_class_t *na_class = HG_Core_class_get_na(hg_bulk->hg_class);
+#ifdef HG_HAS_SM_ROUTING
+        na_class_t *na_sm_class = HG_Core_class_get_na_sm(hg_bulk->hg_class);
+#endif
+        /* Handles deserialized from remote are not registered locally */
+        hg_bool_t na_deregister = hg_bulk->remote
+            || (hg_bulk->na_registered & HG_BULK_SERIALIZE_NA);
 #ifdef HG_HAS_SM_ROUTING
-            if (hg_bulk->na_sm_mem_handles) {
-                na_ret = NA_Mem_handle_create_segments(na_sm_class, na_segments,
-                    na_segment_count, flags, &hg_bulk->na_sm_mem_handles[i]);
+        hg_bool_t na_sm_deregister = hg_bulk->remote
+            || (hg_bulk->na_registered & HG_BULK_SERIALIZE_SM);
+#endif
+
+        /* Unregister/free NA memory handles */
+        for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
+            na_return_t na_ret;
+
+            if (hg_bulk->na_mem_handles[i]) {
+                if (hg_bulk->na_published & HG_BULK_SERIALIZE_NA) {
+                    na_ret = NA_Mem_unpublish(na_class,
+                        hg_bulk->na_mem_handles[i]);
+                    if (na_ret != NA_SUCCESS) {
+                        HG_LOG_ERROR("NA_Mem_unpublish failed");
+                    }
+                }
+                if (na_deregister) {
+                    na_ret = NA_Mem_deregister(na_class,
+                        hg_bulk->na_mem_handles[i]);
+                    if (na_ret != NA_SUCCESS) {
+                        HG_LOG_ERROR("NA_Mem_deregister failed");
+                    }
+                }
+                na_ret = NA_Mem_handle_free(na_class,
+                    hg_bulk->na_mem_handles[i]);
                 if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("NA_Mem_handle_create_segments for SM failed");
-                    ret = HG_NA_ERROR;
-                    goto done;
+                    HG_LOG_ERROR("NA_Mem_handle_free failed");
                 }
+                hg_bulk->na_mem_handles[i] = NA_MEM_HANDLE_NULL;
             }
-#endif
-        } else {
-            na_ret = NA_Mem_handle_create(na_class,
-                (void *) hg_bulk->segments[i].address,
-                hg_bulk->segments[i].size, flags, &hg_bulk->na_mem_handles[i]);
-            if (na_ret != NA_SUCCESS) {
-                HG_LOG_ERROR("NA_Mem_handle_create failed");
-                ret = HG_NA_ERROR;
-                goto done;
-            }
+
 #ifdef HG_HAS_SM_ROUTING
-            if (hg_bulk->na_sm_mem_handles) {
-                na_ret = NA_Mem_handle_create(na_sm_class,
-                    (void *) hg_bulk->segments[i].address,
-                    hg_bulk->segments[i].size, flags, &hg_bulk->na_sm_mem_handles[i]);
+            if (hg_bulk->na_sm_mem_handles && hg_bulk->na_sm_mem_handles[i]) {
+                if (hg_bulk->na_published & HG_BULK_SERIALIZE_SM) {
+                    na_ret = NA_Mem_unpublish(na_sm_class,
+                        hg_bulk->na_sm_mem_handles[i]);
+                    if (na_ret != NA_SUCCESS) {
+                        HG_LOG_ERROR("NA_Mem_unpublish for SM failed");
+                    }
+                }
+                if (na_sm_deregister) {
+                    na_ret = NA_Mem_deregister(na_sm_class,
+                        hg_bulk->na_sm_mem_handles[i]);
+                    if (na_ret != NA_SUCCESS) {
+                        HG_LOG_ERROR("NA_Mem_deregister for SM failed");
+                    }
+                }
+                na_ret = NA_Mem_handle_free(na_sm_class,
+                    hg_bulk->na_sm_mem_handles[i]);
                 if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("NA_Mem_handle_create for SM failed");
-                    ret = HG_NA_ERROR;
-                    goto done;
+                    HG_LOG_ERROR("NA_Mem_handle_free for SM failed");
                 }
+                hg_bulk->na_sm_mem_handles[i] = NA_MEM_HANDLE_NULL;
             }
 #endif
         }
-        /* Register segment */
-        na_ret = NA_Mem_register(na_class, hg_bulk->na_mem_handles[i]);
-        if (na_ret != NA_SUCCESS) {
-            HG_LOG_ERROR("NA_Mem_register failed");
-            ret = HG_NA_ERROR;
-            goto done;
+        hg_bulk->na_registered = 0;
+        hg_bulk->na_published = 0;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_bulk *
+hg_bulk_staging_get(struct hg_class *hg_class, hg_size_t size,
+    hg_uint8_t flags, hg_bool_t use_sm)
+{
+    struct hg_bulk_pool *hg_bulk_pool = hg_core_class_get_bulk_pool(hg_class);
+    struct hg_bulk_staging *hg_bulk_staging;
+    struct hg_bulk *hg_bulk;
+    unsigned int i = 0;
+    void *buf;
+
+    if (!hg_bulk_pool) {
+        HG_LOG_ERROR("NULL bulk pool");
+        return NULL;
+    }
+
+    /* Smallest size class that fits */
+    while (hg_bulk_pool->staging[i].buf_size < size)
+        i++;
+    hg_bulk_staging = &hg_bulk_pool->staging[i];
+
+    hg_thread_spin_lock(&hg_bulk_pool->lock);
+    hg_bulk = HG_QUEUE_FIRST(&hg_bulk_staging->free_list[flags - 1]);
+    if (hg_bulk) {
+        HG_QUEUE_POP_HEAD(&hg_bulk_staging->free_list[flags - 1], entry);
+        hg_bulk_staging->free_count--;
+        hg_bulk_pool->staging_free_size -= hg_bulk_staging->buf_size;
+        hg_bulk_staging->hit_count++;
+    } else
+        hg_bulk_staging->miss_count++;
+    hg_bulk_staging->used_count++;
+    hg_thread_spin_unlock(&hg_bulk_pool->lock);
+
+    if (hg_bulk) {
+        /* NA memory handles are kept, only reset state from previous use */
+        hg_atomic_set32(&hg_bulk->ref_count, 1);
+        hg_bulk->eager_mode = HG_FALSE;
+        hg_bulk->remote = HG_FALSE;
+        hg_bulk->eager_push = NULL;
+        hg_bulk->eager_push_index = 0;
+
+        /* Registration only covers the previous size, redo it on use */
+        if (hg_bulk->segments[0].size != size)
+            hg_bulk_deregister(hg_bulk);
+    } else {
+        buf = hg_mem_aligned_alloc(hg_mem_get_page_size(),
+            hg_bulk_staging->buf_size);
+        if (!buf) {
+            HG_LOG_ERROR("Could not allocate staging buffer");
+            goto error;
         }
-#ifdef HG_HAS_SM_ROUTING
-        if (hg_bulk->na_sm_mem_handles && hg_bulk->na_sm_mem_handles[i]) {
-            na_ret = NA_Mem_register(na_sm_class, hg_bulk->na_sm_mem_handles[i]);
-            if (na_ret != NA_SUCCESS) {
-                HG_LOG_ERROR("NA_Mem_register failed");
-                ret = HG_NA_ERROR;
-                goto done;
-            }
+        /* Avoid uninitialized memory used for transfer */
+        memset(buf, 0, hg_bulk_staging->buf_size);
+
+        hg_bulk = hg_bulk_alloc(hg_class, 1, 1, use_sm);
+        if (!hg_bulk) {
+            hg_mem_aligned_free(buf);
+            goto error;
         }
-#endif
+        hg_bulk->segments[0].address = (hg_ptr_t) buf;
+        hg_bulk->staging = hg_bulk_staging;
+        hg_bulk->flags = flags;
     }
+    hg_bulk->segments[0].size = size;
+    hg_bulk->total_size = size;
 
-    *hg_bulk_ptr = hg_bulk;
+    return hg_bulk;
 
-done:
-    if (ret != HG_SUCCESS) {
-        hg_bulk_free(hg_bulk);
+error:
+    hg_thread_spin_lock(&hg_bulk_pool->lock);
+    hg_bulk_staging->used_count--;
+    hg_thread_spin_unlock(&hg_bulk_pool->lock);
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_bulk_staging_put(struct hg_bulk *hg_bulk)
+{
+    struct hg_bulk_pool *hg_bulk_pool =
+        hg_core_class_get_bulk_pool(hg_bulk->hg_class);
+    struct hg_bulk_staging *hg_bulk_staging = hg_bulk->staging;
+    hg_bool_t ret = HG_FALSE;
+
+    hg_thread_spin_lock(&hg_bulk_pool->lock);
+    hg_bulk_staging->used_count--;
+    /* Limit amount of memory kept registered while idle */
+    if (hg_bulk_staging->free_count < HG_BULK_STAGING_POOL_MAX
+        && hg_bulk_pool->staging_free_size + hg_bulk_staging->buf_size
+            <= HG_BULK_STAGING_POOL_MAX_SIZE) {
+        HG_QUEUE_PUSH_TAIL(&hg_bulk_staging->free_list[hg_bulk->flags - 1],
+            hg_bulk, entry);
+        hg_bulk_staging->free_count++;
+        hg_bulk_pool->staging_free_size += hg_bulk_staging->buf_size;
+        ret = HG_TRUE;
     }
+    hg_thread_spin_unlock(&hg_bulk_pool->lock);
+
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_bulk_free(struct hg_bulk *hg_bulk)
+hg_bulk_register(struct hg_bulk *hg_bulk, hg_uint8_t na_flag,
+    hg_bool_t publish)
 {
+    na_class_t *na_class = HG_Core_class_get_na(hg_bulk->hg_class);
+    na_mem_handle_t *na_mem_handles = hg_bulk->na_mem_handles;
+    hg_bool_t use_register_segments =
+        (hg_bool_t) (hg_bulk->na_mem_handle_count < hg_bulk->segment_count);
     hg_return_t ret = HG_SUCCESS;
     unsigned int i;
 
-    if (!hg_bulk) goto done;
-
-    if (hg_atomic_decr32(&hg_bulk->ref_count)) {
-        /* Cannot free yet */
+    /* Nothing to register for handles received from remote */
+    if (hg_bulk->remote)
         goto done;
-    }
 
-    if (hg_bulk->na_mem_handles) {
-        na_class_t *na_class = HG_Core_class_get_na(hg_bulk->hg_class);
 #ifdef HG_HAS_SM_ROUTING
-        na_class_t *na_sm_class = HG_Core_class_get_na_sm(hg_bulk->hg_class);
+    if (na_flag == HG_BULK_SERIALIZE_SM) {
+        na_class = HG_Core_class_get_na_sm(hg_bulk->hg_class);
+        na_mem_handles = hg_bulk->na_sm_mem_handles;
+    }
 #endif
+    if (!na_class || !na_mem_handles)
+        goto done;
 
-        /* Unregister/free NA memory handles */
-        if (hg_bulk->segment_published) {
-            for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
-                na_return_t na_ret;
+    hg_thread_spin_lock(&hg_bulk->register_lock);
+
+    if (!(hg_bulk->na_registered & na_flag)) {
+        for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
+            na_return_t na_ret;
 
-                if (!hg_bulk->na_mem_handles[i])
-                    continue;
+            /* na_mem_handle_count always <= segment_count */
+            if (!hg_bulk->segments[i].address || na_mem_handles[i])
+                continue;
 
-                na_ret = NA_Mem_unpublish(na_class, hg_bulk->na_mem_handles[i]);
+            if (use_register_segments) {
+                na_ret = NA_Mem_handle_create_segments(na_class,
+                    (struct na_segment *) hg_bulk->segments,
+                    (na_size_t) hg_bulk->segment_count, hg_bulk->flags,
+                    &na_mem_handles[i]);
                 if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("NA_Mem_unpublish failed");
+                    HG_LOG_ERROR("NA_Mem_handle_create_segments failed");
+                    ret = HG_NA_ERROR;
+                    goto unlock;
                 }
-#ifdef HG_HAS_SM_ROUTING
-                if (hg_bulk->na_sm_mem_handles && hg_bulk->na_sm_mem_handles[i]) {
-                    na_ret = NA_Mem_unpublish(na_sm_class, hg_bulk->na_sm_mem_handles[i]);
-                    if (na_ret != NA_SUCCESS) {
-                        HG_LOG_ERROR("NA_Mem_unpublish for SM failed");
-                    }
+            } else {
+                na_ret = NA_Mem_handle_create(na_class,
+                    (void *) hg_bulk->segments[i].address,
+                    hg_bulk->segments[i].size, hg_bulk->flags,
+                    &na_mem_handles[i]);
+                if (na_ret != NA_SUCCESS) {
+                    HG_LOG_ERROR("NA_Mem_handle_create failed");
+                    ret = HG_NA_ERROR;
+                    goto unlock;
                 }
-#endif
             }
-            hg_bulk->segment_published = HG_FALSE;
+
+            /* Register segment */
+            na_ret = NA_Mem_register(na_class, na_mem_handles[i]);
+            if (na_ret != NA_SUCCESS) {
+                HG_LOG_ERROR("NA_Mem_register failed");
+                NA_Mem_handle_free(na_class, na_mem_handles[i]);
+                na_mem_handles[i] = NA_MEM_HANDLE_NULL;
+                ret = HG_NA_ERROR;
+                goto unlock;
+            }
         }
+        hg_bulk->na_registered |= na_flag;
+    }
 
+    if (publish && !(hg_bulk->na_published & na_flag)) {
         for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
             na_return_t na_ret;
 
-            if (!hg_bulk->na_mem_handles[i])
+            if (!na_mem_handles[i])
                 continue;
 
-            na_ret = NA_Mem_deregister(na_class, hg_bulk->na_mem_handles[i]);
+            na_ret = NA_Mem_publish(na_class, na_mem_handles[i]);
             if (na_ret != NA_SUCCESS) {
-                HG_LOG_ERROR("NA_Mem_deregister failed");
+                HG_LOG_ERROR("NA_Mem_publish failed");
+                ret = HG_NA_ERROR;
+                goto unlock;
             }
+        }
+        hg_bulk->na_published |= na_flag;
+    }
 
-            na_ret = NA_Mem_handle_free(na_class, hg_bulk->na_mem_handles[i]);
-            if (na_ret != NA_SUCCESS) {
-                HG_LOG_ERROR("NA_Mem_handle_free failed");
-            }
-            hg_bulk->na_mem_handles[i] = NA_MEM_HANDLE_NULL;
+unlock:
+    hg_thread_spin_unlock(&hg_bulk->register_lock);
 
-#ifdef HG_HAS_SM_ROUTING
-            if (hg_bulk->na_sm_mem_handles && hg_bulk->na_sm_mem_handles[i]) {
-                na_ret = NA_Mem_deregister(na_sm_class, hg_bulk->na_sm_mem_handles[i]);
-                if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("NA_Mem_deregister for SM failed");
-                }
-                na_ret = NA_Mem_handle_free(na_sm_class, hg_bulk->na_sm_mem_handles[i]);
-                if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("NA_Mem_handle_free for SM failed");
-                }
-                hg_bulk->na_sm_mem_handles[i] = NA_MEM_HANDLE_NULL;
-            }
-#endif
-        }
+done:
+    return ret;
+}
 
-        free(hg_bulk->na_mem_handles);
-#ifdef HG_HAS_SM_ROUTING
-        free(hg_bulk->na_sm_mem_handles);
-#endif
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_window_get(struct hg_bulk *hg_bulk,
+    struct hg_bulk_window *hg_bulk_window)
+{
+    struct hg_bulk *hg_bulk_parent = hg_bulk->parent;
+    hg_uint32_t segment_end_index;
+    hg_size_t segment_end_offset;
+
+    if (!hg_bulk_parent) {
+        hg_bulk_window->hg_bulk = hg_bulk;
+        hg_bulk_window->segment_start = 0;
+        hg_bulk_window->segment_count = hg_bulk->segment_count;
+        hg_bulk_window->start_offset = 0;
+        hg_bulk_window->end_offset = (hg_bulk->segment_count) ?
+            hg_bulk->segments[hg_bulk->segment_count - 1].size : 0;
+        hg_bulk_window->na_mem_handle_start = 0;
+        hg_bulk_window->na_mem_handle_count = hg_bulk->na_mem_handle_count;
+        hg_bulk_window->na_mem_handle_offset = hg_bulk->na_mem_handle_offset;
+        return;
     }
 
-    /* Free segments */
-    if (hg_bulk->segment_alloc) {
-        for (i = 0; i < hg_bulk->segment_count; i++) {
-            free((void *) hg_bulk->segments[i].address);
+    hg_bulk_window->hg_bulk = hg_bulk_parent;
+    if (!hg_bulk->total_size) {
+        memset(hg_bulk_window, 0, sizeof(struct hg_bulk_window));
+        hg_bulk_window->hg_bulk = hg_bulk_parent;
+        return;
+    }
+
+    hg_bulk_offset_translate(hg_bulk_parent, hg_bulk->view_offset,
+        &hg_bulk_window->segment_start, &hg_bulk_window->start_offset);
+    hg_bulk_offset_translate(hg_bulk_parent,
+        hg_bulk->view_offset + hg_bulk->total_size - 1, &segment_end_index,
+        &segment_end_offset);
+    hg_bulk_window->segment_count =
+        segment_end_index - hg_bulk_window->segment_start + 1;
+    hg_bulk_window->end_offset = segment_end_offset + 1;
+
+    /* A single NA handle covers all the segments, otherwise there is one
+     * per segment and only the first one may be entered at an offset */
+    if (hg_bulk_parent->na_mem_handle_count > 1) {
+        hg_bulk_window->na_mem_handle_start = hg_bulk_window->segment_start;
+        hg_bulk_window->na_mem_handle_count = hg_bulk_window->segment_count;
+    } else {
+        hg_bulk_window->na_mem_handle_start = 0;
+        hg_bulk_window->na_mem_handle_count =
+            hg_bulk_parent->na_mem_handle_count;
+    }
+    if (hg_bulk_parent->na_mem_handle_count <= 1
+        || hg_bulk_window->segment_start == 0)
+        hg_bulk_window->na_mem_handle_offset =
+            hg_bulk_parent->na_mem_handle_offset + hg_bulk->view_offset;
+    else
+        hg_bulk_window->na_mem_handle_offset = hg_bulk_window->start_offset;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_bulk_window_segment(const struct hg_bulk_window *hg_bulk_window,
+    hg_uint32_t i, struct hg_bulk_segment *segment)
+{
+    const struct hg_bulk_segment *hg_bulk_segment =
+        &hg_bulk_window->hg_bulk->segments[hg_bulk_window->segment_start + i];
+    hg_size_t start = (i == 0) ? hg_bulk_window->start_offset : 0;
+    hg_size_t end = (i == hg_bulk_window->segment_count - 1) ?
+        hg_bulk_window->end_offset : hg_bulk_segment->size;
+
+    segment->address = hg_bulk_segment->address + (hg_ptr_t) start;
+    segment->size = end - start;
+}
+
+/*---------------------------------------------------------------------------*/
+static const hg_size_t *
+hg_bulk_offset_index_get(struct hg_bulk *hg_bulk)
+{
+    hg_size_t *segment_ends;
+    hg_uint32_t i;
+
+    if (hg_atomic_get32(&hg_bulk->segment_ends_ready))
+        return hg_bulk->segment_ends;
+
+    hg_thread_spin_lock(&hg_bulk->register_lock);
+    if (!hg_atomic_get32(&hg_bulk->segment_ends_ready)) {
+        segment_ends = (hg_size_t *) malloc(
+            hg_bulk->segment_count * sizeof(hg_size_t));
+        if (segment_ends) {
+            segment_ends[0] = hg_bulk->segments[0].size;
+            for (i = 1; i < hg_bulk->segment_count; i++)
+                segment_ends[i] = segment_ends[i - 1]
+                    + hg_bulk->segments[i].size;
+            hg_bulk->segment_ends = segment_ends;
+            hg_atomic_fence();
+            hg_atomic_set32(&hg_bulk->segment_ends_ready, 1);
         }
     }
-    free(hg_bulk->segments);
-    free(hg_bulk);
+    hg_thread_spin_unlock(&hg_bulk->register_lock);
 
-done:
-    return ret;
+    return hg_bulk->segment_ends;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -617,6 +1722,29 @@ hg_bulk_offset_translate(struct hg_bulk *hg_bulk, hg_size_t offset,
     hg_uint32_t i, new_segment_start_index = 0;
     hg_size_t new_segment_offset = offset, next_offset = 0;
 
+    /* Binary search first segment ending after offset for large handles */
+    if (hg_bulk->segment_count >= HG_BULK_OFFSET_INDEX_MIN) {
+        const hg_size_t *segment_ends = hg_bulk_offset_index_get(hg_bulk);
+
+        if (segment_ends
+            && offset < segment_ends[hg_bulk->segment_count - 1]) {
+            hg_uint32_t low = 0, high = hg_bulk->segment_count - 1;
+
+            while (low < high) {
+                hg_uint32_t mid = low + (high - low) / 2;
+
+                if (offset < segment_ends[mid])
+                    high = mid;
+                else
+                    low = mid + 1;
+            }
+            *segment_start_index = low;
+            *segment_start_offset = (low) ? offset - segment_ends[low - 1] :
+                offset;
+            return;
+        }
+    }
+
     /* Get start index and handle offset */
     for (i = 0; i < hg_bulk->segment_count; i++) {
         next_offset += hg_bulk->segments[i].size;
@@ -644,6 +1772,11 @@ hg_bulk_access(struct hg_bulk *hg_bulk, hg_size_t offset, hg_size_t size,
 
     /* TODO use flags */
 
+    if (hg_bulk->parent) {
+        offset += hg_bulk->view_offset;
+        hg_bulk = hg_bulk->parent;
+    }
+
     hg_bulk_offset_translate(hg_bulk, offset, &segment_index,
         &segment_offset);
 
@@ -680,6 +1813,307 @@ hg_bulk_access(struct hg_bulk *hg_bulk, hg_size_t offset, hg_size_t size,
     if (actual_count) *actual_count = count;
 }
 
+/*---------------------------------------------------------------------------*/
+static struct hg_bulk_op_id *
+hg_bulk_op_id_alloc(hg_context_t *context, unsigned int na_op_count)
+{
+    struct hg_bulk_op_pool *hg_bulk_op_pool =
+        hg_core_context_get_bulk_op_pool(context);
+    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    unsigned int i;
+
+    /* Reuse a free op ID if there is one */
+    if (hg_bulk_op_pool) {
+        hg_thread_spin_lock(&hg_bulk_op_pool->lock);
+        hg_bulk_op_id = HG_QUEUE_FIRST(&hg_bulk_op_pool->free_list);
+        if (hg_bulk_op_id) {
+            HG_QUEUE_POP_HEAD(&hg_bulk_op_pool->free_list, entry);
+            hg_bulk_op_pool->count--;
+        }
+        hg_thread_spin_unlock(&hg_bulk_op_pool->lock);
+    }
+    if (!hg_bulk_op_id) {
+        hg_bulk_op_id = (struct hg_bulk_op_id *) malloc(
+            sizeof(struct hg_bulk_op_id));
+        if (!hg_bulk_op_id) {
+            HG_LOG_ERROR("Could not allocate HG Bulk operation ID");
+            goto done;
+        }
+    }
+    hg_bulk_op_id->pool = hg_bulk_op_pool;
+
+    /* NA operation IDs are kept inline when possible */
+    if (na_op_count <= HG_BULK_OP_STATIC_MAX)
+        hg_bulk_op_id->na_op_ids = hg_bulk_op_id->na_op_id_static;
+    else {
+        hg_bulk_op_id->na_op_ids = (na_op_id_t *) malloc(
+            na_op_count * sizeof(na_op_id_t));
+        if (!hg_bulk_op_id->na_op_ids) {
+            HG_LOG_ERROR("Could not allocate memory for op_ids");
+            hg_bulk_op_id->na_op_ids = hg_bulk_op_id->na_op_id_static;
+            hg_bulk_op_id_release(hg_bulk_op_id);
+            hg_bulk_op_id = NULL;
+            goto done;
+        }
+    }
+    for (i = 0; i < na_op_count; i++)
+        hg_bulk_op_id->na_op_ids[i] = NA_OP_ID_NULL;
+
+done:
+    return hg_bulk_op_id;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_op_id_release(struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    struct hg_bulk_op_pool *hg_bulk_op_pool = hg_bulk_op_id->pool;
+
+    if (hg_bulk_op_id->na_op_ids != hg_bulk_op_id->na_op_id_static)
+        free(hg_bulk_op_id->na_op_ids);
+
+    if (hg_bulk_op_pool) {
+        hg_thread_spin_lock(&hg_bulk_op_pool->lock);
+        if (hg_bulk_op_pool->count < HG_BULK_OP_POOL_MAX) {
+            HG_QUEUE_PUSH_TAIL(&hg_bulk_op_pool->free_list, hg_bulk_op_id,
+                entry);
+            hg_bulk_op_pool->count++;
+            hg_bulk_op_id = NULL;
+        }
+        hg_thread_spin_unlock(&hg_bulk_op_pool->lock);
+    }
+    free(hg_bulk_op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_memcpy_segments(struct hg_bulk *hg_bulk, hg_size_t offset, void *buf,
+    hg_size_t size, hg_bool_t to_bulk)
+{
+    hg_uint32_t segment_index;
+    hg_size_t segment_offset;
+    char *buf_ptr = (char *) buf;
+
+    if (hg_bulk->parent) {
+        offset += hg_bulk->view_offset;
+        hg_bulk = hg_bulk->parent;
+    }
+
+    hg_bulk_offset_translate(hg_bulk, offset, &segment_index,
+        &segment_offset);
+
+    while ((size > 0) && (segment_index < hg_bulk->segment_count)) {
+        char *segment_ptr = (char *) hg_bulk->segments[segment_index].address
+            + segment_offset;
+        hg_size_t copy_size = hg_bulk->segments[segment_index].size
+            - segment_offset;
+
+        copy_size = HG_BULK_MIN(size, copy_size);
+        if (to_bulk)
+            memcpy(segment_ptr, buf_ptr, copy_size);
+        else
+            memcpy(buf_ptr, segment_ptr, copy_size);
+
+        buf_ptr += copy_size;
+        size -= copy_size;
+        segment_index++;
+        segment_offset = 0;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_bulk_eager_push_add(struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
+    struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_size_t size)
+{
+    struct hg_bulk_eager_push *eager_push = hg_bulk_origin->eager_push;
+    hg_uint64_t rec_offset = (hg_uint64_t) origin_offset;
+    hg_uint64_t rec_size = (hg_uint64_t) size;
+    hg_bool_t ret = HG_FALSE;
+    char *buf_ptr;
+
+    if ((origin_offset + size > hg_bulk_origin->total_size)
+        || (local_offset + size > hg_bulk_local->total_size))
+        return ret;
+
+    hg_thread_spin_lock(&eager_push->lock);
+    if (!eager_push->active || (eager_push->size
+        + HG_BULK_EAGER_PUSH_HEADER_SIZE + size > eager_push->max_size))
+        goto done;
+
+    /* Record is index, origin offset and size followed by the data */
+    buf_ptr = eager_push->buf + eager_push->size;
+    memcpy(buf_ptr, &hg_bulk_origin->eager_push_index, sizeof(hg_uint32_t));
+    buf_ptr += sizeof(hg_uint32_t);
+    memcpy(buf_ptr, &rec_offset, sizeof(hg_uint64_t));
+    buf_ptr += sizeof(hg_uint64_t);
+    memcpy(buf_ptr, &rec_size, sizeof(hg_uint64_t));
+    buf_ptr += sizeof(hg_uint64_t);
+    hg_bulk_memcpy_segments(hg_bulk_local, local_offset, buf_ptr, size,
+        HG_FALSE);
+    eager_push->size += HG_BULK_EAGER_PUSH_HEADER_SIZE + size;
+    ret = HG_TRUE;
+
+done:
+    hg_thread_spin_unlock(&eager_push->lock);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_copy_data(void *dest, const void *src, hg_size_t size,
+    hg_bool_t non_temporal)
+{
+#ifdef __SSE2__
+    if (non_temporal) {
+        char *dest_ptr = (char *) dest;
+        const char *src_ptr = (const char *) src;
+        hg_size_t head_size = (16 - ((hg_ptr_t) dest_ptr & 15)) & 15;
+
+        /* Streaming stores must be aligned, copy head in place */
+        head_size = HG_BULK_MIN(head_size, size);
+        memcpy(dest_ptr, src_ptr, head_size);
+        dest_ptr += head_size;
+        src_ptr += head_size;
+        size -= head_size;
+
+        while (size >= 64) {
+            __m128i x0 = _mm_loadu_si128((const __m128i *) src_ptr);
+            __m128i x1 = _mm_loadu_si128((const __m128i *) src_ptr + 1);
+            __m128i x2 = _mm_loadu_si128((const __m128i *) src_ptr + 2);
+            __m128i x3 = _mm_loadu_si128((const __m128i *) src_ptr + 3);
+
+            _mm_stream_si128((__m128i *) dest_ptr, x0);
+            _mm_stream_si128((__m128i *) dest_ptr + 1, x1);
+            _mm_stream_si128((__m128i *) dest_ptr + 2, x2);
+            _mm_stream_si128((__m128i *) dest_ptr + 3, x3);
+            dest_ptr += 64;
+            src_ptr += 64;
+            size -= 64;
+        }
+        /* Make streaming stores visible before completion is signaled */
+        _mm_sfence();
+
+        memcpy(dest_ptr, src_ptr, size);
+        return;
+    }
+#else
+    (void) non_temporal;
+#endif
+    memcpy(dest, src, size);
+}
+
+/*---------------------------------------------------------------------------*/
+#ifdef HG_HAS_SELF_FORWARD
+static HG_THREAD_RETURN_TYPE
+hg_bulk_copy_thread(void *arg)
+{
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+    struct hg_bulk_copy_part *hg_bulk_copy_part =
+        (struct hg_bulk_copy_part *) arg;
+    struct hg_bulk_copy *hg_bulk_copy = hg_bulk_copy_part->copy;
+
+    hg_bulk_copy_data(hg_bulk_copy_part->dest, hg_bulk_copy_part->src,
+        hg_bulk_copy_part->size, hg_bulk_copy->non_temporal);
+
+    /* Last part to complete calls NA callback */
+    if (hg_atomic_decr32(&hg_bulk_copy->pending_count) == 0) {
+        struct na_cb_info na_cb_info;
+
+        na_cb_info.arg = hg_bulk_copy->arg;
+        na_cb_info.ret = NA_SUCCESS;
+        hg_bulk_copy->callback(&na_cb_info);
+        free(hg_bulk_copy);
+    }
+
+    return thread_ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_memcpy(void *dest, const void *src, hg_size_t size, na_cb_t callback,
+    void *arg)
+{
+#ifdef HG_HAS_SELF_FORWARD
+    /* Memcpy operations are only issued with bulk op IDs */
+    struct hg_bulk_op_id *hg_bulk_op_id = (struct hg_bulk_op_id *) arg;
+    struct hg_bulk_pool *hg_bulk_pool;
+    struct hg_bulk_copy *hg_bulk_copy;
+    hg_thread_pool_t *copy_pool;
+    hg_size_t part_count = size / HG_BULK_COPY_PART_MIN, part_size;
+    hg_size_t i;
+#endif
+    hg_bool_t non_temporal = (hg_bool_t) (size >= HG_BULK_COPY_NT_MIN);
+    struct na_cb_info na_cb_info;
+
+#ifdef HG_HAS_SELF_FORWARD
+    /* Eager transfers are triggered from the caller and must complete in
+     * place, small copies are not worth handing off */
+    if (part_count < 2 || hg_bulk_op_id->eager_mode)
+        goto copy;
+
+    /* Start copy workers on first use */
+    hg_bulk_pool = hg_core_class_get_bulk_pool(hg_bulk_op_id->hg_class);
+    hg_thread_spin_lock(&hg_bulk_pool->lock);
+    copy_pool = hg_bulk_pool->copy_pool;
+    hg_thread_spin_unlock(&hg_bulk_pool->lock);
+    if (!copy_pool) {
+        hg_thread_pool_t *new_pool = NULL;
+
+        if (hg_thread_pool_init(HG_BULK_COPY_THREADS, &new_pool)
+            != HG_UTIL_SUCCESS) {
+            HG_LOG_WARNING("Could not start copy workers, copying in place");
+            goto copy;
+        }
+        hg_thread_spin_lock(&hg_bulk_pool->lock);
+        if (!hg_bulk_pool->copy_pool) {
+            hg_bulk_pool->copy_pool = new_pool;
+            new_pool = NULL;
+        }
+        copy_pool = hg_bulk_pool->copy_pool;
+        hg_thread_spin_unlock(&hg_bulk_pool->lock);
+        /* Another thread started them first */
+        if (new_pool)
+            hg_thread_pool_destroy(new_pool);
+    }
+
+    hg_bulk_copy = (struct hg_bulk_copy *) malloc(sizeof(struct hg_bulk_copy));
+    if (!hg_bulk_copy)
+        goto copy;
+    hg_bulk_copy->callback = callback;
+    hg_bulk_copy->arg = arg;
+    hg_bulk_copy->non_temporal = non_temporal;
+
+    /* Split into parts of whole cache lines, last part takes remainder */
+    part_count = HG_BULK_MIN(part_count, HG_BULK_COPY_THREADS);
+    part_size = (size / part_count) & ~((hg_size_t) 63);
+    hg_atomic_set32(&hg_bulk_copy->pending_count, (hg_util_int32_t) part_count);
+    for (i = 0; i < part_count; i++) {
+        struct hg_bulk_copy_part *hg_bulk_copy_part = &hg_bulk_copy->parts[i];
+
+        hg_bulk_copy_part->copy = hg_bulk_copy;
+        hg_bulk_copy_part->dest = (char *) dest + i * part_size;
+        hg_bulk_copy_part->src = (const char *) src + i * part_size;
+        hg_bulk_copy_part->size = (i == part_count - 1) ?
+            size - i * part_size : part_size;
+        hg_bulk_copy_part->thread_work.func = hg_bulk_copy_thread;
+        hg_bulk_copy_part->thread_work.args = hg_bulk_copy_part;
+    }
+    /* Copy may complete and be freed as soon as last part is posted */
+    for (i = 0; i < part_count; i++)
+        hg_thread_pool_post(copy_pool, &hg_bulk_copy->parts[i].thread_work);
+
+    return;
+
+copy:
+#endif
+    hg_bulk_copy_data(dest, src, size, non_temporal);
+    na_cb_info.arg = arg;
+    na_cb_info.ret = NA_SUCCESS;
+    callback(&na_cb_info);
+}
+
 /*---------------------------------------------------------------------------*/
 static int
 hg_bulk_transfer_cb(const struct na_cb_info *callback_info)
@@ -702,8 +2136,7 @@ hg_bulk_transfer_cb(const struct na_cb_info *callback_info)
     /* When all NA transfers that correspond to bulk operation complete
      * add HG user callback to completion queue
      */
-    if ((unsigned int) hg_atomic_incr32(&hg_bulk_op_id->op_completed_count)
-        == hg_bulk_op_id->op_count) {
+    if (hg_atomic_decr32(&hg_bulk_op_id->op_pending_count) == 0) {
         hg_bulk_complete(hg_bulk_op_id);
         ret++;
     }
@@ -720,8 +2153,7 @@ hg_bulk_transfer_pieces(na_bulk_op_t na_bulk_op, na_addr_t origin_addr, na_uint8
     hg_size_t origin_segment_start_index, hg_size_t origin_segment_start_offset,
     struct hg_bulk *hg_bulk_local, hg_size_t local_segment_start_index,
     hg_size_t local_segment_start_offset, hg_size_t size,
-    hg_bool_t scatter_gather, struct hg_bulk_op_id *hg_bulk_op_id,
-    unsigned int *na_op_count)
+    hg_bool_t scatter_gather, struct hg_bulk_op_id *hg_bulk_op_id)
 {
     hg_size_t origin_segment_index = origin_segment_start_index;
     hg_size_t na_origin_segment_index =
@@ -742,12 +2174,13 @@ hg_bulk_transfer_pieces(na_bulk_op_t na_bulk_op, na_addr_t origin_addr, na_uint8
 #endif
             hg_bulk_local->na_mem_handles;
     hg_size_t remaining_size = size;
-    unsigned int count = 0;
+    unsigned int count = hg_bulk_op_id->op_count;
     hg_return_t ret = HG_SUCCESS;
     na_return_t na_ret;
 
     for (;;) {
         hg_size_t origin_transfer_size, local_transfer_size;
+        hg_size_t origin_handle_offset, local_handle_offset;
         hg_size_t transfer_size = remaining_size;
 
         if (!scatter_gather) {
@@ -764,24 +2197,35 @@ hg_bulk_transfer_pieces(na_bulk_op_t na_bulk_op, na_addr_t origin_addr, na_uint8
             /* Remaining size may be smaller */
             transfer_size = HG_BULK_MIN(remaining_size, transfer_size);
         }
-
-        if (na_bulk_op) {
-            na_ret = na_bulk_op(hg_bulk_op_id->na_class,
-                hg_bulk_op_id->na_context, hg_bulk_transfer_cb, hg_bulk_op_id,
-                na_local_mem_handles[na_local_segment_index],
-                hg_bulk_local->segments[local_segment_index].address,
-                local_segment_offset,
-                na_origin_mem_handles[na_origin_segment_index],
-                hg_bulk_origin->segments[origin_segment_index].address,
-                origin_segment_offset, transfer_size, origin_addr, origin_id,
-                &hg_bulk_op_id->na_op_ids[count]);
-            if (na_ret != NA_SUCCESS) {
-                HG_LOG_ERROR("Could not transfer data");
-                ret = HG_NA_ERROR;
-                break;
-            }
-        }
+
+        /* Data of views received from remote may start at an offset in
+         * their first NA handle, addresses are shifted back accordingly */
+        origin_handle_offset = (na_origin_segment_index == 0) ?
+            hg_bulk_origin->na_mem_handle_offset : 0;
+        local_handle_offset = (na_local_segment_index == 0) ?
+            hg_bulk_local->na_mem_handle_offset : 0;
+
+        /* Operation is counted as pending before it can complete */
+        hg_atomic_incr32(&hg_bulk_op_id->op_pending_count);
+        na_ret = na_bulk_op(hg_bulk_op_id->na_class,
+            hg_bulk_op_id->na_context, hg_bulk_transfer_cb, hg_bulk_op_id,
+            na_local_mem_handles[na_local_segment_index],
+            hg_bulk_local->segments[local_segment_index].address
+                - (hg_ptr_t) local_handle_offset,
+            local_segment_offset + local_handle_offset,
+            na_origin_mem_handles[na_origin_segment_index],
+            hg_bulk_origin->segments[origin_segment_index].address
+                - (hg_ptr_t) origin_handle_offset,
+            origin_segment_offset + origin_handle_offset, transfer_size,
+            origin_addr, origin_id, &hg_bulk_op_id->na_op_ids[count]);
+        if (na_ret != NA_SUCCESS) {
+            HG_LOG_ERROR("Could not transfer data");
+            hg_atomic_decr32(&hg_bulk_op_id->op_pending_count);
+            ret = HG_NA_ERROR;
+            break;
+        }
         count++;
+        hg_bulk_op_id->op_count = count;
 
         /* Decrease remaining size from the size of data we transferred
          * and exit if everything has been transferred */
@@ -810,50 +2254,50 @@ hg_bulk_transfer_pieces(na_bulk_op_t na_bulk_op, na_addr_t origin_addr, na_uint8
         }
     }
 
-    /* Set number of NA operations issued */
-    if (na_op_count)
-        *na_op_count = count;
-
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
-    hg_bulk_op_t op, struct hg_addr *origin_addr, hg_uint8_t origin_id,
-    struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
-    struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_size_t size,
-    hg_op_id_t *op_id)
+hg_bulk_range_prepare(hg_bulk_op_t op, hg_bool_t is_self, hg_bool_t use_sm,
+    hg_bool_t scatter_gather, struct hg_bulk_range *hg_bulk_range)
 {
-    hg_uint32_t origin_segment_start_index = 0, local_segment_start_index = 0;
-    hg_size_t origin_segment_start_offset = origin_offset,
-        local_segment_start_offset = local_offset;
-    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
-    na_bulk_op_t na_bulk_op;
-    na_addr_t na_origin_addr = HG_Core_addr_get_na(origin_addr);
-    na_class_t *na_class = HG_Core_class_get_na(hg_bulk_origin->hg_class);
-    na_context_t *na_context = HG_Core_context_get_na(context);
-    hg_bool_t use_sm = HG_FALSE;
-#ifdef HG_HAS_SM_ROUTING
-    na_class_t *na_sm_class = HG_Core_class_get_na_sm(hg_bulk_origin->hg_class);
-    na_context_t *na_sm_context = HG_Core_context_get_na_sm(context);
-#endif
-    na_class_t *na_origin_addr_class = HG_Core_addr_get_na_class(origin_addr);
-    hg_bool_t is_self = NA_Addr_is_self(na_origin_addr_class, na_origin_addr);
-    hg_bool_t scatter_gather =
-        (na_class->mem_handle_create_segments && !is_self) ? HG_TRUE : HG_FALSE;
+    struct hg_bulk *hg_bulk_origin = hg_bulk_range->hg_bulk_origin;
+    struct hg_bulk *hg_bulk_local = hg_bulk_range->hg_bulk_local;
+    hg_size_t origin_offset = hg_bulk_range->origin_offset;
+    hg_size_t local_offset = hg_bulk_range->local_offset;
+    hg_size_t size = hg_bulk_range->size;
+    hg_bool_t eager_push = HG_FALSE;
     hg_return_t ret = HG_SUCCESS;
-    unsigned int i;
+
+    /* Views are transferred through the handle they view */
+    if (hg_bulk_origin->parent) {
+        origin_offset += hg_bulk_origin->view_offset;
+        hg_bulk_origin = hg_bulk_origin->parent;
+    }
+    if (hg_bulk_local->parent) {
+        local_offset += hg_bulk_local->view_offset;
+        hg_bulk_local = hg_bulk_local->parent;
+    }
 
     /* Map op to NA op */
     switch (op) {
         case HG_BULK_PUSH:
-            na_bulk_op = (is_self) ? hg_bulk_memcpy_put : hg_bulk_na_put;
+            hg_bulk_range->na_bulk_op = (is_self) ? hg_bulk_memcpy_put :
+                hg_bulk_na_put;
+#ifdef HG_HAS_EAGER_BULK
+            /* Small pushes to the RPC origin are sent back with the
+             * response instead of being transferred */
+            if (hg_bulk_origin->eager_push && !is_self)
+                eager_push = hg_bulk_eager_push_add(hg_bulk_origin,
+                    origin_offset, hg_bulk_local, local_offset, size);
+#endif
             break;
         case HG_BULK_PULL:
             /* Eager mode can only be used when data is pulled from origin */
-            na_bulk_op = (is_self || hg_bulk_origin->eager_mode) ?
-                hg_bulk_memcpy_get : hg_bulk_na_get;
+            hg_bulk_range->na_bulk_op =
+                (is_self || hg_bulk_origin->eager_mode) ?
+                    hg_bulk_memcpy_get : hg_bulk_na_get;
             if (hg_bulk_origin->eager_mode) /* Force scatter gather to false */
                 scatter_gather = HG_FALSE;
             break;
@@ -863,25 +2307,117 @@ hg_bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
             goto done;
     }
 
-    /* Allocate op_id */
-    hg_bulk_op_id = (struct hg_bulk_op_id *) malloc(
-        sizeof(struct hg_bulk_op_id));
+    /* Memory is registered with the NA class used on first transfer */
+    if (!is_self && !eager_push && !hg_bulk_origin->eager_mode) {
+        hg_uint8_t na_flag = use_sm ? HG_BULK_SERIALIZE_SM :
+            HG_BULK_SERIALIZE_NA;
+
+        ret = hg_bulk_register(hg_bulk_local, na_flag, HG_FALSE);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not register local bulk handle");
+            goto done;
+        }
+        ret = hg_bulk_register(hg_bulk_origin, na_flag, HG_FALSE);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not register origin bulk handle");
+            goto done;
+        }
+    }
+
+    /* Bound number of NA operations by the number of segments spanned on
+     * each side, pieces are then counted while being issued */
+    if (eager_push)
+        hg_bulk_range->na_op_count = 0;
+    else if (scatter_gather || !size)
+        hg_bulk_range->na_op_count = 1;
+    else {
+        hg_uint32_t origin_segment_start_index, local_segment_start_index,
+            origin_segment_end_index, local_segment_end_index;
+        hg_size_t segment_offset;
+
+        hg_bulk_offset_translate(hg_bulk_origin, origin_offset,
+            &origin_segment_start_index, &segment_offset);
+        hg_bulk_offset_translate(hg_bulk_local, local_offset,
+            &local_segment_start_index, &segment_offset);
+        hg_bulk_offset_translate(hg_bulk_origin, origin_offset + size - 1,
+            &origin_segment_end_index, &segment_offset);
+        hg_bulk_offset_translate(hg_bulk_local, local_offset + size - 1,
+            &local_segment_end_index, &segment_offset);
+        hg_bulk_range->na_op_count =
+            (origin_segment_end_index - origin_segment_start_index)
+            + (local_segment_end_index - local_segment_start_index) + 1;
+    }
+
+    hg_bulk_range->hg_bulk_origin = hg_bulk_origin;
+    hg_bulk_range->origin_offset = origin_offset;
+    hg_bulk_range->hg_bulk_local = hg_bulk_local;
+    hg_bulk_range->local_offset = local_offset;
+    hg_bulk_range->scatter_gather = scatter_gather;
+    hg_bulk_range->eager_push = eager_push;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_range_issue(struct hg_bulk_op_id *hg_bulk_op_id,
+    na_addr_t na_origin_addr, hg_uint8_t origin_id, hg_bool_t use_sm,
+    const struct hg_bulk_range *hg_bulk_range)
+{
+    hg_uint32_t origin_segment_start_index = 0, local_segment_start_index = 0;
+    hg_size_t origin_segment_start_offset = hg_bulk_range->origin_offset,
+        local_segment_start_offset = hg_bulk_range->local_offset;
+
+    /* Data has already been copied for eager push */
+    if (hg_bulk_range->eager_push)
+        return HG_SUCCESS;
+
+    /* Translate bulk_offset */
+    if (hg_bulk_range->origin_offset && !hg_bulk_range->scatter_gather)
+        hg_bulk_offset_translate(hg_bulk_range->hg_bulk_origin,
+            hg_bulk_range->origin_offset, &origin_segment_start_index,
+            &origin_segment_start_offset);
+
+    /* Translate block offset */
+    if (hg_bulk_range->local_offset && !hg_bulk_range->scatter_gather)
+        hg_bulk_offset_translate(hg_bulk_range->hg_bulk_local,
+            hg_bulk_range->local_offset, &local_segment_start_index,
+            &local_segment_start_offset);
+
+    return hg_bulk_transfer_pieces(hg_bulk_range->na_bulk_op, na_origin_addr,
+        origin_id, use_sm, hg_bulk_range->hg_bulk_origin,
+        origin_segment_start_index, origin_segment_start_offset,
+        hg_bulk_range->hg_bulk_local, local_segment_start_index,
+        local_segment_start_offset, hg_bulk_range->size,
+        hg_bulk_range->scatter_gather, hg_bulk_op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_bulk_op_id *
+hg_bulk_transfer_op_id_alloc(hg_context_t *context, hg_cb_t callback,
+    void *arg, hg_bulk_op_t op, struct hg_class *hg_class, hg_bool_t use_sm,
+    unsigned int na_op_count)
+{
+    struct hg_bulk_op_id *hg_bulk_op_id;
+
+    hg_bulk_op_id = hg_bulk_op_id_alloc(context, na_op_count);
     if (!hg_bulk_op_id) {
         HG_LOG_ERROR("Could not allocate HG Bulk operation ID");
-        ret = HG_NOMEM_ERROR;
-        goto done;
+        return NULL;
     }
-    hg_bulk_op_id->hg_class = hg_bulk_origin->hg_class;
+    hg_bulk_op_id->hg_class = hg_class;
     hg_bulk_op_id->context = context;
 #ifdef HG_HAS_SM_ROUTING
-    if (na_sm_class == na_origin_addr_class) {
-        hg_bulk_op_id->na_class = na_sm_class;
-        hg_bulk_op_id->na_context = na_sm_context;
-        use_sm = HG_TRUE;
+    if (use_sm) {
+        hg_bulk_op_id->na_class = HG_Core_class_get_na_sm(hg_class);
+        hg_bulk_op_id->na_context = HG_Core_context_get_na_sm(context);
     } else {
+#else
+    (void) use_sm;
 #endif
-        hg_bulk_op_id->na_class = na_class;
-        hg_bulk_op_id->na_context = na_context;
+        hg_bulk_op_id->na_class = HG_Core_class_get_na(hg_class);
+        hg_bulk_op_id->na_context = HG_Core_context_get_na(context);
 #ifdef HG_HAS_SM_ROUTING
     }
 #endif
@@ -889,108 +2425,570 @@ hg_bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
     hg_bulk_op_id->arg = arg;
     hg_atomic_set32(&hg_bulk_op_id->completed, 0);
     hg_atomic_set32(&hg_bulk_op_id->canceled, 0);
-    hg_bulk_op_id->op_count = 1; /* Default */
-    hg_atomic_set32(&hg_bulk_op_id->op_completed_count, 0);
+    hg_bulk_op_id->op_count = 0;
+    /* Hold one pending count while operations are being issued */
+    hg_atomic_set32(&hg_bulk_op_id->op_pending_count, 1);
     hg_bulk_op_id->op = op;
+    hg_bulk_op_id->stream = NULL;
+    hg_bulk_op_id->batch = NULL;
+    hg_bulk_op_id->batch_count = 0;
+
+    return hg_bulk_op_id;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_issued(struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Release pending count held while issuing */
+    if (hg_atomic_decr32(&hg_bulk_op_id->op_pending_count) == 0) {
+        ret = hg_bulk_complete(hg_bulk_op_id);
+        if (ret != HG_SUCCESS)
+            HG_LOG_ERROR("Could not complete bulk operation");
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_op_t op, struct hg_addr *origin_addr, hg_uint8_t origin_id,
+    struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
+    struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_size_t size,
+    hg_op_id_t *op_id)
+{
+    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    struct hg_bulk_range hg_bulk_range;
+    na_addr_t na_origin_addr = HG_Core_addr_get_na(origin_addr);
+    na_class_t *na_class = HG_Core_class_get_na(hg_bulk_origin->hg_class);
+    hg_bool_t use_sm = HG_FALSE;
+#ifdef HG_HAS_SM_ROUTING
+    na_class_t *na_sm_class = HG_Core_class_get_na_sm(hg_bulk_origin->hg_class);
+#endif
+    na_class_t *na_origin_addr_class = HG_Core_addr_get_na_class(origin_addr);
+    hg_bool_t is_self = NA_Addr_is_self(na_origin_addr_class, na_origin_addr);
+    hg_bool_t scatter_gather =
+        (na_class->mem_handle_create_segments && !is_self) ? HG_TRUE : HG_FALSE;
+    hg_return_t ret = HG_SUCCESS, complete_ret;
+
+#ifdef HG_HAS_SM_ROUTING
+    use_sm = (hg_bool_t) (na_sm_class && na_sm_class == na_origin_addr_class);
+#endif
+
+    hg_bulk_range.hg_bulk_origin = hg_bulk_origin;
+    hg_bulk_range.origin_offset = origin_offset;
+    hg_bulk_range.hg_bulk_local = hg_bulk_local;
+    hg_bulk_range.local_offset = local_offset;
+    hg_bulk_range.size = size;
+    ret = hg_bulk_range_prepare(op, is_self, use_sm, scatter_gather,
+        &hg_bulk_range);
+    if (ret != HG_SUCCESS)
+        goto done;
+    hg_bulk_origin = hg_bulk_range.hg_bulk_origin;
+    hg_bulk_local = hg_bulk_range.hg_bulk_local;
+
+    /* Get op_id */
+    hg_bulk_op_id = hg_bulk_transfer_op_id_alloc(context, callback, arg, op,
+        hg_bulk_origin->hg_class, use_sm, hg_bulk_range.na_op_count);
+    if (!hg_bulk_op_id) {
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    hg_bulk_op_id->size = size;
     hg_bulk_op_id->hg_bulk_origin = hg_bulk_origin;
     hg_atomic_incr32(&hg_bulk_origin->ref_count); /* Increment ref count */
     hg_bulk_op_id->hg_bulk_local = hg_bulk_local;
     hg_atomic_incr32(&hg_bulk_local->ref_count); /* Increment ref count */
-    hg_bulk_op_id->na_op_ids = NULL;
-    hg_bulk_op_id->is_self = is_self;
+    hg_bulk_op_id->eager_mode = hg_bulk_origin->eager_mode;
+    /* Data has already been copied for eager push */
+    hg_bulk_op_id->is_self = is_self || hg_bulk_range.eager_push;
 
-    /* Translate bulk_offset */
-    if (origin_offset && !scatter_gather)
-        hg_bulk_offset_translate(hg_bulk_origin, origin_offset,
-            &origin_segment_start_index, &origin_segment_start_offset);
+    /* Assign op_id */
+    if (op_id && op_id != HG_OP_ID_IGNORE) *op_id = (hg_op_id_t) hg_bulk_op_id;
 
-    /* Translate block offset */
-    if (local_offset && !scatter_gather)
-        hg_bulk_offset_translate(hg_bulk_local, local_offset,
-            &local_segment_start_index, &local_segment_start_offset);
-
-    /* Figure out number of NA operations required */
-    if (!scatter_gather) {
-        hg_bulk_transfer_pieces(NULL, NA_ADDR_NULL, origin_id, use_sm, hg_bulk_origin,
-            origin_segment_start_index, origin_segment_start_offset,
-            hg_bulk_local, local_segment_start_index,
-            local_segment_start_offset, size, HG_FALSE, NULL,
-            &hg_bulk_op_id->op_count);
+    /* Do actual transfer */
+    ret = hg_bulk_range_issue(hg_bulk_op_id, na_origin_addr, origin_id,
+        use_sm, &hg_bulk_range);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not transfer data pieces");
+        if (!hg_bulk_op_id->op_count) {
+            hg_bulk_free(hg_bulk_origin);
+            hg_bulk_free(hg_bulk_local);
+            hg_bulk_op_id_release(hg_bulk_op_id);
+            goto done;
+        }
+        /* Let issued operations complete without notifying user */
+        hg_bulk_op_id->callback = NULL;
+    }
+
+    complete_ret = hg_bulk_transfer_issued(hg_bulk_op_id);
+    if (complete_ret != HG_SUCCESS)
+        ret = complete_ret;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_batch(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_op_t op, struct hg_addr *origin_addr, hg_uint8_t origin_id,
+    const struct hg_bulk_transfer_desc *descs, hg_uint32_t count,
+    hg_op_id_t *op_id)
+{
+    struct hg_bulk *hg_bulk_first = (struct hg_bulk *) descs[0].origin_handle;
+    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    struct hg_bulk_range *hg_bulk_ranges = NULL;
+    na_addr_t na_origin_addr = HG_Core_addr_get_na(origin_addr);
+    na_class_t *na_class = HG_Core_class_get_na(hg_bulk_first->hg_class);
+    hg_bool_t use_sm = HG_FALSE;
+#ifdef HG_HAS_SM_ROUTING
+    na_class_t *na_sm_class = HG_Core_class_get_na_sm(hg_bulk_first->hg_class);
+#endif
+    na_class_t *na_origin_addr_class = HG_Core_addr_get_na_class(origin_addr);
+    hg_bool_t is_self = NA_Addr_is_self(na_origin_addr_class, na_origin_addr);
+    hg_bool_t scatter_gather =
+        (na_class->mem_handle_create_segments && !is_self) ? HG_TRUE : HG_FALSE;
+    hg_bool_t eager_mode = HG_TRUE;
+    unsigned int na_op_count = 0;
+    hg_size_t size = 0;
+    hg_return_t ret = HG_SUCCESS, complete_ret;
+    hg_uint32_t i;
+
+#ifdef HG_HAS_SM_ROUTING
+    use_sm = (hg_bool_t) (na_sm_class && na_sm_class == na_origin_addr_class);
+#endif
+
+    hg_bulk_ranges = (struct hg_bulk_range *) malloc(
+        count * sizeof(struct hg_bulk_range));
+    if (!hg_bulk_ranges) {
+        HG_LOG_ERROR("Could not allocate HG Bulk batch");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+
+    /* Prepare all ranges first so that NA operations can be accounted for
+     * with a single op ID */
+    for (i = 0; i < count; i++) {
+        hg_bulk_ranges[i].hg_bulk_origin =
+            (struct hg_bulk *) descs[i].origin_handle;
+        hg_bulk_ranges[i].origin_offset = descs[i].origin_offset;
+        hg_bulk_ranges[i].hg_bulk_local =
+            (struct hg_bulk *) descs[i].local_handle;
+        hg_bulk_ranges[i].local_offset = descs[i].local_offset;
+        hg_bulk_ranges[i].size = descs[i].size;
+        ret = hg_bulk_range_prepare(op, is_self, use_sm, scatter_gather,
+            &hg_bulk_ranges[i]);
+        if (ret != HG_SUCCESS)
+            goto done;
+        na_op_count += hg_bulk_ranges[i].na_op_count;
+        size += descs[i].size;
+        if (!hg_bulk_ranges[i].hg_bulk_origin->eager_mode)
+            eager_mode = HG_FALSE;
+    }
+
+    /* Get op_id */
+    hg_bulk_op_id = hg_bulk_transfer_op_id_alloc(context, callback, arg, op,
+        hg_bulk_first->hg_class, use_sm, na_op_count);
+    if (!hg_bulk_op_id) {
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    hg_bulk_op_id->size = size;
+    hg_bulk_op_id->hg_bulk_origin = NULL;
+    hg_bulk_op_id->hg_bulk_local = NULL;
+    hg_bulk_op_id->batch = hg_bulk_ranges;
+    hg_bulk_op_id->batch_count = count;
+    for (i = 0; i < count; i++) {
+        hg_atomic_incr32(&hg_bulk_ranges[i].hg_bulk_origin->ref_count);
+        hg_atomic_incr32(&hg_bulk_ranges[i].hg_bulk_local->ref_count);
+    }
+    hg_bulk_op_id->eager_mode = eager_mode;
+    /* No NA progress to wake up if all data has already been copied */
+    hg_bulk_op_id->is_self = is_self || !na_op_count;
+    hg_bulk_ranges = NULL;
+
+    /* Assign op_id */
+    if (op_id && op_id != HG_OP_ID_IGNORE) *op_id = (hg_op_id_t) hg_bulk_op_id;
+
+    /* Issue ranges back to back */
+    for (i = 0; i < count; i++) {
+        ret = hg_bulk_range_issue(hg_bulk_op_id, na_origin_addr, origin_id,
+            use_sm, &hg_bulk_op_id->batch[i]);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not transfer data pieces");
+            break;
+        }
+    }
+    if (ret != HG_SUCCESS) {
         if (!hg_bulk_op_id->op_count) {
-            HG_LOG_ERROR("Could not get bulk op_count");
+            hg_bulk_batch_free(hg_bulk_op_id);
+            hg_bulk_op_id_release(hg_bulk_op_id);
+            goto done;
+        }
+        /* Let issued operations complete without notifying user */
+        hg_bulk_op_id->callback = NULL;
+    }
+
+    complete_ret = hg_bulk_transfer_issued(hg_bulk_op_id);
+    if (complete_ret != HG_SUCCESS)
+        ret = complete_ret;
+
+done:
+    free(hg_bulk_ranges);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_batch_free(struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    hg_uint32_t i;
+
+    for (i = 0; i < hg_bulk_op_id->batch_count; i++) {
+        if (hg_bulk_free(hg_bulk_op_id->batch[i].hg_bulk_origin)
+            != HG_SUCCESS)
+            HG_LOG_ERROR("Could not free bulk handle");
+        if (hg_bulk_free(hg_bulk_op_id->batch[i].hg_bulk_local)
+            != HG_SUCCESS)
+            HG_LOG_ERROR("Could not free bulk handle");
+    }
+    free(hg_bulk_op_id->batch);
+    hg_bulk_op_id->batch = NULL;
+    hg_bulk_op_id->batch_count = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_complete(struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    hg_context_t *context = hg_bulk_op_id->context;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Mark operation as completed */
+    hg_atomic_incr32(&hg_bulk_op_id->completed);
+
+    if (hg_bulk_op_id->eager_mode) {
+        /* In the case of eager bulk transfer, directly trigger the operation
+         * to avoid potential deadlocks */
+        ret = hg_bulk_trigger_entry(hg_bulk_op_id);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not trigger completion entry");
+            goto done;
+        }
+    } else {
+        struct hg_completion_entry *hg_completion_entry =
+            &hg_bulk_op_id->hg_completion_entry;
+
+        hg_completion_entry->op_type = HG_BULK;
+        hg_completion_entry->op_id.hg_bulk_op_id = hg_bulk_op_id;
+
+        ret = hg_core_completion_add(context, hg_completion_entry,
+            hg_bulk_op_id->is_self);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not add HG completion entry to completion queue");
+            goto done;
+        }
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_check(hg_bulk_op_t op, struct hg_bulk *hg_bulk_origin,
+    struct hg_bulk *hg_bulk_local, hg_size_t size)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_bulk_origin || !hg_bulk_local) {
+        HG_LOG_ERROR("NULL memory handle passed");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    if (!size) {
+        HG_LOG_ERROR("Transfer size must be non-zero");
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+
+    if (size > hg_bulk_origin->total_size) {
+        HG_LOG_ERROR("Exceeding size of memory exposed by origin handle");
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+
+    if (size > hg_bulk_local->total_size) {
+        HG_LOG_ERROR("Exceeding size of memory exposed by local handle");
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+
+    switch (op) {
+        case HG_BULK_PUSH:
+            if (!(hg_bulk_origin->flags & HG_BULK_WRITE_ONLY)
+                || !(hg_bulk_local->flags & HG_BULK_READ_ONLY)) {
+                HG_LOG_ERROR("Invalid permission flags for PUSH operation "
+                    "(origin=%d, local=%d)", hg_bulk_origin->flags,
+                    hg_bulk_local->flags);
+                ret = HG_INVALID_PARAM;
+                goto done;
+            }
+            break;
+        case HG_BULK_PULL:
+            if (!(hg_bulk_origin->flags & HG_BULK_READ_ONLY)
+                || !(hg_bulk_local->flags & HG_BULK_WRITE_ONLY)) {
+                HG_LOG_ERROR("Invalid permission flags for PULL operation "
+                    "(origin=%d, local=%d)", hg_bulk_origin->flags,
+                    hg_bulk_local->flags);
+                ret = HG_INVALID_PARAM;
+                goto done;
+            }
+            break;
+        default:
+            HG_LOG_ERROR("Unknown bulk operation");
             ret = HG_INVALID_PARAM;
             goto done;
-        }
-    }
-
-    /* Allocate memory for NA operation IDs */
-    hg_bulk_op_id->na_op_ids = malloc(sizeof(na_op_id_t) * hg_bulk_op_id->op_count);
-    if (!hg_bulk_op_id->na_op_ids) {
-        HG_LOG_ERROR("Could not allocate memory for op_ids");
-        ret = HG_NOMEM_ERROR;
-        goto done;
-    }
-    for (i = 0; i < hg_bulk_op_id->op_count; i++)
-        hg_bulk_op_id->na_op_ids[i] = NA_OP_ID_NULL;
-
-    /* Assign op_id */
-    if (op_id && op_id != HG_OP_ID_IGNORE) *op_id = (hg_op_id_t) hg_bulk_op_id;
-
-    /* Do actual transfer */
-    ret = hg_bulk_transfer_pieces(na_bulk_op, na_origin_addr, origin_id, use_sm,
-        hg_bulk_origin, origin_segment_start_index, origin_segment_start_offset,
-        hg_bulk_local, local_segment_start_index, local_segment_start_offset,
-        size, scatter_gather, hg_bulk_op_id, NULL);
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not transfer data pieces");
-        goto done;
     }
 
 done:
-    if (ret != HG_SUCCESS && hg_bulk_op_id) {
-        free(hg_bulk_op_id->na_op_ids);
-        free(hg_bulk_op_id);
-    }
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_bulk_complete(struct hg_bulk_op_id *hg_bulk_op_id)
+hg_bulk_stream_issue(struct hg_bulk_stream *hg_bulk_stream)
 {
-    hg_context_t *context = hg_bulk_op_id->context;
+    struct hg_bulk_op_id *hg_bulk_op_id = hg_bulk_stream->hg_bulk_op_id;
     hg_return_t ret = HG_SUCCESS;
 
-    /* Mark operation as completed */
-    hg_atomic_incr32(&hg_bulk_op_id->completed);
+    while (!hg_bulk_stream->canceled
+        && hg_bulk_stream->next_issue < hg_bulk_stream->chunk_count) {
+        struct hg_bulk_stream_chunk *hg_bulk_stream_chunk;
+        hg_size_t index = hg_bulk_stream->next_issue, chunk_offset, chunk_size;
+        hg_op_id_t chunk_op_id = HG_OP_ID_NULL;
+        unsigned int slot;
+
+        /* Ordered chunks use the slot of their index, which is free as long
+         * as less than window chunks are waiting to be delivered */
+        if (hg_bulk_stream->ordered) {
+            if (index - hg_bulk_stream->delivered >= hg_bulk_stream->window)
+                break;
+            slot = (unsigned int) (index % hg_bulk_stream->window);
+        } else {
+            if (!hg_bulk_stream->free_count)
+                break;
+            slot = hg_bulk_stream->free_slots[--hg_bulk_stream->free_count];
+        }
+        hg_bulk_stream_chunk = &hg_bulk_stream->chunks[slot];
+        hg_bulk_stream_chunk->index = index;
+        hg_bulk_stream_chunk->op_id = HG_OP_ID_NULL;
+        hg_bulk_stream_chunk->completed = HG_FALSE;
+        hg_bulk_stream->next_issue++;
+        hg_bulk_stream->in_flight++;
+
+        chunk_offset = index * hg_bulk_stream->chunk_size;
+        chunk_size = HG_BULK_MIN(hg_bulk_stream->chunk_size,
+            hg_bulk_op_id->size - chunk_offset);
+
+        /* Chunk may complete (and issue next ones) before transfer returns,
+         * stream cannot finish meanwhile as this chunk is in flight */
+        hg_thread_mutex_unlock(&hg_bulk_stream->mutex);
+        ret = hg_bulk_transfer(hg_bulk_op_id->context, hg_bulk_stream_chunk_cb,
+            hg_bulk_stream_chunk, hg_bulk_op_id->op,
+            hg_bulk_stream->origin_addr, hg_bulk_stream->origin_id,
+            hg_bulk_op_id->hg_bulk_origin,
+            hg_bulk_stream->origin_offset + chunk_offset,
+            hg_bulk_op_id->hg_bulk_local,
+            hg_bulk_stream->local_offset + chunk_offset, chunk_size,
+            &chunk_op_id);
+        hg_thread_mutex_lock(&hg_bulk_stream->mutex);
 
-    if (hg_bulk_op_id->hg_bulk_origin->eager_mode) {
-        /* In the case of eager bulk transfer, directly trigger the operation
-         * to avoid potential deadlocks */
-        ret = hg_bulk_trigger_entry(hg_bulk_op_id);
         if (ret != HG_SUCCESS) {
-            HG_LOG_ERROR("Could not trigger completion entry");
-            goto done;
+            HG_LOG_ERROR("Could not transfer chunk");
+            hg_bulk_stream_chunk->completed = HG_TRUE;
+            if (!hg_bulk_stream->ordered)
+                hg_bulk_stream->free_slots[hg_bulk_stream->free_count++] = slot;
+            hg_bulk_stream->in_flight--;
+            if (hg_bulk_stream->ret == HG_SUCCESS)
+                hg_bulk_stream->ret = ret;
+            hg_bulk_stream->canceled = HG_TRUE;
+            hg_bulk_stream_cancel_chunks(hg_bulk_stream);
+            break;
         }
-    } else {
-        struct hg_completion_entry *hg_completion_entry =
-            &hg_bulk_op_id->hg_completion_entry;
 
-        hg_completion_entry->op_type = HG_BULK;
-        hg_completion_entry->op_id.hg_bulk_op_id = hg_bulk_op_id;
+        /* Slot may have been reused if chunk already completed */
+        if (hg_bulk_stream_chunk->index == index
+            && !hg_bulk_stream_chunk->completed) {
+            hg_bulk_stream_chunk->op_id = chunk_op_id;
+            if (hg_bulk_stream->canceled)
+                HG_Bulk_cancel(chunk_op_id);
+        }
+    }
 
-        ret = hg_core_completion_add(context, hg_completion_entry,
-            hg_bulk_op_id->is_self);
-        if (ret != HG_SUCCESS) {
-            HG_LOG_ERROR("Could not add HG completion entry to completion queue");
-            goto done;
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_stream_deliver(struct hg_bulk_stream *hg_bulk_stream,
+    struct hg_bulk_stream_chunk *hg_bulk_stream_chunk)
+{
+    struct hg_bulk_op_id *hg_bulk_op_id = hg_bulk_stream->hg_bulk_op_id;
+    struct hg_cb_info hg_cb_info;
+    hg_size_t chunk_offset =
+        hg_bulk_stream_chunk->index * hg_bulk_stream->chunk_size;
+
+    hg_cb_info.arg = hg_bulk_op_id->arg;
+    hg_cb_info.ret = HG_SUCCESS;
+    hg_cb_info.type = HG_CB_BULK;
+    hg_cb_info.info.bulk.op = hg_bulk_op_id->op;
+    hg_cb_info.info.bulk.origin_handle =
+        (hg_bulk_t) hg_bulk_op_id->hg_bulk_origin;
+    hg_cb_info.info.bulk.local_handle =
+        (hg_bulk_t) hg_bulk_op_id->hg_bulk_local;
+    hg_cb_info.info.bulk.offset = chunk_offset;
+    hg_cb_info.info.bulk.size = HG_BULK_MIN(hg_bulk_stream->chunk_size,
+        hg_bulk_op_id->size - chunk_offset);
+
+    hg_bulk_stream->chunk_callback(&hg_cb_info);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_stream_chunk_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_bulk_stream_chunk *hg_bulk_stream_chunk =
+        (struct hg_bulk_stream_chunk *) callback_info->arg;
+    struct hg_bulk_stream *hg_bulk_stream = hg_bulk_stream_chunk->stream;
+    struct hg_bulk_op_id *hg_bulk_op_id = hg_bulk_stream->hg_bulk_op_id;
+    hg_bool_t finish;
+    hg_return_t ret;
+
+    hg_thread_mutex_lock(&hg_bulk_stream->mutex);
+
+    hg_bulk_stream_chunk->completed = HG_TRUE;
+    hg_bulk_stream->in_flight--;
+
+    /* Failed chunk stops the stream */
+    if (callback_info->ret != HG_SUCCESS && !hg_bulk_stream->canceled) {
+        hg_bulk_stream->ret = callback_info->ret;
+        hg_bulk_stream->canceled = HG_TRUE;
+        hg_bulk_stream_cancel_chunks(hg_bulk_stream);
+    }
+
+    if (hg_bulk_stream->ordered) {
+        /* Only one caller delivers at a time so that chunk callbacks are
+         * executed in order, others leave their chunk to it */
+        if (!hg_bulk_stream->delivering) {
+            hg_bulk_stream->delivering++;
+            while (!hg_bulk_stream->canceled
+                && hg_bulk_stream->delivered < hg_bulk_stream->next_issue) {
+                struct hg_bulk_stream_chunk *next = &hg_bulk_stream->chunks[
+                    hg_bulk_stream->delivered % hg_bulk_stream->window];
+
+                if (!next->completed)
+                    break;
+                hg_thread_mutex_unlock(&hg_bulk_stream->mutex);
+                hg_bulk_stream_deliver(hg_bulk_stream, next);
+                hg_thread_mutex_lock(&hg_bulk_stream->mutex);
+                hg_bulk_stream->delivered++;
+            }
+            hg_bulk_stream->delivering--;
+        }
+    } else {
+        if (!hg_bulk_stream->canceled) {
+            hg_bulk_stream->delivering++;
+            hg_thread_mutex_unlock(&hg_bulk_stream->mutex);
+            hg_bulk_stream_deliver(hg_bulk_stream, hg_bulk_stream_chunk);
+            hg_thread_mutex_lock(&hg_bulk_stream->mutex);
+            hg_bulk_stream->delivering--;
+            hg_bulk_stream->delivered++;
         }
+        hg_bulk_stream->free_slots[hg_bulk_stream->free_count++] =
+            (unsigned int) (hg_bulk_stream_chunk - hg_bulk_stream->chunks);
     }
 
-done:
+    /* Refill window */
+    ret = hg_bulk_stream_issue(hg_bulk_stream);
+
+    finish = hg_bulk_stream_check_finish(hg_bulk_stream);
+    hg_thread_mutex_unlock(&hg_bulk_stream->mutex);
+
+    /* Stream may be freed once completed */
+    if (finish)
+        hg_bulk_complete(hg_bulk_op_id);
+
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_stream_cancel_chunks(struct hg_bulk_stream *hg_bulk_stream)
+{
+    unsigned int i;
+
+    for (i = 0; i < hg_bulk_stream->window; i++) {
+        struct hg_bulk_stream_chunk *hg_bulk_stream_chunk =
+            &hg_bulk_stream->chunks[i];
+
+        if (!hg_bulk_stream_chunk->completed
+            && hg_bulk_stream_chunk->op_id != HG_OP_ID_NULL)
+            HG_Bulk_cancel(hg_bulk_stream_chunk->op_id);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_bulk_stream_check_finish(struct hg_bulk_stream *hg_bulk_stream)
+{
+    if (hg_bulk_stream->finished || hg_bulk_stream->in_flight
+        || hg_bulk_stream->delivering)
+        return HG_FALSE;
+    if (!hg_bulk_stream->canceled
+        && hg_bulk_stream->delivered < hg_bulk_stream->chunk_count)
+        return HG_FALSE;
+
+    hg_bulk_stream->finished = HG_TRUE;
+    return HG_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_stream_cancel(struct hg_bulk_stream *hg_bulk_stream)
+{
+    struct hg_bulk_op_id *hg_bulk_op_id = hg_bulk_stream->hg_bulk_op_id;
+    hg_bool_t finish;
+
+    hg_thread_mutex_lock(&hg_bulk_stream->mutex);
+    if (!hg_bulk_stream->canceled) {
+        hg_bulk_stream->canceled = HG_TRUE;
+        hg_atomic_set32(&hg_bulk_op_id->canceled, 1);
+        hg_bulk_stream_cancel_chunks(hg_bulk_stream);
+    }
+    finish = hg_bulk_stream_check_finish(hg_bulk_stream);
+    hg_thread_mutex_unlock(&hg_bulk_stream->mutex);
+
+    return finish ? hg_bulk_complete(hg_bulk_op_id) : HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_stream_free(struct hg_bulk_stream *hg_bulk_stream)
+{
+    HG_Core_addr_free(hg_bulk_stream->hg_bulk_op_id->hg_class,
+        hg_bulk_stream->origin_addr);
+    hg_thread_mutex_destroy(&hg_bulk_stream->mutex);
+    free(hg_bulk_stream->free_slots);
+    free(hg_bulk_stream->chunks);
+    free(hg_bulk_stream);
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 hg_bulk_trigger_entry(struct hg_bulk_op_id *hg_bulk_op_id)
@@ -1011,25 +3009,107 @@ hg_bulk_trigger_entry(struct hg_bulk_op_id *hg_bulk_op_id)
             (hg_bulk_t) hg_bulk_op_id->hg_bulk_origin;
         hg_cb_info.info.bulk.local_handle =
             (hg_bulk_t) hg_bulk_op_id->hg_bulk_local;
+        hg_cb_info.info.bulk.offset = 0;
+        hg_cb_info.info.bulk.size = hg_bulk_op_id->size;
+        if (hg_bulk_op_id->stream && hg_bulk_op_id->stream->ret != HG_SUCCESS)
+            hg_cb_info.ret = hg_bulk_op_id->stream->ret;
 
         hg_bulk_op_id->callback(&hg_cb_info);
     }
 
+    /* Stream is done once its op ID is triggered */
+    if (hg_bulk_op_id->stream)
+        hg_bulk_stream_free(hg_bulk_op_id->stream);
+
     /* Decrement ref_count */
-    ret = hg_bulk_free(hg_bulk_op_id->hg_bulk_origin);
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not free bulk handle");
-        goto done;
-    }
-    ret = hg_bulk_free(hg_bulk_op_id->hg_bulk_local);
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not free bulk handle");
-        goto done;
+    if (hg_bulk_op_id->batch)
+        hg_bulk_batch_free(hg_bulk_op_id);
+    else {
+        ret = hg_bulk_free(hg_bulk_op_id->hg_bulk_origin);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not free bulk handle");
+            goto done;
+        }
+        ret = hg_bulk_free(hg_bulk_op_id->hg_bulk_local);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not free bulk handle");
+            goto done;
+        }
     }
 
-    /* Free op */
-    free(hg_bulk_op_id->na_op_ids);
-    free(hg_bulk_op_id);
+    /* Release op */
+    hg_bulk_op_id_release(hg_bulk_op_id);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+hg_bulk_eager_push_accept(hg_bulk_t handle)
+{
+    struct hg_bulk *hg_bulk = (struct hg_bulk *) handle;
+
+    return (hg_bulk && !hg_bulk->remote && hg_bulk->flags != HG_BULK_READ_ONLY)
+        ? HG_TRUE : HG_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_bulk_eager_push_set(hg_bulk_t handle, struct hg_bulk_eager_push *eager_push,
+    hg_uint32_t index)
+{
+    struct hg_bulk *hg_bulk = (struct hg_bulk *) handle;
+
+    hg_bulk->eager_push = eager_push;
+    hg_bulk->eager_push_index = index;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_bulk_eager_push_apply(hg_bulk_t *handles, hg_uint32_t count,
+    hg_uint32_t mask, void *buf, hg_size_t buf_size)
+{
+    char *buf_ptr = (char *) buf;
+    hg_size_t buf_left = buf_size;
+    hg_return_t ret = HG_SUCCESS;
+
+    while (buf_left > 0) {
+        struct hg_bulk *hg_bulk;
+        hg_uint32_t index;
+        hg_uint64_t offset, size;
+
+        if (buf_left < HG_BULK_EAGER_PUSH_HEADER_SIZE) {
+            HG_LOG_ERROR("Truncated eager push record");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+        memcpy(&index, buf_ptr, sizeof(hg_uint32_t));
+        buf_ptr += sizeof(hg_uint32_t);
+        memcpy(&offset, buf_ptr, sizeof(hg_uint64_t));
+        buf_ptr += sizeof(hg_uint64_t);
+        memcpy(&size, buf_ptr, sizeof(hg_uint64_t));
+        buf_ptr += sizeof(hg_uint64_t);
+        buf_left -= HG_BULK_EAGER_PUSH_HEADER_SIZE;
+
+        if (index >= count || !(mask & (1U << index)) || size > buf_left) {
+            HG_LOG_ERROR("Invalid eager push record");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+        hg_bulk = (struct hg_bulk *) handles[index];
+        if (offset > hg_bulk->total_size
+            || size > hg_bulk->total_size - offset) {
+            HG_LOG_ERROR("Eager push record exceeds handle size");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+
+        hg_bulk_memcpy_segments(hg_bulk, (hg_size_t) offset, buf_ptr,
+            (hg_size_t) size, HG_TRUE);
+        buf_ptr += size;
+        buf_left -= size;
+    }
 
 done:
     return ret;
@@ -1124,6 +3204,58 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_view(hg_bulk_t handle, hg_size_t offset, hg_size_t size,
+    hg_bulk_t *view)
+{
+    struct hg_bulk *hg_bulk = (struct hg_bulk *) handle;
+    struct hg_bulk *hg_bulk_view = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_bulk) {
+        HG_LOG_ERROR("NULL memory handle passed");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    if (!view) {
+        HG_LOG_ERROR("NULL pointer to view passed");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    if (offset > hg_bulk->total_size || size > hg_bulk->total_size - offset) {
+        HG_LOG_ERROR("Exceeding size of memory exposed by handle");
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+
+    /* Views of views directly reference the same handle */
+    if (hg_bulk->parent) {
+        offset += hg_bulk->view_offset;
+        hg_bulk = hg_bulk->parent;
+    }
+
+    hg_bulk_view = hg_bulk_alloc(hg_bulk->hg_class, 0, 0, HG_FALSE);
+    if (!hg_bulk_view) {
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    hg_bulk_view->total_size = size;
+    hg_bulk_view->flags = hg_bulk->flags;
+    hg_bulk_view->eager_mode = hg_bulk->eager_mode;
+    hg_bulk_view->remote = hg_bulk->remote;
+    hg_bulk_view->parent = hg_bulk;
+    hg_bulk_view->view_offset = offset;
+    hg_atomic_incr32(&hg_bulk->ref_count);
+
+    *view = (hg_bulk_t) hg_bulk_view;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Bulk_access(hg_bulk_t handle, hg_size_t offset, hg_size_t size,
@@ -1182,7 +3314,54 @@ HG_Bulk_get_segment_count(hg_bulk_t handle)
         goto done;
     }
 
-    ret = hg_bulk->segment_count;
+    if (hg_bulk->parent) {
+        struct hg_bulk_window hg_bulk_window;
+
+        hg_bulk_window_get(hg_bulk, &hg_bulk_window);
+        ret = hg_bulk_window.segment_count;
+    } else
+        ret = hg_bulk->segment_count;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_get_staging_info(hg_class_t *hg_class, hg_uint32_t size_class,
+    struct hg_bulk_staging_info *info)
+{
+    struct hg_bulk_pool *hg_bulk_pool;
+    struct hg_bulk_staging *hg_bulk_staging;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_class || !info) {
+        HG_LOG_ERROR("NULL argument");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    if (size_class >= HG_BULK_STAGING_CLASS_COUNT) {
+        HG_LOG_ERROR("Invalid staging size class");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    hg_bulk_pool = hg_core_class_get_bulk_pool(hg_class);
+    if (!hg_bulk_pool) {
+        HG_LOG_ERROR("NULL bulk pool");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+    hg_bulk_staging = &hg_bulk_pool->staging[size_class];
+
+    hg_thread_spin_lock(&hg_bulk_pool->lock);
+    info->buf_size = hg_bulk_staging->buf_size;
+    info->free_count = hg_bulk_staging->free_count;
+    info->used_count = hg_bulk_staging->used_count;
+    info->hit_count = hg_bulk_staging->hit_count;
+    info->miss_count = hg_bulk_staging->miss_count;
+    hg_thread_spin_unlock(&hg_bulk_pool->lock);
 
 done:
     return ret;
@@ -1191,8 +3370,28 @@ done:
 /*---------------------------------------------------------------------------*/
 hg_size_t
 HG_Bulk_get_serialize_size(hg_bulk_t handle, hg_bool_t request_eager)
+{
+    hg_uint8_t flags = HG_BULK_SERIALIZE_NA | HG_BULK_SERIALIZE_SM;
+
+    /* Peer transport is not known, encode handles for all of them */
+    if (request_eager)
+        flags |= HG_BULK_SERIALIZE_EAGER;
+
+    return HG_Bulk_get_serialize_size_flags(handle, flags);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_size_t
+HG_Bulk_get_serialize_size_flags(hg_bulk_t handle, hg_uint8_t flags)
 {
     struct hg_bulk *hg_bulk = (struct hg_bulk *) handle;
+    struct hg_bulk_window hg_bulk_window;
+    struct hg_bulk_segment segment;
+    na_class_t *na_class;
+#ifdef HG_HAS_SM_ROUTING
+    na_class_t *na_sm_class;
+#endif
+    hg_ptr_t prev_end = 0;
     hg_size_t ret = 0;
     hg_uint32_t i;
 
@@ -1200,40 +3399,70 @@ HG_Bulk_get_serialize_size(hg_bulk_t handle, hg_bool_t request_eager)
         HG_LOG_ERROR("NULL bulk handle");
         goto done;
     }
+    na_class = HG_Core_class_get_na(hg_bulk->hg_class);
+#ifdef HG_HAS_SM_ROUTING
+    na_sm_class = HG_Core_class_get_na_sm(hg_bulk->hg_class);
+#endif
+    hg_bulk_window_get(hg_bulk, &hg_bulk_window);
 
-    /* Permission flags */
-    ret = sizeof(hg_bulk->flags);
+    /* Size of NA memory handles is only known once they are created */
+    if ((flags & HG_BULK_SERIALIZE_NA)
+        && hg_bulk_register(hg_bulk_window.hg_bulk, HG_BULK_SERIALIZE_NA,
+            HG_FALSE) != HG_SUCCESS)
+        HG_LOG_ERROR("Could not register bulk handle");
+#ifdef HG_HAS_SM_ROUTING
+    if ((flags & HG_BULK_SERIALIZE_SM)
+        && hg_bulk_register(hg_bulk_window.hg_bulk, HG_BULK_SERIALIZE_SM,
+            HG_FALSE) != HG_SUCCESS)
+        HG_LOG_ERROR("Could not register bulk handle for SM");
+#endif
 
-    /* Segments */
-    ret += sizeof(hg_bulk->total_size) + sizeof(hg_bulk->segment_count)
-        + hg_bulk->segment_count * sizeof(*hg_bulk->segments);
+    /* Version, permission flags and descriptor flags */
+    ret = 3 * sizeof(hg_uint8_t);
+
+    /* Segments (sizes and delta-encoded addresses) */
+    ret += hg_bulk_varint_size(hg_bulk_window.segment_count);
+    for (i = 0; i < hg_bulk_window.segment_count; i++) {
+        hg_bulk_window_segment(&hg_bulk_window, i, &segment);
+        ret += hg_bulk_varint_size(segment.size);
+        ret += hg_bulk_varint_size(hg_bulk_zigzag_encode(
+            (hg_int64_t) (segment.address - prev_end)));
+        prev_end = segment.address + segment.size;
+    }
 
     /* NA mem handles */
-    ret += sizeof(hg_bulk->na_mem_handle_count);
-    for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
+    ret += hg_bulk_varint_size(hg_bulk_window.na_mem_handle_count);
+    if (hg_bulk_window.na_mem_handle_offset)
+        ret += hg_bulk_varint_size(hg_bulk_window.na_mem_handle_offset);
+    for (i = hg_bulk_window.na_mem_handle_start; i
+        < hg_bulk_window.na_mem_handle_start
+        + hg_bulk_window.na_mem_handle_count; i++) {
+        na_mem_handle_t na_mem_handle =
+            hg_bulk_window.hg_bulk->na_mem_handles[i];
         na_size_t serialize_size = 0;
 
-        if (hg_bulk->na_mem_handles[i]) {
-            serialize_size = NA_Mem_handle_get_serialize_size(
-                HG_Core_class_get_na(hg_bulk->hg_class),
-                hg_bulk->na_mem_handles[i]);
+        if ((flags & HG_BULK_SERIALIZE_NA) && na_mem_handle) {
+            serialize_size = NA_Mem_handle_get_serialize_size(na_class,
+                na_mem_handle);
         }
-        ret += sizeof(serialize_size) + serialize_size;
+        ret += hg_bulk_varint_size(serialize_size) + serialize_size;
 #ifdef HG_HAS_SM_ROUTING
-        if (hg_bulk->na_sm_mem_handles) {
-            if (hg_bulk->na_sm_mem_handles[i]) {
+        if ((flags & HG_BULK_SERIALIZE_SM)
+            && hg_bulk_window.hg_bulk->na_sm_mem_handles) {
+            na_mem_handle = hg_bulk_window.hg_bulk->na_sm_mem_handles[i];
+            serialize_size = 0;
+            if (na_mem_handle) {
                 serialize_size = NA_Mem_handle_get_serialize_size(
-                    HG_Core_class_get_na_sm(hg_bulk->hg_class),
-                    hg_bulk->na_sm_mem_handles[i]);
+                    na_sm_class, na_mem_handle);
             }
-            ret += sizeof(serialize_size) + serialize_size;
+            ret += hg_bulk_varint_size(serialize_size) + serialize_size;
         }
 #endif
     }
 
     /* Eager mode */
-    ret += sizeof(hg_bulk->eager_mode);
-    if (request_eager && (hg_bulk->flags == HG_BULK_READ_ONLY))
+    if ((flags & HG_BULK_SERIALIZE_EAGER)
+        && (hg_bulk->flags == HG_BULK_READ_ONLY))
         ret += hg_bulk->total_size;
 
 done:
@@ -1244,12 +3473,29 @@ done:
 hg_return_t
 HG_Bulk_serialize(void *buf, hg_size_t buf_size, hg_bool_t request_eager,
     hg_bulk_t handle)
+{
+    hg_uint8_t flags = HG_BULK_SERIALIZE_NA | HG_BULK_SERIALIZE_SM;
+
+    /* Peer transport is not known, encode handles for all of them */
+    if (request_eager)
+        flags |= HG_BULK_SERIALIZE_EAGER;
+
+    return HG_Bulk_serialize_flags(buf, buf_size, flags, handle);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_serialize_flags(void *buf, hg_size_t buf_size, hg_uint8_t flags,
+    hg_bulk_t handle)
 {
     struct hg_bulk *hg_bulk = (struct hg_bulk *) handle;
+    struct hg_bulk_window hg_bulk_window;
+    struct hg_bulk_segment segment;
     char *buf_ptr = (char *) buf;
     ssize_t buf_size_left = (ssize_t) buf_size;
     hg_return_t ret = HG_SUCCESS;
-    hg_bool_t eager_mode;
+    hg_uint8_t version = HG_BULK_DESC_VERSION, desc_flags = 0;
+    hg_ptr_t prev_end = 0;
     na_class_t *na_class;
 #ifdef HG_HAS_SM_ROUTING
     na_class_t *na_sm_class;
@@ -1268,32 +3514,48 @@ HG_Bulk_serialize(void *buf, hg_size_t buf_size, hg_bool_t request_eager,
     na_sm_class = HG_Core_class_get_na_sm(hg_bulk->hg_class);
 #endif
 
-    /* Publish handle at this point if not published yet */
-    if (!hg_bulk->segment_published) {
-        for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
-            na_return_t na_ret;
-
-            if (!hg_bulk->na_mem_handles[i])
-                continue;
+    /* Only the segments and NA memory handles covered by views are encoded */
+    hg_bulk_window_get(hg_bulk, &hg_bulk_window);
 
-            na_ret = NA_Mem_publish(na_class, hg_bulk->na_mem_handles[i]);
-            if (na_ret != NA_SUCCESS) {
-                HG_LOG_ERROR("NA_Mem_publish failed");
-                ret = HG_NA_ERROR;
-                goto done;
-            }
+    /* Register and publish handle for the requested NA classes at this
+     * point if not done yet */
+    if (flags & HG_BULK_SERIALIZE_NA) {
+        ret = hg_bulk_register(hg_bulk_window.hg_bulk, HG_BULK_SERIALIZE_NA,
+            HG_TRUE);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not register bulk handle");
+            goto done;
+        }
+    }
 #ifdef HG_HAS_SM_ROUTING
-            if (hg_bulk->na_sm_mem_handles && hg_bulk->na_sm_mem_handles[i]) {
-                na_ret = NA_Mem_publish(na_sm_class, hg_bulk->na_sm_mem_handles[i]);
-                if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("NA_Mem_publish for SM failed");
-                    ret = HG_NA_ERROR;
-                    goto done;
-                }
-            }
-#endif
+    if (flags & HG_BULK_SERIALIZE_SM) {
+        ret = hg_bulk_register(hg_bulk_window.hg_bulk, HG_BULK_SERIALIZE_SM,
+            HG_TRUE);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not register bulk handle for SM");
+            goto done;
         }
-        hg_bulk->segment_published = HG_TRUE;
+    }
+#endif
+
+    /* Eager mode is used only when data is set to HG_BULK_READ_ONLY */
+    if ((flags & HG_BULK_SERIALIZE_EAGER)
+        && (hg_bulk->flags == HG_BULK_READ_ONLY))
+        desc_flags |= HG_BULK_DESC_EAGER;
+#ifdef HG_HAS_SM_ROUTING
+    if ((flags & HG_BULK_SERIALIZE_SM)
+        && hg_bulk_window.hg_bulk->na_sm_mem_handles)
+        desc_flags |= HG_BULK_DESC_SM;
+#endif
+    if (hg_bulk_window.na_mem_handle_offset)
+        desc_flags |= HG_BULK_DESC_VIEW;
+
+    /* Add the version */
+    ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left,
+        &version, sizeof(version));
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not encode version");
+        goto done;
     }
 
     /* Add the permission flags */
@@ -1304,58 +3566,81 @@ HG_Bulk_serialize(void *buf, hg_size_t buf_size, hg_bool_t request_eager,
         goto done;
     }
 
-    /* Add the total size of the segments */
+    /* Add the descriptor flags */
     ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left,
-        &hg_bulk->total_size, sizeof(hg_bulk->total_size));
+        &desc_flags, sizeof(desc_flags));
     if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not encode total size");
+        HG_LOG_ERROR("Could not encode descriptor flags");
         goto done;
     }
 
-    /* Add the number of segments */
-    ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left,
-        &hg_bulk->segment_count, sizeof(hg_bulk->segment_count));
+    /* Add the number of segments (total size is recomputed on decode) */
+    ret = hg_bulk_serialize_varint(&buf_ptr, &buf_size_left,
+        hg_bulk_window.segment_count);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not encode segment count");
         goto done;
     }
 
-    /* Add the array of segments */
-    for (i = 0; i < hg_bulk->segment_count; i++) {
-        ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left,
-            &hg_bulk->segments[i], sizeof(hg_bulk->segments[i]));
+    /* Add the array of segments, addresses are encoded relative to the end
+     * of the previous segment */
+    for (i = 0; i < hg_bulk_window.segment_count; i++) {
+        hg_bulk_window_segment(&hg_bulk_window, i, &segment);
+        ret = hg_bulk_serialize_varint(&buf_ptr, &buf_size_left,
+            segment.size);
         if (ret != HG_SUCCESS) {
-            HG_LOG_ERROR("Could not encode segment");
+            HG_LOG_ERROR("Could not encode segment size");
             goto done;
         }
+        ret = hg_bulk_serialize_varint(&buf_ptr, &buf_size_left,
+            hg_bulk_zigzag_encode((hg_int64_t) (segment.address - prev_end)));
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not encode segment address");
+            goto done;
+        }
+        prev_end = segment.address + segment.size;
     }
 
     /* Add the number of NA memory handles */
-    ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left,
-        &hg_bulk->na_mem_handle_count, sizeof(hg_bulk->na_mem_handle_count));
+    ret = hg_bulk_serialize_varint(&buf_ptr, &buf_size_left,
+        hg_bulk_window.na_mem_handle_count);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not encode NA memory handle count");
         goto done;
     }
 
+    /* Add the offset of data in the first NA memory handle */
+    if (desc_flags & HG_BULK_DESC_VIEW) {
+        ret = hg_bulk_serialize_varint(&buf_ptr, &buf_size_left,
+            hg_bulk_window.na_mem_handle_offset);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not encode NA memory handle offset");
+            goto done;
+        }
+    }
+
     /* Add the NA memory handles */
-    for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
+    for (i = hg_bulk_window.na_mem_handle_start; i
+        < hg_bulk_window.na_mem_handle_start
+        + hg_bulk_window.na_mem_handle_count; i++) {
+        na_mem_handle_t na_mem_handle = (flags & HG_BULK_SERIALIZE_NA) ?
+            hg_bulk_window.hg_bulk->na_mem_handles[i] : NA_MEM_HANDLE_NULL;
         na_size_t serialize_size = 0;
         na_return_t na_ret;
 
-        if (hg_bulk->na_mem_handles[i]) {
+        if (na_mem_handle) {
             serialize_size = NA_Mem_handle_get_serialize_size(
-                na_class, hg_bulk->na_mem_handles[i]);
+                na_class, na_mem_handle);
         }
-        ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left, &serialize_size,
-            sizeof(serialize_size));
+        ret = hg_bulk_serialize_varint(&buf_ptr, &buf_size_left,
+            serialize_size);
         if (ret != HG_SUCCESS) {
             HG_LOG_ERROR("Could not encode serialize size");
             goto done;
         }
-        if (hg_bulk->na_mem_handles[i]) {
+        if (na_mem_handle) {
             na_ret = NA_Mem_handle_serialize(na_class, buf_ptr,
-                (na_size_t) buf_size_left, hg_bulk->na_mem_handles[i]);
+                (na_size_t) buf_size_left, na_mem_handle);
             if (na_ret != NA_SUCCESS) {
                 HG_LOG_ERROR("Could not serialize memory handle");
                 ret = HG_NA_ERROR;
@@ -1366,21 +3651,22 @@ HG_Bulk_serialize(void *buf, hg_size_t buf_size, hg_bool_t request_eager,
         }
 
 #ifdef HG_HAS_SM_ROUTING
-        if (hg_bulk->na_sm_mem_handles) {
-            if (hg_bulk->na_sm_mem_handles[i]) {
+        if (desc_flags & HG_BULK_DESC_SM) {
+            na_mem_handle = hg_bulk_window.hg_bulk->na_sm_mem_handles[i];
+            if (na_mem_handle) {
                 serialize_size = NA_Mem_handle_get_serialize_size(
-                    na_class, hg_bulk->na_sm_mem_handles[i]);
+                    na_sm_class, na_mem_handle);
             } else
                 serialize_size = 0;
-            ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left,
-                &serialize_size, sizeof(serialize_size));
+            ret = hg_bulk_serialize_varint(&buf_ptr, &buf_size_left,
+                serialize_size);
             if (ret != HG_SUCCESS) {
                 HG_LOG_ERROR("Could not encode serialize size");
                 goto done;
             }
-            if (hg_bulk->na_sm_mem_handles[i]) {
+            if (na_mem_handle) {
                 na_ret = NA_Mem_handle_serialize(na_sm_class, buf_ptr,
-                    (na_size_t) buf_size_left, hg_bulk->na_sm_mem_handles[i]);
+                    (na_size_t) buf_size_left, na_mem_handle);
                 if (na_ret != NA_SUCCESS) {
                     HG_LOG_ERROR("Could not serialize SM memory handle");
                     ret = HG_NA_ERROR;
@@ -1393,24 +3679,15 @@ HG_Bulk_serialize(void *buf, hg_size_t buf_size, hg_bool_t request_eager,
 #endif
     }
 
-    /* Eager mode is used only when data is set to HG_BULK_READ_ONLY */
-    eager_mode = (request_eager && (hg_bulk->flags == HG_BULK_READ_ONLY));
-    ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left, &eager_mode,
-        sizeof(eager_mode));
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not encode eager_mode bool");
-        goto done;
-    }
-
     /* Add the serialized data */
-    if (eager_mode) {
-        for (i = 0; i < hg_bulk->segment_count; i++) {
-            if (!hg_bulk->segments[i].size)
+    if (desc_flags & HG_BULK_DESC_EAGER) {
+        for (i = 0; i < hg_bulk_window.segment_count; i++) {
+            hg_bulk_window_segment(&hg_bulk_window, i, &segment);
+            if (!segment.size)
                 continue;
 
             ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left,
-                (const void *) hg_bulk->segments[i].address,
-                hg_bulk->segments[i].size);
+                (const void *) segment.address, segment.size);
             if (ret != HG_SUCCESS) {
                 HG_LOG_ERROR("Could not encode segment data");
                 goto done;
@@ -1430,6 +3707,7 @@ hg_return_t
 HG_Bulk_deserialize(hg_class_t *hg_class, hg_bulk_t *handle, const void *buf,
     hg_size_t buf_size)
 {
+    na_class_t *na_class;
 #ifdef HG_HAS_SM_ROUTING
     na_class_t *na_sm_class;
 #endif
@@ -1437,6 +3715,10 @@ HG_Bulk_deserialize(hg_class_t *hg_class, hg_bulk_t *handle, const void *buf,
     const char *buf_ptr = (const char *) buf;
     ssize_t buf_size_left = (ssize_t) buf_size;
     hg_return_t ret = HG_SUCCESS;
+    hg_uint8_t version, flags, desc_flags;
+    hg_uint64_t segment_count, na_mem_handle_count;
+    hg_ptr_t prev_end = 0;
+    hg_bool_t use_sm = HG_FALSE;
     hg_uint32_t i;
 
     if (!handle) {
@@ -1445,102 +3727,148 @@ HG_Bulk_deserialize(hg_class_t *hg_class, hg_bulk_t *handle, const void *buf,
         goto done;
     }
 
+    na_class = HG_Core_class_get_na(hg_class);
 #ifdef HG_HAS_SM_ROUTING
     na_sm_class = HG_Core_class_get_na_sm(hg_class);
 #endif
 
-    hg_bulk = (struct hg_bulk *) malloc(sizeof(struct hg_bulk));
-    if (!hg_bulk) {
-        HG_LOG_ERROR("Could not allocate handle");
-        ret = HG_NOMEM_ERROR;
+    /* Get the version */
+    ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
+        &version, sizeof(version));
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not decode version");
+        goto done;
+    }
+    if (version != HG_BULK_DESC_VERSION) {
+        HG_LOG_ERROR("Unsupported bulk descriptor version (%u)",
+            (unsigned int) version);
+        ret = HG_PROTOCOL_ERROR;
         goto done;
     }
-    memset(hg_bulk, 0, sizeof(struct hg_bulk));
-    hg_bulk->hg_class = hg_class;
-    hg_atomic_set32(&hg_bulk->ref_count, 1);
 
     /* Get the permission flags */
     ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
-        &hg_bulk->flags, sizeof(hg_bulk->flags));
+        &flags, sizeof(flags));
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not decode permission flags");
         goto done;
     }
 
-    /* Get the total size of the segments */
+    /* Get the descriptor flags */
     ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
-        &hg_bulk->total_size, sizeof(hg_bulk->total_size));
+        &desc_flags, sizeof(desc_flags));
     if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not decode total size");
+        HG_LOG_ERROR("Could not decode descriptor flags");
         goto done;
     }
 
     /* Get the number of segments */
-    ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
-        &hg_bulk->segment_count, sizeof(hg_bulk->segment_count));
+    ret = hg_bulk_deserialize_varint(&buf_ptr, &buf_size_left, &segment_count);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not decode segment count");
         goto done;
     }
-
-    /* Get the array of segments */
-    hg_bulk->segments = (struct hg_bulk_segment *) malloc(
-            hg_bulk->segment_count * sizeof(struct hg_bulk_segment));
-    if (!hg_bulk->segments) {
-        HG_LOG_ERROR("Could not allocate segment array");
-        ret = HG_NOMEM_ERROR;
+    /* Each segment takes at least two bytes */
+    if (segment_count > (hg_uint64_t) buf_size_left / 2) {
+        HG_LOG_ERROR("Invalid segment count");
+        ret = HG_PROTOCOL_ERROR;
         goto done;
     }
-    for (i = 0; i < hg_bulk->segment_count; i++) {
-        ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
-            &hg_bulk->segments[i], sizeof(hg_bulk->segments[i]));
+
+    /* Peek at the number of NA memory handles to set up the handle at once */
+    {
+        const char *peek_ptr = buf_ptr;
+        ssize_t peek_left = buf_size_left;
+        hg_uint64_t val, total_size = 0;
+
+        for (i = 0; i < 2 * segment_count; i++) {
+            ret = hg_bulk_deserialize_varint(&peek_ptr, &peek_left, &val);
+            if (ret != HG_SUCCESS) {
+                HG_LOG_ERROR("Could not decode segment");
+                goto done;
+            }
+            /* Segment sizes and address deltas alternate, the total size
+             * must fit so that it can be trusted for the eager copy */
+            if (i % 2)
+                continue;
+            if (val > (hg_uint64_t) HG_SIZE_MAX - total_size) {
+                HG_LOG_ERROR("Segment sizes overflow total size");
+                ret = HG_PROTOCOL_ERROR;
+                goto done;
+            }
+            total_size += val;
+        }
+        ret = hg_bulk_deserialize_varint(&peek_ptr, &peek_left,
+            &na_mem_handle_count);
         if (ret != HG_SUCCESS) {
-            HG_LOG_ERROR("Could not decode segment");
+            HG_LOG_ERROR("Could not decode NA memory handle count");
+            goto done;
+        }
+        if (na_mem_handle_count > (hg_uint64_t) peek_left) {
+            HG_LOG_ERROR("Invalid NA memory handle count");
+            ret = HG_PROTOCOL_ERROR;
             goto done;
         }
     }
 
-    /* Get the number of NA memory handles */
-    ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
-        &hg_bulk->na_mem_handle_count, sizeof(hg_bulk->na_mem_handle_count));
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not decode NA memory handle count");
+#ifdef HG_HAS_SM_ROUTING
+    use_sm = (hg_bool_t) (na_sm_class && (desc_flags & HG_BULK_DESC_SM));
+#endif
+    hg_bulk = hg_bulk_alloc(hg_class, (hg_uint32_t) segment_count,
+        (hg_uint32_t) na_mem_handle_count, use_sm);
+    if (!hg_bulk) {
+        ret = HG_NOMEM_ERROR;
         goto done;
     }
+    hg_bulk->flags = flags;
+    hg_bulk->eager_mode = (hg_bool_t) (desc_flags & HG_BULK_DESC_EAGER);
+    hg_bulk->remote = HG_TRUE;
 
-    /* Get the NA memory handles */
-    hg_bulk->na_mem_handles = (na_mem_handle_t *) malloc(
-            hg_bulk->na_mem_handle_count * sizeof(na_mem_handle_t));
-    if (!hg_bulk->na_mem_handles) {
-        HG_LOG_ERROR("Could not allocate NA memory handle array");
-        ret = HG_NOMEM_ERROR;
-        goto done;
+    /* Get the array of segments (already validated) */
+    for (i = 0; i < hg_bulk->segment_count; i++) {
+        hg_uint64_t size = 0, delta = 0;
+
+        hg_bulk_deserialize_varint(&buf_ptr, &buf_size_left, &size);
+        hg_bulk_deserialize_varint(&buf_ptr, &buf_size_left, &delta);
+        hg_bulk->segments[i].size = (hg_size_t) size;
+        hg_bulk->segments[i].address =
+            prev_end + (hg_ptr_t) hg_bulk_zigzag_decode(delta);
+        prev_end = hg_bulk->segments[i].address + hg_bulk->segments[i].size;
+        hg_bulk->total_size += hg_bulk->segments[i].size;
     }
-#ifdef HG_HAS_SM_ROUTING
-    if (na_sm_class) {
-        hg_bulk->na_sm_mem_handles = (na_mem_handle_t *) malloc(
-                hg_bulk->na_mem_handle_count * sizeof(na_mem_handle_t));
-        if (!hg_bulk->na_sm_mem_handles) {
-            HG_LOG_ERROR("Could not allocate NA SM memory handle array");
-            ret = HG_NOMEM_ERROR;
+    hg_bulk_deserialize_varint(&buf_ptr, &buf_size_left, &na_mem_handle_count);
+
+    /* Get the offset of data in the first NA memory handle */
+    if (desc_flags & HG_BULK_DESC_VIEW) {
+        hg_uint64_t na_mem_handle_offset;
+
+        ret = hg_bulk_deserialize_varint(&buf_ptr, &buf_size_left,
+            &na_mem_handle_offset);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not decode NA memory handle offset");
             goto done;
         }
+        hg_bulk->na_mem_handle_offset = (hg_size_t) na_mem_handle_offset;
     }
-#endif
 
+    /* Get the NA memory handles */
     for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
-        na_size_t serialize_size;
+        hg_uint64_t serialize_size;
         na_return_t na_ret;
 
-        ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
-            &serialize_size, sizeof(serialize_size));
+        ret = hg_bulk_deserialize_varint(&buf_ptr, &buf_size_left,
+            &serialize_size);
         if (ret != HG_SUCCESS) {
             HG_LOG_ERROR("Could not decode serialize size");
             goto done;
         }
+        if (serialize_size > (hg_uint64_t) buf_size_left) {
+            HG_LOG_ERROR("Buffer size too small");
+            ret = HG_SIZE_ERROR;
+            goto done;
+        }
         if (serialize_size) {
-            na_ret = NA_Mem_handle_deserialize(
-                HG_Core_class_get_na(hg_bulk->hg_class),
+            na_ret = NA_Mem_handle_deserialize(na_class,
                 &hg_bulk->na_mem_handles[i], buf_ptr,
                 (na_size_t) buf_size_left);
             if (na_ret != NA_SUCCESS) {
@@ -1550,19 +3878,22 @@ HG_Bulk_deserialize(hg_class_t *hg_class, hg_bulk_t *handle, const void *buf,
             }
             buf_ptr += serialize_size;
             buf_size_left -= (ssize_t) serialize_size;
-        } else {
-            hg_bulk->na_mem_handles[i] = NA_MEM_HANDLE_NULL;
         }
 
-#ifdef HG_HAS_SM_ROUTING
-        if (hg_bulk->na_sm_mem_handles) {
-            ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
-                &serialize_size, sizeof(serialize_size));
+        if (desc_flags & HG_BULK_DESC_SM) {
+            ret = hg_bulk_deserialize_varint(&buf_ptr, &buf_size_left,
+                &serialize_size);
             if (ret != HG_SUCCESS) {
                 HG_LOG_ERROR("Could not decode serialize size");
                 goto done;
             }
-            if (serialize_size) {
+            if (serialize_size > (hg_uint64_t) buf_size_left) {
+                HG_LOG_ERROR("Buffer size too small");
+                ret = HG_SIZE_ERROR;
+                goto done;
+            }
+#ifdef HG_HAS_SM_ROUTING
+            if (serialize_size && hg_bulk->na_sm_mem_handles) {
                 na_ret = NA_Mem_handle_deserialize(na_sm_class,
                     &hg_bulk->na_sm_mem_handles[i], buf_ptr,
                     (na_size_t) buf_size_left);
@@ -1571,45 +3902,37 @@ HG_Bulk_deserialize(hg_class_t *hg_class, hg_bulk_t *handle, const void *buf,
                     ret = HG_NA_ERROR;
                     goto done;
                 }
-                buf_ptr += serialize_size;
-                buf_size_left -= (ssize_t) serialize_size;
-            } else {
-                hg_bulk->na_sm_mem_handles[i] = NA_MEM_HANDLE_NULL;
             }
-        }
 #endif
+            /* SM handles are skipped if SM routing is not enabled here */
+            buf_ptr += serialize_size;
+            buf_size_left -= (ssize_t) serialize_size;
+        }
     }
 
-    /* Get whether data is serialized or not */
-    ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
-        &hg_bulk->eager_mode, sizeof(hg_bulk->eager_mode));
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not decode eager_mode bool");
-        goto done;
-    }
+    /* Get the serialized data, segments point into a single buffer */
+    if (hg_bulk->eager_mode && hg_bulk->total_size) {
+        char *eager_ptr;
 
-    /* Get the serialized data */
-    if (hg_bulk->eager_mode) {
-        hg_bulk->segment_alloc = HG_TRUE;
-        for (i = 0; i < hg_bulk->segment_count; i++) {
-            if (!hg_bulk->segments[i].size)
-                continue;
+        if (hg_bulk->total_size > (hg_size_t) buf_size_left) {
+            HG_LOG_ERROR("Buffer size too small");
+            ret = HG_SIZE_ERROR;
+            goto done;
+        }
+        hg_bulk->eager_buf = malloc(hg_bulk->total_size);
+        if (!hg_bulk->eager_buf) {
+            HG_LOG_ERROR("Could not allocate eager buffer");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        memcpy(hg_bulk->eager_buf, buf_ptr, hg_bulk->total_size);
+        buf_ptr += hg_bulk->total_size;
+        buf_size_left -= (ssize_t) hg_bulk->total_size;
 
-            /* Use calloc to avoid uninitialized memory used for transfer */
-            hg_bulk->segments[i].address = (hg_ptr_t) calloc(
-                hg_bulk->segments[i].size, sizeof(char));
-            if (!hg_bulk->segments[i].address) {
-                HG_LOG_ERROR("Could not allocate segment");
-                ret = HG_NOMEM_ERROR;
-                goto done;
-            }
-            ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
-                (void *) hg_bulk->segments[i].address,
-                hg_bulk->segments[i].size);
-            if (ret != HG_SUCCESS) {
-                HG_LOG_ERROR("Could not decode segment data");
-                goto done;
-            }
+        eager_ptr = (char *) hg_bulk->eager_buf;
+        for (i = 0; i < hg_bulk->segment_count; i++) {
+            hg_bulk->segments[i].address = (hg_ptr_t) eager_ptr;
+            eager_ptr += hg_bulk->segments[i].size;
         }
     }
 
@@ -1659,60 +3982,222 @@ HG_Bulk_transfer_id(hg_context_t *context, hg_cb_t callback, void *arg,
         goto done;
     }
 
-    if (!hg_bulk_origin || !hg_bulk_local) {
-        HG_LOG_ERROR("NULL memory handle passed");
+    ret = hg_bulk_transfer_check(op, hg_bulk_origin, hg_bulk_local, size);
+    if (ret != HG_SUCCESS)
+        goto done;
+
+    ret = hg_bulk_transfer(context, callback, arg, op, origin_addr, origin_id,
+        hg_bulk_origin, origin_offset, hg_bulk_local, local_offset, size,
+        op_id);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not transfer data");
+        goto done;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_transfer_stream(hg_context_t *context, hg_cb_t chunk_callback,
+    hg_cb_t callback, void *arg, hg_bulk_op_t op, hg_addr_t origin_addr,
+    hg_uint8_t origin_id, hg_bulk_t origin_handle, hg_size_t origin_offset,
+    hg_bulk_t local_handle, hg_size_t local_offset, hg_size_t size,
+    hg_size_t chunk_size, unsigned int window, hg_bool_t ordered,
+    hg_op_id_t *op_id)
+{
+    struct hg_bulk *hg_bulk_origin = (struct hg_bulk *) origin_handle;
+    struct hg_bulk *hg_bulk_local = (struct hg_bulk *) local_handle;
+    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    struct hg_bulk_stream *hg_bulk_stream = NULL;
+    hg_bool_t finish;
+    unsigned int i;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG bulk context");
         ret = HG_INVALID_PARAM;
         goto done;
     }
 
-    if (!size) {
-        HG_LOG_ERROR("Transfer size must be non-zero");
-        ret = HG_SIZE_ERROR;
+    if (origin_addr == HG_ADDR_NULL) {
+        HG_LOG_ERROR("NULL addr passed");
+        ret = HG_INVALID_PARAM;
         goto done;
     }
 
-    if (size > hg_bulk_origin->total_size) {
-        HG_LOG_ERROR("Exceeding size of memory exposed by origin handle");
-        ret = HG_SIZE_ERROR;
+    if (!chunk_callback) {
+        HG_LOG_ERROR("NULL chunk callback");
+        ret = HG_INVALID_PARAM;
         goto done;
     }
 
-    if (size > hg_bulk_local->total_size) {
-        HG_LOG_ERROR("Exceeding size of memory exposed by local handle");
-        ret = HG_SIZE_ERROR;
+    if (!chunk_size || !window) {
+        HG_LOG_ERROR("Chunk size and window must be non-zero");
+        ret = HG_INVALID_PARAM;
         goto done;
     }
 
-    switch (op) {
-        case HG_BULK_PUSH:
-            if (!(hg_bulk_origin->flags & HG_BULK_WRITE_ONLY)
-                || !(hg_bulk_local->flags & HG_BULK_READ_ONLY)) {
-                HG_LOG_ERROR("Invalid permission flags for PUSH operation "
-                    "(origin=%d, local=%d)", hg_bulk_origin->flags,
-                    hg_bulk_local->flags);
-                ret = HG_INVALID_PARAM;
-                goto done;
-            }
-            break;
-        case HG_BULK_PULL:
-            if (!(hg_bulk_origin->flags & HG_BULK_READ_ONLY)
-                || !(hg_bulk_local->flags & HG_BULK_WRITE_ONLY)) {
-                HG_LOG_ERROR("Invalid permission flags for PULL operation "
-                    "(origin=%d, local=%d)", hg_bulk_origin->flags,
-                    hg_bulk_local->flags);
-                ret = HG_INVALID_PARAM;
-                goto done;
-            }
-            break;
-        default:
-            HG_LOG_ERROR("Unknown bulk operation");
-            ret = HG_INVALID_PARAM;
+    ret = hg_bulk_transfer_check(op, hg_bulk_origin, hg_bulk_local, size);
+    if (ret != HG_SUCCESS)
+        goto done;
+
+    hg_bulk_stream = (struct hg_bulk_stream *) malloc(
+        sizeof(struct hg_bulk_stream));
+    if (!hg_bulk_stream) {
+        HG_LOG_ERROR("Could not allocate HG Bulk stream");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    memset(hg_bulk_stream, 0, sizeof(struct hg_bulk_stream));
+    hg_bulk_stream->chunk_callback = chunk_callback;
+    hg_bulk_stream->origin_id = origin_id;
+    hg_bulk_stream->origin_offset = origin_offset;
+    hg_bulk_stream->local_offset = local_offset;
+    hg_bulk_stream->chunk_size = chunk_size;
+    hg_bulk_stream->chunk_count = (size + chunk_size - 1) / chunk_size;
+    /* No need for more slots than chunks */
+    hg_bulk_stream->window = (hg_bulk_stream->chunk_count < window) ?
+        (unsigned int) hg_bulk_stream->chunk_count : window;
+    hg_bulk_stream->ordered = ordered;
+    hg_bulk_stream->ret = HG_SUCCESS;
+    hg_thread_mutex_init(&hg_bulk_stream->mutex);
+
+    hg_bulk_stream->chunks = (struct hg_bulk_stream_chunk *) malloc(
+        hg_bulk_stream->window * sizeof(struct hg_bulk_stream_chunk));
+    hg_bulk_stream->free_slots = (unsigned int *) malloc(
+        hg_bulk_stream->window * sizeof(unsigned int));
+    if (!hg_bulk_stream->chunks || !hg_bulk_stream->free_slots) {
+        HG_LOG_ERROR("Could not allocate HG Bulk stream chunks");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    for (i = 0; i < hg_bulk_stream->window; i++) {
+        hg_bulk_stream->chunks[i].stream = hg_bulk_stream;
+        hg_bulk_stream->chunks[i].op_id = HG_OP_ID_NULL;
+        hg_bulk_stream->chunks[i].completed = HG_TRUE;
+        hg_bulk_stream->free_slots[i] = hg_bulk_stream->window - i - 1;
+    }
+    hg_bulk_stream->free_count = hg_bulk_stream->window;
+
+    /* Chunks are issued after this call returns, keep address alive */
+    ret = HG_Core_addr_dup(hg_bulk_origin->hg_class, origin_addr,
+        &hg_bulk_stream->origin_addr);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not duplicate origin address");
+        goto done;
+    }
+
+    /* Stream op ID does not issue NA operations itself */
+    hg_bulk_op_id = hg_bulk_op_id_alloc(context, 0);
+    if (!hg_bulk_op_id) {
+        HG_LOG_ERROR("Could not allocate HG Bulk operation ID");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    hg_bulk_op_id->hg_class = hg_bulk_origin->hg_class;
+    hg_bulk_op_id->context = context;
+    hg_bulk_op_id->na_class = NULL;
+    hg_bulk_op_id->na_context = NULL;
+    hg_bulk_op_id->callback = callback;
+    hg_bulk_op_id->arg = arg;
+    hg_atomic_set32(&hg_bulk_op_id->completed, 0);
+    hg_atomic_set32(&hg_bulk_op_id->canceled, 0);
+    hg_bulk_op_id->op_count = 0;
+    hg_atomic_set32(&hg_bulk_op_id->op_pending_count, 0);
+    hg_bulk_op_id->op = op;
+    hg_bulk_op_id->size = size;
+    hg_bulk_op_id->stream = hg_bulk_stream;
+    hg_bulk_op_id->batch = NULL;
+    hg_bulk_op_id->batch_count = 0;
+    hg_bulk_op_id->eager_mode = hg_bulk_origin->eager_mode;
+    hg_bulk_op_id->hg_bulk_origin = hg_bulk_origin;
+    hg_atomic_incr32(&hg_bulk_origin->ref_count); /* Increment ref count */
+    hg_bulk_op_id->hg_bulk_local = hg_bulk_local;
+    hg_atomic_incr32(&hg_bulk_local->ref_count); /* Increment ref count */
+    /* Completed from chunk callbacks, no NA progress to wake up */
+    hg_bulk_op_id->is_self = HG_TRUE;
+    hg_bulk_stream->hg_bulk_op_id = hg_bulk_op_id;
+
+    /* Assign op_id */
+    if (op_id && op_id != HG_OP_ID_IGNORE) *op_id = (hg_op_id_t) hg_bulk_op_id;
+
+    /* Fill window, errors are reported to the stream callback once chunks
+     * already issued have completed */
+    hg_thread_mutex_lock(&hg_bulk_stream->mutex);
+    hg_bulk_stream_issue(hg_bulk_stream);
+    finish = hg_bulk_stream_check_finish(hg_bulk_stream);
+    hg_thread_mutex_unlock(&hg_bulk_stream->mutex);
+
+    /* Stream is now released when its op ID is triggered */
+    hg_bulk_stream = NULL;
+
+    if (finish) {
+        ret = hg_bulk_complete(hg_bulk_op_id);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not complete bulk stream");
             goto done;
+        }
     }
 
-    ret = hg_bulk_transfer(context, callback, arg, op, origin_addr, origin_id,
-        hg_bulk_origin, origin_offset, hg_bulk_local, local_offset, size,
-        op_id);
+done:
+    if (ret != HG_SUCCESS && hg_bulk_stream) {
+        if (hg_bulk_op_id) {
+            hg_bulk_free(hg_bulk_origin);
+            hg_bulk_free(hg_bulk_local);
+            hg_bulk_op_id_release(hg_bulk_op_id);
+        }
+        if (hg_bulk_stream->origin_addr)
+            HG_Core_addr_free(hg_bulk_origin->hg_class,
+                hg_bulk_stream->origin_addr);
+        hg_thread_mutex_destroy(&hg_bulk_stream->mutex);
+        free(hg_bulk_stream->free_slots);
+        free(hg_bulk_stream->chunks);
+        free(hg_bulk_stream);
+    }
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_transfer_batch(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_op_t op, hg_addr_t origin_addr, hg_uint8_t origin_id,
+    const struct hg_bulk_transfer_desc *descs, hg_uint32_t count,
+    hg_op_id_t *op_id)
+{
+    hg_return_t ret = HG_SUCCESS;
+    hg_uint32_t i;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG bulk context");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    if (origin_addr == HG_ADDR_NULL) {
+        HG_LOG_ERROR("NULL addr passed");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    if (!descs || !count) {
+        HG_LOG_ERROR("No range to transfer");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    /* Check all ranges before anything is issued */
+    for (i = 0; i < count; i++) {
+        ret = hg_bulk_transfer_check(op,
+            (struct hg_bulk *) descs[i].origin_handle,
+            (struct hg_bulk *) descs[i].local_handle, descs[i].size);
+        if (ret != HG_SUCCESS)
+            goto done;
+    }
+
+    ret = hg_bulk_transfer_batch(context, callback, arg, op, origin_addr,
+        origin_id, descs, count, op_id);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not transfer data");
         goto done;
@@ -1735,6 +4220,11 @@ HG_Bulk_cancel(hg_op_id_t op_id)
         goto done;
     }
 
+    if (hg_bulk_op_id->stream) {
+        ret = hg_bulk_stream_cancel(hg_bulk_op_id->stream);
+        goto done;
+    }
+
     if (HG_UTIL_TRUE != hg_atomic_cas32(&hg_bulk_op_id->completed, 1, 0)) {
         unsigned int i = 0;
 
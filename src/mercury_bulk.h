@@ -26,7 +26,13 @@ extern "C" {
  * Memory allocated is then freed when HG_Bulk_free() is called.
  * \remark If NULL is passed to buf_ptrs, i.e.,
  * \verbatim HG_Bulk_create(count, NULL, buf_sizes, flags, &handle) \endverbatim
- * memory for the missing buf_ptrs array will be internally allocated.
+ * memory for the missing buf_ptrs array will be internally allocated. Single
+ * segments are then taken from a per-class pool of page-aligned staging
+ * buffers that remain registered, with the same size and permission, when the
+ * handle is freed (up to a bounded amount of memory); their content is not
+ * zeroed on reuse.
+ * Memory is registered with an NA class the first time that the handle is
+ * serialized for, or used in a transfer over, that class.
  *
  * \param hg_class [IN]         pointer to HG class
  * \param count [IN]            number of segments
@@ -74,6 +80,29 @@ HG_Bulk_ref_incr(
         hg_bulk_t handle
         );
 
+/**
+ * Create a view of the range [offset, offset + size) of an existing bulk
+ * handle. The view references the segments and NA memory registrations of
+ * the handle it is created from, no memory is registered, and it holds a
+ * reference to that handle until freed with HG_Bulk_free(). Offsets passed
+ * to transfer and access calls are relative to the start of the view, and
+ * serializing a view only encodes the segments it covers.
+ *
+ * \param handle [IN]           abstract bulk handle
+ * \param offset [IN]           offset of the view in handle
+ * \param size [IN]             size of the view
+ * \param view [OUT]            pointer to returned abstract bulk handle
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Bulk_view(
+        hg_bulk_t handle,
+        hg_size_t offset,
+        hg_size_t size,
+        hg_bulk_t *view
+        );
+
 /**
  * Access bulk handle to retrieve memory segments abstracted by handle.
  * \remark When using mercury in co-resident mode (i.e., when addr passed is
@@ -166,6 +195,65 @@ HG_Bulk_serialize(
         hg_bulk_t handle
         );
 
+/**
+ * Get size required to serialize bulk handle for the transports given in
+ * flags. Memory is registered with the corresponding NA classes if it was
+ * not already.
+ *
+ * \param handle [IN]           abstract bulk handle
+ * \param flags [IN]            bitwise OR of:
+ *                                  - HG_BULK_SERIALIZE_EAGER
+ *                                  - HG_BULK_SERIALIZE_NA
+ *                                  - HG_BULK_SERIALIZE_SM
+ *
+ * \return Non-negative value
+ */
+HG_EXPORT hg_size_t
+HG_Bulk_get_serialize_size_flags(
+        hg_bulk_t handle,
+        hg_uint8_t flags
+        );
+
+/**
+ * Serialize bulk handle into a buffer for the transports given in flags.
+ * Only the memory handles of the corresponding NA classes are encoded, the
+ * handle can then only be transferred over these transports.
+ *
+ * \param buf [IN/OUT]          pointer to buffer
+ * \param buf_size [IN]         buffer size
+ * \param flags [IN]            bitwise OR of:
+ *                                  - HG_BULK_SERIALIZE_EAGER
+ *                                  - HG_BULK_SERIALIZE_NA
+ *                                  - HG_BULK_SERIALIZE_SM
+ * \param handle [IN]           abstract bulk handle
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Bulk_serialize_flags(
+        void *buf,
+        hg_size_t buf_size,
+        hg_uint8_t flags,
+        hg_bulk_t handle
+        );
+
+/**
+ * Get occupancy of a size class of the staging buffer pool used by
+ * HG_Bulk_create() when no buffer is passed.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param size_class [IN]       size class (< HG_BULK_STAGING_CLASS_COUNT)
+ * \param info [OUT]            pointer to staging info
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Bulk_get_staging_info(
+        hg_class_t *hg_class,
+        hg_uint32_t size_class,
+        struct hg_bulk_staging_info *info
+        );
+
 /**
  * Deserialize bulk handle from an existing buffer.
  *
@@ -258,6 +346,94 @@ HG_Bulk_transfer_id(
         hg_op_id_t *op_id
         );
 
+/**
+ * Transfer data to/from origin as a stream of chunks of chunk_size bytes
+ * (last chunk may be smaller). Up to window chunks are kept in flight and a
+ * new chunk is issued as soon as one completes. chunk_callback is triggered
+ * for each chunk transferred, either in chunk order if ordered is HG_TRUE or
+ * as chunks complete otherwise, with the offset of the chunk relative to the
+ * start of the stream and its size set in the bulk callback info. callback
+ * is triggered once all chunks have completed, or once chunks in flight have
+ * completed after the stream has been canceled with HG_Bulk_cancel() on the
+ * returned operation ID, in which case it returns HG_CANCELED and remaining
+ * chunks are not issued. Both callbacks can be triggered using HG_Trigger().
+ *
+ * \param context [IN]          pointer to HG context
+ * \param chunk_callback [IN]   pointer to function callback for each chunk
+ * \param callback [IN]         pointer to function callback for the stream
+ * \param arg [IN]              pointer to data passed to callbacks
+ * \param op [IN]               transfer operation:
+ *                                  - HG_BULK_PUSH
+ *                                  - HG_BULK_PULL
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_id [IN]        context ID of origin
+ * \param origin_handle [IN]    abstract bulk handle
+ * \param origin_offset [IN]    offset
+ * \param local_handle [IN]     abstract bulk handle
+ * \param local_offset [IN]     offset
+ * \param size [IN]             size of data to be transferred
+ * \param chunk_size [IN]       size of each chunk
+ * \param window [IN]           maximum number of chunks in flight
+ * \param ordered [IN]          deliver chunks in order
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Bulk_transfer_stream(
+        hg_context_t *context,
+        hg_cb_t chunk_callback,
+        hg_cb_t callback,
+        void *arg,
+        hg_bulk_op_t op,
+        hg_addr_t origin_addr,
+        hg_uint8_t origin_id,
+        hg_bulk_t origin_handle,
+        hg_size_t origin_offset,
+        hg_bulk_t local_handle,
+        hg_size_t local_offset,
+        hg_size_t size,
+        hg_size_t chunk_size,
+        unsigned int window,
+        hg_bool_t ordered,
+        hg_op_id_t *op_id
+        );
+
+/**
+ * Transfer data to/from origin for each of the count ranges described by
+ * descs, all ranges being transferred with the same origin address. Ranges
+ * share a single operation ID and callback is triggered once, after all of
+ * them have completed, with origin and local handles set to HG_BULK_NULL in
+ * the bulk callback info and size set to the total size transferred.
+ * Canceling the returned operation ID cancels all the ranges.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param op [IN]               transfer operation:
+ *                                  - HG_BULK_PUSH
+ *                                  - HG_BULK_PULL
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_id [IN]        context ID of origin
+ * \param descs [IN]            array of ranges to be transferred
+ * \param count [IN]            number of ranges
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Bulk_transfer_batch(
+        hg_context_t *context,
+        hg_cb_t callback,
+        void *arg,
+        hg_bulk_op_t op,
+        hg_addr_t origin_addr,
+        hg_uint8_t origin_id,
+        const struct hg_bulk_transfer_desc *descs,
+        hg_uint32_t count,
+        hg_op_id_t *op_id
+        );
+
 /**
  * Cancel an ongoing operation.
  *
@@ -27,7 +27,7 @@
 #ifdef HG_HAS_SELF_FORWARD
 #include "mercury_event.h"
 #endif
-#include "mercury_atomic_queue.h"
+#include "mercury_atomic_seg_queue.h"
 #include "mercury_mem.h"
 
 #ifdef HG_HAS_SM_ROUTING
@@ -44,6 +44,7 @@
 #define HG_CORE_MAX_SELF_THREADS    4
 #define HG_CORE_MASK_NBITS          8
 #define HG_CORE_ATOMIC_QUEUE_SIZE   1024
+#define HG_CORE_NA_TRIGGER_COUNT    16
 #define HG_CORE_PENDING_INCR        256
 #define HG_CORE_PROCESSING_TIMEOUT  1000
 #ifdef HG_HAS_SM_ROUTING
@@ -101,6 +102,7 @@ struct hg_class {
     void (*data_free_callback)(void *); /* User data free callback */
     hg_atomic_int32_t n_contexts;       /* Atomic used for number of contexts */
     hg_atomic_int32_t n_addrs;          /* Atomic used for number of addrs */
+    struct hg_bulk_pool *bulk_pool;     /* Pool of free bulk handles */
 
     /* Callbacks */
     hg_return_t (*create)(
@@ -127,9 +129,7 @@ struct hg_context {
     struct hg_poll_set *poll_set;                 /* Context poll set */
     /* Pointer to function used for making progress */
     hg_return_t (*progress)(struct hg_context *context, unsigned int timeout);
-    struct hg_atomic_queue *completion_queue;     /* Default completion queue */
-    HG_QUEUE_HEAD(hg_completion_entry) backfill_queue; /* Backfill completion queue */
-    hg_atomic_int32_t backfill_queue_count;       /* Backfill queue count */
+    struct hg_atomic_seg_queue *completion_queue; /* Default completion queue */
     hg_thread_mutex_t completion_queue_mutex;     /* Completion queue mutex */
     hg_thread_cond_t  completion_queue_cond;      /* Completion queue cond */
     hg_atomic_int32_t trigger_waiting;            /* Waiting in trigger */
@@ -141,6 +141,7 @@ struct hg_context {
 #endif
     HG_LIST_HEAD(hg_handle) created_list;         /* List of handles for that context */
     hg_thread_spin_t created_list_lock;           /* Handle list lock */
+    struct hg_bulk_op_pool *bulk_op_pool;         /* Pool of free bulk op IDs */
 #ifdef HG_HAS_SELF_FORWARD
     int completion_queue_notify;                  /* Self notification */
     hg_thread_pool_t *self_processing_pool;       /* Thread pool for self processing */
@@ -696,6 +697,15 @@ hg_core_reset_post(
         struct hg_handle *hg_handle
         );
 
+/**
+ * Trigger NA callbacks in batches of HG_CORE_NA_TRIGGER_COUNT.
+ */
+static HG_INLINE na_return_t
+hg_core_trigger_na(
+        na_context_t *na_context,
+        unsigned int *completed_count
+        );
+
 /**
  * Make progress on NA layer.
  */
@@ -791,6 +801,54 @@ hg_bulk_trigger_entry(
         struct hg_bulk_op_id *hg_bulk_op_id
         );
 
+/**
+ * Create bulk handle pool.
+ */
+extern struct hg_bulk_pool *
+hg_bulk_pool_create(
+        void
+        );
+
+/**
+ * Destroy bulk handle pool.
+ */
+extern void
+hg_bulk_pool_destroy(
+        struct hg_bulk_pool *hg_bulk_pool
+        );
+
+/**
+ * Get bulk handle pool from class.
+ */
+struct hg_bulk_pool *
+hg_core_class_get_bulk_pool(
+        const struct hg_class *hg_class
+        );
+
+/**
+ * Create bulk op ID pool.
+ */
+extern struct hg_bulk_op_pool *
+hg_bulk_op_pool_create(
+        void
+        );
+
+/**
+ * Destroy bulk op ID pool.
+ */
+extern void
+hg_bulk_op_pool_destroy(
+        struct hg_bulk_op_pool *hg_bulk_op_pool
+        );
+
+/**
+ * Get bulk op ID pool from context.
+ */
+struct hg_bulk_op_pool *
+hg_core_context_get_bulk_op_pool(
+        const struct hg_context *context
+        );
+
 /**
  * Cancel handle.
  */
@@ -1230,6 +1288,14 @@ hg_core_init(const char *na_info_string, hg_bool_t na_listen,
     /* Initialize mutex */
     hg_thread_spin_init(&hg_class->func_map_lock);
 
+    /* Create pool of bulk handles */
+    hg_class->bulk_pool = hg_bulk_pool_create();
+    if (!hg_class->bulk_pool) {
+        HG_LOG_ERROR("Could not create bulk pool");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+
 done:
     if (ret != HG_SUCCESS) {
         hg_core_finalize(hg_class);
@@ -1275,6 +1341,10 @@ hg_core_finalize(struct hg_class *hg_class)
     /* Destroy mutex */
     hg_thread_spin_destroy(&hg_class->func_map_lock);
 
+    /* Destroy pool of bulk handles */
+    hg_bulk_pool_destroy(hg_class->bulk_pool);
+    hg_class->bulk_pool = NULL;
+
     if (!hg_class->na_ext_init) {
         /* Finalize interface */
         if (NA_Finalize(hg_class->na_class) != NA_SUCCESS) {
@@ -2621,6 +2691,20 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+struct hg_bulk_pool *
+hg_core_class_get_bulk_pool(const struct hg_class *hg_class)
+{
+    return hg_class->bulk_pool;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_bulk_op_pool *
+hg_core_context_get_bulk_op_pool(const struct hg_context *context)
+{
+    return context->bulk_op_pool;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 hg_core_completion_add(struct hg_context *context,
@@ -2634,14 +2718,12 @@ hg_core_completion_add(struct hg_context *context,
         hg_core_stat_incr(&hg_core_bulk_count_g);
 #endif
 
-    if (hg_atomic_queue_push(context->completion_queue, hg_completion_entry)
-        != HG_UTIL_SUCCESS) {
-        /* Queue is full */
-        hg_thread_mutex_lock(&context->completion_queue_mutex);
-        HG_QUEUE_PUSH_TAIL(&context->backfill_queue, hg_completion_entry,
-            entry);
-        hg_atomic_incr32(&context->backfill_queue_count);
-        hg_thread_mutex_unlock(&context->completion_queue_mutex);
+    /* Queue is unbounded, push only fails if no segment can be allocated */
+    if (hg_atomic_seg_queue_push(context->completion_queue,
+        hg_completion_entry) != HG_UTIL_SUCCESS) {
+        HG_LOG_ERROR("Could not push completion entry");
+        ret = HG_NOMEM_ERROR;
+        goto done;
     }
 
     if (hg_atomic_get32(&context->trigger_waiting)) {
@@ -2663,6 +2745,7 @@ hg_core_completion_add(struct hg_context *context,
     (void) self_notify;
 #endif
 
+done:
     return ret;
 }
 
@@ -2799,8 +2882,8 @@ hg_core_completion_queue_notify_cb(void *arg, unsigned int timeout,
         ret = HG_PROTOCOL_ERROR;
         goto done;
     }
-    if (notified || !hg_atomic_queue_is_empty(context->completion_queue)
-        || hg_atomic_get32(&context->backfill_queue_count)) {
+    if (notified
+        || !hg_atomic_seg_queue_is_empty(context->completion_queue)) {
         *progressed = HG_UTIL_TRUE; /* Progressed */
         goto done;
     }
@@ -2812,6 +2895,28 @@ done:
 }
 #endif
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE na_return_t
+hg_core_trigger_na(na_context_t *na_context, unsigned int *completed_count)
+{
+    int cb_ret[HG_CORE_NA_TRIGGER_COUNT] = {0};
+    unsigned int actual_count, i;
+    na_return_t na_ret;
+
+    /* Completions are handed over from NA in batches, see NA_Trigger() */
+    do {
+        actual_count = 0;
+        na_ret = NA_Trigger(na_context, 0, HG_CORE_NA_TRIGGER_COUNT, cb_ret,
+            &actual_count);
+
+        /* Return value of callback is completion count */
+        for (i = 0; i < actual_count; i++)
+            *completed_count += (unsigned int) cb_ret[i];
+    } while ((na_ret == NA_SUCCESS) && actual_count);
+
+    return na_ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static int
 hg_core_progress_na_cb(void *arg, unsigned int timeout,
@@ -2819,10 +2924,8 @@ hg_core_progress_na_cb(void *arg, unsigned int timeout,
 {
     struct hg_context *context = (struct hg_context *) arg;
     struct hg_class *hg_class = context->hg_class;
-    unsigned int actual_count = 0;
     na_return_t na_ret;
     unsigned int completed_count = 0;
-    int cb_ret[1] = {0};
     int ret = HG_UTIL_SUCCESS;
 
     /* Check progress on NA (no need to call try_wait here) */
@@ -2840,18 +2943,13 @@ hg_core_progress_na_cb(void *arg, unsigned int timeout,
 
     /* Trigger everything we can from NA, if something completed it will
      * be moved to the HG context completion queue */
-    do {
-        na_ret = NA_Trigger(context->na_context, 0, 1, cb_ret, &actual_count);
-
-        /* Return value of callback is completion count */
-        completed_count += (unsigned int) cb_ret[0];
-    } while ((na_ret == NA_SUCCESS) && actual_count);
+    hg_core_trigger_na(context->na_context, &completed_count);
 
     /* We can't only verify that the completion queue is not empty, we need
      * to check what was added to the completion queue, as the completion queue
      * may have been concurrently emptied */
-    if (!completed_count && hg_atomic_queue_is_empty(context->completion_queue)
-        && !hg_atomic_get32(&context->backfill_queue_count)) {
+    if (!completed_count
+        && hg_atomic_seg_queue_is_empty(context->completion_queue)) {
         /* Nothing progressed */
         *progressed = HG_UTIL_FALSE;
         goto done;
@@ -2871,10 +2969,8 @@ hg_core_progress_na_sm_cb(void *arg, unsigned int timeout,
 {
     struct hg_context *context = (struct hg_context *) arg;
     struct hg_class *hg_class = context->hg_class;
-    unsigned int actual_count = 0;
     na_return_t na_ret;
     unsigned int completed_count = 0;
-    int cb_ret[1] = {0};
     int ret = HG_UTIL_SUCCESS;
 
     /* Check progress on NA SM (no need to call try_wait here) */
@@ -2892,18 +2988,13 @@ hg_core_progress_na_sm_cb(void *arg, unsigned int timeout,
 
     /* Trigger everything we can from NA, if something completed it will
      * be moved to the HG context completion queue */
-    do {
-        na_ret = NA_Trigger(context->na_sm_context, 0, 1, cb_ret, &actual_count);
-
-        /* Return value of callback is completion count */
-        completed_count += (unsigned int) cb_ret[0];
-    } while ((na_ret == NA_SUCCESS) && actual_count);
+    hg_core_trigger_na(context->na_sm_context, &completed_count);
 
     /* We can't only verify that the completion queue is not empty, we need
      * to check what was added to the completion queue, as the completion queue
      * may have been concurrently emptied */
-    if (!completed_count && hg_atomic_queue_is_empty(context->completion_queue)
-        && !hg_atomic_get32(&context->backfill_queue_count)) {
+    if (!completed_count
+        && hg_atomic_seg_queue_is_empty(context->completion_queue)) {
         /* Nothing progressed */
         *progressed = HG_UTIL_FALSE;
         goto done;
@@ -2933,8 +3024,6 @@ hg_core_progress_na(struct hg_context *context, unsigned int timeout)
 
     for (;;) {
         struct hg_class *hg_class = context->hg_class;
-        unsigned int actual_count = 0;
-        int cb_ret[1] = {0};
         unsigned int completed_count = 0;
         unsigned int progress_timeout;
         na_return_t na_ret;
@@ -2942,20 +3031,13 @@ hg_core_progress_na(struct hg_context *context, unsigned int timeout)
 
         /* Trigger everything we can from NA, if something completed it will
          * be moved to the HG context completion queue */
-        do {
-            na_ret = NA_Trigger(context->na_context, 0, 1, cb_ret,
-                &actual_count);
-
-            /* Return value of callback is completion count */
-            completed_count += (unsigned int)cb_ret[0];
-        } while ((na_ret == NA_SUCCESS) && actual_count);
+        hg_core_trigger_na(context->na_context, &completed_count);
 
         /* We can't only verify that the completion queue is not empty, we need
          * to check what was added to the completion queue, as the completion
          * queue may have been concurrently emptied */
         if (completed_count
-            || !hg_atomic_queue_is_empty(context->completion_queue)
-            || hg_atomic_get32(&context->backfill_queue_count)) {
+            || !hg_atomic_seg_queue_is_empty(context->completion_queue)) {
             ret = HG_SUCCESS; /* Progressed */
             break;
         }
@@ -3009,8 +3091,7 @@ hg_core_poll_try_wait_cb(void *arg)
         return NA_FALSE;
 
     /* Something is in one of the completion queues */
-    if (!hg_atomic_queue_is_empty(hg_context->completion_queue) ||
-        hg_atomic_get32(&hg_context->backfill_queue_count)) {
+    if (!hg_atomic_seg_queue_is_empty(hg_context->completion_queue)) {
         return NA_FALSE;
     }
 
@@ -3094,18 +3175,12 @@ hg_core_trigger(struct hg_context *context, unsigned int timeout,
         struct hg_completion_entry *hg_completion_entry = NULL;
 
         hg_completion_entry =
-            hg_atomic_queue_pop_mc(context->completion_queue);
+            hg_atomic_seg_queue_pop(context->completion_queue);
         if (!hg_completion_entry) {
-            /* Check backfill queue */
-            if (hg_atomic_get32(&context->backfill_queue_count)) {
-                hg_thread_mutex_lock(&context->completion_queue_mutex);
-                hg_completion_entry = HG_QUEUE_FIRST(&context->backfill_queue);
-                HG_QUEUE_POP_HEAD(&context->backfill_queue, entry);
-                hg_atomic_decr32(&context->backfill_queue_count);
-                hg_thread_mutex_unlock(&context->completion_queue_mutex);
-                if (!hg_completion_entry)
-                    continue; /* Give another change to grab it */
-            } else {
+            /* Push may still be in progress */
+            if (!hg_atomic_seg_queue_is_empty(context->completion_queue))
+                continue; /* Give another change to grab it */
+            else {
                 hg_time_t t1, t2;
 
                 /* If something was already processed leave */
@@ -3123,8 +3198,8 @@ hg_core_trigger(struct hg_context *context, unsigned int timeout,
                 hg_atomic_incr32(&context->trigger_waiting);
                 hg_thread_mutex_lock(&context->completion_queue_mutex);
                 /* Otherwise wait timeout ms */
-                while (hg_atomic_queue_is_empty(context->completion_queue) &&
-                    !hg_atomic_get32(&context->backfill_queue_count)) {
+                while (hg_atomic_seg_queue_is_empty(
+                    context->completion_queue)) {
                     if (hg_thread_cond_timedwait(&context->completion_queue_cond,
                         &context->completion_queue_mutex, timeout)
                         != HG_UTIL_SUCCESS) {
@@ -3614,14 +3689,12 @@ HG_Core_context_create_id(hg_class_t *hg_class, hg_uint8_t id)
     memset(context, 0, sizeof(struct hg_context));
     context->hg_class = hg_class;
     context->completion_queue =
-        hg_atomic_queue_alloc(HG_CORE_ATOMIC_QUEUE_SIZE);
+        hg_atomic_seg_queue_alloc(HG_CORE_ATOMIC_QUEUE_SIZE);
     if (!context->completion_queue) {
         HG_LOG_ERROR("Could not allocate queue");
         ret = HG_NOMEM_ERROR;
         goto done;
     }
-    HG_QUEUE_INIT(&context->backfill_queue);
-    hg_atomic_init32(&context->backfill_queue_count, 0);
     HG_LIST_INIT(&context->pending_list);
 #ifdef HG_HAS_SM_ROUTING
     HG_LIST_INIT(&context->sm_pending_list);
@@ -3642,6 +3715,14 @@ HG_Core_context_create_id(hg_class_t *hg_class, hg_uint8_t id)
 #endif
     hg_thread_spin_init(&context->created_list_lock);
 
+    /* Create pool of bulk op IDs */
+    context->bulk_op_pool = hg_bulk_op_pool_create();
+    if (!context->bulk_op_pool) {
+        HG_LOG_ERROR("Could not create bulk op pool");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+
     context->na_context = NA_Context_create_id(hg_class->na_class, id);
     if (!context->na_context) {
         HG_LOG_ERROR("Could not create NA context");
@@ -3814,22 +3895,12 @@ HG_Core_context_destroy(hg_context_t *context)
     }
 
     /* Check that completion queue is empty now */
-    if (!hg_atomic_queue_is_empty(context->completion_queue)) {
-        HG_LOG_ERROR("Completion queue should be empty");
-        ret = HG_PROTOCOL_ERROR;
-        goto done;
-    }
-    hg_atomic_queue_free(context->completion_queue);
-
-    /* Check that completion queue is empty now */
-    hg_thread_mutex_lock(&context->completion_queue_mutex);
-    if (!HG_QUEUE_IS_EMPTY(&context->backfill_queue)) {
+    if (!hg_atomic_seg_queue_is_empty(context->completion_queue)) {
         HG_LOG_ERROR("Completion queue should be empty");
         ret = HG_PROTOCOL_ERROR;
-        hg_thread_mutex_unlock(&context->completion_queue_mutex);
         goto done;
     }
-    hg_thread_mutex_unlock(&context->completion_queue_mutex);
+    hg_atomic_seg_queue_free(context->completion_queue);
 
 #ifdef HG_HAS_SELF_FORWARD
     if (context->completion_queue_notify > 0) {
@@ -3917,6 +3988,9 @@ HG_Core_context_destroy(hg_context_t *context)
 #endif
     hg_thread_spin_destroy(&context->created_list_lock);
 
+    /* Destroy pool of bulk op IDs */
+    hg_bulk_op_pool_destroy(context->bulk_op_pool);
+
     /* Decrement context count of parent class */
     hg_atomic_decr32(&context->hg_class->n_contexts);
 
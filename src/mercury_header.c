@@ -88,6 +88,7 @@ hg_header_proc(hg_proc_op_t op, void *buf, size_t buf_size,
 #ifdef HG_HAS_CHECKSUMS
     struct hg_header_hash *header_hash = NULL;
 #endif
+    hg_uint32_t *eager_push = NULL;
     hg_return_t ret = HG_SUCCESS;
 
     switch (hg_header->op) {
@@ -100,6 +101,7 @@ hg_header_proc(hg_proc_op_t op, void *buf, size_t buf_size,
 #ifdef HG_HAS_CHECKSUMS
             header_hash = &hg_header->msg.input.hash;
 #endif
+            eager_push = &hg_header->msg.input.eager_push;
             break;
         case HG_OUTPUT:
             if (buf_size < sizeof(struct hg_header_output)) {
@@ -110,20 +112,20 @@ hg_header_proc(hg_proc_op_t op, void *buf, size_t buf_size,
 #ifdef HG_HAS_CHECKSUMS
             header_hash = &hg_header->msg.output.hash;
 #endif
+            eager_push = &hg_header->msg.output.eager_push_size;
             break;
         default:
-            break;
+            goto done;
     }
 
 #ifdef HG_HAS_CHECKSUMS
     /* Checksum of user payload */
     HG_HEADER_PROC32(hg_header, buf_ptr, header_hash->payload, op, tmp);
-#else
-    (void) hg_header;
-    (void) buf_ptr;
-    (void) op;
 #endif
 
+    /* Eager push mask (input) or eager push data size (output) */
+    HG_HEADER_PROC32(hg_header, buf_ptr, *eager_push, op, tmp);
+
 done:
     return ret;
 }
@@ -39,17 +39,18 @@ struct hg_header_input {
 #ifdef HG_HAS_CHECKSUMS
     struct hg_header_hash hash; /* Hash */
 #else
-    hg_uint64_t pad;
+    hg_uint32_t pad;
 #endif
-    /* 128 bits here */
+    hg_uint32_t eager_push;     /* Bulk handles accepting eager push (mask) */
+    /* 64 bits here */
 };
 
 struct hg_header_output {
 #ifdef HG_HAS_CHECKSUMS
     struct hg_header_hash hash; /* Hash */
 #endif
-    hg_uint32_t pad;
-    /* 128/64 bits here */
+    hg_uint32_t eager_push_size; /* Size of eager push data after header */
+    /* 64/32 bits here */
 };
 #if defined(__GNUC__) || defined(_WIN32)
 # pragma pack(pop)
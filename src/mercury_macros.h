@@ -56,8 +56,8 @@ typedef struct \
       return ret; \
     }
 
-/* Generate proc for struct */
-#define HG_GEN_STRUCT_PROC(struct_type_name, fields) \
+/* Generate proc for struct, one proc call per field */
+#define HG_GEN_STRUCT_PROC_FIELDS(struct_type_name, fields) \
 static HG_INLINE hg_return_t \
     BOOST_PP_CAT(hg_proc_, struct_type_name) \
     (hg_proc_t proc, void *data) \
@@ -70,6 +70,106 @@ static HG_INLINE hg_return_t \
     return ret; \
 }
 
+/* Fixed-width types that are encoded as is, HG_GEN_IS_POD(type) expands to 1
+ * if type is one of them and to 0 otherwise */
+#define HG_GEN_POD_PROBE ~, 1
+#define HG_GEN_POD_CHECK_N(x, n, ...) n
+#define HG_GEN_POD_CHECK(...) HG_GEN_POD_CHECK_N(__VA_ARGS__, 0, ~)
+#define HG_GEN_IS_POD(type) HG_GEN_POD_CHECK(BOOST_PP_CAT(HG_GEN_POD_, type))
+
+#define HG_GEN_POD_int8_t       HG_GEN_POD_PROBE
+#define HG_GEN_POD_uint8_t      HG_GEN_POD_PROBE
+#define HG_GEN_POD_int16_t      HG_GEN_POD_PROBE
+#define HG_GEN_POD_uint16_t     HG_GEN_POD_PROBE
+#define HG_GEN_POD_int32_t      HG_GEN_POD_PROBE
+#define HG_GEN_POD_uint32_t     HG_GEN_POD_PROBE
+#define HG_GEN_POD_int64_t      HG_GEN_POD_PROBE
+#define HG_GEN_POD_uint64_t     HG_GEN_POD_PROBE
+#define HG_GEN_POD_hg_int8_t    HG_GEN_POD_PROBE
+#define HG_GEN_POD_hg_uint8_t   HG_GEN_POD_PROBE
+#define HG_GEN_POD_hg_int16_t   HG_GEN_POD_PROBE
+#define HG_GEN_POD_hg_uint16_t  HG_GEN_POD_PROBE
+#define HG_GEN_POD_hg_int32_t   HG_GEN_POD_PROBE
+#define HG_GEN_POD_hg_uint32_t  HG_GEN_POD_PROBE
+#define HG_GEN_POD_hg_int64_t   HG_GEN_POD_PROBE
+#define HG_GEN_POD_hg_uint64_t  HG_GEN_POD_PROBE
+#define HG_GEN_POD_hg_bool_t    HG_GEN_POD_PROBE
+#define HG_GEN_POD_hg_ptr_t     HG_GEN_POD_PROBE
+#define HG_GEN_POD_hg_size_t    HG_GEN_POD_PROBE
+#define HG_GEN_POD_hg_id_t      HG_GEN_POD_PROBE
+
+/* Check that all fields are fixed-width types */
+#define HG_GEN_POD_AND(s, state, field) \
+    BOOST_PP_BITAND(state, HG_GEN_IS_POD(HG_GEN_GET_TYPE(field)))
+#define HG_GEN_ALL_POD(fields) \
+    BOOST_PP_SEQ_FOLD_LEFT(HG_GEN_POD_AND, 1, fields)
+
+/* Get encoded size of fixed-width field */
+#define HG_GEN_POD_SIZE(r, data, field) \
+    + sizeof(HG_GEN_GET_TYPE(field))
+
+/* Copy fixed-width field to / from buffer */
+#define HG_GEN_POD_ENCODE(r, struct_name, field) \
+    memcpy(buf_ptr, &struct_name->HG_GEN_GET_NAME(field), \
+        sizeof(HG_GEN_GET_TYPE(field))); \
+    buf_ptr += sizeof(HG_GEN_GET_TYPE(field));
+#define HG_GEN_POD_DECODE(r, struct_name, field) \
+    memcpy(&struct_name->HG_GEN_GET_NAME(field), buf_ptr, \
+        sizeof(HG_GEN_GET_TYPE(field))); \
+    buf_ptr += sizeof(HG_GEN_GET_TYPE(field));
+
+/* Generate proc for struct of fixed-width fields, space for all the fields
+ * is reserved at once and fields are copied in place. The encoding is the
+ * same as the one of HG_GEN_STRUCT_PROC_FIELDS, which is used instead when
+ * fields must be converted (XDR or big-endian hosts). */
+#if defined(HG_HAS_XDR) || defined(HG_BIG_ENDIAN)
+#define HG_GEN_STRUCT_PROC_POD(struct_type_name, fields) \
+    HG_GEN_STRUCT_PROC_FIELDS(struct_type_name, fields)
+#else
+#define HG_GEN_STRUCT_PROC_POD(struct_type_name, fields) \
+static HG_INLINE hg_return_t \
+    BOOST_PP_CAT(hg_proc_, struct_type_name) \
+    (hg_proc_t proc, void *data) \
+{   \
+    hg_return_t ret = HG_SUCCESS; \
+    struct_type_name *struct_data = (struct_type_name *) data; \
+    hg_size_t size = 0 BOOST_PP_SEQ_FOR_EACH(HG_GEN_POD_SIZE, , fields); \
+    char *buf_ptr; \
+    \
+    switch (hg_proc_get_op(proc)) { \
+        case HG_ENCODE: \
+            buf_ptr = (char *) hg_proc_save_ptr(proc, size); \
+            if (!buf_ptr) { \
+                HG_LOG_ERROR("Proc error"); \
+                return HG_SIZE_ERROR; \
+            } \
+            BOOST_PP_SEQ_FOR_EACH(HG_GEN_POD_ENCODE, struct_data, fields) \
+            break; \
+        case HG_DECODE: \
+            buf_ptr = (char *) hg_proc_save_ptr(proc, size); \
+            if (!buf_ptr) { \
+                HG_LOG_ERROR("Proc error"); \
+                return HG_SIZE_ERROR; \
+            } \
+            BOOST_PP_SEQ_FOR_EACH(HG_GEN_POD_DECODE, struct_data, fields) \
+            break; \
+        case HG_SIZE: \
+            hg_proc_save_ptr(proc, size); \
+            break; \
+        default: \
+            break; \
+    } \
+    \
+    return ret; \
+}
+#endif
+
+/* Generate proc for struct, structs made of fixed-width fields only are
+ * processed in a single pass */
+#define HG_GEN_STRUCT_PROC(struct_type_name, fields) \
+    BOOST_PP_IIF(HG_GEN_ALL_POD(fields), HG_GEN_STRUCT_PROC_POD, \
+        HG_GEN_STRUCT_PROC_FIELDS)(struct_type_name, fields)
+
 /*****************/
 /* Public Macros */
 /*****************/
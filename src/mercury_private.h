@@ -14,6 +14,7 @@
 #include "mercury_types.h"
 
 #include "mercury_queue.h"
+#include "mercury_thread_spin.h"
 
 /*************************************/
 /* Public Type and Struct Definition */
@@ -34,7 +35,15 @@ struct hg_completion_entry {
         struct hg_handle *hg_handle;
         struct hg_bulk_op_id *hg_bulk_op_id;
     } op_id;
-    HG_QUEUE_ENTRY(hg_completion_entry) entry;
+};
+
+/* Small bulk data pushed back to the origin within the RPC response */
+struct hg_bulk_eager_push {
+    char *buf;                  /* Buffer of pushed records */
+    hg_size_t size;             /* Size used */
+    hg_size_t max_size;         /* Max size that can be used */
+    hg_bool_t active;           /* Response has not been sent yet */
+    hg_thread_spin_t lock;      /* Lock */
 };
 
 #endif /* MERCURY_PRIVATE_H */
@@ -9,10 +9,12 @@
  */
 
 #include "mercury_proc.h"
+#include "mercury_proc_private.h"
 #include "mercury_proc_buf.h"
 #include "mercury_mem.h"
 
 #ifdef HG_HAS_CHECKSUMS
+# include "mercury_crc32c.h"
 # include <mchecksum.h>
 # include <mchecksum_error.h>
 #endif
@@ -21,6 +23,16 @@
 /* Local Macros */
 /****************/
 
+/* Capacity of a proc that only computes the encoded size */
+#define HG_PROC_SIZE_MAX ((hg_size_t) -1)
+
+/* Minimum size of arena chunks */
+#define HG_PROC_ARENA_CHUNK_SIZE 4096
+
+/* Alignment of arena allocations */
+#define HG_PROC_ARENA_ALIGN(size) \
+    (((size) + sizeof(hg_uint64_t) - 1) & ~((hg_size_t) sizeof(hg_uint64_t) - 1))
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -36,15 +48,29 @@ struct hg_proc_buf {
 #endif
 };
 
+struct hg_proc_arena_chunk {
+    struct hg_proc_arena_chunk *next;   /* Previously allocated chunk */
+    hg_size_t size;                     /* Usable size of chunk */
+    hg_size_t used;                     /* Size already allocated */
+    hg_uint64_t mem[];                  /* Chunk memory */
+};
+
 struct hg_proc {
     hg_class_t *hg_class;               /* HG class */
     hg_proc_op_t op;
     struct hg_proc_buf proc_buf;
     struct hg_proc_buf extra_buf;
     struct hg_proc_buf *current_buf;
+    hg_bulk_t bulk_handles[HG_PROC_BULK_TRACK_MAX]; /* Recorded bulk handles */
+    hg_uint32_t bulk_count;             /* Number of recorded bulk handles */
+    hg_bool_t bulk_track;               /* Record bulk handles */
+    hg_uint8_t bulk_flags;              /* Bulk serialization flags */
+    hg_bool_t array_borrow;             /* Decoded arrays point into buf */
+    struct hg_proc_arena_chunk *arena;  /* Decode memory, rewound on reset */
 #ifdef HG_HAS_CHECKSUMS
-    mchecksum_object_t checksum;    /* Checksum */
-    void *checksum_hash;            /* Base checksum buf */
+    hg_proc_hash_t hash;            /* Hash method */
+    mchecksum_object_t checksum;    /* Checksum (CRC16/CRC64 only) */
+    hg_uint64_t checksum_hash;      /* Checksum of data processed */
     size_t checksum_size;           /* Checksum size */
 #endif
 };
@@ -54,27 +80,81 @@ struct hg_proc {
 /********************/
 
 /**
- * Update checksum.
+ * Grow the extra buffer so that data_size more bytes fit, at least doubling
+ * its size so that encoding large payloads piecewise remains linear.
  */
-#ifdef HG_HAS_CHECKSUMS
-static HG_INLINE hg_return_t
-hg_proc_checksum_update(
-        hg_proc_t proc,
-        void *data,
+static hg_return_t
+hg_proc_grow(
+        struct hg_proc *hg_proc,
         hg_size_t data_size
         );
+
+/**
+ * Release arena chunks, keeping the most recent (and largest) chunk for
+ * reuse if keep is set.
+ */
+static void
+hg_proc_arena_release(
+        struct hg_proc *hg_proc,
+        hg_bool_t keep
+        );
+
+#ifdef HG_HAS_XDR
+/**
+ * Update buffer position from the XDR stream, which XDR routines advance
+ * without going through the proc.
+ */
+static HG_INLINE void
+hg_proc_xdr_sync(
+        struct hg_proc_buf *proc_buf
+        );
+
+/**
+ * Create XDR stream on buffer for operation op.
+ */
+static hg_return_t
+hg_proc_xdr_create(
+        struct hg_proc_buf *proc_buf,
+        hg_proc_op_t op
+        );
+#endif
+
+#ifdef HG_HAS_CHECKSUMS
+/**
+ * Set hash method used for computing checksum.
+ */
+static hg_return_t
+hg_proc_checksum_init(
+        struct hg_proc *hg_proc,
+        hg_proc_hash_t hash
+        );
+
+/**
+ * Compute checksum of data processed, in a single pass over the buffer.
+ */
+static hg_return_t
+hg_proc_checksum_compute(
+        struct hg_proc *hg_proc
+        );
 #endif
 
 /*******************/
 /* Local Variables */
 /*******************/
 
+/*---------------------------------------------------------------------------*/
+hg_size_t
+hg_proc_get_struct_size(void)
+{
+    return sizeof(struct hg_proc);
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
-hg_proc_create(hg_class_t *hg_class, hg_proc_hash_t hash, hg_proc_t *proc)
+hg_proc_init(hg_class_t *hg_class, hg_proc_hash_t hash, void *mem,
+    hg_proc_t *proc)
 {
-    struct hg_proc *hg_proc = NULL;
-    const char *hash_method;
+    struct hg_proc *hg_proc = (struct hg_proc *) mem;
     hg_return_t ret = HG_SUCCESS;
 
     if (!hg_class) {
@@ -83,57 +163,50 @@ hg_proc_create(hg_class_t *hg_class, hg_proc_hash_t hash, hg_proc_t *proc)
         goto done;
     }
 
-    hg_proc = (struct hg_proc *) malloc(sizeof(struct hg_proc));
-    if (!hg_proc) {
-        HG_LOG_ERROR("Could not allocate proc");
-        ret = HG_NOMEM_ERROR;
-        goto done;
-    }
     memset(hg_proc, 0, sizeof(struct hg_proc));
     hg_proc->hg_class = hg_class;
+    hg_proc->bulk_flags = HG_BULK_SERIALIZE_NA | HG_BULK_SERIALIZE_SM;
 
-    /* Map enum to string */
-    switch (hash) {
-        case HG_CRC16:
-            hash_method = "crc16";
-            break;
-        case HG_CRC32:
-            hash_method = "crc32c";
-            break;
-        case HG_CRC64:
-            hash_method = "crc64";
-            break;
-        default:
-            hash_method = NULL;
-            break;
-    }
-
-    if (hash_method) {
 #ifdef HG_HAS_CHECKSUMS
-        int checksum_ret;
-
-        checksum_ret = mchecksum_init(hash_method, &hg_proc->checksum);
-        if (checksum_ret != MCHECKSUM_SUCCESS) {
-            HG_LOG_ERROR("Could not initialize checksum");
-            ret = HG_CHECKSUM_ERROR;
-            goto done;
-        }
-
-        hg_proc->checksum_size = mchecksum_get_size(hg_proc->checksum);
-        hg_proc->checksum_hash = (char *) malloc(hg_proc->checksum_size);
-        if (!hg_proc->checksum_hash) {
-            HG_LOG_ERROR("Could not allocate space for checksum hash");
-            ret = HG_NOMEM_ERROR;
-            goto done;
-        }
-#endif
+    hg_proc->hash = HG_NOHASH;
+    ret = hg_proc_checksum_init(hg_proc, hash);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not initialize checksum");
+        goto done;
     }
+#else
+    (void) hash;
+#endif
 
     /* Default to proc_buf */
     hg_proc->current_buf = &hg_proc->proc_buf;
 
     *proc = (struct hg_proc *) hg_proc;
 
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_create(hg_class_t *hg_class, hg_proc_hash_t hash, hg_proc_t *proc)
+{
+    struct hg_proc *hg_proc = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_proc = (struct hg_proc *) malloc(sizeof(struct hg_proc));
+    if (!hg_proc) {
+        HG_LOG_ERROR("Could not allocate proc");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+
+    ret = hg_proc_init(hg_class, hash, hg_proc, proc);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not initialize proc");
+        goto done;
+    }
+
 done:
     if (ret != HG_SUCCESS) {
         free(hg_proc);
@@ -176,6 +249,22 @@ hg_proc_free(hg_proc_t proc)
 
     if (!hg_proc) goto done;
 
+    ret = hg_proc_finalize(proc);
+
+    /* Free proc */
+    free(hg_proc);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_finalize(hg_proc_t proc)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    hg_return_t ret = HG_SUCCESS;
+
 #ifdef HG_HAS_CHECKSUMS
     if (hg_proc->checksum != MCHECKSUM_OBJECT_NULL) {
         int checksum_ret;
@@ -186,18 +275,14 @@ hg_proc_free(hg_proc_t proc)
             ret = HG_CHECKSUM_ERROR;
         }
     }
-
-    free(hg_proc->checksum_hash);
 #endif
 
     /* Free extra proc buffer if needed */
     if (hg_proc->extra_buf.buf && hg_proc->extra_buf.is_mine)
         hg_mem_aligned_free(hg_proc->extra_buf.buf);
 
-    /* Free proc */
-    free(hg_proc);
+    hg_proc_arena_release(hg_proc, HG_FALSE);
 
-done:
     return ret;
 }
 
@@ -210,35 +295,31 @@ hg_proc_reset(hg_proc_t proc, void *buf, hg_size_t buf_size, hg_proc_op_t op)
 
     if (!hg_proc) goto done;
 
-    if (!buf && op != HG_FREE) {
+    if (!buf && op != HG_FREE && op != HG_SIZE) {
         HG_LOG_ERROR("NULL buffer");
         ret = HG_INVALID_PARAM;
         goto done;
     }
     hg_proc->op = op;
-#ifdef HG_HAS_XDR
-    switch (op) {
-        case HG_ENCODE:
-            xdrmem_create(&hg_proc->proc_buf.xdr, (char *) buf, buf_size, XDR_ENCODE);
-            break;
-        case HG_DECODE:
-            xdrmem_create(&hg_proc->proc_buf.xdr, (char *) buf, buf_size, XDR_DECODE);
-            break;
-        case HG_FREE:
-            xdrmem_create(&hg_proc->proc_buf.xdr, (char *) buf, buf_size, XDR_FREE);
-            break;
-        default:
-            HG_LOG_ERROR("Unknown proc operation");
-            ret = HG_INVALID_PARAM;
-            goto done;
+
+    /* Sizing only accounts for data and never touches a buffer */
+    if (op == HG_SIZE) {
+        buf = NULL;
+        buf_size = HG_PROC_SIZE_MAX;
     }
-#endif
 
     /* Reset proc buf */
     hg_proc->proc_buf.buf = buf;
     hg_proc->proc_buf.size = buf_size;
     hg_proc->proc_buf.buf_ptr = hg_proc->proc_buf.buf;
     hg_proc->proc_buf.size_left = hg_proc->proc_buf.size;
+#ifdef HG_HAS_XDR
+    ret = hg_proc_xdr_create(&hg_proc->proc_buf, op);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not create XDR stream");
+        goto done;
+    }
+#endif
 
     /* Free extra proc buffer if needed */
     if (hg_proc->extra_buf.buf && hg_proc->extra_buf.is_mine)
@@ -251,18 +332,12 @@ hg_proc_reset(hg_proc_t proc, void *buf, hg_size_t buf_size, hg_proc_op_t op)
     /* Default to proc_buf */
     hg_proc->current_buf = &hg_proc->proc_buf;
 
+    /* Memory previously allocated from the arena is no longer in use */
+    hg_proc_arena_release(hg_proc, HG_TRUE);
+
 #ifdef HG_HAS_CHECKSUMS
     /* Reset checksum */
-    if (hg_proc->checksum != MCHECKSUM_OBJECT_NULL) {
-        int checksum_ret;
-
-        checksum_ret = mchecksum_reset(hg_proc->checksum);
-        if (checksum_ret != MCHECKSUM_SUCCESS) {
-            HG_LOG_ERROR("Could not reset checksum");
-            ret = HG_CHECKSUM_ERROR;
-        }
-        memset(hg_proc->checksum_hash, 0, hg_proc->checksum_size);
-    }
+    hg_proc->checksum_hash = 0;
 #endif
 
 done:
@@ -335,6 +410,9 @@ hg_proc_get_size_used(hg_proc_t proc)
         goto done;
     }
 
+#ifdef HG_HAS_XDR
+    hg_proc_xdr_sync(hg_proc->current_buf);
+#endif
     size = hg_proc->current_buf->size - hg_proc->current_buf->size_left;
 
 done:
@@ -354,12 +432,21 @@ hg_proc_set_size(hg_proc_t proc, hg_size_t req_buf_size)
     hg_return_t ret = HG_SUCCESS;
 
     /* Save current position */
+#ifdef HG_HAS_XDR
+    hg_proc_xdr_sync(hg_proc->current_buf);
+#endif
     current_pos = (char *) hg_proc->current_buf->buf_ptr -
         (char *) hg_proc->current_buf->buf;
 
-    /* Get one more page size buf */
-    new_buf_size = ((hg_size_t)(req_buf_size / page_size) + 1) * page_size;
-    if (new_buf_size <= hg_proc_get_size(proc)) {
+    if (hg_proc->op == HG_SIZE) {
+        HG_LOG_ERROR("Cannot set size of proc used for sizing");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    /* Round up to page size */
+    new_buf_size = ((req_buf_size + page_size - 1) / page_size) * page_size;
+    if (new_buf_size <= hg_proc->current_buf->size) {
         HG_LOG_ERROR("Buffer is already of the size requested");
         ret = HG_SIZE_ERROR;
         goto done;
@@ -390,6 +477,15 @@ hg_proc_set_size(hg_proc_t proc, hg_size_t req_buf_size)
     hg_proc->extra_buf.buf_ptr = (char *) hg_proc->extra_buf.buf + current_pos;
     hg_proc->extra_buf.size_left = hg_proc->extra_buf.size - (hg_size_t) current_pos;
     hg_proc->extra_buf.is_mine = HG_TRUE;
+#ifdef HG_HAS_XDR
+    /* Continue XDR stream at the same position in the new buffer */
+    ret = hg_proc_xdr_create(&hg_proc->extra_buf, hg_proc->op);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not create XDR stream");
+        goto done;
+    }
+    xdr_setpos(&hg_proc->extra_buf.xdr, (unsigned int) current_pos);
+#endif
 
 done:
     return ret;
@@ -407,6 +503,9 @@ hg_proc_get_size_left(hg_proc_t proc)
         goto done;
     }
 
+#ifdef HG_HAS_XDR
+    hg_proc_xdr_sync(hg_proc->current_buf);
+#endif
     size = hg_proc->current_buf->size_left;
 
 done:
@@ -419,27 +518,35 @@ hg_proc_save_ptr(hg_proc_t proc, hg_size_t data_size)
 {
     struct hg_proc *hg_proc = (struct hg_proc *) proc;
     void *ptr = NULL;
-#ifdef HG_HAS_XDR
-    unsigned int cur_pos;
-#endif
 
     if (!hg_proc) {
         HG_LOG_ERROR("Proc is not initialized");
         goto done;
     }
 
+    /* Sizing only reserves space, there is no buffer to point to */
+    if (hg_proc->op == HG_SIZE) {
+        hg_proc->current_buf->size_left -= data_size;
+        goto done;
+    }
+#ifdef HG_HAS_XDR
+    hg_proc_xdr_sync(hg_proc->current_buf);
+#endif
+
     /* If not enough space allocate extra space if encoding or
      * just get extra buffer if decoding */
-    if (data_size && hg_proc->current_buf->size_left < data_size)
-        hg_proc_set_size(proc, hg_proc->proc_buf.size +
-                hg_proc->extra_buf.size + data_size);
+    if (data_size && hg_proc->current_buf->size_left < data_size
+        && hg_proc_grow(hg_proc, data_size) != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not grow proc buffer");
+        goto done;
+    }
 
     ptr = hg_proc->current_buf->buf_ptr;
     hg_proc->current_buf->buf_ptr = (char *) hg_proc->current_buf->buf_ptr + data_size;
     hg_proc->current_buf->size_left -= data_size;
 #ifdef HG_HAS_XDR
-    cur_pos = xdr_getpos(&hg_proc->current_buf->xdr);
-    xdr_setpos(&hg_proc->current_buf->xdr, cur_pos + data_size);
+    xdr_setpos(&hg_proc->current_buf->xdr, (unsigned int)
+        (hg_proc->current_buf->size - hg_proc->current_buf->size_left));
 #endif
 
 done:
@@ -460,30 +567,84 @@ hg_proc_get_xdr_ptr(hg_proc_t proc)
 
     return ptr;
 }
-#endif
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-hg_proc_restore_ptr(hg_proc_t proc, void *data, hg_size_t data_size)
+hg_proc_xdr_reserve(hg_proc_t proc, hg_size_t data_size)
 {
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
     hg_return_t ret = HG_SUCCESS;
 
-#ifdef HG_HAS_CHECKSUMS
-    ret = hg_proc_checksum_update(proc, data, data_size);
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not update checksum");
+    /* Only encoding can grow the stream, decoding fails on truncated data */
+    if (hg_proc->op != HG_ENCODE)
         goto done;
+
+    hg_proc_xdr_sync(hg_proc->current_buf);
+    if (hg_proc->current_buf->size_left < data_size) {
+        ret = hg_proc_grow(hg_proc, data_size);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not grow proc buffer");
+            goto done;
+        }
     }
-#else
-    /* Silent warning */
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_proc_xdr_sync(struct hg_proc_buf *proc_buf)
+{
+    hg_size_t pos = (hg_size_t) xdr_getpos(&proc_buf->xdr);
+
+    proc_buf->buf_ptr = (char *) proc_buf->buf + pos;
+    proc_buf->size_left = proc_buf->size - pos;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_xdr_create(struct hg_proc_buf *proc_buf, hg_proc_op_t op)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    switch (op) {
+        case HG_ENCODE:
+            xdrmem_create(&proc_buf->xdr, (char *) proc_buf->buf,
+                (unsigned int) proc_buf->size, XDR_ENCODE);
+            break;
+        case HG_DECODE:
+            xdrmem_create(&proc_buf->xdr, (char *) proc_buf->buf,
+                (unsigned int) proc_buf->size, XDR_DECODE);
+            break;
+        case HG_FREE:
+            xdrmem_create(&proc_buf->xdr, (char *) proc_buf->buf,
+                (unsigned int) proc_buf->size, XDR_FREE);
+            break;
+        case HG_SIZE:
+            HG_LOG_ERROR("Size operation is not supported using XDR");
+            ret = HG_INVALID_PARAM;
+            break;
+        default:
+            HG_LOG_ERROR("Unknown proc operation");
+            ret = HG_INVALID_PARAM;
+            break;
+    }
+
+    return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_restore_ptr(hg_proc_t proc, void *data, hg_size_t data_size)
+{
+    /* Data is in the proc buffer and checksummed with it on flush */
     (void)proc;
     (void)data;
     (void)data_size;
-    goto done;
-#endif
 
-done:
-    return ret;
+    return HG_SUCCESS;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -522,14 +683,151 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+void
+hg_proc_set_bulk_track(hg_proc_t proc, hg_bool_t track)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+
+    if (track)
+        hg_proc->bulk_count = 0;
+    hg_proc->bulk_track = track;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_proc_bulk_track(hg_proc_t proc, hg_bulk_t handle)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+
+    if (hg_proc->bulk_track && hg_proc->bulk_count < HG_PROC_BULK_TRACK_MAX)
+        hg_proc->bulk_handles[hg_proc->bulk_count++] = handle;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_uint32_t
+hg_proc_get_bulk_count(hg_proc_t proc)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+
+    return hg_proc->bulk_count;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_proc_set_bulk_flags(hg_proc_t proc, hg_uint8_t flags)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+
+    hg_proc->bulk_flags = flags;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_uint8_t
+hg_proc_get_bulk_flags(hg_proc_t proc)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+
+    return hg_proc->bulk_flags;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_proc_set_array_borrow(hg_proc_t proc, hg_bool_t borrow)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+
+    hg_proc->array_borrow = borrow;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+hg_proc_get_array_borrow(hg_proc_t proc)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+
+    return hg_proc->array_borrow;
+}
+
+/*---------------------------------------------------------------------------*/
+void *
+hg_proc_arena_alloc(hg_proc_t proc, hg_size_t size)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    struct hg_proc_arena_chunk *chunk = hg_proc->arena;
+    hg_size_t alloc_size = HG_PROC_ARENA_ALIGN(size);
+    void *ptr = NULL;
+
+    if (alloc_size < size) {
+        HG_LOG_ERROR("Arena allocation is too large");
+        goto done;
+    }
+
+    if (!chunk || chunk->size - chunk->used < alloc_size) {
+        hg_size_t chunk_size = chunk ? chunk->size * 2 :
+            HG_PROC_ARENA_CHUNK_SIZE;
+        struct hg_proc_arena_chunk *new_chunk;
+
+        if (chunk_size < alloc_size)
+            chunk_size = alloc_size;
+        new_chunk = (struct hg_proc_arena_chunk *) malloc(
+            sizeof(struct hg_proc_arena_chunk) + (size_t) chunk_size);
+        if (!new_chunk) {
+            HG_LOG_ERROR("Could not allocate arena chunk");
+            goto done;
+        }
+        new_chunk->next = chunk;
+        new_chunk->size = chunk_size;
+        new_chunk->used = 0;
+        hg_proc->arena = chunk = new_chunk;
+    }
+
+    ptr = (char *) chunk->mem + chunk->used;
+    chunk->used += alloc_size;
+
+done:
+    return ptr;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_proc_arena_release(struct hg_proc *hg_proc, hg_bool_t keep)
+{
+    struct hg_proc_arena_chunk *chunk = hg_proc->arena;
+
+    if (!chunk)
+        return;
+
+    if (keep) {
+        chunk->used = 0;
+        chunk = chunk->next;
+        hg_proc->arena->next = NULL;
+    } else
+        hg_proc->arena = NULL;
+
+    while (chunk) {
+        struct hg_proc_arena_chunk *next = chunk->next;
+
+        free(chunk);
+        chunk = next;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+hg_bulk_t
+hg_proc_get_bulk(hg_proc_t proc, hg_uint32_t index)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+
+    return (index < hg_proc->bulk_count) ? hg_proc->bulk_handles[index] :
+        HG_BULK_NULL;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 hg_proc_flush(hg_proc_t proc)
 {
     struct hg_proc *hg_proc = (struct hg_proc *) proc;
-#ifdef HG_HAS_CHECKSUMS
-    int checksum_ret;
-#endif
     hg_return_t ret = HG_SUCCESS;
 
     if (!hg_proc) {
@@ -539,11 +837,9 @@ hg_proc_flush(hg_proc_t proc)
     }
 
 #ifdef HG_HAS_CHECKSUMS
-    checksum_ret = mchecksum_get(hg_proc->checksum, hg_proc->checksum_hash,
-        hg_proc->checksum_size, MCHECKSUM_FINALIZE);
-    if (checksum_ret != MCHECKSUM_SUCCESS) {
-        HG_LOG_ERROR("Could not get checksum");
-        ret = HG_CHECKSUM_ERROR;
+    ret = hg_proc_checksum_compute(hg_proc);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not compute checksum");
         goto done;
     }
 #endif
@@ -567,37 +863,100 @@ hg_proc_memcpy(hg_proc_t proc, void *data, hg_size_t data_size)
 
     if (hg_proc->op == HG_FREE) goto done;
 
+    /* Only account for data when sizing */
+    if (hg_proc->op == HG_SIZE) {
+        hg_proc->current_buf->size_left -= data_size;
+        goto done;
+    }
+
+#ifdef HG_HAS_XDR
+    hg_proc_xdr_sync(hg_proc->current_buf);
+#endif
+
     /* If not enough space allocate extra space if encoding or
      * just get extra buffer if decoding */
-    if (hg_proc->current_buf->size_left < data_size)
-        hg_proc_set_size(proc, hg_proc->proc_buf.size +
-                hg_proc->extra_buf.size + data_size);
+    if (hg_proc->current_buf->size_left < data_size) {
+        ret = hg_proc_grow(hg_proc, data_size);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not grow proc buffer");
+            goto done;
+        }
+    }
 
     /* Process data */
     hg_proc->current_buf->buf_ptr =
             hg_proc_buf_memcpy(hg_proc->current_buf->buf_ptr, data, data_size,
                     hg_proc->op);
     hg_proc->current_buf->size_left -= data_size;
+#ifdef HG_HAS_XDR
+    xdr_setpos(&hg_proc->current_buf->xdr, (unsigned int)
+        (hg_proc->current_buf->size - hg_proc->current_buf->size_left));
+#endif
 
-#ifdef HG_HAS_CHECKSUMS
-    ret = hg_proc_checksum_update(proc, data, data_size);
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not update checksum");
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+#if !defined(HG_HAS_XDR) && defined(HG_BIG_ENDIAN)
+hg_return_t
+hg_proc_memcpy_le(hg_proc_t proc, void *data, hg_size_t data_size)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    char *bytes = (char *) data;
+    char swapped[sizeof(hg_uint64_t)];
+    hg_size_t i;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (data_size > sizeof(swapped)) {
+        HG_LOG_ERROR("Data size exceeds integer size");
+        ret = HG_INVALID_PARAM;
         goto done;
     }
-#endif
+
+    if (hg_proc->op != HG_ENCODE) {
+        ret = hg_proc_memcpy(proc, data, data_size);
+        if (ret != HG_SUCCESS || hg_proc->op != HG_DECODE)
+            goto done;
+
+        /* Swap decoded data in place */
+        for (i = 0; i < data_size / 2; i++) {
+            char tmp = bytes[i];
+
+            bytes[i] = bytes[data_size - 1 - i];
+            bytes[data_size - 1 - i] = tmp;
+        }
+        goto done;
+    }
+
+    for (i = 0; i < data_size; i++)
+        swapped[i] = bytes[data_size - 1 - i];
+    ret = hg_proc_memcpy(proc, swapped, data_size);
 
 done:
     return ret;
 }
+#endif
 
-#ifdef HG_HAS_CHECKSUMS
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_proc_checksum_update(hg_proc_t proc, void *data, hg_size_t data_size)
+static hg_return_t
+hg_proc_grow(struct hg_proc *hg_proc, hg_size_t data_size)
+{
+    hg_size_t size_used = hg_proc->current_buf->size -
+        hg_proc->current_buf->size_left;
+    hg_size_t new_buf_size = 2 * hg_proc->current_buf->size;
+
+    if (new_buf_size < size_used + data_size)
+        new_buf_size = size_used + data_size;
+
+    return hg_proc_set_size((hg_proc_t) hg_proc, new_buf_size);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_set_hash(hg_proc_t proc, hg_proc_hash_t hash)
 {
     struct hg_proc *hg_proc = (struct hg_proc *) proc;
-    int checksum_ret;
     hg_return_t ret = HG_SUCCESS;
 
     if (!hg_proc) {
@@ -606,12 +965,111 @@ hg_proc_checksum_update(hg_proc_t proc, void *data, hg_size_t data_size)
         goto done;
     }
 
-    /* Update checksum */
-    checksum_ret = mchecksum_update(hg_proc->checksum, data, data_size);
-    if (checksum_ret != MCHECKSUM_SUCCESS) {
-        HG_LOG_ERROR("Could not update checksum");
-        ret = HG_CHECKSUM_ERROR;
+#ifdef HG_HAS_CHECKSUMS
+    if (hash != hg_proc->hash)
+        ret = hg_proc_checksum_init(hg_proc, hash);
+#else
+    (void) hash;
+#endif
+
+done:
+    return ret;
+}
+
+#ifdef HG_HAS_CHECKSUMS
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_checksum_init(struct hg_proc *hg_proc, hg_proc_hash_t hash)
+{
+    const char *hash_method = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (hg_proc->checksum != MCHECKSUM_OBJECT_NULL) {
+        mchecksum_destroy(hg_proc->checksum);
+        hg_proc->checksum = MCHECKSUM_OBJECT_NULL;
+    }
+    hg_proc->hash = HG_NOHASH;
+    hg_proc->checksum_size = 0;
+
+    /* CRC32C is computed directly, other methods go through mchecksum */
+    switch (hash) {
+        case HG_CRC16:
+            hash_method = "crc16";
+            break;
+        case HG_CRC32:
+            hg_proc->checksum_size = sizeof(hg_uint32_t);
+            break;
+        case HG_CRC64:
+            hash_method = "crc64";
+            break;
+        default:
+            goto done;
+    }
+
+    if (hash_method) {
+        int checksum_ret;
+
+        checksum_ret = mchecksum_init(hash_method, &hg_proc->checksum);
+        if (checksum_ret != MCHECKSUM_SUCCESS) {
+            HG_LOG_ERROR("Could not initialize checksum");
+            ret = HG_CHECKSUM_ERROR;
+            goto done;
+        }
+        hg_proc->checksum_size = mchecksum_get_size(hg_proc->checksum);
+        if (hg_proc->checksum_size > sizeof(hg_uint64_t)) {
+            HG_LOG_ERROR("Checksum size is not supported");
+            mchecksum_destroy(hg_proc->checksum);
+            hg_proc->checksum = MCHECKSUM_OBJECT_NULL;
+            hg_proc->checksum_size = 0;
+            ret = HG_CHECKSUM_ERROR;
+            goto done;
+        }
+    }
+    hg_proc->hash = hash;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_checksum_compute(struct hg_proc *hg_proc)
+{
+    struct hg_proc_buf *proc_buf = hg_proc->current_buf;
+    hg_size_t size;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (hg_proc->hash == HG_NOHASH || hg_proc->op == HG_FREE
+        || hg_proc->op == HG_SIZE)
         goto done;
+
+    /* Data processed is contiguous from the start of the buffer */
+#ifdef HG_HAS_XDR
+    size = xdr_getpos(&proc_buf->xdr);
+#else
+    size = proc_buf->size - proc_buf->size_left;
+#endif
+
+    if (hg_proc->hash == HG_CRC32) {
+        hg_uint32_t crc = hg_crc32c(0, proc_buf->buf, (size_t) size);
+
+        memcpy(&hg_proc->checksum_hash, &crc, sizeof(crc));
+    } else {
+        int checksum_ret;
+
+        checksum_ret = mchecksum_reset(hg_proc->checksum);
+        if (checksum_ret == MCHECKSUM_SUCCESS)
+            checksum_ret = mchecksum_update(hg_proc->checksum, proc_buf->buf,
+                size);
+        if (checksum_ret == MCHECKSUM_SUCCESS)
+            checksum_ret = mchecksum_get(hg_proc->checksum,
+                &hg_proc->checksum_hash, hg_proc->checksum_size,
+                MCHECKSUM_FINALIZE);
+        if (checksum_ret != MCHECKSUM_SUCCESS) {
+            HG_LOG_ERROR("Could not compute checksum");
+            ret = HG_CHECKSUM_ERROR;
+            goto done;
+        }
     }
 
 done:
@@ -643,7 +1101,7 @@ hg_proc_checksum_get(hg_proc_t proc, void *hash, hg_size_t hash_size)
         goto done;
     }
 
-    memcpy(hash, hg_proc->checksum_hash, hg_proc->checksum_size);
+    memcpy(hash, &hg_proc->checksum_hash, hg_proc->checksum_size);
 
 done:
     return ret;
@@ -669,20 +1127,26 @@ hg_proc_checksum_verify(hg_proc_t proc, const void *hash, hg_size_t hash_size)
     }
 
     /* Verify checksums */
-    if (memcmp(hash, hg_proc->checksum_hash, hg_proc->checksum_size) != 0) {
-        if (hg_proc->checksum_size == sizeof(hg_uint16_t))
+    if (memcmp(hash, &hg_proc->checksum_hash, hg_proc->checksum_size) != 0) {
+        hg_uint16_t hash16, checksum16;
+        hg_uint32_t hash32, checksum32;
+        hg_uint64_t hash64;
+
+        if (hg_proc->checksum_size == sizeof(hg_uint16_t)) {
+            memcpy(&checksum16, &hg_proc->checksum_hash, sizeof(hg_uint16_t));
+            memcpy(&hash16, hash, sizeof(hg_uint16_t));
             HG_LOG_ERROR("checksum 0x%04X does not match (expected 0x%04X!)",
-                *(hg_uint16_t *) hg_proc->checksum_hash,
-                *(const hg_uint16_t *) hash);
-        else if (hg_proc->checksum_size == sizeof(hg_uint32_t))
+                checksum16, hash16);
+        } else if (hg_proc->checksum_size == sizeof(hg_uint32_t)) {
+            memcpy(&checksum32, &hg_proc->checksum_hash, sizeof(hg_uint32_t));
+            memcpy(&hash32, hash, sizeof(hg_uint32_t));
             HG_LOG_ERROR("checksum 0x%08X does not match (expected 0x%08X!)",
-                *(hg_uint32_t *) hg_proc->checksum_hash,
-                *(const hg_uint32_t *) hash);
-        else if (hg_proc->checksum_size == sizeof(hg_uint64_t))
+                checksum32, hash32);
+        } else if (hg_proc->checksum_size == sizeof(hg_uint64_t)) {
+            memcpy(&hash64, hash, sizeof(hg_uint64_t));
             HG_LOG_ERROR("checksum 0x%016X does not match (expected 0x%016X!)",
-                *(hg_uint64_t *) hg_proc->checksum_hash,
-                *(const hg_uint64_t *) hash);
-        else
+                hg_proc->checksum_hash, hash64);
+        } else
             HG_LOG_ERROR("Checksums do not match (unknown size?)");
         ret = HG_CHECKSUM_ERROR;
         goto done;
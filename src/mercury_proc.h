@@ -33,6 +33,9 @@
 /* Public Macros */
 /*****************/
 
+/* Max number of bulk handles that can be recorded by a proc */
+#define HG_PROC_BULK_TRACK_MAX 8
+
 /* Encode/decode version number into uint32 */
 #define HG_GET_MAJOR(value) ((value >> 24) & 0xFF)
 #define HG_GET_MINOR(value) ((value >> 16) & 0xFF)
@@ -54,7 +57,8 @@ extern "C" {
  * \param hg_class [IN]         HG class
  * \param hash [IN]             hash method used for computing checksum
  *                              (if NULL, checksum is not computed)
- *                              hash method: HG_CRC16, HG_CRC64, HG_NOHASH
+ *                              hash method: HG_CRC16, HG_CRC32, HG_CRC64,
+ *                              HG_NOHASH
  * \param proc [OUT]            pointer to abstract processor object
  *
  * \return HG_SUCCESS or corresponding HG error code
@@ -76,7 +80,8 @@ hg_proc_create(
  * \param op [IN]               operation type: HG_ENCODE / HG_DECODE / HG_FREE
  * \param hash [IN]             hash method used for computing checksum
  *                              (if NULL, checksum is not computed)
- *                              hash method: HG_CRC16, HG_CRC64, HG_NOHASH
+ *                              hash method: HG_CRC16, HG_CRC32, HG_CRC64,
+ *                              HG_NOHASH
  * \param proc [OUT]            pointer to abstract processor object
  *
  * \return HG_SUCCESS or corresponding HG error code
@@ -104,13 +109,16 @@ hg_proc_free(
         );
 
 /**
- * Reset the processor.
+ * Reset the processor. When op is HG_SIZE, buf and buf_size are ignored and
+ * processing data only accounts for its encoded size, which can then be
+ * retrieved with hg_proc_get_size_used() (not supported using XDR).
  *
  * \param proc [IN/OUT]         abstract processor object
  * \param buf [IN]              pointer to buffer that will be used for
  *                              serialization/deserialization
  * \param buf_size [IN]         buffer size
  * \param op [IN]               operation type: HG_ENCODE / HG_DECODE / HG_FREE
+ *                              / HG_SIZE
  *
  * \return HG_SUCCESS or corresponding HG error code
  */
@@ -173,7 +181,9 @@ hg_proc_get_size_used(
 
 /**
  * Request a new buffer size. This will modify the size of the buffer attached
- * to the processor or create an extra processing buffer.
+ * to the processor or create an extra processing buffer. The size is rounded
+ * up to a multiple of the page size. When data does not fit, the processor
+ * itself at least doubles the size of its buffer.
  *
  * \param proc [IN/OUT]         abstract processor object
  * \param buf_size [IN]         buffer size
@@ -204,7 +214,7 @@ hg_proc_get_size_left(
  * \param proc [IN]             abstract processor object
  * \param data_size [IN]        data size
  *
- * \return Buffer pointer
+ * \return Buffer pointer or NULL if the operation is HG_SIZE
  */
 HG_EXPORT void *
 hg_proc_save_ptr(
@@ -224,6 +234,27 @@ HG_EXPORT XDR *
 hg_proc_get_xdr_ptr(
         hg_proc_t proc
         );
+
+/**
+ * Make sure that data_size bytes can be encoded into the current XDR stream,
+ * growing the buffer if needed (for manual encoding).
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data_size [IN]        data size
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+hg_proc_xdr_reserve(
+        hg_proc_t proc,
+        hg_size_t data_size
+        );
+
+/* Process data with XDR routine xdr_proc, after reserving its encoded size */
+#define HG_PROC_XDR(proc, xdr_proc, data, size)                         \
+    ((hg_proc_xdr_reserve(proc, size) == HG_SUCCESS                     \
+        && xdr_proc(hg_proc_get_xdr_ptr(proc), data)) ? HG_SUCCESS :    \
+        HG_PROTOCOL_ERROR)
 #endif
 
 /**
@@ -281,8 +312,146 @@ hg_proc_set_extra_buf_is_mine(
         );
 
 /**
- * Flush the proc after data has been encoded or decoded and finalize internal
- * checksum if checksum of data processed was initially requested.
+ * Start or stop recording bulk handles processed by hg_proc_hg_bulk_t().
+ * Starting a new record discards previously recorded handles.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param track [IN]            boolean
+ */
+HG_EXPORT void
+hg_proc_set_bulk_track(
+        hg_proc_t proc,
+        hg_bool_t track
+        );
+
+/**
+ * Record bulk handle if recording was started, at most HG_PROC_BULK_TRACK_MAX
+ * handles are recorded.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param handle [IN]           bulk handle
+ */
+HG_EXPORT void
+hg_proc_bulk_track(
+        hg_proc_t proc,
+        hg_bulk_t handle
+        );
+
+/**
+ * Get number of bulk handles recorded.
+ *
+ * \param proc [IN]             abstract processor object
+ *
+ * \return Non-negative value
+ */
+HG_EXPORT hg_uint32_t
+hg_proc_get_bulk_count(
+        hg_proc_t proc
+        );
+
+/**
+ * Set transports that bulk handles processed by hg_proc_hg_bulk_t() are
+ * serialized for (HG_BULK_SERIALIZE_NA and/or HG_BULK_SERIALIZE_SM, both by
+ * default).
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param flags [IN]            bulk serialization flags
+ */
+HG_EXPORT void
+hg_proc_set_bulk_flags(
+        hg_proc_t proc,
+        hg_uint8_t flags
+        );
+
+/**
+ * Get transports that bulk handles are serialized for.
+ *
+ * \param proc [IN]             abstract processor object
+ *
+ * \return Bulk serialization flags
+ */
+HG_EXPORT hg_uint8_t
+hg_proc_get_bulk_flags(
+        hg_proc_t proc
+        );
+
+/**
+ * Let array and small string procs point decoded arrays and strings into the
+ * processed buffer instead of copying them, they are then only valid as long
+ * as the buffer is.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param borrow [IN]           boolean
+ */
+HG_EXPORT void
+hg_proc_set_array_borrow(
+        hg_proc_t proc,
+        hg_bool_t borrow
+        );
+
+/**
+ * Get whether decoded arrays may point into the processed buffer.
+ *
+ * \param proc [IN]             abstract processor object
+ *
+ * \return boolean
+ */
+HG_EXPORT hg_bool_t
+hg_proc_get_array_borrow(
+        hg_proc_t proc
+        );
+
+/**
+ * Allocate memory for decoded data from an arena owned by the proc. The
+ * arena is rewound when the proc is reset and released when the proc is
+ * freed, so that memory of a handle's decoded input or output remains valid
+ * until it is freed and no allocation is needed once the arena has grown
+ * large enough.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param size [IN]             size of allocation
+ *
+ * \return Pointer to memory or NULL if it could not be allocated
+ */
+HG_EXPORT void *
+hg_proc_arena_alloc(
+        hg_proc_t proc,
+        hg_size_t size
+        );
+
+/**
+ * Get recorded bulk handle.
+ *
+ * \param proc [IN]             abstract processor object
+ * \param index [IN]            index of handle in order of processing
+ *
+ * \return Bulk handle or HG_BULK_NULL
+ */
+HG_EXPORT hg_bulk_t
+hg_proc_get_bulk(
+        hg_proc_t proc,
+        hg_uint32_t index
+        );
+
+/**
+ * Set hash method used for computing checksum of data processed.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param hash [IN]             hash method: HG_CRC16, HG_CRC32, HG_CRC64,
+ *                              HG_NOHASH
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+hg_proc_set_hash(
+        hg_proc_t proc,
+        hg_proc_hash_t hash
+        );
+
+/**
+ * Flush the proc after data has been encoded or decoded and compute internal
+ * checksum of data processed if requested. The checksum is computed over the
+ * encoded buffer at once (CRC32 uses CRC32C).
  *
  * \param proc [IN]             abstract processor object
  *
@@ -310,6 +479,25 @@ hg_proc_memcpy(
         hg_size_t data_size
         );
 
+#if !defined(HG_HAS_XDR) && defined(HG_BIG_ENDIAN)
+/**
+ * Same as hg_proc_memcpy() for integers of up to 8 bytes, which are stored
+ * little-endian in the buffer.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to data
+ * \param data_size [IN]        data size
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+hg_proc_memcpy_le(
+        hg_proc_t proc,
+        void *data,
+        hg_size_t data_size
+        );
+#endif
+
 #ifdef HG_HAS_CHECKSUMS
 /**
  * Retrieve internal proc checksum hash.
@@ -408,7 +596,7 @@ hg_proc_hg_int8_t(hg_proc_t proc, void *data)
 {
     hg_return_t ret;
 #ifdef HG_HAS_XDR
-    ret = xdr_int8_t(hg_proc_get_xdr_ptr(proc), data) ? HG_SUCCESS : HG_PROTOCOL_ERROR;
+    ret = HG_PROC_XDR(proc, xdr_int8_t, data, BYTES_PER_XDR_UNIT);
 #else
     ret = hg_proc_memcpy(proc, data, sizeof(hg_int8_t));
 #endif
@@ -428,7 +616,7 @@ hg_proc_hg_uint8_t(hg_proc_t proc, void *data)
 {
     hg_return_t ret;
 #ifdef HG_HAS_XDR
-    ret = xdr_uint8_t(hg_proc_get_xdr_ptr(proc), data) ? HG_SUCCESS : HG_PROTOCOL_ERROR;
+    ret = HG_PROC_XDR(proc, xdr_uint8_t, data, BYTES_PER_XDR_UNIT);
 #else
     ret = hg_proc_memcpy(proc, data, sizeof(hg_uint8_t));
 #endif
@@ -448,7 +636,9 @@ hg_proc_hg_int16_t(hg_proc_t proc, void *data)
 {
     hg_return_t ret;
 #ifdef HG_HAS_XDR
-    ret = xdr_int16_t(hg_proc_get_xdr_ptr(proc), data) ? HG_SUCCESS : HG_PROTOCOL_ERROR;
+    ret = HG_PROC_XDR(proc, xdr_int16_t, data, BYTES_PER_XDR_UNIT);
+#elif defined(HG_BIG_ENDIAN)
+    ret = hg_proc_memcpy_le(proc, data, sizeof(hg_int16_t));
 #else
     ret = hg_proc_memcpy(proc, data, sizeof(hg_int16_t));
 #endif
@@ -468,7 +658,9 @@ hg_proc_hg_uint16_t(hg_proc_t proc, void *data)
 {
     hg_return_t ret;
 #ifdef HG_HAS_XDR
-    ret = xdr_uint16_t(hg_proc_get_xdr_ptr(proc), data) ? HG_SUCCESS : HG_PROTOCOL_ERROR;
+    ret = HG_PROC_XDR(proc, xdr_uint16_t, data, BYTES_PER_XDR_UNIT);
+#elif defined(HG_BIG_ENDIAN)
+    ret = hg_proc_memcpy_le(proc, data, sizeof(hg_uint16_t));
 #else
     ret = hg_proc_memcpy(proc, data, sizeof(hg_uint16_t));
 #endif
@@ -488,7 +680,9 @@ hg_proc_hg_int32_t(hg_proc_t proc, void *data)
 {
     hg_return_t ret;
 #ifdef HG_HAS_XDR
-    ret = xdr_int32_t(hg_proc_get_xdr_ptr(proc), data) ? HG_SUCCESS : HG_PROTOCOL_ERROR;
+    ret = HG_PROC_XDR(proc, xdr_int32_t, data, BYTES_PER_XDR_UNIT);
+#elif defined(HG_BIG_ENDIAN)
+    ret = hg_proc_memcpy_le(proc, data, sizeof(hg_int32_t));
 #else
     ret = hg_proc_memcpy(proc, data, sizeof(hg_int32_t));
 #endif
@@ -508,7 +702,9 @@ hg_proc_hg_uint32_t(hg_proc_t proc, void *data)
 {
     hg_return_t ret;
 #ifdef HG_HAS_XDR
-    ret = xdr_uint32_t(hg_proc_get_xdr_ptr(proc), data) ? HG_SUCCESS : HG_PROTOCOL_ERROR;
+    ret = HG_PROC_XDR(proc, xdr_uint32_t, data, BYTES_PER_XDR_UNIT);
+#elif defined(HG_BIG_ENDIAN)
+    ret = hg_proc_memcpy_le(proc, data, sizeof(hg_uint32_t));
 #else
     ret = hg_proc_memcpy(proc, data, sizeof(hg_uint32_t));
 #endif
@@ -528,7 +724,9 @@ hg_proc_hg_int64_t(hg_proc_t proc, void *data)
 {
     hg_return_t ret;
 #ifdef HG_HAS_XDR
-    ret = xdr_int64_t(hg_proc_get_xdr_ptr(proc), data) ? HG_SUCCESS : HG_PROTOCOL_ERROR;
+    ret = HG_PROC_XDR(proc, xdr_int64_t, data, 2 * BYTES_PER_XDR_UNIT);
+#elif defined(HG_BIG_ENDIAN)
+    ret = hg_proc_memcpy_le(proc, data, sizeof(hg_int64_t));
 #else
     ret = hg_proc_memcpy(proc, data, sizeof(hg_int64_t));
 #endif
@@ -548,7 +746,9 @@ hg_proc_hg_uint64_t(hg_proc_t proc, void *data)
 {
     hg_return_t ret;
 #ifdef HG_HAS_XDR
-    ret = xdr_uint64_t(hg_proc_get_xdr_ptr(proc), data) ? HG_SUCCESS : HG_PROTOCOL_ERROR;
+    ret = HG_PROC_XDR(proc, xdr_uint64_t, data, 2 * BYTES_PER_XDR_UNIT);
+#elif defined(HG_BIG_ENDIAN)
+    ret = hg_proc_memcpy_le(proc, data, sizeof(hg_uint64_t));
 #else
     ret = hg_proc_memcpy(proc, data, sizeof(hg_uint64_t));
 #endif
@@ -572,8 +772,10 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
     hg_uint64_t buf_size = 0;
 
     switch (hg_proc_get_op(proc)) {
+        case HG_SIZE:
         case HG_ENCODE: {
             hg_bool_t request_eager = HG_FALSE;
+            hg_uint8_t flags = hg_proc_get_bulk_flags(proc);
 
             if (*bulk_ptr == HG_BULK_NULL) {
                 /* If HG_BULK_NULL set 0 to buf_size */
@@ -581,10 +783,13 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
             } else {
 #ifdef HG_HAS_EAGER_BULK
                 request_eager = (hg_proc_get_size_left(proc)
-                    > HG_Bulk_get_serialize_size(*bulk_ptr, HG_TRUE))
+                    > HG_Bulk_get_serialize_size_flags(*bulk_ptr,
+                        flags | HG_BULK_SERIALIZE_EAGER))
                     ? HG_TRUE : HG_FALSE;
 #endif
-                buf_size = HG_Bulk_get_serialize_size(*bulk_ptr, request_eager);
+                if (request_eager)
+                    flags |= HG_BULK_SERIALIZE_EAGER;
+                buf_size = HG_Bulk_get_serialize_size_flags(*bulk_ptr, flags);
             }
             /* Encode size */
             ret = hg_proc_uint64_t(proc, &buf_size);
@@ -594,12 +799,15 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
             }
             if (buf_size) {
                 buf = hg_proc_save_ptr(proc, buf_size);
-                ret = HG_Bulk_serialize(buf, buf_size, request_eager, *bulk_ptr);
+                if (hg_proc_get_op(proc) == HG_SIZE)
+                    break;
+                ret = HG_Bulk_serialize_flags(buf, buf_size, flags, *bulk_ptr);
                 if (ret != HG_SUCCESS) {
                     HG_LOG_ERROR("Could not serialize bulk handle");
                     return ret;
                 }
                 hg_proc_restore_ptr(proc, buf, buf_size);
+                hg_proc_bulk_track(proc, *bulk_ptr);
             }
         }
         break;
@@ -620,6 +828,7 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
                     return ret;
                 }
                 hg_proc_restore_ptr(proc, buf, buf_size);
+                hg_proc_bulk_track(proc, *bulk_ptr);
             } else {
                 /* If buf_size is 0, define handle to HG_BULK_NULL */
                 *bulk_ptr = HG_BULK_NULL;
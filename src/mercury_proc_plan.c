@@ -0,0 +1,741 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_proc_plan.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Fields must be converted one at a time (XDR or big-endian hosts) */
+#if defined(HG_HAS_XDR) || defined(HG_BIG_ENDIAN)
+# define HG_PROC_PLAN_CONVERT
+#endif
+
+/* Max depth of nested structs */
+#define HG_PROC_PLAN_MAX_DEPTH 16
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Plan operation */
+typedef enum {
+    HG_PROC_PLAN_RUN,       /* Run of fixed-width fields */
+    HG_PROC_PLAN_ARRAY,     /* Array of fixed-width elements */
+    HG_PROC_PLAN_PROC       /* Field processed by proc callback */
+} hg_proc_plan_op_type_t;
+
+/* Copy of fixed-width field(s) between struct and buffer */
+struct hg_proc_plan_copy {
+    size_t offset;          /* Offset in struct */
+    size_t size;            /* Size of copy */
+    size_t elem_size;       /* Element size */
+};
+
+struct hg_proc_plan_op {
+    hg_proc_plan_op_type_t type;
+    size_t offset;          /* Offset in struct (array and proc) */
+    size_t size;            /* Encoded size of run / element size of array */
+    size_t copy_index;      /* First copy of run */
+    size_t copy_count;      /* Number of copies of run */
+    size_t length_offset;   /* Offset of array length field */
+    size_t length_size;     /* Size of array length field */
+    hg_proc_cb_t proc_cb;   /* Proc callback */
+};
+
+struct hg_proc_plan {
+    struct hg_proc_plan_op *ops;        /* Operations */
+    size_t op_count;                    /* Number of operations */
+    size_t op_max;                      /* Allocated operations */
+    struct hg_proc_plan_copy *copies;   /* Copies of runs */
+    size_t copy_count;                  /* Number of copies */
+    size_t copy_max;                    /* Allocated copies */
+    hg_bool_t has_proc;                 /* Some fields use proc callbacks */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Append operation to plan.
+ */
+static struct hg_proc_plan_op *
+hg_proc_plan_add_op(
+        struct hg_proc_plan *hg_proc_plan,
+        hg_proc_plan_op_type_t type
+        );
+
+/**
+ * Append copy of fixed-width field(s) to current run, merging it with the
+ * previous copy when both are contiguous in struct.
+ */
+static hg_return_t
+hg_proc_plan_add_copy(
+        struct hg_proc_plan *hg_proc_plan,
+        size_t offset,
+        size_t size,
+        size_t elem_size
+        );
+
+/**
+ * Compile field table of struct at offset base.
+ */
+static hg_return_t
+hg_proc_plan_compile(
+        struct hg_proc_plan *hg_proc_plan,
+        const struct hg_field *fields,
+        size_t base,
+        unsigned int depth
+        );
+
+#ifdef HG_PROC_PLAN_CONVERT
+/**
+ * Process count fixed-width elements of elem_size.
+ */
+static hg_return_t
+hg_proc_plan_elems(
+        hg_proc_t proc,
+        void *data,
+        size_t count,
+        size_t elem_size
+        );
+#endif
+
+/**
+ * Process run of fixed-width fields.
+ */
+static HG_INLINE hg_return_t
+hg_proc_plan_run(
+        hg_proc_t proc,
+        const struct hg_proc_plan *hg_proc_plan,
+        const struct hg_proc_plan_op *op,
+        char *data
+        );
+
+/**
+ * Get number of elements of array from its length field.
+ */
+static HG_INLINE hg_uint64_t
+hg_proc_plan_array_count(
+        const struct hg_proc_plan_op *op,
+        const char *data
+        );
+
+/**
+ * Process array of fixed-width elements.
+ */
+static hg_return_t
+hg_proc_plan_array(
+        hg_proc_t proc,
+        const struct hg_proc_plan_op *op,
+        char *data
+        );
+
+/**
+ * Release fields decoded by operations preceding op_end, after decoding
+ * failed.
+ */
+static void
+hg_proc_plan_release(
+        hg_proc_t proc,
+        const struct hg_proc_plan *hg_proc_plan,
+        const struct hg_proc_plan_op *op_end,
+        char *data
+        );
+
+/*---------------------------------------------------------------------------*/
+static struct hg_proc_plan_op *
+hg_proc_plan_add_op(struct hg_proc_plan *hg_proc_plan,
+    hg_proc_plan_op_type_t type)
+{
+    struct hg_proc_plan_op *op = NULL;
+
+    if (hg_proc_plan->op_count == hg_proc_plan->op_max) {
+        size_t new_max = hg_proc_plan->op_max ? 2 * hg_proc_plan->op_max : 8;
+        struct hg_proc_plan_op *new_ops = (struct hg_proc_plan_op *) realloc(
+            hg_proc_plan->ops, new_max * sizeof(struct hg_proc_plan_op));
+
+        if (!new_ops) {
+            HG_LOG_ERROR("Could not allocate plan operations");
+            goto done;
+        }
+        hg_proc_plan->ops = new_ops;
+        hg_proc_plan->op_max = new_max;
+    }
+
+    op = &hg_proc_plan->ops[hg_proc_plan->op_count++];
+    memset(op, 0, sizeof(struct hg_proc_plan_op));
+    op->type = type;
+
+done:
+    return op;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_plan_add_copy(struct hg_proc_plan *hg_proc_plan, size_t offset,
+    size_t size, size_t elem_size)
+{
+    struct hg_proc_plan_op *op = hg_proc_plan->op_count ?
+        &hg_proc_plan->ops[hg_proc_plan->op_count - 1] : NULL;
+    struct hg_proc_plan_copy *copy;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Start new run */
+    if (!op || op->type != HG_PROC_PLAN_RUN) {
+        op = hg_proc_plan_add_op(hg_proc_plan, HG_PROC_PLAN_RUN);
+        if (!op) {
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        op->copy_index = hg_proc_plan->copy_count;
+    }
+    op->size += size;
+
+#ifndef HG_PROC_PLAN_CONVERT
+    /* Merge with previous copy, elements are copied as they are */
+    if (op->copy_count) {
+        copy = &hg_proc_plan->copies[hg_proc_plan->copy_count - 1];
+        if (copy->offset + copy->size == offset) {
+            copy->size += size;
+            goto done;
+        }
+    }
+#endif
+
+    if (hg_proc_plan->copy_count == hg_proc_plan->copy_max) {
+        size_t new_max =
+            hg_proc_plan->copy_max ? 2 * hg_proc_plan->copy_max : 8;
+        struct hg_proc_plan_copy *new_copies =
+            (struct hg_proc_plan_copy *) realloc(hg_proc_plan->copies,
+                new_max * sizeof(struct hg_proc_plan_copy));
+
+        if (!new_copies) {
+            HG_LOG_ERROR("Could not allocate plan copies");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        hg_proc_plan->copies = new_copies;
+        hg_proc_plan->copy_max = new_max;
+    }
+    copy = &hg_proc_plan->copies[hg_proc_plan->copy_count++];
+    copy->offset = offset;
+    copy->size = size;
+    copy->elem_size = elem_size;
+    op->copy_count++;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_plan_compile(struct hg_proc_plan *hg_proc_plan,
+    const struct hg_field *fields, size_t base, unsigned int depth)
+{
+    const struct hg_field *field;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (depth > HG_PROC_PLAN_MAX_DEPTH) {
+        HG_LOG_ERROR("Exceeding max depth of nested structs");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    for (field = fields; field->kind != HG_FIELD_END; field++) {
+        size_t count = field->count ? field->count : 1;
+        struct hg_proc_plan_op *op;
+        const struct hg_field *length_field;
+        size_t i;
+
+        switch (field->kind) {
+            case HG_FIELD_FIXED:
+                if (field->size != 1 && field->size != 2 && field->size != 4
+                    && field->size != 8) {
+                    HG_LOG_ERROR("Fixed-width field size must be 1, 2, 4 or "
+                        "8");
+                    ret = HG_INVALID_PARAM;
+                    goto done;
+                }
+                ret = hg_proc_plan_add_copy(hg_proc_plan, base + field->offset,
+                    count * field->size, field->size);
+                if (ret != HG_SUCCESS)
+                    goto done;
+                break;
+            case HG_FIELD_ARRAY:
+                if (field->size != 1 && field->size != 2 && field->size != 4
+                    && field->size != 8) {
+                    HG_LOG_ERROR("Array element size must be 1, 2, 4 or 8");
+                    ret = HG_INVALID_PARAM;
+                    goto done;
+                }
+                /* Length is processed before the array */
+                length_field = &fields[field->length_field];
+                if (length_field >= field
+                    || length_field->kind != HG_FIELD_FIXED
+                    || (length_field->count && length_field->count != 1)) {
+                    HG_LOG_ERROR("Array length must be a previous fixed-width "
+                        "field");
+                    ret = HG_INVALID_PARAM;
+                    goto done;
+                }
+                op = hg_proc_plan_add_op(hg_proc_plan, HG_PROC_PLAN_ARRAY);
+                if (!op) {
+                    ret = HG_NOMEM_ERROR;
+                    goto done;
+                }
+                op->offset = base + field->offset;
+                op->size = field->size;
+                op->length_offset = base + length_field->offset;
+                op->length_size = length_field->size;
+                break;
+            case HG_FIELD_STRUCT:
+                if (!field->fields) {
+                    HG_LOG_ERROR("NULL field table of nested struct");
+                    ret = HG_INVALID_PARAM;
+                    goto done;
+                }
+                for (i = 0; i < count; i++) {
+                    ret = hg_proc_plan_compile(hg_proc_plan, field->fields,
+                        base + field->offset + i * field->size, depth + 1);
+                    if (ret != HG_SUCCESS)
+                        goto done;
+                }
+                break;
+            case HG_FIELD_PROC:
+                if (!field->proc_cb) {
+                    HG_LOG_ERROR("NULL proc callback");
+                    ret = HG_INVALID_PARAM;
+                    goto done;
+                }
+                op = hg_proc_plan_add_op(hg_proc_plan, HG_PROC_PLAN_PROC);
+                if (!op) {
+                    ret = HG_NOMEM_ERROR;
+                    goto done;
+                }
+                op->offset = base + field->offset;
+                op->proc_cb = field->proc_cb;
+                hg_proc_plan->has_proc = HG_TRUE;
+                break;
+            default:
+                HG_LOG_ERROR("Unknown field kind");
+                ret = HG_INVALID_PARAM;
+                goto done;
+        }
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifdef HG_PROC_PLAN_CONVERT
+static hg_return_t
+hg_proc_plan_elems(hg_proc_t proc, void *data, size_t count, size_t elem_size)
+{
+    hg_return_t ret = HG_SUCCESS;
+    size_t i;
+
+    /* Select element proc once for all elements */
+    switch (elem_size) {
+        case 1:
+            for (i = 0; i < count && ret == HG_SUCCESS; i++)
+                ret = hg_proc_uint8_t(proc, (hg_uint8_t *) data + i);
+            break;
+        case 2:
+            for (i = 0; i < count && ret == HG_SUCCESS; i++)
+                ret = hg_proc_uint16_t(proc, (hg_uint16_t *) data + i);
+            break;
+        case 4:
+            for (i = 0; i < count && ret == HG_SUCCESS; i++)
+                ret = hg_proc_uint32_t(proc, (hg_uint32_t *) data + i);
+            break;
+        default:
+            for (i = 0; i < count && ret == HG_SUCCESS; i++)
+                ret = hg_proc_uint64_t(proc, (hg_uint64_t *) data + i);
+            break;
+    }
+
+    return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_proc_plan_run(hg_proc_t proc, const struct hg_proc_plan *hg_proc_plan,
+    const struct hg_proc_plan_op *op, char *data)
+{
+    const struct hg_proc_plan_copy *copy =
+        &hg_proc_plan->copies[op->copy_index];
+    const struct hg_proc_plan_copy *copy_end = copy + op->copy_count;
+    hg_proc_op_t proc_op = hg_proc_get_op(proc);
+    hg_return_t ret = HG_SUCCESS;
+#ifndef HG_PROC_PLAN_CONVERT
+    char *buf;
+#endif
+
+    /* One bounds check for the whole run */
+    if (proc_op == HG_DECODE && op->size > hg_proc_get_size_left(proc)) {
+        HG_LOG_ERROR("Fields exceed buffer size");
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+
+#ifdef HG_PROC_PLAN_CONVERT
+    for (; copy < copy_end; copy++) {
+        ret = hg_proc_plan_elems(proc, data + copy->offset,
+            copy->size / copy->elem_size, copy->elem_size);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Proc error");
+            goto done;
+        }
+    }
+#else
+    buf = (char *) hg_proc_save_ptr(proc, op->size);
+    switch (proc_op) {
+        case HG_ENCODE:
+            if (!buf) {
+                HG_LOG_ERROR("Could not reserve buffer space");
+                ret = HG_NOMEM_ERROR;
+                goto done;
+            }
+            for (; copy < copy_end; buf += copy->size, copy++)
+                memcpy(buf, data + copy->offset, copy->size);
+            break;
+        case HG_DECODE:
+            for (; copy < copy_end; buf += copy->size, copy++)
+                memcpy(data + copy->offset, buf, copy->size);
+            break;
+        default:
+            /* HG_SIZE only reserves space */
+            break;
+    }
+#endif
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_uint64_t
+hg_proc_plan_array_count(const struct hg_proc_plan_op *op, const char *data)
+{
+    const char *length = data + op->length_offset;
+
+    switch (op->length_size) {
+        case 1:
+            return *(const hg_uint8_t *) length;
+        case 2:
+            return *(const hg_uint16_t *) length;
+        case 4:
+            return *(const hg_uint32_t *) length;
+        default:
+            return *(const hg_uint64_t *) length;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_plan_array(hg_proc_t proc, const struct hg_proc_plan_op *op,
+    char *data)
+{
+    void **array = (void **) (data + op->offset);
+    hg_proc_op_t proc_op = hg_proc_get_op(proc);
+    hg_uint64_t count = hg_proc_plan_array_count(op, data);
+    hg_size_t size;
+    hg_return_t ret = HG_SUCCESS;
+#ifndef HG_PROC_PLAN_CONVERT
+    void *buf;
+#endif
+
+    size = count * op->size;
+    if (size / op->size != count) {
+        HG_LOG_ERROR("Array of %llu elements is too large",
+            (unsigned long long) count);
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+
+    if (proc_op == HG_DECODE) {
+        /* Check against buffer before allocating anything */
+        if (size > hg_proc_get_size_left(proc)) {
+            HG_LOG_ERROR("Array exceeds buffer size");
+            ret = HG_SIZE_ERROR;
+            goto done;
+        }
+        *array = size ? malloc((size_t) size) : NULL;
+        if (size && !*array) {
+            HG_LOG_ERROR("Could not allocate array");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+    }
+    if (!size)
+        goto done;
+
+#ifdef HG_PROC_PLAN_CONVERT
+    if (proc_op == HG_SIZE) {
+        /* Elements are not read when sizing */
+        hg_proc_save_ptr(proc, size);
+        goto done;
+    }
+    ret = hg_proc_plan_elems(proc, *array, (size_t) count, op->size);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Proc error");
+        if (proc_op == HG_DECODE) {
+            free(*array);
+            *array = NULL;
+        }
+        goto done;
+    }
+#else
+    buf = hg_proc_save_ptr(proc, size);
+    switch (proc_op) {
+        case HG_ENCODE:
+            if (!buf) {
+                HG_LOG_ERROR("Could not reserve buffer space");
+                ret = HG_NOMEM_ERROR;
+                goto done;
+            }
+            memcpy(buf, *array, (size_t) size);
+            break;
+        case HG_DECODE:
+            memcpy(*array, buf, (size_t) size);
+            break;
+        default:
+            /* HG_SIZE only reserves space */
+            break;
+    }
+#endif
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_proc_plan_release(hg_proc_t proc, const struct hg_proc_plan *hg_proc_plan,
+    const struct hg_proc_plan_op *op_end, char *data)
+{
+    const struct hg_proc_plan_op *op;
+    hg_bool_t reset = HG_FALSE;
+
+    for (op = hg_proc_plan->ops; op < op_end; op++) {
+        switch (op->type) {
+            case HG_PROC_PLAN_ARRAY: {
+                void **array = (void **) (data + op->offset);
+
+                free(*array);
+                *array = NULL;
+                break;
+            }
+            case HG_PROC_PLAN_PROC:
+                /* Decoding failed, proc can be reset to free fields */
+                if (!reset) {
+                    hg_proc_reset(proc, NULL, 0, HG_FREE);
+                    reset = HG_TRUE;
+                }
+                op->proc_cb(proc, data + op->offset);
+                break;
+            default:
+                /* Nothing to release */
+                break;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_plan_create(const struct hg_field *fields, hg_proc_plan_t *plan)
+{
+    struct hg_proc_plan *hg_proc_plan = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!fields) {
+        HG_LOG_ERROR("NULL field table");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    hg_proc_plan = (struct hg_proc_plan *) malloc(sizeof(struct hg_proc_plan));
+    if (!hg_proc_plan) {
+        HG_LOG_ERROR("Could not allocate plan");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    memset(hg_proc_plan, 0, sizeof(struct hg_proc_plan));
+
+    ret = hg_proc_plan_compile(hg_proc_plan, fields, 0, 0);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not compile field table");
+        goto done;
+    }
+
+    *plan = hg_proc_plan;
+
+done:
+    if (ret != HG_SUCCESS)
+        hg_proc_plan_free(hg_proc_plan);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_plan_free(hg_proc_plan_t plan)
+{
+    struct hg_proc_plan *hg_proc_plan = (struct hg_proc_plan *) plan;
+
+    if (!hg_proc_plan)
+        goto done;
+
+    free(hg_proc_plan->ops);
+    free(hg_proc_plan->copies);
+    free(hg_proc_plan);
+
+done:
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_plan_process(hg_proc_t proc, hg_proc_plan_t plan, void *data)
+{
+    struct hg_proc_plan *hg_proc_plan = (struct hg_proc_plan *) plan;
+    const struct hg_proc_plan_op *op, *op_end;
+    hg_proc_op_t proc_op = hg_proc_get_op(proc);
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_proc_plan) {
+        HG_LOG_ERROR("NULL plan");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+    op_end = hg_proc_plan->ops + hg_proc_plan->op_count;
+
+    for (op = hg_proc_plan->ops; op < op_end; op++) {
+        switch (op->type) {
+            case HG_PROC_PLAN_RUN:
+                /* Nothing to release */
+                if (proc_op == HG_FREE)
+                    break;
+                ret = hg_proc_plan_run(proc, hg_proc_plan, op, (char *) data);
+                break;
+            case HG_PROC_PLAN_ARRAY:
+                if (proc_op == HG_FREE) {
+                    void **array = (void **) ((char *) data + op->offset);
+
+                    free(*array);
+                    *array = NULL;
+                    break;
+                }
+                ret = hg_proc_plan_array(proc, op, (char *) data);
+                break;
+            case HG_PROC_PLAN_PROC:
+                ret = op->proc_cb(proc, (char *) data + op->offset);
+                break;
+            default:
+                ret = HG_INVALID_PARAM;
+                break;
+        }
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not process field");
+            /* Do not leak fields that were already decoded */
+            if (proc_op == HG_DECODE)
+                hg_proc_plan_release(proc, hg_proc_plan, op, (char *) data);
+            goto done;
+        }
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+hg_proc_plan_has_proc(hg_proc_plan_t plan)
+{
+    struct hg_proc_plan *hg_proc_plan = (struct hg_proc_plan *) plan;
+
+    return (hg_proc_plan && hg_proc_plan->has_proc) ? HG_TRUE : HG_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_plan_get_size(hg_proc_t proc, hg_proc_plan_t plan, void *data,
+    hg_size_t *size)
+{
+    struct hg_proc_plan *hg_proc_plan = (struct hg_proc_plan *) plan;
+    const struct hg_proc_plan_op *op, *op_end;
+    hg_size_t total_size = 0, proc_size = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_proc_plan) {
+        HG_LOG_ERROR("NULL plan");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+#ifdef HG_HAS_XDR
+    /* Fields are not encoded with their own size */
+    HG_LOG_ERROR("Not supported using XDR");
+    ret = HG_PROTOCOL_ERROR;
+    goto done;
+#endif
+    if (hg_proc_plan->has_proc) {
+        if (proc == HG_PROC_NULL || hg_proc_get_op(proc) != HG_SIZE) {
+            HG_LOG_ERROR("Proc must be reset with HG_SIZE");
+            ret = HG_INVALID_PARAM;
+            goto done;
+        }
+        proc_size = hg_proc_get_size_used(proc);
+    }
+    op_end = hg_proc_plan->ops + hg_proc_plan->op_count;
+
+    for (op = hg_proc_plan->ops; op < op_end; op++) {
+        hg_uint64_t count;
+
+        switch (op->type) {
+            case HG_PROC_PLAN_RUN:
+                total_size += op->size;
+                break;
+            case HG_PROC_PLAN_ARRAY:
+                count = hg_proc_plan_array_count(op, (const char *) data);
+                if (count > (HG_SIZE_MAX - total_size) / op->size) {
+                    HG_LOG_ERROR("Array of %llu elements is too large",
+                        (unsigned long long) count);
+                    ret = HG_SIZE_ERROR;
+                    goto done;
+                }
+                total_size += count * op->size;
+                break;
+            case HG_PROC_PLAN_PROC:
+                ret = op->proc_cb(proc, (char *) data + op->offset);
+                if (ret != HG_SUCCESS) {
+                    HG_LOG_ERROR("Could not size field");
+                    goto done;
+                }
+                break;
+            default:
+                ret = HG_INVALID_PARAM;
+                goto done;
+        }
+    }
+    if (hg_proc_plan->has_proc)
+        total_size += hg_proc_get_size_used(proc) - proc_size;
+
+    *size = total_size;
+
+done:
+    return ret;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_PROC_PLAN_H
+#define MERCURY_PROC_PLAN_H
+
+#include "mercury_proc.h"
+
+#include <stddef.h>
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+/* Field descriptors of struct type, to be used in field tables terminated
+ * by HG_FIELD_DESC_END */
+#define HG_FIELD_MEMBER_SIZE(type, member) sizeof(((type *) 0)->member)
+
+/* Fixed-width integer member */
+#define HG_FIELD_DESC_FIXED(type, member)                                   \
+    { HG_FIELD_FIXED, offsetof(type, member),                               \
+      HG_FIELD_MEMBER_SIZE(type, member), 1, 0, NULL, NULL }
+
+/* Member that is a C array of fixed-width integers */
+#define HG_FIELD_DESC_FIXED_ARRAY(type, member)                             \
+    { HG_FIELD_FIXED, offsetof(type, member),                               \
+      HG_FIELD_MEMBER_SIZE(type, member[0]),                                \
+      HG_FIELD_MEMBER_SIZE(type, member) /                                  \
+      HG_FIELD_MEMBER_SIZE(type, member[0]), 0, NULL, NULL }
+
+/* Member pointing to fixed-width integers, whose count is the member
+ * described at index length_field of the table (which must come first) */
+#define HG_FIELD_DESC_ARRAY(type, member, length_field)                     \
+    { HG_FIELD_ARRAY, offsetof(type, member),                               \
+      HG_FIELD_MEMBER_SIZE(type, member[0]), 0, length_field, NULL, NULL }
+
+/* Nested struct member described by field table member_fields */
+#define HG_FIELD_DESC_STRUCT(type, member, member_fields)                   \
+    { HG_FIELD_STRUCT, offsetof(type, member),                              \
+      HG_FIELD_MEMBER_SIZE(type, member), 1, 0, member_fields, NULL }
+
+/* Member processed by proc callback (e.g., hg_proc_hg_string_t) */
+#define HG_FIELD_DESC_PROC(type, member, member_proc_cb)                    \
+    { HG_FIELD_PROC, offsetof(type, member),                                \
+      HG_FIELD_MEMBER_SIZE(type, member), 1, 0, NULL, member_proc_cb }
+
+/* End of field table */
+#define HG_FIELD_DESC_END { HG_FIELD_END, 0, 0, 0, 0, NULL, NULL }
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Compile a field table into a serialization plan. Fixed-width fields that
+ * follow each other are gathered into runs that are bounds-checked and
+ * copied at once, nested structs are flattened. The encoding is the same as
+ * the one of the corresponding proc routines (e.g., hg_proc_uint32_t(),
+ * followed by the elements for arrays). Must be freed with
+ * hg_proc_plan_free().
+ *
+ * \param fields [IN]           field table terminated by HG_FIELD_DESC_END
+ * \param plan [OUT]            pointer to plan
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+hg_proc_plan_create(
+        const struct hg_field *fields,
+        hg_proc_plan_t *plan
+        );
+
+/**
+ * Free a plan.
+ *
+ * \param plan [IN/OUT]         plan
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+hg_proc_plan_free(
+        hg_proc_plan_t plan
+        );
+
+/**
+ * Process struct described by plan. Arrays are allocated on HG_DECODE and
+ * released on HG_FREE. Using HG_SIZE gives the exact encoded size.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param plan [IN]             plan
+ * \param data [IN/OUT]         pointer to struct
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+hg_proc_plan_process(
+        hg_proc_t proc,
+        hg_proc_plan_t plan,
+        void *data
+        );
+
+/**
+ * Determine whether some fields of plan are processed by proc callbacks.
+ *
+ * \param plan [IN]             plan
+ *
+ * \return HG_TRUE if plan has such fields, HG_FALSE otherwise
+ */
+HG_EXPORT hg_bool_t
+hg_proc_plan_has_proc(
+        hg_proc_plan_t plan
+        );
+
+/**
+ * Compute the exact encoded size of struct described by plan, directly from
+ * its runs of fixed-width fields and the length fields of its arrays. Fields
+ * processed by proc callbacks (see hg_proc_plan_has_proc()) are sized by
+ * running their callback with proc, which must then have been reset with
+ * HG_SIZE, proc is otherwise not used and may be HG_PROC_NULL (not supported
+ * using XDR).
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param plan [IN]             plan
+ * \param data [IN]             pointer to struct
+ * \param size [OUT]            pointer to encoded size
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+hg_proc_plan_get_size(
+        hg_proc_t proc,
+        hg_proc_plan_t plan,
+        void *data,
+        hg_size_t *size
+        );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_PROC_PLAN_H */
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_PROC_PRIVATE_H
+#define MERCURY_PROC_PRIVATE_H
+
+#include "mercury_proc.h"
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Get size of proc object, so that it can be embedded into other structures.
+ *
+ * \return Non-negative size value
+ */
+hg_size_t
+hg_proc_get_struct_size(
+        void
+        );
+
+/**
+ * Create proc object in memory of hg_proc_get_struct_size() bytes provided
+ * by the caller. Must be released with hg_proc_finalize().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param hash [IN]             hash method used for computing checksum
+ * \param mem [IN]              memory of at least hg_proc_get_struct_size()
+ * \param proc [OUT]            pointer to abstract processor object
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+hg_return_t
+hg_proc_init(
+        hg_class_t *hg_class,
+        hg_proc_hash_t hash,
+        void *mem,
+        hg_proc_t *proc
+        );
+
+/**
+ * Release resources of proc object created with hg_proc_init(), memory of
+ * the object itself is not freed.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+hg_return_t
+hg_proc_finalize(
+        hg_proc_t proc
+        );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_PROC_PRIVATE_H */
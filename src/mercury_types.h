@@ -28,6 +28,7 @@ typedef struct hg_handle *hg_handle_t;  /* Abstract RPC handle */
 typedef struct hg_bulk *hg_bulk_t;      /* Abstract bulk data handle */
 typedef struct hg_proc *hg_proc_t;      /* Abstract serialization processor */
 typedef struct hg_op_id *hg_op_id_t;    /* Abstract operation id */
+typedef struct hg_proc_plan *hg_proc_plan_t; /* Compiled serialization plan */
 
 /* HG init info struct */
 struct hg_init_info {
@@ -37,6 +38,24 @@ struct hg_init_info {
     hg_bool_t stats;                    /* (Debug) Print stats at exit */
 };
 
+/* Occupancy of a staging buffer size class */
+struct hg_bulk_staging_info {
+    hg_size_t buf_size;         /* Size of buffers in class */
+    hg_uint32_t free_count;     /* Registered buffers ready for reuse */
+    hg_uint32_t used_count;     /* Buffers currently in use */
+    hg_uint64_t hit_count;      /* Handles created from a free buffer */
+    hg_uint64_t miss_count;     /* Handles that required a new buffer */
+};
+
+/* Range of a batched bulk transfer */
+struct hg_bulk_transfer_desc {
+    hg_bulk_t origin_handle;    /* HG Bulk origin handle */
+    hg_size_t origin_offset;    /* Offset in origin handle */
+    hg_bulk_t local_handle;     /* HG Bulk local handle */
+    hg_size_t local_offset;     /* Offset in local handle */
+    hg_size_t size;             /* Size of data to be transferred */
+};
+
 /* HG info struct */
 struct hg_info {
     hg_class_t *hg_class;       /* HG class */
@@ -60,7 +79,8 @@ typedef enum {
 typedef enum {
     HG_ENCODE,  /*!< causes the type to be encoded into the stream */
     HG_DECODE,  /*!< causes the type to be extracted from the stream */
-    HG_FREE     /*!< can be used to release the space allocated by an HG_DECODE request */
+    HG_FREE,    /*!< can be used to release the space allocated by an HG_DECODE request */
+    HG_SIZE     /*!< causes the encoded size of the type to be computed only */
 } hg_proc_op_t;
 
 /**
@@ -114,6 +134,8 @@ struct hg_cb_info_bulk {
     hg_bulk_op_t op;            /* Operation type */
     hg_bulk_t origin_handle;    /* HG Bulk origin handle */
     hg_bulk_t local_handle;     /* HG Bulk local handle */
+    hg_size_t offset;           /* Offset of chunk within stream */
+    hg_size_t size;             /* Size of data transferred */
 };
 
 struct hg_cb_info {
@@ -135,6 +157,27 @@ typedef hg_return_t (*hg_cb_t)(const struct hg_cb_info *callback_info);
 /* Proc callback for serializing/deserializing parameters */
 typedef hg_return_t (*hg_proc_cb_t)(hg_proc_t proc, void *data);
 
+/* Kind of field described in a field table */
+typedef enum {
+    HG_FIELD_END = 0,   /*!< end of field table */
+    HG_FIELD_FIXED,     /*!< fixed-width integer(s) of 1, 2, 4 or 8 bytes */
+    HG_FIELD_ARRAY,     /*!< pointer to fixed-width integers, count is stored
+                             in another fixed-width field */
+    HG_FIELD_STRUCT,    /*!< nested struct(s) described by a field table */
+    HG_FIELD_PROC       /*!< field processed by a proc callback */
+} hg_field_kind_t;
+
+/* Field descriptor, tables of fields describe structs serialized with plans */
+struct hg_field {
+    hg_field_kind_t kind;           /* Field kind */
+    size_t offset;                  /* Offset of field in struct */
+    size_t size;                    /* Element size (struct size if nested) */
+    size_t count;                   /* Number of elements in place */
+    hg_uint32_t length_field;       /* Table index of array length field */
+    const struct hg_field *fields;  /* Field table of nested struct */
+    hg_proc_cb_t proc_cb;           /* Proc callback */
+};
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -159,4 +202,13 @@ typedef hg_return_t (*hg_proc_cb_t)(hg_proc_t proc, void *data);
 #define HG_BULK_WRITE_ONLY  0x02
 #define HG_BULK_READWRITE   0x03
 
+/* Bulk handle serialization flags, memory handles are only registered
+ * with the NA classes that they are serialized for */
+#define HG_BULK_SERIALIZE_EAGER 0x01 /* Encode data along the handle */
+#define HG_BULK_SERIALIZE_NA    0x02 /* Encode NA memory handles */
+#define HG_BULK_SERIALIZE_SM    0x04 /* Encode NA SM memory handles */
+
+/* Number of size classes of bulk staging buffers */
+#define HG_BULK_STAGING_CLASS_COUNT 5
+
 #endif /* MERCURY_TYPES_H */
@@ -17,7 +17,7 @@
 #include "mercury_time.h"
 #include "mercury_atomic.h"
 #include "mercury_mem.h"
-#include "mercury_atomic_queue.h"
+#include "mercury_atomic_seg_queue.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -38,6 +38,7 @@
 #endif
 
 #define NA_ATOMIC_QUEUE_SIZE 1024   /* TODO make it configurable */
+#define NA_TRIGGER_BATCH_SIZE 16    /* Max entries dequeued at once */
 
 #define NA_PROGRESS_LOCK 0x80000000 /* 32-bit lock value for serial progress */
 
@@ -56,9 +57,7 @@ struct na_private_class {
 struct na_private_context {
     struct na_context context;                  /* Must remain as first field */
     na_class_t *na_class;                       /* Pointer to NA class */
-    struct hg_atomic_queue *completion_queue;   /* Default completion queue */
-    HG_QUEUE_HEAD(na_cb_completion_data) backfill_queue; /* Backfill completion queue */
-    hg_atomic_int32_t backfill_queue_count;     /* Number of entries in backfill queue */
+    struct hg_atomic_seg_queue *completion_queue; /* Default completion queue */
     hg_thread_mutex_t completion_queue_mutex;   /* Completion queue mutex */
     hg_thread_cond_t  completion_queue_cond;    /* Completion queue cond */
     hg_atomic_int32_t trigger_waiting;          /* Polling/waiting in trigger */
@@ -534,14 +533,12 @@ NA_Context_create_id(na_class_t *na_class, na_uint8_t id)
 
     /* Initialize completion queue */
     na_private_context->completion_queue =
-        hg_atomic_queue_alloc(NA_ATOMIC_QUEUE_SIZE);
+        hg_atomic_seg_queue_alloc(NA_ATOMIC_QUEUE_SIZE);
     if (!na_private_context->completion_queue) {
         NA_LOG_ERROR("Could not allocate queue");
         ret = NA_NOMEM_ERROR;
         goto done;
     }
-    HG_QUEUE_INIT(&na_private_context->backfill_queue);
-    hg_atomic_init32(&na_private_context->backfill_queue_count, 0);
 
     /* Initialize completion queue mutex/cond */
     hg_thread_mutex_init(&na_private_context->completion_queue_mutex);
@@ -579,22 +576,12 @@ NA_Context_destroy(na_class_t *na_class, na_context_t *context)
     if (!context) goto done;
 
     /* Check that completion queue is empty now */
-    if (!hg_atomic_queue_is_empty(na_private_context->completion_queue)) {
+    if (!hg_atomic_seg_queue_is_empty(na_private_context->completion_queue)) {
         NA_LOG_ERROR("Completion queue should be empty");
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
-    hg_atomic_queue_free(na_private_context->completion_queue);
-
-    /* Check that backfill completion queue is empty now */
-    hg_thread_mutex_lock(&na_private_context->completion_queue_mutex);
-    if (!HG_QUEUE_IS_EMPTY(&na_private_context->backfill_queue)) {
-        NA_LOG_ERROR("Completion queue should be empty");
-        ret = NA_PROTOCOL_ERROR;
-        hg_thread_mutex_unlock(&na_private_context->completion_queue_mutex);
-        goto done;
-    }
-    hg_thread_mutex_unlock(&na_private_context->completion_queue_mutex);
+    hg_atomic_seg_queue_free(na_private_context->completion_queue);
 
     /* Destroy completion queue mutex/cond */
     hg_thread_mutex_destroy(&na_private_context->completion_queue_mutex);
@@ -621,6 +608,40 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Context_get_stats(na_class_t *na_class, na_context_t *context,
+    struct na_context_stats *stats)
+{
+    na_return_t ret = NA_SUCCESS;
+
+    if (!na_class) {
+        NA_LOG_ERROR("NULL NA class");
+        ret = NA_INVALID_PARAM;
+        goto done;
+    }
+    if (!context) {
+        NA_LOG_ERROR("NULL context");
+        ret = NA_INVALID_PARAM;
+        goto done;
+    }
+    if (!stats) {
+        NA_LOG_ERROR("NULL stats");
+        ret = NA_INVALID_PARAM;
+        goto done;
+    }
+    if (!na_class->context_get_stats) {
+        NA_LOG_ERROR("context_get_stats plugin callback is not defined");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    ret = na_class->context_get_stats(na_class, context, stats);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 na_op_id_t
 NA_Op_create(na_class_t *na_class)
@@ -1767,8 +1788,7 @@ NA_Poll_try_wait(na_class_t *na_class, na_context_t *context)
         return NA_FALSE;
 
     /* Something is in one of the completion queues */
-    if (!hg_atomic_queue_is_empty(na_private_context->completion_queue) ||
-        hg_atomic_get32(&na_private_context->backfill_queue_count)) {
+    if (!hg_atomic_seg_queue_is_empty(na_private_context->completion_queue)) {
         return NA_FALSE;
     }
 
@@ -1863,8 +1883,7 @@ NA_Progress(na_class_t *na_class, na_context_t *context, unsigned int timeout)
 #endif
 
     /* Something is in one of the completion queues */
-    if (!hg_atomic_queue_is_empty(na_private_context->completion_queue) ||
-        hg_atomic_get32(&na_private_context->backfill_queue_count)) {
+    if (!hg_atomic_seg_queue_is_empty(na_private_context->completion_queue)) {
         ret = NA_SUCCESS; /* Progressed */
 #ifdef NA_HAS_MULTI_PROGRESS
         goto unlock;
@@ -1924,24 +1943,20 @@ NA_Trigger(na_context_t *context, unsigned int timeout, unsigned int max_count,
     }
 
     while (count < max_count) {
-        struct na_cb_completion_data *completion_data = NULL;
-
-        completion_data =
-            hg_atomic_queue_pop_mc(na_private_context->completion_queue);
-        if (!completion_data) {
-            /* Check backfill queue */
-            if (hg_atomic_get32(&na_private_context->backfill_queue_count)) {
-                hg_thread_mutex_lock(
-                    &na_private_context->completion_queue_mutex);
-                completion_data =
-                    HG_QUEUE_FIRST(&na_private_context->backfill_queue);
-                HG_QUEUE_POP_HEAD(&na_private_context->backfill_queue, entry);
-                hg_atomic_decr32(&na_private_context->backfill_queue_count);
-                hg_thread_mutex_unlock(
-                    &na_private_context->completion_queue_mutex);
-                if (!completion_data)
-                    continue; /* Give another change to grab it */
-            } else {
+        void *completion_batch[NA_TRIGGER_BATCH_SIZE];
+        unsigned int batch_count, i;
+
+        /* Dequeue a batch of completions at once */
+        batch_count = hg_atomic_seg_queue_pop_n(
+            na_private_context->completion_queue, completion_batch,
+            ((max_count - count) < NA_TRIGGER_BATCH_SIZE) ?
+                (max_count - count) : NA_TRIGGER_BATCH_SIZE);
+        if (!batch_count) {
+            /* Push may still be in progress */
+            if (!hg_atomic_seg_queue_is_empty(
+                na_private_context->completion_queue))
+                continue; /* Give another change to grab it */
+            else {
                 hg_time_t t1, t2;
 
                 /* If something was already processed leave */
@@ -1960,10 +1975,8 @@ NA_Trigger(na_context_t *context, unsigned int timeout, unsigned int max_count,
                 hg_thread_mutex_lock(
                     &na_private_context->completion_queue_mutex);
                 /* Otherwise wait timeout ms */
-                while (hg_atomic_queue_is_empty(
-                    na_private_context->completion_queue)
-                    && !hg_atomic_get32(
-                        &na_private_context->backfill_queue_count)) {
+                while (hg_atomic_seg_queue_is_empty(
+                    na_private_context->completion_queue)) {
                     if (hg_thread_cond_timedwait(
                         &na_private_context->completion_queue_cond,
                         &na_private_context->completion_queue_mutex, timeout)
@@ -1985,32 +1998,38 @@ NA_Trigger(na_context_t *context, unsigned int timeout, unsigned int max_count,
             }
         }
 
-        /* Completion queue should not be empty now */
-        if (!completion_data) {
-            NA_LOG_ERROR("NULL completion data");
-            ret = NA_PROTOCOL_ERROR;
-            goto done;
-        }
-
-        /* Execute callback */
-        if (completion_data->callback) {
-            int cb_ret =
-                completion_data->callback(&completion_data->callback_info);
-            if (callback_ret)
-                callback_ret[count] = cb_ret;
-        }
+        for (i = 0; i < batch_count; i++) {
+            struct na_cb_completion_data *completion_data =
+                (struct na_cb_completion_data *) completion_batch[i];
 
-        /* Execute plugin callback (free resources etc)
-         * NB. If the NA operation ID is reused by the plugin for another
-         * operation we must be careful that resources are released BEFORE
-         * that operation ID gets re-used. This is currently not protected
-         * and left upon the plugin implementation.
-         */
-        if (completion_data->plugin_callback)
-            completion_data->plugin_callback(
-                completion_data->plugin_callback_args);
+            /* Completion queue should not be empty now */
+            if (!completion_data) {
+                NA_LOG_ERROR("NULL completion data");
+                ret = NA_PROTOCOL_ERROR;
+                goto done;
+            }
 
-        count++;
+            /* Execute callback */
+            if (completion_data->callback) {
+                int cb_ret =
+                    completion_data->callback(&completion_data->callback_info);
+                if (callback_ret)
+                    callback_ret[count] = cb_ret;
+            } else if (callback_ret)
+                callback_ret[count] = 0;
+
+            /* Execute plugin callback (free resources etc)
+             * NB. If the NA operation ID is reused by the plugin for another
+             * operation we must be careful that resources are released BEFORE
+             * that operation ID gets re-used. This is currently not protected
+             * and left upon the plugin implementation.
+             */
+            if (completion_data->plugin_callback)
+                completion_data->plugin_callback(
+                    completion_data->plugin_callback_args);
+
+            count++;
+        }
     }
 
 done:
@@ -2081,14 +2100,12 @@ na_cb_completion_add(na_context_t *context,
         (struct na_private_context *) context;
     na_return_t ret = NA_SUCCESS;
 
-    if (hg_atomic_queue_push(na_private_context->completion_queue,
+    /* Queue is unbounded, push only fails if no segment can be allocated */
+    if (hg_atomic_seg_queue_push(na_private_context->completion_queue,
         na_cb_completion_data) != HG_UTIL_SUCCESS) {
-        /* Queue is full */
-        hg_thread_mutex_lock(&na_private_context->completion_queue_mutex);
-        HG_QUEUE_PUSH_TAIL(&na_private_context->backfill_queue,
-            na_cb_completion_data, entry);
-        hg_atomic_incr32(&na_private_context->backfill_queue_count);
-        hg_thread_mutex_unlock(&na_private_context->completion_queue_mutex);
+        NA_LOG_ERROR("Could not push completion data");
+        ret = NA_NOMEM_ERROR;
+        goto done;
     }
 
     if (hg_atomic_get32(&na_private_context->trigger_waiting)) {
@@ -2099,5 +2116,39 @@ na_cb_completion_add(na_context_t *context,
         hg_thread_mutex_unlock(&na_private_context->completion_queue_mutex);
     }
 
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+na_cb_completion_add_batch(na_context_t *context,
+    struct na_cb_completion_data *na_cb_completion_data[], unsigned int count)
+{
+    struct na_private_context *na_private_context =
+        (struct na_private_context *) context;
+    unsigned int pushed;
+    na_return_t ret = NA_SUCCESS;
+
+    if (!count)
+        goto done;
+
+    pushed = hg_atomic_seg_queue_push_n(na_private_context->completion_queue,
+        (void **) na_cb_completion_data, count);
+    if (pushed < count) {
+        NA_LOG_ERROR("Could not push completion data");
+        ret = NA_NOMEM_ERROR;
+        if (!pushed)
+            goto done;
+    }
+
+    /* Wake up anyone waiting in the trigger once for the whole batch */
+    if (hg_atomic_get32(&na_private_context->trigger_waiting)) {
+        hg_thread_mutex_lock(&na_private_context->completion_queue_mutex);
+        hg_thread_cond_signal(&na_private_context->completion_queue_cond);
+        hg_thread_mutex_unlock(&na_private_context->completion_queue_mutex);
+    }
+
+done:
     return ret;
 }
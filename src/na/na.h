@@ -40,6 +40,7 @@ struct na_init_info {
     na_progress_mode_t progress_mode;   /* Progress mode */
     na_uint8_t max_contexts;            /* Max contexts */
     const char *auth_key;               /* Authorization key */
+    na_uint8_t rma_stripe_count;        /* Endpoints used to stripe large RMA */
 };
 
 /* Segment */
@@ -99,6 +100,16 @@ struct na_cb_info {
 /* Callback type */
 typedef int (*na_cb_t)(const struct na_cb_info *callback_info);
 
+/* Completion queue stats of a context */
+struct na_context_stats {
+    na_uint64_t cq_reads;       /* Number of completion queue reads */
+    na_uint64_t cq_empty_reads; /* Reads that returned no event */
+    na_uint64_t cq_full_reads;  /* Reads that filled the batch */
+    na_uint64_t cq_events;      /* Number of events read */
+    na_uint32_t cq_batch;       /* Current number of events read at once */
+    na_uint32_t cq_batch_max;   /* Largest batch size reached */
+};
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -266,6 +277,24 @@ NA_Context_destroy(
         na_context_t *context
         );
 
+/**
+ * Get completion queue stats of a context. Counters are only collected when
+ * the plugin is built with stats enabled (e.g., NA_OFI_ENABLE_STATS) and are
+ * 0 otherwise.
+ *
+ * \param na_class [IN]         pointer to NA class
+ * \param context [IN]          pointer to context of execution
+ * \param stats [OUT]           pointer to stats
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_EXPORT na_return_t
+NA_Context_get_stats(
+        na_class_t              *na_class,
+        na_context_t            *context,
+        struct na_context_stats *stats
+        );
+
 /**
  * Allocate an operation ID for the higher level layer to save and
  * pass back to the NA layer rather than have the NA layer allocate operation
@@ -1043,6 +1072,13 @@ NA_Progress(
  * timeout before returning. Function can return when at least one or more
  * callbacks are triggered (at most max_count).
  *
+ * Completions are dequeued in batches: callers that can process several
+ * completions at once (e.g., the HG core layer) should pass a max_count
+ * greater than 1 along with a callback_ret array of at least max_count
+ * entries, so that a batch of completions is handed over without
+ * synchronizing on the completion queue for every entry. The return value
+ * of each callback is stored in callback_ret (0 if no callback was set).
+ *
  * \param context [IN/OUT]      pointer to context of execution
  * \param timeout [IN]          timeout (in milliseconds)
  * \param max_count [IN]        maximum number of callbacks triggered
@@ -52,6 +52,9 @@
 #define NA_BMI_CANCEL_R (1 << 0)
 #define NA_BMI_CANCEL_C (1 << 1)
 
+/* Max number of events retrieved by a single test call */
+#define NA_BMI_TEST_EVENT_NUM 16
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -123,7 +126,7 @@ struct na_bmi_info_put {
     bmi_size_t  completion_actual_size;
     na_bool_t   internal_progress;
     BMI_addr_t  remote_addr;
-    struct na_bmi_rma_info *rma_info;
+    struct na_bmi_rma_info rma_info;
 };
 
 struct na_bmi_info_get {
@@ -132,10 +135,11 @@ struct na_bmi_info_get {
     bmi_size_t  transfer_actual_size;
     na_bool_t   internal_progress;
     BMI_addr_t  remote_addr;
-    struct na_bmi_rma_info *rma_info;
+    struct na_bmi_rma_info rma_info;
 };
 
 struct na_bmi_op_id {
+    na_class_t *na_class;
     na_context_t *context;
     na_cb_type_t type;
     na_cb_t callback;               /* Callback */
@@ -143,6 +147,7 @@ struct na_bmi_op_id {
     hg_atomic_int32_t ref_count;    /* Ref count */
     hg_atomic_int32_t completed;    /* Operation completed */
     uint64_t cancel;
+    na_bool_t pooled;               /* Internal op ID returned to pool */
     union {
       struct na_bmi_info_lookup lookup;
       struct na_bmi_info_send_unexpected send_unexpected;
@@ -156,13 +161,22 @@ struct na_bmi_op_id {
     HG_QUEUE_ENTRY(na_bmi_op_id) entry;
 };
 
+struct na_bmi_completion_batch {
+    na_context_t *context;          /* Context of the completion queue */
+    struct na_cb_completion_data *entries[NA_BMI_TEST_EVENT_NUM];
+    unsigned int count;             /* Number of entries */
+};
+
 struct na_bmi_private_data {
     char *listen_addr;                               /* Listen addr */
     int port;                                        /* Port used */
     char *protocol_name;                             /* Protocol used for this class */
     hg_thread_mutex_t test_unexpected_mutex;         /* Mutex */
     HG_QUEUE_HEAD(na_bmi_unexpected_info) unexpected_msg_queue; /* Unexpected message queue */
+    HG_QUEUE_HEAD(na_bmi_unexpected_info) unexpected_info_pool; /* Free unexpected info */
     hg_thread_mutex_t unexpected_msg_queue_mutex;    /* Mutex */
+    HG_QUEUE_HEAD(na_bmi_op_id) rma_op_pool;         /* Free internal RMA op IDs */
+    hg_thread_mutex_t rma_op_pool_mutex;             /* Mutex */
     HG_QUEUE_HEAD(na_bmi_op_id) unexpected_op_queue; /* Unexpected op queue */
     hg_thread_mutex_t unexpected_op_queue_mutex;     /* Mutex */
     hg_atomic_int32_t rma_tag;                       /* Atomic RMA tag value */
@@ -365,6 +379,25 @@ na_bmi_msg_unexpected_op_pop(
         na_class_t *na_class
         );
 
+/* Get unexpected info from pool */
+static struct na_bmi_unexpected_info *
+na_bmi_unexpected_info_get(
+        na_class_t *na_class
+        );
+
+/* Return unexpected info to pool */
+static void
+na_bmi_unexpected_info_release(
+        na_class_t                    *na_class,
+        struct na_bmi_unexpected_info *unexpected_info
+        );
+
+/* Get internal RMA op ID from pool */
+static struct na_bmi_op_id *
+na_bmi_rma_op_get(
+        na_class_t *na_class
+        );
+
 /* mem_handle */
 static na_return_t
 na_bmi_mem_handle_create(
@@ -472,6 +505,14 @@ na_bmi_progress_expected(
         unsigned int  timeout
         );
 
+static na_return_t
+na_bmi_progress_expected_event(
+        struct na_bmi_op_id            *na_bmi_op_id,
+        bmi_op_id_t                     bmi_op_id,
+        bmi_size_t                      bmi_actual_size,
+        struct na_bmi_completion_batch *batch
+        );
+
 static na_return_t
 na_bmi_progress_rma(
         na_class_t                 *na_class,
@@ -489,6 +530,12 @@ na_bmi_complete(
         struct na_bmi_op_id *na_bmi_op_id
         );
 
+static na_return_t
+na_bmi_complete_batch(
+        struct na_bmi_op_id            *na_bmi_op_id,
+        struct na_bmi_completion_batch *batch
+        );
+
 static void
 na_bmi_release(
         void *arg
@@ -515,6 +562,7 @@ const na_class_t na_bmi_class_g = {
         NULL,                                 /* cleanup */
         na_bmi_context_create,                /* context_create */
         na_bmi_context_destroy,               /* context_destroy */
+        NULL,                                 /* context_get_stats */
         na_bmi_op_create,                     /* op_create */
         na_bmi_op_destroy,                    /* op_destroy */
         na_bmi_addr_lookup,                   /* addr_lookup */
@@ -651,7 +699,9 @@ na_bmi_initialize(na_class_t * na_class, const struct na_info *na_info,
     NA_BMI_PRIVATE_DATA(na_class)->protocol_name =
         strdup(na_info->protocol_name);
     HG_QUEUE_INIT(&NA_BMI_PRIVATE_DATA(na_class)->unexpected_msg_queue);
+    HG_QUEUE_INIT(&NA_BMI_PRIVATE_DATA(na_class)->unexpected_info_pool);
     HG_QUEUE_INIT(&NA_BMI_PRIVATE_DATA(na_class)->unexpected_op_queue);
+    HG_QUEUE_INIT(&NA_BMI_PRIVATE_DATA(na_class)->rma_op_pool);
 
     if (listen) {
         int desc_len = 0;
@@ -727,6 +777,7 @@ again:
         &NA_BMI_PRIVATE_DATA(na_class)->unexpected_msg_queue_mutex);
     hg_thread_mutex_init(
         &NA_BMI_PRIVATE_DATA(na_class)->unexpected_op_queue_mutex);
+    hg_thread_mutex_init(&NA_BMI_PRIVATE_DATA(na_class)->rma_op_pool_mutex);
 
     /* Initialize atomic op */
     hg_atomic_set32(&NA_BMI_PRIVATE_DATA(na_class)->rma_tag, NA_BMI_RMA_TAG);
@@ -764,6 +815,22 @@ na_bmi_finalize(na_class_t *na_class)
         ret = NA_PROTOCOL_ERROR;
     }
 
+    /* Free pooled unexpected info and RMA op IDs */
+    while (!HG_QUEUE_IS_EMPTY(
+            &NA_BMI_PRIVATE_DATA(na_class)->unexpected_info_pool)) {
+        struct na_bmi_unexpected_info *unexpected_info = HG_QUEUE_FIRST(
+            &NA_BMI_PRIVATE_DATA(na_class)->unexpected_info_pool);
+        HG_QUEUE_POP_HEAD(
+            &NA_BMI_PRIVATE_DATA(na_class)->unexpected_info_pool, entry);
+        free(unexpected_info);
+    }
+    while (!HG_QUEUE_IS_EMPTY(&NA_BMI_PRIVATE_DATA(na_class)->rma_op_pool)) {
+        struct na_bmi_op_id *na_bmi_op_id =
+            HG_QUEUE_FIRST(&NA_BMI_PRIVATE_DATA(na_class)->rma_op_pool);
+        HG_QUEUE_POP_HEAD(&NA_BMI_PRIVATE_DATA(na_class)->rma_op_pool, entry);
+        free(na_bmi_op_id);
+    }
+
     /* Finalize BMI */
     bmi_ret = BMI_finalize();
     if (bmi_ret < 0) {
@@ -778,6 +845,8 @@ na_bmi_finalize(na_class_t *na_class)
             &NA_BMI_PRIVATE_DATA(na_class)->unexpected_msg_queue_mutex);
     hg_thread_mutex_destroy(
             &NA_BMI_PRIVATE_DATA(na_class)->unexpected_op_queue_mutex);
+    hg_thread_mutex_destroy(
+            &NA_BMI_PRIVATE_DATA(na_class)->rma_op_pool_mutex);
 
     free(NA_BMI_PRIVATE_DATA(na_class)->listen_addr);
     free(NA_BMI_PRIVATE_DATA(na_class)->protocol_name);
@@ -833,7 +902,7 @@ na_bmi_context_destroy(na_class_t NA_UNUSED *na_class, void *context)
 
 /*---------------------------------------------------------------------------*/
 static na_op_id_t
-na_bmi_op_create(na_class_t NA_UNUSED *na_class)
+na_bmi_op_create(na_class_t *na_class)
 {
     struct na_bmi_op_id *na_bmi_op_id = NULL;
 
@@ -843,6 +912,7 @@ na_bmi_op_create(na_class_t NA_UNUSED *na_class)
         goto done;
     }
     memset(na_bmi_op_id, 0, sizeof(struct na_bmi_op_id));
+    na_bmi_op_id->na_class = na_class;
     hg_atomic_set32(&na_bmi_op_id->ref_count, 1);
     /* Completed by default */
     hg_atomic_set32(&na_bmi_op_id->completed, 1);
@@ -862,6 +932,19 @@ na_bmi_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t op_id)
         /* Cannot free yet */
         goto done;
     }
+
+    /* Internal RMA op IDs go back to the pool for the next request */
+    if (na_bmi_op_id->pooled) {
+        na_class_t *bmi_class = na_bmi_op_id->na_class;
+
+        hg_thread_mutex_lock(
+            &NA_BMI_PRIVATE_DATA(bmi_class)->rma_op_pool_mutex);
+        HG_QUEUE_PUSH_TAIL(&NA_BMI_PRIVATE_DATA(bmi_class)->rma_op_pool,
+            na_bmi_op_id, entry);
+        hg_thread_mutex_unlock(
+            &NA_BMI_PRIVATE_DATA(bmi_class)->rma_op_pool_mutex);
+        goto done;
+    }
     free(na_bmi_op_id);
 
 done:
@@ -1232,7 +1315,7 @@ done:
     if (ret != NA_SUCCESS) {
         na_bmi_op_destroy(na_class, (na_op_id_t) na_bmi_op_id);
     }
-    free(unexpected_info);
+    na_bmi_unexpected_info_release(na_class, unexpected_info);
     return ret;
 }
 
@@ -1325,6 +1408,79 @@ na_bmi_msg_unexpected_op_pop(na_class_t *na_class)
     return na_bmi_op_id;
 }
 
+/*---------------------------------------------------------------------------*/
+static struct na_bmi_unexpected_info *
+na_bmi_unexpected_info_get(na_class_t *na_class)
+{
+    struct na_bmi_unexpected_info *unexpected_info;
+
+    hg_thread_mutex_lock(
+            &NA_BMI_PRIVATE_DATA(na_class)->unexpected_msg_queue_mutex);
+
+    unexpected_info = HG_QUEUE_FIRST(
+            &NA_BMI_PRIVATE_DATA(na_class)->unexpected_info_pool);
+    HG_QUEUE_POP_HEAD(&NA_BMI_PRIVATE_DATA(na_class)->unexpected_info_pool,
+            entry);
+
+    hg_thread_mutex_unlock(
+            &NA_BMI_PRIVATE_DATA(na_class)->unexpected_msg_queue_mutex);
+
+    /* Pool is empty, allocate a new one */
+    if (!unexpected_info) {
+        unexpected_info = (struct na_bmi_unexpected_info *)
+                            malloc(sizeof(struct na_bmi_unexpected_info));
+        if (!unexpected_info)
+            NA_LOG_ERROR("Could not allocate unexpected info");
+    }
+
+    return unexpected_info;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_bmi_unexpected_info_release(na_class_t *na_class,
+        struct na_bmi_unexpected_info *unexpected_info)
+{
+    if (!unexpected_info)
+        return;
+
+    hg_thread_mutex_lock(
+            &NA_BMI_PRIVATE_DATA(na_class)->unexpected_msg_queue_mutex);
+
+    HG_QUEUE_PUSH_TAIL(&NA_BMI_PRIVATE_DATA(na_class)->unexpected_info_pool,
+        unexpected_info, entry);
+
+    hg_thread_mutex_unlock(
+            &NA_BMI_PRIVATE_DATA(na_class)->unexpected_msg_queue_mutex);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct na_bmi_op_id *
+na_bmi_rma_op_get(na_class_t *na_class)
+{
+    struct na_bmi_op_id *na_bmi_op_id;
+
+    hg_thread_mutex_lock(&NA_BMI_PRIVATE_DATA(na_class)->rma_op_pool_mutex);
+
+    na_bmi_op_id = HG_QUEUE_FIRST(&NA_BMI_PRIVATE_DATA(na_class)->rma_op_pool);
+    HG_QUEUE_POP_HEAD(&NA_BMI_PRIVATE_DATA(na_class)->rma_op_pool, entry);
+
+    hg_thread_mutex_unlock(&NA_BMI_PRIVATE_DATA(na_class)->rma_op_pool_mutex);
+
+    if (na_bmi_op_id) {
+        /* Recycled op ID, reset its ref count */
+        hg_atomic_set32(&na_bmi_op_id->ref_count, 1);
+    } else {
+        na_bmi_op_id = (struct na_bmi_op_id *) na_bmi_op_create(na_class);
+        if (!na_bmi_op_id)
+            goto done;
+        na_bmi_op_id->pooled = NA_TRUE;
+    }
+
+done:
+    return na_bmi_op_id;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_bmi_msg_send_expected(na_class_t *na_class, na_context_t *context,
@@ -1637,24 +1793,18 @@ na_bmi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_bmi_op_id->info.put.completion_actual_size = 0;
     na_bmi_op_id->info.put.internal_progress = NA_FALSE;
     na_bmi_op_id->info.put.remote_addr = na_bmi_addr->bmi_addr;
-    na_bmi_op_id->info.put.rma_info = NULL;
     na_bmi_op_id->cancel = 0;
 
-    /* Allocate rma info (use calloc to avoid uninitialized transfer) */
-    na_bmi_rma_info =
-            (struct na_bmi_rma_info *) calloc(1, sizeof(struct na_bmi_rma_info));
-    if (!na_bmi_rma_info) {
-        NA_LOG_ERROR("Could not allocate NA BMI RMA info");
-        ret = NA_NOMEM_ERROR;
-        goto done;
-    }
+    /* RMA info is embedded in the op ID (zero it to avoid uninitialized
+     * transfer) */
+    na_bmi_rma_info = &na_bmi_op_id->info.put.rma_info;
+    memset(na_bmi_rma_info, 0, sizeof(struct na_bmi_rma_info));
     na_bmi_rma_info->op = NA_BMI_RMA_PUT;
     na_bmi_rma_info->base = bmi_remote_mem_handle->base;
     na_bmi_rma_info->disp = bmi_remote_offset;
     na_bmi_rma_info->count = bmi_length;
     na_bmi_rma_info->transfer_tag = na_bmi_gen_rma_tag(na_class);
     na_bmi_rma_info->completion_tag = na_bmi_gen_rma_tag(na_class);
-    na_bmi_op_id->info.put.rma_info = na_bmi_rma_info;
 
     /* Assign op_id */
     if (op_id && op_id != NA_OP_ID_IGNORE && *op_id == NA_OP_ID_NULL)
@@ -1713,7 +1863,6 @@ na_bmi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
 done:
     if (ret != NA_SUCCESS) {
         na_bmi_op_destroy(na_class, (na_op_id_t) na_bmi_op_id);
-        free(na_bmi_rma_info);
     }
     return ret;
 }
@@ -1776,24 +1925,18 @@ na_bmi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_bmi_op_id->info.get.transfer_actual_size = 0;
     na_bmi_op_id->info.get.internal_progress = NA_FALSE;
     na_bmi_op_id->info.get.remote_addr = na_bmi_addr->bmi_addr;
-    na_bmi_op_id->info.get.rma_info = NULL;
     na_bmi_op_id->cancel = 0;
 
-    /* Allocate rma info (use calloc to avoid uninitialized transfer) */
-    na_bmi_rma_info =
-            (struct na_bmi_rma_info *) calloc(1, sizeof(struct na_bmi_rma_info));
-    if (!na_bmi_rma_info) {
-        NA_LOG_ERROR("Could not allocate NA BMI RMA info");
-        ret = NA_NOMEM_ERROR;
-        goto done;
-    }
+    /* RMA info is embedded in the op ID (zero it to avoid uninitialized
+     * transfer) */
+    na_bmi_rma_info = &na_bmi_op_id->info.get.rma_info;
+    memset(na_bmi_rma_info, 0, sizeof(struct na_bmi_rma_info));
     na_bmi_rma_info->op = NA_BMI_RMA_GET;
     na_bmi_rma_info->base = bmi_remote_mem_handle->base;
     na_bmi_rma_info->disp = bmi_remote_offset;
     na_bmi_rma_info->count = bmi_length;
     na_bmi_rma_info->transfer_tag = na_bmi_gen_rma_tag(na_class);
     na_bmi_rma_info->completion_tag = 0; /* not used */
-    na_bmi_op_id->info.get.rma_info = na_bmi_rma_info;
 
     /* Assign op_id */
     if (op_id && op_id != NA_OP_ID_IGNORE && *op_id == NA_OP_ID_NULL)
@@ -1834,7 +1977,6 @@ na_bmi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
 done:
     if (ret != NA_SUCCESS) {
         na_bmi_op_destroy(na_class, (na_op_id_t) na_bmi_op_id);
-        free(na_bmi_rma_info);
     }
     return ret;
 }
@@ -1894,18 +2036,18 @@ na_bmi_progress_unexpected(na_class_t *na_class, na_context_t *context,
         unsigned int timeout)
 {
     int outcount = 0;
-    struct BMI_unexpected_info test_unexpected_info;
+    struct BMI_unexpected_info test_unexpected_info[NA_BMI_TEST_EVENT_NUM];
     struct na_bmi_unexpected_info *unexpected_info = NULL;
     struct na_bmi_op_id *na_bmi_op_id = NULL;
     na_return_t ret = NA_SUCCESS;
-    int bmi_ret;
+    int bmi_ret, i;
 
     /* Prevent multiple threads from calling BMI_testunexpected concurrently */
     hg_thread_mutex_lock(&NA_BMI_PRIVATE_DATA(na_class)->test_unexpected_mutex);
 
-    /* Test unexpected message */
-    bmi_ret = BMI_testunexpected(1, &outcount, &test_unexpected_info,
-            (int) timeout);
+    /* Test unexpected messages */
+    bmi_ret = BMI_testunexpected(NA_BMI_TEST_EVENT_NUM, &outcount,
+            test_unexpected_info, (int) timeout);
 
     hg_thread_mutex_unlock(
             &NA_BMI_PRIVATE_DATA(na_class)->test_unexpected_mutex);
@@ -1916,64 +2058,64 @@ na_bmi_progress_unexpected(na_class_t *na_class, na_context_t *context,
         goto done;
     }
 
-    if (outcount) {
-        if (test_unexpected_info.error_code != 0) {
+    if (!outcount) {
+        ret = NA_TIMEOUT; /* No progress */
+        goto done;
+    }
+
+    for (i = 0; i < outcount; i++) {
+        na_return_t progress_ret = NA_SUCCESS;
+
+        if (test_unexpected_info[i].error_code != 0) {
             NA_LOG_ERROR("BMI_testunexpected failed, error code set");
             ret = NA_PROTOCOL_ERROR;
-            goto done;
-        }
-        /* If no error and message arrived, keep a copy of the struct in
-         * the unexpected message queue */
-        unexpected_info = (struct na_bmi_unexpected_info *)
-                            malloc(sizeof(struct na_bmi_unexpected_info));
-        if (!unexpected_info) {
-            NA_LOG_ERROR("Could not allocate unexpected info");
-            ret = NA_NOMEM_ERROR;
-            goto done;
+            continue;
         }
 
-        memcpy(&unexpected_info->info, &test_unexpected_info,
-                sizeof(struct BMI_unexpected_info));
-
-        if (unexpected_info->info.tag == NA_BMI_RMA_REQUEST_TAG) {
+        if (test_unexpected_info[i].tag == NA_BMI_RMA_REQUEST_TAG) {
             /* Make RMA progress */
-            ret = na_bmi_progress_rma(na_class, context, &unexpected_info->info);
-            if (ret != NA_SUCCESS) {
+            progress_ret = na_bmi_progress_rma(na_class, context,
+                    &test_unexpected_info[i]);
+            if (progress_ret != NA_SUCCESS)
                 NA_LOG_ERROR("Could not make RMA progress");
-                goto done;
-            }
         } else {
             na_bmi_op_id = na_bmi_msg_unexpected_op_pop(na_class);
 
             if (na_bmi_op_id) {
                 /* If an op id was pushed, associate unexpected info to this
-                 * operation ID and complete operation */
+                 * operation ID and complete operation, the message is
+                 * consumed by the completion so no copy is kept */
                 na_bmi_op_id->info.recv_unexpected.unexpected_info =
-                        &unexpected_info->info;
-                ret = na_bmi_complete(na_bmi_op_id);
-                if (ret != NA_SUCCESS) {
+                        &test_unexpected_info[i];
+                progress_ret = na_bmi_complete(na_bmi_op_id);
+                if (progress_ret != NA_SUCCESS)
                     NA_LOG_ERROR("Could not complete operation");
-                    goto done;
-                }
             } else {
-                /* Otherwise push the unexpected message into our
-                 * unexpected queue so that we can treat it later when a
+                /* Otherwise keep a copy of the struct in the unexpected
+                 * message queue so that we can treat it later when a
                  * recv_unexpected is posted */
-                ret = na_bmi_msg_unexpected_push(na_class, unexpected_info);
-                if (ret != NA_SUCCESS) {
+                unexpected_info = na_bmi_unexpected_info_get(na_class);
+                if (!unexpected_info) {
+                    ret = NA_NOMEM_ERROR;
+                    continue;
+                }
+                memcpy(&unexpected_info->info, &test_unexpected_info[i],
+                        sizeof(struct BMI_unexpected_info));
+
+                progress_ret = na_bmi_msg_unexpected_push(na_class,
+                        unexpected_info);
+                if (progress_ret != NA_SUCCESS) {
                     NA_LOG_ERROR("Could not push unexpected info");
-                    goto done;
+                    na_bmi_unexpected_info_release(na_class, unexpected_info);
                 }
-                /* It's pushed now and we don't want to free it */
-                unexpected_info = NULL;
             }
         }
-    } else {
-        ret = NA_TIMEOUT; /* No progress */
+        /* Keep processing remaining events but report first error */
+        if (progress_ret != NA_SUCCESS && ret == NA_SUCCESS)
+            ret = progress_ret;
     }
 
 done:
-    free(unexpected_info);
     return ret;
 }
 
@@ -1982,125 +2124,155 @@ static na_return_t
 na_bmi_progress_expected(na_class_t NA_UNUSED *na_class, na_context_t *context,
         unsigned int timeout)
 {
-    bmi_op_id_t bmi_op_id = 0;
+    bmi_op_id_t bmi_op_ids[NA_BMI_TEST_EVENT_NUM];
     int outcount = 0;
-    bmi_error_code_t error_code = 0;
-    bmi_size_t  bmi_actual_size = 0;
-    struct na_bmi_op_id *na_bmi_op_id = NULL;
+    bmi_error_code_t error_codes[NA_BMI_TEST_EVENT_NUM];
+    bmi_size_t bmi_actual_sizes[NA_BMI_TEST_EVENT_NUM];
+    void *user_ptrs[NA_BMI_TEST_EVENT_NUM];
+    struct na_bmi_completion_batch completion_batch;
     bmi_context_id *bmi_context = (bmi_context_id *) context->plugin_context;
     na_return_t ret = NA_SUCCESS;
-    int bmi_ret = 0;
+    int bmi_ret = 0, i;
+
+    memset(error_codes, 0, sizeof(error_codes));
+    completion_batch.context = context;
+    completion_batch.count = 0;
 
     /* Return as soon as something completes or timeout is reached */
-    bmi_ret = BMI_testcontext(1, &bmi_op_id, &outcount, &error_code,
-            &bmi_actual_size, (void **) &na_bmi_op_id, (int) timeout,
+    bmi_ret = BMI_testcontext(NA_BMI_TEST_EVENT_NUM, bmi_op_ids, &outcount,
+            error_codes, bmi_actual_sizes, user_ptrs, (int) timeout,
             *bmi_context);
 
     /* TODO Sometimes bmi_ret is weird so check error_code as well */
-    if (bmi_ret < 0 && (error_code != 0)) {
+    if (bmi_ret < 0 && (!outcount || error_codes[0] != 0)) {
         NA_LOG_ERROR("BMI_testcontext failed");
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
 
-    if (outcount && na_bmi_op_id) {
-        if ((error_code != 0) &&
-            (error_code != -BMI_ECANCEL)) {
+    for (i = 0; i < outcount; i++) {
+        struct na_bmi_op_id *na_bmi_op_id =
+            (struct na_bmi_op_id *) user_ptrs[i];
+        na_return_t progress_ret;
+
+        if (!na_bmi_op_id)
+            continue;
+
+        if ((error_codes[i] != 0) &&
+            (error_codes[i] != -BMI_ECANCEL)) {
             NA_LOG_ERROR("BMI_testcontext failed, error code set");
             ret = NA_PROTOCOL_ERROR;
-            goto done;
+            continue;
         }
 
-        if (error_code == -BMI_ECANCEL) {
+        if (error_codes[i] == -BMI_ECANCEL) {
             na_bmi_op_id->cancel |= NA_BMI_CANCEL_C;
         }
 
-        switch (na_bmi_op_id->type) {
-            case NA_CB_LOOKUP:
-                NA_LOG_ERROR("Should not complete lookup here");
-                break;
-            case NA_CB_RECV_UNEXPECTED:
-                NA_LOG_ERROR("Should not complete unexpected recv here");
-                break;
-            case NA_CB_SEND_UNEXPECTED:
-                ret = na_bmi_complete(na_bmi_op_id);
-                break;
-            case NA_CB_RECV_EXPECTED:
-                /* Set the actual size */
-                na_bmi_op_id->info.recv_expected.actual_size = bmi_actual_size;
-                ret = na_bmi_complete(na_bmi_op_id);
-                break;
-            case NA_CB_SEND_EXPECTED:
-                ret = na_bmi_complete(na_bmi_op_id);
-                break;
-            case NA_CB_PUT:
-                if (!hg_atomic_get32(&na_bmi_op_id->info.put.transfer_completed)
-                    && na_bmi_op_id->info.put.transfer_op_id == bmi_op_id) {
-                    if (na_bmi_op_id->info.put.internal_progress) {
-                        hg_atomic_set32(&na_bmi_op_id->info.put.transfer_completed, NA_TRUE);
-                        /* Progress completion and send an ack after the put */
-                        ret = na_bmi_progress_rma_completion(na_bmi_op_id);
-                    } else {
-                        /* Nothing */
-                    }
-                }
-                else if (na_bmi_op_id->info.put.completion_op_id == bmi_op_id) {
-                    if (na_bmi_op_id->info.put.internal_progress) {
-                        hg_atomic_set32(&na_bmi_op_id->completed, 1);
-
-                        /* Transfer is now done so free RMA info */
-                        free(na_bmi_op_id->info.put.rma_info);
-                        na_bmi_op_id->info.put.rma_info = NULL;
-                        na_bmi_release(na_bmi_op_id);
-                    } else {
-                        /* Check ack completion flag */
-                        if (!na_bmi_op_id->info.put.completion_flag) {
-                            NA_LOG_ERROR("Error during transfer, ack received is %u",
-                                na_bmi_op_id->info.put.completion_flag);
-                            ret = NA_PROTOCOL_ERROR;
-                            goto done;
-                        }
-                        /* No internal progress but actual put */
-                        ret = na_bmi_complete(na_bmi_op_id);
-                    }
-                }
-                else if (na_bmi_op_id->info.put.request_op_id == bmi_op_id) {
-                    /* If request just completed, nothing to do, just ignore */
+        progress_ret = na_bmi_progress_expected_event(na_bmi_op_id,
+                bmi_op_ids[i], bmi_actual_sizes[i], &completion_batch);
+        /* Keep processing remaining events but report first error */
+        if (progress_ret != NA_SUCCESS && ret == NA_SUCCESS)
+            ret = progress_ret;
+    }
+
+    /* Hand all completions from this test call to NA at once */
+    if (completion_batch.count) {
+        if (na_cb_completion_add_batch(context, completion_batch.entries,
+            completion_batch.count) != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not add callbacks to completion queue");
+            ret = NA_PROTOCOL_ERROR;
+        }
+    } else if (ret == NA_SUCCESS && !outcount)
+        ret = NA_TIMEOUT; /* No progress */
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_bmi_progress_expected_event(struct na_bmi_op_id *na_bmi_op_id,
+        bmi_op_id_t bmi_op_id, bmi_size_t bmi_actual_size,
+        struct na_bmi_completion_batch *batch)
+{
+    na_return_t ret = NA_SUCCESS;
+
+    switch (na_bmi_op_id->type) {
+        case NA_CB_LOOKUP:
+            NA_LOG_ERROR("Should not complete lookup here");
+            break;
+        case NA_CB_RECV_UNEXPECTED:
+            NA_LOG_ERROR("Should not complete unexpected recv here");
+            break;
+        case NA_CB_SEND_UNEXPECTED:
+            ret = na_bmi_complete_batch(na_bmi_op_id, batch);
+            break;
+        case NA_CB_RECV_EXPECTED:
+            /* Set the actual size */
+            na_bmi_op_id->info.recv_expected.actual_size = bmi_actual_size;
+            ret = na_bmi_complete_batch(na_bmi_op_id, batch);
+            break;
+        case NA_CB_SEND_EXPECTED:
+            ret = na_bmi_complete_batch(na_bmi_op_id, batch);
+            break;
+        case NA_CB_PUT:
+            if (!hg_atomic_get32(&na_bmi_op_id->info.put.transfer_completed)
+                && na_bmi_op_id->info.put.transfer_op_id == bmi_op_id) {
+                if (na_bmi_op_id->info.put.internal_progress) {
+                    hg_atomic_set32(&na_bmi_op_id->info.put.transfer_completed, NA_TRUE);
+                    /* Progress completion and send an ack after the put */
+                    ret = na_bmi_progress_rma_completion(na_bmi_op_id);
                 } else {
-                    NA_LOG_ERROR("Unexpected operation ID");
-                    ret = NA_PROTOCOL_ERROR;
-                    goto done;
+                    /* Nothing */
                 }
-                break;
-            case NA_CB_GET:
-                if (na_bmi_op_id->info.get.transfer_op_id == bmi_op_id) {
-                    if (na_bmi_op_id->info.get.internal_progress) {
-                        hg_atomic_set32(&na_bmi_op_id->completed, 1);
-
-                        /* Transfer is now done so free RMA info */
-                        free(na_bmi_op_id->info.get.rma_info);
-                        na_bmi_op_id->info.get.rma_info = NULL;
-                        na_bmi_release(na_bmi_op_id);
-                    } else {
-                        /* No internal progress but actual get */
-                        ret = na_bmi_complete(na_bmi_op_id);
+            }
+            else if (na_bmi_op_id->info.put.completion_op_id == bmi_op_id) {
+                if (na_bmi_op_id->info.put.internal_progress) {
+                    hg_atomic_set32(&na_bmi_op_id->completed, 1);
+                    na_bmi_release(na_bmi_op_id);
+                } else {
+                    /* Check ack completion flag */
+                    if (!na_bmi_op_id->info.put.completion_flag) {
+                        NA_LOG_ERROR("Error during transfer, ack received is %u",
+                            na_bmi_op_id->info.put.completion_flag);
+                        ret = NA_PROTOCOL_ERROR;
+                        goto done;
                     }
+                    /* No internal progress but actual put */
+                    ret = na_bmi_complete_batch(na_bmi_op_id, batch);
                 }
-                else if (na_bmi_op_id->info.get.request_op_id == bmi_op_id) {
-                    /* If request just completed, nothing to do, just ignore */
+            }
+            else if (na_bmi_op_id->info.put.request_op_id == bmi_op_id) {
+                /* If request just completed, nothing to do, just ignore */
+            } else {
+                NA_LOG_ERROR("Unexpected operation ID");
+                ret = NA_PROTOCOL_ERROR;
+                goto done;
+            }
+            break;
+        case NA_CB_GET:
+            if (na_bmi_op_id->info.get.transfer_op_id == bmi_op_id) {
+                if (na_bmi_op_id->info.get.internal_progress) {
+                    hg_atomic_set32(&na_bmi_op_id->completed, 1);
+                    na_bmi_release(na_bmi_op_id);
                 } else {
-                    NA_LOG_ERROR("Unexpected operation ID");
-                    ret = NA_PROTOCOL_ERROR;
-                    goto done;
+                    /* No internal progress but actual get */
+                    ret = na_bmi_complete_batch(na_bmi_op_id, batch);
                 }
-                break;
-            default:
-                NA_LOG_ERROR("Unknown type of operation ID");
+            }
+            else if (na_bmi_op_id->info.get.request_op_id == bmi_op_id) {
+                /* If request just completed, nothing to do, just ignore */
+            } else {
+                NA_LOG_ERROR("Unexpected operation ID");
                 ret = NA_PROTOCOL_ERROR;
                 goto done;
-        }
-    } else {
-        ret = NA_TIMEOUT; /* No progress */
+            }
+            break;
+        default:
+            NA_LOG_ERROR("Unknown type of operation ID");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
     }
 
 done:
@@ -2109,9 +2281,10 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_bmi_progress_rma(na_class_t NA_UNUSED *na_class, na_context_t *context,
+na_bmi_progress_rma(na_class_t *na_class, na_context_t *context,
         struct BMI_unexpected_info *unexpected_info)
 {
+    struct na_bmi_rma_info rma_info;
     struct na_bmi_rma_info *na_bmi_rma_info = NULL;
     struct na_bmi_op_id *na_bmi_op_id = NULL;
     bmi_context_id *bmi_context = (bmi_context_id *) context->plugin_context;
@@ -2123,18 +2296,10 @@ na_bmi_progress_rma(na_class_t NA_UNUSED *na_class, na_context_t *context,
         ret = NA_SIZE_ERROR;
         goto done;
     }
-    /* Allocate rma info */
-    na_bmi_rma_info =
-            (struct na_bmi_rma_info *) malloc(sizeof(struct na_bmi_rma_info));
-    if (!na_bmi_rma_info) {
-        NA_LOG_ERROR("Could not allocate NA BMI RMA info");
-        ret = NA_NOMEM_ERROR;
-        goto done;
-    }
-    memcpy(na_bmi_rma_info, unexpected_info->buffer, (size_t) unexpected_info->size);
+    memcpy(&rma_info, unexpected_info->buffer, (size_t) unexpected_info->size);
 
-    /* Allocate na_op_id */
-    na_bmi_op_id = (struct na_bmi_op_id *) na_bmi_op_create(na_class);
+    /* Get na_op_id from pool, RMA info is kept in the op ID */
+    na_bmi_op_id = na_bmi_rma_op_get(na_class);
     if (!na_bmi_op_id) {
         NA_LOG_ERROR("Could not allocate NA BMI operation ID");
         ret = NA_NOMEM_ERROR;
@@ -2146,7 +2311,7 @@ na_bmi_progress_rma(na_class_t NA_UNUSED *na_class, na_context_t *context,
     na_bmi_op_id->arg = NULL;
     hg_atomic_set32(&na_bmi_op_id->completed, 0);
 
-    switch (na_bmi_rma_info->op) {
+    switch (rma_info.op) {
         /* Remote wants to do a put so wait in a recv */
         case NA_BMI_RMA_PUT:
             na_bmi_op_id->type = NA_CB_PUT;
@@ -2159,7 +2324,8 @@ na_bmi_progress_rma(na_class_t NA_UNUSED *na_class, na_context_t *context,
             na_bmi_op_id->info.put.completion_actual_size = 0;
             na_bmi_op_id->info.put.internal_progress = NA_TRUE;
             na_bmi_op_id->info.put.remote_addr = unexpected_info->addr;
-            na_bmi_op_id->info.put.rma_info = na_bmi_rma_info;
+            na_bmi_op_id->info.put.rma_info = rma_info;
+            na_bmi_rma_info = &na_bmi_op_id->info.put.rma_info;
             na_bmi_op_id->cancel = 0;
 
             /* Start receiving data */
@@ -2190,7 +2356,8 @@ na_bmi_progress_rma(na_class_t NA_UNUSED *na_class, na_context_t *context,
             na_bmi_op_id->info.get.transfer_actual_size = 0;
             na_bmi_op_id->info.get.internal_progress = NA_TRUE;
             na_bmi_op_id->info.get.remote_addr = unexpected_info->addr;
-            na_bmi_op_id->info.get.rma_info = na_bmi_rma_info;
+            na_bmi_op_id->info.get.rma_info = rma_info;
+            na_bmi_rma_info = &na_bmi_op_id->info.get.rma_info;
             na_bmi_op_id->cancel = 0;
 
             /* Start sending data */
@@ -2208,9 +2375,6 @@ na_bmi_progress_rma(na_class_t NA_UNUSED *na_class, na_context_t *context,
 
             if (bmi_ret) {
                 hg_atomic_set32(&na_bmi_op_id->completed, 1);
-
-                free(na_bmi_op_id->info.get.rma_info);
-                na_bmi_op_id->info.get.rma_info = NULL;
                 na_bmi_release(na_bmi_op_id);
             }
             break;
@@ -2223,9 +2387,8 @@ na_bmi_progress_rma(na_class_t NA_UNUSED *na_class, na_context_t *context,
     BMI_unexpected_free(unexpected_info->addr, unexpected_info->buffer);
 
 done:
-    if (ret != NA_SUCCESS) {
-        free(na_bmi_op_id);
-        free(na_bmi_rma_info);
+    if (ret != NA_SUCCESS && na_bmi_op_id) {
+        na_bmi_op_destroy(na_class, (na_op_id_t) na_bmi_op_id);
     }
     return ret;
 }
@@ -2248,7 +2411,7 @@ na_bmi_progress_rma_completion(struct na_bmi_op_id *na_bmi_op_id)
         goto done;
     }
 
-    na_bmi_rma_info = na_bmi_op_id->info.put.rma_info;
+    na_bmi_rma_info = &na_bmi_op_id->info.put.rma_info;
 
     /* Send an ack to tell the server that the data is here */
     bmi_ret = BMI_post_send(&na_bmi_op_id->info.put.completion_op_id,
@@ -2262,9 +2425,6 @@ na_bmi_progress_rma_completion(struct na_bmi_op_id *na_bmi_op_id)
     }
     if (bmi_ret) {
         hg_atomic_set32(&na_bmi_op_id->completed, 1);
-
-        free(na_bmi_op_id->info.put.rma_info);
-        na_bmi_op_id->info.put.rma_info = NULL;
         na_bmi_release(na_bmi_op_id);
     }
 
@@ -2275,6 +2435,14 @@ done:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_bmi_complete(struct na_bmi_op_id *na_bmi_op_id)
+{
+    return na_bmi_complete_batch(na_bmi_op_id, NULL);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_bmi_complete_batch(struct na_bmi_op_id *na_bmi_op_id,
+        struct na_bmi_completion_batch *batch)
 {
     struct na_cb_info *callback_info = NULL;
     na_return_t ret = NA_SUCCESS;
@@ -2359,14 +2527,7 @@ na_bmi_complete(struct na_bmi_op_id *na_bmi_op_id)
             }
             break;
         case NA_CB_PUT:
-            /* Transfer is now done so free RMA info */
-            free(na_bmi_op_id->info.put.rma_info);
-            na_bmi_op_id->info.put.rma_info = NULL;
-            break;
         case NA_CB_GET:
-            /* Transfer is now done so free RMA info */
-            free(na_bmi_op_id->info.get.rma_info);
-            na_bmi_op_id->info.get.rma_info = NULL;
             break;
         default:
             NA_LOG_ERROR("Operation not supported");
@@ -2378,6 +2539,13 @@ na_bmi_complete(struct na_bmi_op_id *na_bmi_op_id)
     na_bmi_op_id->completion_data.plugin_callback = na_bmi_release;
     na_bmi_op_id->completion_data.plugin_callback_args = na_bmi_op_id;
 
+    /* Defer to batch if completion goes to the same completion queue */
+    if (batch && batch->context == na_bmi_op_id->context
+        && batch->count < NA_BMI_TEST_EVENT_NUM) {
+        batch->entries[batch->count++] = &na_bmi_op_id->completion_data;
+        goto done;
+    }
+
     ret = na_cb_completion_add(na_bmi_op_id->context,
         &na_bmi_op_id->completion_data);
     if (ret != NA_SUCCESS) {
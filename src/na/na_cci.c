@@ -373,6 +373,7 @@ const na_class_t na_cci_class_g = {
     NULL,                                   /* cleanup */
     NULL,                                   /* context_create */
     NULL,                                   /* context_destroy */
+    NULL,                                   /* context_get_stats */
     na_cci_op_create,                       /* op_create */
     na_cci_op_destroy,                      /* op_destroy */
     na_cci_addr_lookup,                     /* addr_lookup */
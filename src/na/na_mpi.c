@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 #ifdef NA_MPI_HAS_GNI_SETUP
 #include <gni_pub.h>
 #endif
@@ -48,6 +49,25 @@ static int MPI_MAX_TAG = 32767;
 #define NA_MPI_RMA_TAG (NA_MPI_RMA_REQUEST_TAG + 1)
 #define NA_MPI_MAX_RMA_TAG (MPI_MAX_TAG >> 1)
 
+/* Outstanding requests */
+#define NA_MPI_REQUEST_INIT_MAX 64   /* Initial size of request array */
+#define NA_MPI_OP_MAX_REQUESTS  2    /* Max requests posted per op ID */
+#define NA_MPI_OP_DATA_REQUEST  0    /* Index of data request */
+#define NA_MPI_OP_RMA_REQUEST   1    /* Index of RMA emulation request */
+
+/* Use MPI-3 dynamic windows for one-sided operations */
+#if defined(NA_MPI_HAS_RMA) && (MPI_VERSION >= 3)
+#  define NA_MPI_USE_RMA_WIN
+#endif
+
+/* Max number of memory regions attached to dynamic windows, implementations
+ * limit attachments (e.g., osc_rdma_max_attach), further memory is emulated */
+#define NA_MPI_RMA_MAX_ATTACH   32
+
+/* Size of the serialized part of the memory handle */
+#define NA_MPI_MEM_HANDLE_SIZE \
+    (offsetof(struct na_mpi_mem_handle, attached) + sizeof(na_uint8_t))
+
 #define NA_MPI_PRIVATE_DATA(na_class) \
     ((struct na_mpi_private_data *)(na_class->private_data))
 
@@ -70,6 +90,11 @@ struct na_mpi_addr {
     na_bool_t self;              /* Boolean for self */
     na_bool_t dynamic;           /* Address generated using MPI DPM routines */
     char      port_name[MPI_MAX_PORT_NAME]; /* String version of addr */
+#ifdef NA_MPI_USE_RMA_WIN
+    MPI_Comm  win_comm;          /* Merged comm used for one sided window */
+    MPI_Win   win;               /* Dynamic window (MPI_WIN_NULL if none) */
+    int       win_rank_offset;   /* Offset of remote ranks in win_comm */
+#endif
     HG_LIST_ENTRY(na_mpi_addr) entry;
 };
 
@@ -77,7 +102,14 @@ struct na_mpi_addr {
 struct na_mpi_mem_handle {
     na_ptr_t base;     /* Initial address of memory */
     MPI_Aint size;    /* Size of memory */
+    MPI_Aint disp;    /* Window displacement of base (0 if not attached) */
     na_uint8_t attr;   /* Flag of operation access */
+    na_uint8_t attached; /* Memory is attached to dynamic windows */
+    /* Fields below are not serialized */
+#ifdef NA_MPI_USE_RMA_WIN
+    na_bool_t registered; /* Memory handle is in registered list */
+    HG_LIST_ENTRY(na_mpi_mem_handle) entry;
+#endif
 };
 
 /* na_mpi_rma_op */
@@ -100,11 +132,6 @@ struct na_mpi_info_lookup {
     na_addr_t addr;
 };
 
-/* na_mpi_info_send_unexpected */
-struct na_mpi_info_send_unexpected {
-    MPI_Request data_request;
-};
-
 /* na_mpi_info_recv_unexpected */
 struct na_mpi_info_recv_unexpected {
     void *buf;
@@ -113,14 +140,8 @@ struct na_mpi_info_recv_unexpected {
     MPI_Status status;
 };
 
-/* na_mpi_info_send_expected */
-struct na_mpi_info_send_expected {
-    MPI_Request data_request;
-};
-
 /* na_mpi_info_recv_expected */
 struct na_mpi_info_recv_expected {
-    MPI_Request data_request;
     int buf_size;
     int actual_size;
     MPI_Status status;
@@ -128,18 +149,23 @@ struct na_mpi_info_recv_expected {
 
 /* na_mpi_info_put */
 struct na_mpi_info_put {
-    MPI_Request rma_request;
-    MPI_Request data_request;
     struct na_mpi_rma_info *rma_info;
     na_bool_t internal_progress; /* Used for internal RMA emulation */
+#ifdef NA_MPI_USE_RMA_WIN
+    MPI_Win win;                 /* Window used for one-sided operation */
+    int win_rank;                /* Target rank in window */
+    char flush_byte;             /* Result of remote completion read */
+#endif
 };
 
 /* na_mpi_info_get */
 struct na_mpi_info_get {
-    MPI_Request rma_request;
-    MPI_Request data_request;
     struct na_mpi_rma_info *rma_info;
     na_bool_t internal_progress; /* Used for internal RMA emulation */
+#ifdef NA_MPI_USE_RMA_WIN
+    MPI_Win win;                 /* Window used for one-sided operation */
+    int win_rank;                /* Target rank in window */
+#endif
 };
 
 struct na_mpi_op_id {
@@ -149,11 +175,11 @@ struct na_mpi_op_id {
     void *arg;
     na_bool_t completed; /* Operation completed */
     na_bool_t canceled;  /* Operation canceled */
+    int request_slots[NA_MPI_OP_MAX_REQUESTS]; /* Slots in request array */
+    int request_count;   /* Number of outstanding requests */
     union {
       struct na_mpi_info_lookup lookup;
-      struct na_mpi_info_send_unexpected send_unexpected;
       struct na_mpi_info_recv_unexpected recv_unexpected;
-      struct na_mpi_info_send_expected send_expected;
       struct na_mpi_info_recv_expected recv_expected;
       struct na_mpi_info_put put;
       struct na_mpi_info_get get;
@@ -162,6 +188,12 @@ struct na_mpi_op_id {
     struct na_cb_completion_data completion_data;
 };
 
+/* na_mpi_request_entry */
+struct na_mpi_request_entry {
+    struct na_mpi_op_id *op_id; /* Op ID that posted the request */
+    int index;                  /* Index of request in op ID slots */
+};
+
 struct na_mpi_private_data {
     na_bool_t listening;                    /* Used in server mode */
     na_bool_t mpi_ext_initialized;          /* MPI externally initialized */
@@ -183,8 +215,21 @@ struct na_mpi_private_data {
 
     hg_atomic_int32_t  rma_tag;              /* Atomic RMA tag value */
 
-    HG_LIST_HEAD(na_mpi_op_id) op_id_list;  /* List of na_mpi_op_ids */
-    hg_thread_mutex_t  op_id_list_mutex;    /* Mutex */
+    /* Outstanding requests are kept contiguous so that they can be tested
+     * with a single MPI_Testsome() call, entries are parallel to requests */
+    MPI_Request *requests;                   /* Outstanding requests */
+    struct na_mpi_request_entry *request_entries; /* Owners of requests */
+    int *request_indices;                    /* Indices of completed requests */
+    MPI_Status *request_statuses;            /* Status of completed requests */
+    int request_count;                       /* Number of requests */
+    int request_max;                         /* Size of request arrays */
+    hg_thread_mutex_t  request_mutex;        /* Mutex */
+
+#ifdef NA_MPI_USE_RMA_WIN
+    HG_LIST_HEAD(na_mpi_mem_handle) mem_handle_list; /* Registered memory */
+    hg_thread_mutex_t  mem_handle_list_mutex;        /* Mutex */
+    int attach_count;                        /* Number of attached regions */
+#endif
 };
 
 /********************/
@@ -229,6 +274,39 @@ na_mpi_remote_list_disconnect(
         na_class_t *na_class
         );
 
+/* remote_list_add */
+static na_return_t
+na_mpi_remote_list_add(
+        na_class_t         *na_class,
+        struct na_mpi_addr *na_mpi_addr
+        );
+
+#ifdef NA_MPI_USE_RMA_WIN
+/* rma_win_create */
+static na_return_t
+na_mpi_rma_win_create(
+        struct na_mpi_addr *na_mpi_addr,
+        na_bool_t           high
+        );
+
+/* rma_win_destroy */
+static na_return_t
+na_mpi_rma_win_destroy(
+        struct na_mpi_addr *na_mpi_addr
+        );
+
+/* rma_win_post */
+static na_return_t
+na_mpi_rma_win_post(
+        na_class_t          *na_class,
+        struct na_mpi_op_id *na_mpi_op_id,
+        void                *local_buf,
+        int                  length,
+        struct na_mpi_addr  *na_mpi_addr,
+        MPI_Aint             remote_disp
+        );
+#endif
+
 /* msg_unexpected_op_push */
 static na_return_t
 na_mpi_msg_unexpected_op_push(
@@ -242,6 +320,29 @@ na_mpi_msg_unexpected_op_pop(
         na_class_t *na_class
         );
 
+/* request_add */
+static na_return_t
+na_mpi_request_add(
+        na_class_t          *na_class,
+        struct na_mpi_op_id *na_mpi_op_id,
+        const MPI_Request   *requests,
+        int                  count
+        );
+
+/* request_remove */
+static NA_INLINE void
+na_mpi_request_remove(
+        na_class_t *na_class,
+        int         slot
+        );
+
+/* request_cancel */
+static int
+na_mpi_request_cancel(
+        na_class_t          *na_class,
+        struct na_mpi_op_id *na_mpi_op_id
+        );
+
 /* gen_rma_tag */
 static NA_INLINE na_tag_t
 na_mpi_gen_rma_tag(
@@ -546,6 +647,7 @@ const na_class_t na_mpi_class_g = {
         NULL,                                 /* cleanup */
         NULL,                                 /* context_create */
         NULL,                                 /* context_destroy */
+        NULL,                                 /* context_get_stats */
         NULL,                                 /* op_create */
         NULL,                                 /* op_destroy */
         na_mpi_addr_lookup,                   /* addr_lookup */
@@ -754,11 +856,21 @@ na_mpi_accept(na_class_t *na_class)
             (!NA_MPI_PRIVATE_DATA(na_class)->use_static_inter_comm);
     memset(na_mpi_addr->port_name, '\0', MPI_MAX_PORT_NAME);
 
+#ifdef NA_MPI_USE_RMA_WIN
+    /* Accepting side is low group of merged comm */
+    ret = na_mpi_rma_win_create(na_mpi_addr, NA_FALSE);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not create RMA window");
+        goto done;
+    }
+#endif
+
     /* Add comms to list of connected remotes */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->remote_list,
-        na_mpi_addr, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+    ret = na_mpi_remote_list_add(na_class, na_mpi_addr);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add remote to list");
+        goto done;
+    }
 
 done:
     return ret;
@@ -772,6 +884,13 @@ na_mpi_disconnect(na_class_t NA_UNUSED *na_class,
     na_return_t ret = NA_SUCCESS;
 
     if (na_mpi_addr && !na_mpi_addr->unexpected) {
+#ifdef NA_MPI_USE_RMA_WIN
+        ret = na_mpi_rma_win_destroy(na_mpi_addr);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not destroy RMA window");
+            goto done;
+        }
+#endif
         MPI_Comm_free(&na_mpi_addr->rma_comm);
 
         if (na_mpi_addr->dynamic) {
@@ -818,6 +937,236 @@ na_mpi_remote_list_disconnect(na_class_t *na_class)
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_remote_list_add(na_class_t *na_class, struct na_mpi_addr *na_mpi_addr)
+{
+    na_return_t ret = NA_SUCCESS;
+
+#ifdef NA_MPI_USE_RMA_WIN
+    /* Keep the registered list locked until the remote is visible so that
+     * memory registered concurrently is attached to the new window */
+    hg_thread_mutex_lock(
+            &NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list_mutex);
+
+    if (na_mpi_addr->win != MPI_WIN_NULL) {
+        struct na_mpi_mem_handle *na_mpi_mem_handle, *var;
+
+        HG_LIST_FOREACH(na_mpi_mem_handle,
+            &NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list, entry) {
+            int mpi_ret;
+
+            if (!na_mpi_mem_handle->attached)
+                continue;
+
+            mpi_ret = MPI_Win_attach(na_mpi_addr->win,
+                    (void *) na_mpi_mem_handle->base, na_mpi_mem_handle->size);
+            if (mpi_ret != MPI_SUCCESS) {
+                NA_LOG_ERROR("MPI_Win_attach() failed");
+                ret = NA_PROTOCOL_ERROR;
+                break;
+            }
+        }
+
+        /* Release attach slots taken before the failure */
+        if (ret != NA_SUCCESS) {
+            HG_LIST_FOREACH(var,
+                &NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list, entry) {
+                if (var == na_mpi_mem_handle)
+                    break;
+                if (var->attached)
+                    MPI_Win_detach(na_mpi_addr->win, (void *) var->base);
+            }
+            goto done;
+        }
+    }
+#endif
+
+    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->remote_list,
+        na_mpi_addr, entry);
+    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+
+#ifdef NA_MPI_USE_RMA_WIN
+done:
+    hg_thread_mutex_unlock(
+            &NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list_mutex);
+#endif
+    return ret;
+}
+
+#ifdef NA_MPI_USE_RMA_WIN
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_rma_win_create(struct na_mpi_addr *na_mpi_addr, na_bool_t high)
+{
+    int is_inter = 0;
+    na_return_t ret = NA_SUCCESS;
+    int mpi_ret;
+
+    na_mpi_addr->win_comm = MPI_COMM_NULL;
+    na_mpi_addr->win = MPI_WIN_NULL;
+    na_mpi_addr->win_rank_offset = 0;
+
+    /* Windows can only be created from an intra-communicator, remotes that
+     * are not reached through an inter-communicator keep using emulation */
+    mpi_ret = MPI_Comm_test_inter(na_mpi_addr->comm, &is_inter);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Comm_test_inter() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+    if (!is_inter)
+        goto done;
+
+    /* Merge both groups, remote ranks are shifted by the size of the local
+     * group when the local group is ordered first */
+    mpi_ret = MPI_Intercomm_merge(na_mpi_addr->comm, (int) high,
+            &na_mpi_addr->win_comm);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Intercomm_merge() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+    if (!high)
+        MPI_Comm_size(na_mpi_addr->comm, &na_mpi_addr->win_rank_offset);
+
+    mpi_ret = MPI_Win_create_dynamic(MPI_INFO_NULL, na_mpi_addr->win_comm,
+            &na_mpi_addr->win);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Win_create_dynamic() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    /* Errors on the window (e.g., running out of attach slots) must be
+     * returned so that memory can fall back to emulation */
+    mpi_ret = MPI_Win_set_errhandler(na_mpi_addr->win, MPI_ERRORS_RETURN);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Win_set_errhandler() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    /* Open a passive target epoch for the lifetime of the window */
+    mpi_ret = MPI_Win_lock_all(MPI_MODE_NOCHECK, na_mpi_addr->win);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Win_lock_all() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+done:
+    if (ret != NA_SUCCESS) {
+        if (na_mpi_addr->win != MPI_WIN_NULL)
+            MPI_Win_free(&na_mpi_addr->win);
+        if (na_mpi_addr->win_comm != MPI_COMM_NULL)
+            MPI_Comm_free(&na_mpi_addr->win_comm);
+    }
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_rma_win_destroy(struct na_mpi_addr *na_mpi_addr)
+{
+    na_return_t ret = NA_SUCCESS;
+    int mpi_ret;
+
+    if (na_mpi_addr->win == MPI_WIN_NULL)
+        goto done;
+
+    mpi_ret = MPI_Win_unlock_all(na_mpi_addr->win);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Win_unlock_all() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    /* Attached memory does not need to be detached before freeing */
+    mpi_ret = MPI_Win_free(&na_mpi_addr->win);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Win_free() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    MPI_Comm_free(&na_mpi_addr->win_comm);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_rma_win_post(na_class_t *na_class, struct na_mpi_op_id *na_mpi_op_id,
+        void *local_buf, int length, struct na_mpi_addr *na_mpi_addr,
+        MPI_Aint remote_disp)
+{
+    int win_rank = na_mpi_addr->rank + na_mpi_addr->win_rank_offset;
+    MPI_Request data_requests[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+    int request_count = 1;
+    na_return_t ret = NA_SUCCESS;
+    int mpi_ret;
+
+    /* Dynamic windows are addressed with target displacements and completion
+     * is request based so that neither side blocks on the transfer */
+    switch (na_mpi_op_id->type) {
+        case NA_CB_PUT:
+            na_mpi_op_id->info.put.win = na_mpi_addr->win;
+            na_mpi_op_id->info.put.win_rank = win_rank;
+            /* Request completion of a put is only local. Accumulates to the
+             * same location are ordered, so the put is issued as a replace
+             * accumulate followed by a read of its last byte, which completes
+             * once the data has reached the target */
+            mpi_ret = MPI_Raccumulate(local_buf, length, MPI_BYTE, win_rank,
+                    remote_disp, length, MPI_BYTE, MPI_REPLACE,
+                    na_mpi_addr->win, &data_requests[0]);
+            if (mpi_ret != MPI_SUCCESS) {
+                NA_LOG_ERROR("MPI_Raccumulate() failed");
+                ret = NA_PROTOCOL_ERROR;
+                goto done;
+            }
+            if (length > 0) {
+                mpi_ret = MPI_Rget_accumulate(NULL, 0, MPI_BYTE,
+                        &na_mpi_op_id->info.put.flush_byte, 1, MPI_BYTE,
+                        win_rank, remote_disp + length - 1, 1, MPI_BYTE,
+                        MPI_NO_OP, na_mpi_addr->win, &data_requests[1]);
+                if (mpi_ret != MPI_SUCCESS) {
+                    NA_LOG_ERROR("MPI_Rget_accumulate() failed");
+                    ret = NA_PROTOCOL_ERROR;
+                    goto done;
+                }
+                request_count++;
+            }
+            break;
+        case NA_CB_GET:
+            na_mpi_op_id->info.get.win = na_mpi_addr->win;
+            na_mpi_op_id->info.get.win_rank = win_rank;
+            mpi_ret = MPI_Rget(local_buf, length, MPI_BYTE, win_rank,
+                    remote_disp, length, MPI_BYTE, na_mpi_addr->win,
+                    &data_requests[0]);
+            if (mpi_ret != MPI_SUCCESS) {
+                NA_LOG_ERROR("MPI_Rget() failed");
+                ret = NA_PROTOCOL_ERROR;
+                goto done;
+            }
+            break;
+        default:
+            NA_LOG_ERROR("Operation not supported");
+            ret = NA_INVALID_PARAM;
+            goto done;
+    }
+
+    /* Track requests */
+    ret = na_mpi_request_add(na_class, na_mpi_op_id, data_requests,
+        request_count);
+
+done:
+    return ret;
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_mpi_msg_unexpected_op_push(na_class_t *na_class,
@@ -875,6 +1224,130 @@ na_mpi_gen_rma_tag(na_class_t *na_class)
     return tag;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_request_add(na_class_t *na_class, struct na_mpi_op_id *na_mpi_op_id,
+        const MPI_Request *requests, int count)
+{
+    struct na_mpi_private_data *priv = NA_MPI_PRIVATE_DATA(na_class);
+    na_return_t ret = NA_SUCCESS;
+    int i;
+
+    hg_thread_mutex_lock(&priv->request_mutex);
+
+    /* Grow request arrays if needed */
+    if (priv->request_count + count > priv->request_max) {
+        int new_max = (priv->request_max) ? priv->request_max * 2
+            : NA_MPI_REQUEST_INIT_MAX;
+        MPI_Request *new_requests;
+        struct na_mpi_request_entry *new_entries;
+        int *new_indices;
+        MPI_Status *new_statuses;
+
+        new_requests = (MPI_Request *) realloc(priv->requests,
+            (size_t) new_max * sizeof(MPI_Request));
+        if (!new_requests) {
+            NA_LOG_ERROR("Could not grow request array");
+            ret = NA_NOMEM_ERROR;
+            goto done;
+        }
+        priv->requests = new_requests;
+
+        new_entries = (struct na_mpi_request_entry *) realloc(
+            priv->request_entries,
+            (size_t) new_max * sizeof(struct na_mpi_request_entry));
+        if (!new_entries) {
+            NA_LOG_ERROR("Could not grow request entry array");
+            ret = NA_NOMEM_ERROR;
+            goto done;
+        }
+        priv->request_entries = new_entries;
+
+        new_indices = (int *) realloc(priv->request_indices,
+            (size_t) new_max * sizeof(int));
+        if (!new_indices) {
+            NA_LOG_ERROR("Could not grow request index array");
+            ret = NA_NOMEM_ERROR;
+            goto done;
+        }
+        priv->request_indices = new_indices;
+
+        new_statuses = (MPI_Status *) realloc(priv->request_statuses,
+            (size_t) new_max * sizeof(MPI_Status));
+        if (!new_statuses) {
+            NA_LOG_ERROR("Could not grow request status array");
+            ret = NA_NOMEM_ERROR;
+            goto done;
+        }
+        priv->request_statuses = new_statuses;
+
+        priv->request_max = new_max;
+    }
+
+    /* All requests of the op ID are added at once so that the op ID cannot
+     * be completed before the last one is tracked */
+    for (i = 0; i < NA_MPI_OP_MAX_REQUESTS; i++)
+        na_mpi_op_id->request_slots[i] = -1;
+    na_mpi_op_id->request_count = 0;
+    for (i = 0; i < count; i++) {
+        int slot = priv->request_count++;
+
+        priv->requests[slot] = requests[i];
+        priv->request_entries[slot].op_id = na_mpi_op_id;
+        priv->request_entries[slot].index = i;
+        na_mpi_op_id->request_slots[i] = slot;
+        na_mpi_op_id->request_count++;
+    }
+
+done:
+    hg_thread_mutex_unlock(&priv->request_mutex);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_mpi_request_remove(na_class_t *na_class, int slot)
+{
+    struct na_mpi_private_data *priv = NA_MPI_PRIVATE_DATA(na_class);
+    int last = --priv->request_count;
+
+    /* Fill the hole with the last request */
+    if (slot != last) {
+        struct na_mpi_request_entry *entry = &priv->request_entries[last];
+
+        priv->requests[slot] = priv->requests[last];
+        priv->request_entries[slot] = *entry;
+        entry->op_id->request_slots[entry->index] = slot;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+na_mpi_request_cancel(na_class_t *na_class, struct na_mpi_op_id *na_mpi_op_id)
+{
+    struct na_mpi_private_data *priv = NA_MPI_PRIVATE_DATA(na_class);
+    int slot, mpi_ret = MPI_SUCCESS;
+
+    /* Requests may be moved by progress so look up slot under lock */
+    hg_thread_mutex_lock(&priv->request_mutex);
+    slot = na_mpi_op_id->request_slots[NA_MPI_OP_DATA_REQUEST];
+    if (slot >= 0)
+        mpi_ret = MPI_Cancel(&priv->requests[slot]);
+    hg_thread_mutex_unlock(&priv->request_mutex);
+
+    return mpi_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+na_mpi_request_index_cmp(const void *a, const void *b)
+{
+    int ia = *(const int *) a, ib = *(const int *) b;
+
+    /* Descending order */
+    return (ia < ib) - (ia > ib);
+}
+
 /*---------------------------------------------------------------------------*/
 na_return_t
 NA_MPI_Set_init_intra_comm(MPI_Comm intra_comm)
@@ -1016,8 +1489,17 @@ na_mpi_initialize(na_class_t *na_class, const struct na_info *na_info,
     }
     NA_MPI_PRIVATE_DATA(na_class)->accept_thread = 0;
     HG_LIST_INIT(&NA_MPI_PRIVATE_DATA(na_class)->remote_list);
-    HG_LIST_INIT(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list);
+    NA_MPI_PRIVATE_DATA(na_class)->requests = NULL;
+    NA_MPI_PRIVATE_DATA(na_class)->request_entries = NULL;
+    NA_MPI_PRIVATE_DATA(na_class)->request_indices = NULL;
+    NA_MPI_PRIVATE_DATA(na_class)->request_statuses = NULL;
+    NA_MPI_PRIVATE_DATA(na_class)->request_count = 0;
+    NA_MPI_PRIVATE_DATA(na_class)->request_max = 0;
     HG_QUEUE_INIT(&NA_MPI_PRIVATE_DATA(na_class)->unexpected_op_queue);
+#ifdef NA_MPI_USE_RMA_WIN
+    HG_LIST_INIT(&NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list);
+    NA_MPI_PRIVATE_DATA(na_class)->attach_count = 0;
+#endif
 
     /* Check flags */
     if (strcmp(na_info->protocol_name, "static") == 0)
@@ -1109,9 +1591,13 @@ na_mpi_initialize(na_class_t *na_class, const struct na_info *na_info,
     hg_thread_mutex_init(&NA_MPI_PRIVATE_DATA(na_class)->accept_mutex);
     hg_thread_cond_init(&NA_MPI_PRIVATE_DATA(na_class)->accept_cond);
     hg_thread_mutex_init(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
-    hg_thread_mutex_init(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    hg_thread_mutex_init(&NA_MPI_PRIVATE_DATA(na_class)->request_mutex);
     hg_thread_mutex_init(
             &NA_MPI_PRIVATE_DATA(na_class)->unexpected_op_queue_mutex);
+#ifdef NA_MPI_USE_RMA_WIN
+    hg_thread_mutex_init(
+            &NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list_mutex);
+#endif
 
     /* Initialize atomic op */
     hg_atomic_set32(&NA_MPI_PRIVATE_DATA(na_class)->rma_tag, NA_MPI_RMA_TAG);
@@ -1214,10 +1700,18 @@ na_mpi_finalize(na_class_t *na_class)
     hg_thread_mutex_destroy(&NA_MPI_PRIVATE_DATA(na_class)->accept_mutex);
     hg_thread_cond_destroy(&NA_MPI_PRIVATE_DATA(na_class)->accept_cond);
     hg_thread_mutex_destroy(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
-    hg_thread_mutex_destroy(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    hg_thread_mutex_destroy(&NA_MPI_PRIVATE_DATA(na_class)->request_mutex);
     hg_thread_mutex_destroy(
             &NA_MPI_PRIVATE_DATA(na_class)->unexpected_op_queue_mutex);
+#ifdef NA_MPI_USE_RMA_WIN
+    hg_thread_mutex_destroy(
+            &NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list_mutex);
+#endif
 
+    free(NA_MPI_PRIVATE_DATA(na_class)->requests);
+    free(NA_MPI_PRIVATE_DATA(na_class)->request_entries);
+    free(NA_MPI_PRIVATE_DATA(na_class)->request_indices);
+    free(NA_MPI_PRIVATE_DATA(na_class)->request_statuses);
     free(na_class->private_data);
 
  done:
@@ -1261,6 +1755,11 @@ na_mpi_addr_lookup(na_class_t *na_class, na_context_t *context,
     na_mpi_addr->unexpected = NA_FALSE;
     na_mpi_addr->self = NA_FALSE;
     na_mpi_addr->dynamic = NA_FALSE;
+#ifdef NA_MPI_USE_RMA_WIN
+    na_mpi_addr->win_comm = MPI_COMM_NULL;
+    na_mpi_addr->win = MPI_WIN_NULL;
+    na_mpi_addr->win_rank_offset = 0;
+#endif
     na_mpi_op_id->info.lookup.addr = (na_addr_t) na_mpi_addr;
     memset(na_mpi_addr->port_name, '\0', MPI_MAX_PORT_NAME);
     /* get port_name and remote server rank */
@@ -1318,13 +1817,23 @@ na_mpi_addr_lookup(na_class_t *na_class, na_context_t *context,
         goto done;
     }
 
+#ifdef NA_MPI_USE_RMA_WIN
+    /* Connecting side is high group of merged comm */
+    ret = na_mpi_rma_win_create(na_mpi_addr, NA_TRUE);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not create RMA window");
+        goto done;
+    }
+#endif
+
     hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->accept_mutex);
 
     /* Add addr to list of addresses */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->remote_list,
-        na_mpi_addr, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+    ret = na_mpi_remote_list_add(na_class, na_mpi_addr);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add remote to list");
+        goto done;
+    }
 
     /* TODO MPI calls are blocking and so is na_mpi_addr_lookup,
      * i.e. we always complete here for now */
@@ -1363,6 +1872,11 @@ na_mpi_addr_self(na_class_t *na_class, na_addr_t *addr)
     na_mpi_addr->unexpected = NA_FALSE;
     na_mpi_addr->self = NA_TRUE;
     na_mpi_addr->dynamic = NA_FALSE;
+#ifdef NA_MPI_USE_RMA_WIN
+    na_mpi_addr->win_comm = MPI_COMM_NULL;
+    na_mpi_addr->win = MPI_WIN_NULL;
+    na_mpi_addr->win_rank_offset = 0;
+#endif
     memset(na_mpi_addr->port_name, '\0', MPI_MAX_PORT_NAME);
     if (!NA_MPI_PRIVATE_DATA(na_class)->use_static_inter_comm
             && NA_MPI_PRIVATE_DATA(na_class)->listening)
@@ -1493,6 +2007,7 @@ na_mpi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     int mpi_tag = (int) tag;
     struct na_mpi_addr *mpi_addr = (struct na_mpi_addr *) dest;
     struct na_mpi_op_id *na_mpi_op_id = NULL;
+    MPI_Request data_request = MPI_REQUEST_NULL;
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
 
@@ -1509,25 +2024,24 @@ na_mpi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_mpi_op_id->arg = arg;
     na_mpi_op_id->completed = NA_FALSE;
     na_mpi_op_id->canceled = NA_FALSE;
-    na_mpi_op_id->info.send_unexpected.data_request = MPI_REQUEST_NULL;
 
     /* Assign op_id */
     if (op_id && op_id != NA_OP_ID_IGNORE) *op_id = (na_op_id_t) na_mpi_op_id;
 
     mpi_ret = MPI_Isend(buf, mpi_buf_size, MPI_BYTE, mpi_addr->rank,
-            mpi_tag, mpi_addr->comm,
-            &na_mpi_op_id->info.send_unexpected.data_request);
+            mpi_tag, mpi_addr->comm, &data_request);
     if (mpi_ret != MPI_SUCCESS) {
         NA_LOG_ERROR("MPI_Isend() failed");
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
 
-    /* Append op_id to op_id list */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list,
-        na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    /* Track request */
+    ret = na_mpi_request_add(na_class, na_mpi_op_id, &data_request, 1);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not track MPI request");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -1603,6 +2117,7 @@ na_mpi_msg_send_expected(na_class_t *na_class, na_context_t *context,
     int mpi_tag = (int) tag;
     struct na_mpi_addr *mpi_addr = (struct na_mpi_addr *) dest;
     struct na_mpi_op_id *na_mpi_op_id = NULL;
+    MPI_Request data_request = MPI_REQUEST_NULL;
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
 
@@ -1619,25 +2134,24 @@ na_mpi_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_mpi_op_id->arg = arg;
     na_mpi_op_id->completed = NA_FALSE;
     na_mpi_op_id->canceled = NA_FALSE;
-    na_mpi_op_id->info.send_expected.data_request = MPI_REQUEST_NULL;
 
     /* Assign op_id */
     if (op_id && op_id != NA_OP_ID_IGNORE) *op_id = (na_op_id_t) na_mpi_op_id;
 
     mpi_ret = MPI_Isend(buf, mpi_buf_size, MPI_BYTE, mpi_addr->rank,
-            mpi_tag, mpi_addr->comm,
-            &na_mpi_op_id->info.send_expected.data_request);
+            mpi_tag, mpi_addr->comm, &data_request);
     if (mpi_ret != MPI_SUCCESS) {
         NA_LOG_ERROR("MPI_Isend() failed");
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
 
-    /* Append op_id to op_id list assign op_id */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list,
-        na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    /* Track request */
+    ret = na_mpi_request_add(na_class, na_mpi_op_id, &data_request, 1);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not track MPI request");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -1657,6 +2171,7 @@ na_mpi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     int mpi_tag = (int) tag;
     struct na_mpi_addr *mpi_addr = (struct na_mpi_addr *) source;
     struct na_mpi_op_id *na_mpi_op_id = NULL;
+    MPI_Request data_request = MPI_REQUEST_NULL;
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
 
@@ -1675,25 +2190,24 @@ na_mpi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_mpi_op_id->canceled = NA_FALSE;
     na_mpi_op_id->info.recv_expected.buf_size = mpi_buf_size;
     na_mpi_op_id->info.recv_expected.actual_size = 0;
-    na_mpi_op_id->info.recv_expected.data_request = MPI_REQUEST_NULL;
 
     /* Assign op_id */
     if (op_id && op_id != NA_OP_ID_IGNORE) *op_id = (na_op_id_t) na_mpi_op_id;
 
     mpi_ret = MPI_Irecv(buf, mpi_buf_size, MPI_BYTE, mpi_addr->rank,
-            mpi_tag, mpi_addr->comm,
-            &na_mpi_op_id->info.recv_expected.data_request);
+            mpi_tag, mpi_addr->comm, &data_request);
     if (mpi_ret != MPI_SUCCESS) {
         NA_LOG_ERROR("MPI_Irecv() failed");
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
 
-    /* Append op_id to op_id list */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list,
-        na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    /* Track request */
+    ret = na_mpi_request_add(na_class, na_mpi_op_id, &data_request, 1);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not track MPI request");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -1740,31 +2254,178 @@ na_mpi_mem_handle_free(na_class_t NA_UNUSED *na_class,
             (struct na_mpi_mem_handle*) mem_handle;
     na_return_t ret = NA_SUCCESS;
 
+#ifdef NA_MPI_USE_RMA_WIN
+    /* Make sure that memory is no longer attached */
+    if (mpi_mem_handle->registered) {
+        ret = na_mpi_mem_deregister(na_class, mem_handle);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not deregister memory handle");
+            return ret;
+        }
+    }
+#endif
+
     free(mpi_mem_handle);
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
+#ifdef NA_MPI_USE_RMA_WIN
+static na_return_t
+na_mpi_mem_register(na_class_t *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_mpi_mem_handle *na_mpi_mem_handle =
+            (struct na_mpi_mem_handle *) mem_handle;
+    struct na_mpi_mem_handle *var = NULL;
+    struct na_mpi_addr *na_mpi_addr = NULL;
+    na_return_t ret = NA_SUCCESS;
+
+    if (na_mpi_mem_handle->registered || !na_mpi_mem_handle->size)
+        goto done;
+
+    /* Dynamic windows are addressed with absolute displacements, which must
+     * be obtained from MPI rather than by casting the pointer */
+    if (MPI_Get_address((void *) na_mpi_mem_handle->base,
+        &na_mpi_mem_handle->disp) != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Get_address() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    hg_thread_mutex_lock(
+            &NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list_mutex);
+
+    /* Overlapping regions cannot be attached twice to the same window, keep
+     * using emulation for those */
+    HG_LIST_FOREACH(var, &NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list,
+        entry) {
+        if (var->attached
+            && na_mpi_mem_handle->base < var->base + (na_ptr_t) var->size
+            && var->base < na_mpi_mem_handle->base
+                + (na_ptr_t) na_mpi_mem_handle->size)
+            goto unlock;
+    }
+
+    /* Failed attachments may leave some implementations in a bad state,
+     * do not go past the attach limit */
+    if (NA_MPI_PRIVATE_DATA(na_class)->attach_count >= NA_MPI_RMA_MAX_ATTACH)
+        goto insert;
+
+    /* Attach memory to windows of all connected remotes */
+    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+    HG_LIST_FOREACH(na_mpi_addr, &NA_MPI_PRIVATE_DATA(na_class)->remote_list,
+        entry) {
+        if (na_mpi_addr->win == MPI_WIN_NULL)
+            continue;
+
+        if (MPI_Win_attach(na_mpi_addr->win, (void *) na_mpi_mem_handle->base,
+            na_mpi_mem_handle->size) != MPI_SUCCESS)
+            break;
+    }
+
+    /* Windows have a limited number of attach slots, if memory could not be
+     * attached everywhere, detach it and use emulation for that memory */
+    if (na_mpi_addr) {
+        struct na_mpi_addr *failed_addr = na_mpi_addr;
+
+        NA_LOG_DEBUG("MPI_Win_attach() failed, using RMA emulation");
+        HG_LIST_FOREACH(na_mpi_addr,
+            &NA_MPI_PRIVATE_DATA(na_class)->remote_list, entry) {
+            if (na_mpi_addr == failed_addr)
+                break;
+            if (na_mpi_addr->win != MPI_WIN_NULL)
+                MPI_Win_detach(na_mpi_addr->win,
+                    (void *) na_mpi_mem_handle->base);
+        }
+    }
+    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+    if (!na_mpi_addr) {
+        na_mpi_mem_handle->attached = NA_TRUE;
+        NA_MPI_PRIVATE_DATA(na_class)->attach_count++;
+    }
+
+insert:
+    /* Keep handle in list even on failure so that it gets deregistered */
+    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list,
+        na_mpi_mem_handle, entry);
+    na_mpi_mem_handle->registered = NA_TRUE;
+
+unlock:
+    hg_thread_mutex_unlock(
+            &NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list_mutex);
+
+done:
+    return ret;
+}
+#else
 static na_return_t
 na_mpi_mem_register(na_class_t NA_UNUSED *na_class, na_mem_handle_t NA_UNUSED mem_handle)
 {
     return NA_SUCCESS;
 }
+#endif
 
 /*---------------------------------------------------------------------------*/
+#ifdef NA_MPI_USE_RMA_WIN
+static na_return_t
+na_mpi_mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_mpi_mem_handle *na_mpi_mem_handle =
+            (struct na_mpi_mem_handle *) mem_handle;
+    struct na_mpi_addr *na_mpi_addr = NULL;
+    na_return_t ret = NA_SUCCESS;
+
+    if (!na_mpi_mem_handle->registered)
+        goto done;
+
+    hg_thread_mutex_lock(
+            &NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list_mutex);
+
+    /* Detach memory from windows of all connected remotes */
+    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+    HG_LIST_FOREACH(na_mpi_addr, &NA_MPI_PRIVATE_DATA(na_class)->remote_list,
+        entry) {
+        int mpi_ret;
+
+        if (!na_mpi_mem_handle->attached || na_mpi_addr->win == MPI_WIN_NULL)
+            continue;
+
+        mpi_ret = MPI_Win_detach(na_mpi_addr->win,
+                (void *) na_mpi_mem_handle->base);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Win_detach() failed");
+            ret = NA_PROTOCOL_ERROR;
+        }
+    }
+    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+
+    HG_LIST_REMOVE(na_mpi_mem_handle, entry);
+    if (na_mpi_mem_handle->attached)
+        NA_MPI_PRIVATE_DATA(na_class)->attach_count--;
+    na_mpi_mem_handle->registered = NA_FALSE;
+    na_mpi_mem_handle->attached = NA_FALSE;
+
+    hg_thread_mutex_unlock(
+            &NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list_mutex);
+
+done:
+    return ret;
+}
+#else
 static na_return_t
 na_mpi_mem_deregister(na_class_t NA_UNUSED *na_class, na_mem_handle_t NA_UNUSED mem_handle)
 {
     return NA_SUCCESS;
 }
+#endif
 
 /*---------------------------------------------------------------------------*/
 static na_size_t
 na_mpi_mem_handle_get_serialize_size(na_class_t NA_UNUSED *na_class,
         na_mem_handle_t NA_UNUSED mem_handle)
 {
-    return sizeof(struct na_mpi_mem_handle);
+    return NA_MPI_MEM_HANDLE_SIZE;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1776,14 +2437,14 @@ na_mpi_mem_handle_serialize(na_class_t NA_UNUSED *na_class, void *buf,
             (struct na_mpi_mem_handle*) mem_handle;
     na_return_t ret = NA_SUCCESS;
 
-    if (buf_size < sizeof(struct na_mpi_mem_handle)) {
+    if (buf_size < NA_MPI_MEM_HANDLE_SIZE) {
         NA_LOG_ERROR("Buffer size too small for serializing handle");
         ret = NA_SIZE_ERROR;
         goto done;
     }
 
     /* Copy struct */
-    memcpy(buf, na_mpi_mem_handle, sizeof(struct na_mpi_mem_handle));
+    memcpy(buf, na_mpi_mem_handle, NA_MPI_MEM_HANDLE_SIZE);
 
 done:
     return ret;
@@ -1797,14 +2458,14 @@ na_mpi_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
     struct na_mpi_mem_handle *na_mpi_mem_handle = NULL;
     na_return_t ret = NA_SUCCESS;
 
-    if (buf_size < sizeof(struct na_mpi_mem_handle)) {
+    if (buf_size < NA_MPI_MEM_HANDLE_SIZE) {
         NA_LOG_ERROR("Buffer size too small for deserializing handle");
         ret = NA_SIZE_ERROR;
         goto done;
     }
 
     na_mpi_mem_handle = (struct na_mpi_mem_handle*)
-            malloc(sizeof(struct na_mpi_mem_handle));
+            calloc(1, sizeof(struct na_mpi_mem_handle));
     if (!na_mpi_mem_handle) {
           NA_LOG_ERROR("Could not allocate NA MPI memory handle");
           ret = NA_NOMEM_ERROR;
@@ -1812,7 +2473,7 @@ na_mpi_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
     }
 
     /* Copy struct */
-    memcpy(na_mpi_mem_handle, buf, sizeof(struct na_mpi_mem_handle));
+    memcpy(na_mpi_mem_handle, buf, NA_MPI_MEM_HANDLE_SIZE);
 
     *mem_handle = (na_mem_handle_t) na_mpi_mem_handle;
 
@@ -1839,6 +2500,8 @@ na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
                                     * than 2GB */
     struct na_mpi_op_id *na_mpi_op_id = NULL;
     struct na_mpi_rma_info *na_mpi_rma_info = NULL;
+    MPI_Request requests[NA_MPI_OP_MAX_REQUESTS] =
+        {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
 
@@ -1869,11 +2532,27 @@ na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_mpi_op_id->arg = arg;
     na_mpi_op_id->completed = NA_FALSE;
     na_mpi_op_id->canceled = NA_FALSE;
-    na_mpi_op_id->info.put.rma_request = MPI_REQUEST_NULL;
-    na_mpi_op_id->info.put.data_request = MPI_REQUEST_NULL;
     na_mpi_op_id->info.put.internal_progress = NA_FALSE;
     na_mpi_op_id->info.put.rma_info = NULL;
 
+#ifdef NA_MPI_USE_RMA_WIN
+    na_mpi_op_id->info.put.win = MPI_WIN_NULL;
+    na_mpi_op_id->info.put.win_rank = 0;
+
+    /* Use one-sided operation if remote memory is attached to window */
+    if (na_mpi_addr->win != MPI_WIN_NULL && mpi_remote_mem_handle->attached) {
+        /* Assign op_id */
+        if (op_id && op_id != NA_OP_ID_IGNORE)
+            *op_id = (na_op_id_t) na_mpi_op_id;
+
+        ret = na_mpi_rma_win_post(na_class, na_mpi_op_id,
+                (char *) mpi_local_mem_handle->base + mpi_local_offset,
+                mpi_length, na_mpi_addr,
+                mpi_remote_mem_handle->disp + mpi_remote_offset);
+        goto done;
+    }
+#endif
+
     /* Allocate rma info (use calloc to avoid uninitialized transfer) */
     na_mpi_rma_info =
             (struct na_mpi_rma_info *) calloc(1, sizeof(struct na_mpi_rma_info));
@@ -1895,7 +2574,7 @@ na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     /* Post the MPI send request */
     mpi_ret = MPI_Isend(na_mpi_rma_info, sizeof(struct na_mpi_rma_info),
             MPI_BYTE, na_mpi_addr->rank, NA_MPI_RMA_REQUEST_TAG,
-            na_mpi_addr->rma_comm, &na_mpi_op_id->info.put.rma_request);
+            na_mpi_addr->rma_comm, &requests[NA_MPI_OP_RMA_REQUEST]);
     if (mpi_ret != MPI_SUCCESS) {
         NA_LOG_ERROR("MPI_Isend() failed");
         ret = NA_PROTOCOL_ERROR;
@@ -1905,18 +2584,20 @@ na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     /* Simply do a non blocking synchronous send */
     mpi_ret = MPI_Issend((char*) mpi_local_mem_handle->base + mpi_local_offset,
             mpi_length, MPI_BYTE, na_mpi_addr->rank, (int) na_mpi_rma_info->tag,
-            na_mpi_addr->rma_comm, &na_mpi_op_id->info.put.data_request);
+            na_mpi_addr->rma_comm, &requests[NA_MPI_OP_DATA_REQUEST]);
     if (mpi_ret != MPI_SUCCESS) {
         NA_LOG_ERROR("MPI_Issend() failed");
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
 
-    /* Append op_id to op_id list */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list,
-        na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    /* Track requests, op ID completes once both requests have completed */
+    ret = na_mpi_request_add(na_class, na_mpi_op_id, requests,
+        NA_MPI_OP_MAX_REQUESTS);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not track MPI requests");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -1945,6 +2626,8 @@ na_mpi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
                                     * than 2GB */
     struct na_mpi_op_id *na_mpi_op_id = NULL;
     struct na_mpi_rma_info *na_mpi_rma_info = NULL;
+    MPI_Request requests[NA_MPI_OP_MAX_REQUESTS] =
+        {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
 
@@ -1975,11 +2658,27 @@ na_mpi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_mpi_op_id->arg = arg;
     na_mpi_op_id->completed = NA_FALSE;
     na_mpi_op_id->canceled = NA_FALSE;
-    na_mpi_op_id->info.get.rma_request = MPI_REQUEST_NULL;
-    na_mpi_op_id->info.get.data_request = MPI_REQUEST_NULL;
-    na_mpi_op_id->info.put.internal_progress = NA_FALSE;
+    na_mpi_op_id->info.get.internal_progress = NA_FALSE;
     na_mpi_op_id->info.get.rma_info = NULL;
 
+#ifdef NA_MPI_USE_RMA_WIN
+    na_mpi_op_id->info.get.win = MPI_WIN_NULL;
+    na_mpi_op_id->info.get.win_rank = 0;
+
+    /* Use one-sided operation if remote memory is attached to window */
+    if (na_mpi_addr->win != MPI_WIN_NULL && mpi_remote_mem_handle->attached) {
+        /* Assign op_id */
+        if (op_id && op_id != NA_OP_ID_IGNORE)
+            *op_id = (na_op_id_t) na_mpi_op_id;
+
+        ret = na_mpi_rma_win_post(na_class, na_mpi_op_id,
+                (char *) mpi_local_mem_handle->base + mpi_local_offset,
+                mpi_length, na_mpi_addr,
+                mpi_remote_mem_handle->disp + mpi_remote_offset);
+        goto done;
+    }
+#endif
+
     /* Allocate rma info (use calloc to avoid uninitialized transfer) */
     na_mpi_rma_info =
             (struct na_mpi_rma_info *) calloc(1, sizeof(struct na_mpi_rma_info));
@@ -2001,7 +2700,7 @@ na_mpi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     /* Post the MPI send request */
     mpi_ret = MPI_Isend(na_mpi_rma_info, sizeof(struct na_mpi_rma_info),
             MPI_BYTE, na_mpi_addr->rank, NA_MPI_RMA_REQUEST_TAG,
-            na_mpi_addr->rma_comm, &na_mpi_op_id->info.get.rma_request);
+            na_mpi_addr->rma_comm, &requests[NA_MPI_OP_RMA_REQUEST]);
     if (mpi_ret != MPI_SUCCESS) {
         NA_LOG_ERROR("MPI_Isend() failed");
         ret = NA_PROTOCOL_ERROR;
@@ -2011,18 +2710,20 @@ na_mpi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     /* Simply do an asynchronous recv */
     mpi_ret = MPI_Irecv((char*) mpi_local_mem_handle->base + mpi_local_offset,
             mpi_length, MPI_BYTE, na_mpi_addr->rank, (int) na_mpi_rma_info->tag,
-            na_mpi_addr->rma_comm, &na_mpi_op_id->info.get.data_request);
+            na_mpi_addr->rma_comm, &requests[NA_MPI_OP_DATA_REQUEST]);
     if (mpi_ret != MPI_SUCCESS) {
         NA_LOG_ERROR("MPI_Irecv() failed");
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
 
-    /* Append op_id to op_id list */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list,
-        na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    /* Track requests, op ID completes once both requests have completed */
+    ret = na_mpi_request_add(na_class, na_mpi_op_id, requests,
+        NA_MPI_OP_MAX_REQUESTS);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not track MPI requests");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -2195,6 +2896,7 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
 {
     struct na_mpi_rma_info *na_mpi_rma_info = NULL;
     struct na_mpi_op_id *na_mpi_op_id = NULL;
+    MPI_Request data_request = MPI_REQUEST_NULL;
     int unexpected_buf_size = 0;
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
@@ -2243,8 +2945,6 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
         /* Remote wants to do a put so wait in a recv */
         case NA_MPI_RMA_PUT:
             na_mpi_op_id->type = NA_CB_PUT;
-            na_mpi_op_id->info.put.rma_request = MPI_REQUEST_NULL;
-            na_mpi_op_id->info.put.data_request = MPI_REQUEST_NULL;
             na_mpi_op_id->info.put.internal_progress = NA_TRUE;
             na_mpi_op_id->info.put.rma_info = na_mpi_rma_info;
 
@@ -2252,7 +2952,7 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
                     (char*) na_mpi_rma_info->base + na_mpi_rma_info->disp,
                     na_mpi_rma_info->count, MPI_BYTE, na_mpi_addr->rank,
                     (int) na_mpi_rma_info->tag, na_mpi_addr->rma_comm,
-                    &na_mpi_op_id->info.put.data_request);
+                    &data_request);
             if (mpi_ret != MPI_SUCCESS) {
                 NA_LOG_ERROR("MPI_Irecv() failed");
                 ret = NA_PROTOCOL_ERROR;
@@ -2263,8 +2963,6 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
             /* Remote wants to do a get so do a send */
         case NA_MPI_RMA_GET:
             na_mpi_op_id->type = NA_CB_GET;
-            na_mpi_op_id->info.get.rma_request = MPI_REQUEST_NULL;
-            na_mpi_op_id->info.get.data_request = MPI_REQUEST_NULL;
             na_mpi_op_id->info.get.internal_progress = NA_TRUE;
             na_mpi_op_id->info.get.rma_info = na_mpi_rma_info;
 
@@ -2272,7 +2970,7 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
                     (char*) na_mpi_rma_info->base + na_mpi_rma_info->disp,
                     na_mpi_rma_info->count, MPI_BYTE, na_mpi_addr->rank,
                     (int) na_mpi_rma_info->tag, na_mpi_addr->rma_comm,
-                    &na_mpi_op_id->info.get.data_request);
+                    &data_request);
             if (mpi_ret != MPI_SUCCESS) {
                 NA_LOG_ERROR("MPI_Isend() failed");
                 ret = NA_PROTOCOL_ERROR;
@@ -2282,14 +2980,16 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
 
         default:
             NA_LOG_ERROR("Operation not supported");
-            break;
+            ret = NA_INVALID_PARAM;
+            goto done;
     }
 
-    /* Add op_id to list */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list,
-        na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    /* Track request */
+    ret = na_mpi_request_add(na_class, na_mpi_op_id, &data_request, 1);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not track MPI request");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -2304,128 +3004,105 @@ static na_return_t
 na_mpi_progress_expected(na_class_t *na_class, na_context_t NA_UNUSED *context,
         unsigned int NA_UNUSED timeout)
 {
-    struct na_mpi_op_id *na_mpi_op_id = NULL;
-    na_return_t ret = NA_TIMEOUT;
+    struct na_mpi_private_data *priv = NA_MPI_PRIVATE_DATA(na_class);
+    na_return_t ret = NA_TIMEOUT, error_ret = NA_SUCCESS;
+    int completed_count = 0;
+    int i, mpi_ret;
 
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    hg_thread_mutex_lock(&priv->request_mutex);
 
-    na_mpi_op_id = HG_LIST_FIRST(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list);
-    while (na_mpi_op_id) {
-        MPI_Request *request = NULL;
-        na_bool_t internal = NA_FALSE; /* Only used to complete internal ops */
+    if (!priv->request_count)
+        goto done;
+
+    /* Test all outstanding requests at once */
+    mpi_ret = MPI_Testsome(priv->request_count, priv->requests,
+        &completed_count, priv->request_indices, priv->request_statuses);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Testsome() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+    if (completed_count == MPI_UNDEFINED || completed_count == 0)
+        goto done;
+
+    /* Completed slots are already set to MPI_REQUEST_NULL, errors are
+     * reported once all of them have been processed and removed */
+    for (i = 0; i < completed_count; i++) {
+        struct na_mpi_request_entry *entry =
+            &priv->request_entries[priv->request_indices[i]];
+        struct na_mpi_op_id *na_mpi_op_id = entry->op_id;
         struct na_mpi_rma_info **rma_info = NULL;
-        na_bool_t complete_op_id = NA_TRUE;
-        int flag = 0, mpi_ret = 0;
-        MPI_Status *status = MPI_STATUS_IGNORE;
+        na_bool_t internal = NA_FALSE; /* Only used to complete internal ops */
 
         /* If the op_id is marked as completed, something is wrong */
         if (na_mpi_op_id->completed) {
             NA_LOG_ERROR("Op ID should not have completed yet");
-            ret = NA_PROTOCOL_ERROR;
-            goto done;
+            error_ret = NA_PROTOCOL_ERROR;
+            continue;
         }
 
+        na_mpi_op_id->request_slots[entry->index] = -1;
+
         switch (na_mpi_op_id->type) {
-            case NA_CB_LOOKUP:
-                NA_LOG_ERROR("Should not complete lookup here");
-                break;
-            case NA_CB_RECV_UNEXPECTED:
-                NA_LOG_ERROR("Should not complete unexpected recv here");
-                break;
             case NA_CB_SEND_UNEXPECTED:
-                request = &na_mpi_op_id->info.send_unexpected.data_request;
+            case NA_CB_SEND_EXPECTED:
                 break;
             case NA_CB_RECV_EXPECTED:
-                status = &na_mpi_op_id->info.recv_expected.status;
-                request = &na_mpi_op_id->info.recv_expected.data_request;
-                break;
-            case NA_CB_SEND_EXPECTED:
-                request = &na_mpi_op_id->info.send_expected.data_request;
+                memcpy(&na_mpi_op_id->info.recv_expected.status,
+                    &priv->request_statuses[i], sizeof(MPI_Status));
                 break;
             case NA_CB_PUT:
                 if (na_mpi_op_id->info.put.internal_progress) {
-                    request = &na_mpi_op_id->info.put.data_request;
                     rma_info = &na_mpi_op_id->info.put.rma_info;
                     internal = NA_TRUE;
-                } else {
-                    request = &na_mpi_op_id->info.put.rma_request;
-                    if (*request != MPI_REQUEST_NULL) {
-                        complete_op_id = NA_FALSE;
-                    } else {
-                        request = &na_mpi_op_id->info.put.data_request;
-                    }
                 }
                 break;
             case NA_CB_GET:
                 if (na_mpi_op_id->info.get.internal_progress) {
-                    request = &na_mpi_op_id->info.get.data_request;
                     rma_info = &na_mpi_op_id->info.get.rma_info;
                     internal = NA_TRUE;
-                } else {
-                    request = &na_mpi_op_id->info.get.rma_request;
-                    if (*request != MPI_REQUEST_NULL) {
-                        complete_op_id = NA_FALSE;
-                    } else {
-                        request = &na_mpi_op_id->info.get.data_request;
-                    }
                 }
                 break;
             default:
                 NA_LOG_ERROR("Unknown type of operation ID");
-                ret = NA_PROTOCOL_ERROR;
-                goto done;
-        }
-
-        /* If request is MPI_REQUEST_NULL, the operation should be completed */
-        if (!request || (request && (*request == MPI_REQUEST_NULL))) {
-            NA_LOG_ERROR("NULL request found");
-            ret = NA_PROTOCOL_ERROR;
-            goto done;
+                error_ret = NA_PROTOCOL_ERROR;
+                continue;
         }
+        ret = NA_SUCCESS; /* progressed */
 
-        mpi_ret = MPI_Test(request, &flag, status);
-        if (mpi_ret != MPI_SUCCESS) {
-            NA_LOG_ERROR("MPI_Test() failed");
-            ret = NA_PROTOCOL_ERROR;
-            goto done;
-        }
-        if (!flag) {
-            na_mpi_op_id = HG_LIST_NEXT(na_mpi_op_id, entry);
+        /* Wait for remaining requests of that op ID */
+        if (--na_mpi_op_id->request_count > 0)
             continue;
-        }
-
-        *request = MPI_REQUEST_NULL;
 
         /* If internal operation call release directly otherwise add callback
          * to completion queue */
         if (internal) {
             na_mpi_op_id->completed = NA_TRUE;
-            /* Remove entry from list */
-            HG_LIST_REMOVE(na_mpi_op_id, entry);
-
             free(*rma_info);
             *rma_info = NULL;
             na_mpi_release(na_mpi_op_id);
         } else {
-            if (!complete_op_id) {
-                na_mpi_op_id = HG_LIST_NEXT(na_mpi_op_id, entry);
-                continue;
-            }
-            /* Remove entry from list */
-            HG_LIST_REMOVE(na_mpi_op_id, entry);
+            na_return_t complete_ret = na_mpi_complete(na_mpi_op_id);
 
-            ret = na_mpi_complete(na_mpi_op_id);
-            if (ret != NA_SUCCESS) {
+            if (complete_ret != NA_SUCCESS) {
                 NA_LOG_ERROR("Could not complete operation");
-                goto done;
+                error_ret = complete_ret;
             }
         }
-        ret = NA_SUCCESS; /* progressed */
-        break;
     }
 
+    /* Compact request arrays, removing from the highest index first so that
+     * moved requests are never completed ones */
+    qsort(priv->request_indices, (size_t) completed_count, sizeof(int),
+        na_mpi_request_index_cmp);
+    for (i = 0; i < completed_count; i++)
+        na_mpi_request_remove(na_class, priv->request_indices[i]);
+
+    if (error_ret != NA_SUCCESS)
+        ret = error_ret;
+
 done:
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    hg_thread_mutex_unlock(&priv->request_mutex);
     return ret;
 }
 
@@ -2492,6 +3169,12 @@ na_mpi_complete(struct na_mpi_op_id *na_mpi_op_id)
             na_mpi_addr->unexpected = NA_TRUE;
             na_mpi_addr->self = NA_FALSE;
             na_mpi_addr->dynamic = NA_TRUE;
+#ifdef NA_MPI_USE_RMA_WIN
+            /* Window remains owned by the connected remote */
+            na_mpi_addr->win_comm = na_mpi_remote_addr->win_comm;
+            na_mpi_addr->win = na_mpi_remote_addr->win;
+            na_mpi_addr->win_rank_offset = na_mpi_remote_addr->win_rank_offset;
+#endif
             memset(na_mpi_addr->port_name, '\0', MPI_MAX_PORT_NAME);
             /* Can only write debug info here */
             sprintf(na_mpi_addr->port_name, "comm: %d rank:%d\n",
@@ -2584,7 +3267,7 @@ na_mpi_cancel(na_class_t *na_class, na_context_t NA_UNUSED *context,
             /* Nothing for now */
             break;
         case NA_CB_SEND_UNEXPECTED:
-            mpi_ret = MPI_Cancel(&na_mpi_op_id->info.send_unexpected.data_request);
+            mpi_ret = na_mpi_request_cancel(na_class, na_mpi_op_id);
             if (mpi_ret != MPI_SUCCESS) {
                 NA_LOG_ERROR("MPI_Cancel() failed");
                 ret = NA_PROTOCOL_ERROR;
@@ -2615,7 +3298,7 @@ na_mpi_cancel(na_class_t *na_class, na_context_t NA_UNUSED *context,
         }
             break;
         case NA_CB_SEND_EXPECTED:
-            mpi_ret = MPI_Cancel(&na_mpi_op_id->info.send_expected.data_request);
+            mpi_ret = na_mpi_request_cancel(na_class, na_mpi_op_id);
             if (mpi_ret != MPI_SUCCESS) {
                 NA_LOG_ERROR("MPI_Cancel() failed");
                 ret = NA_PROTOCOL_ERROR;
@@ -2624,7 +3307,7 @@ na_mpi_cancel(na_class_t *na_class, na_context_t NA_UNUSED *context,
             na_mpi_op_id->canceled = NA_TRUE;
             break;
         case NA_CB_RECV_EXPECTED:
-            mpi_ret = MPI_Cancel(&na_mpi_op_id->info.recv_expected.data_request);
+            mpi_ret = na_mpi_request_cancel(na_class, na_mpi_op_id);
             if (mpi_ret != MPI_SUCCESS) {
                 NA_LOG_ERROR("MPI_Cancel() failed");
                 ret = NA_PROTOCOL_ERROR;
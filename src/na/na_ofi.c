@@ -57,6 +57,7 @@
 #include "mercury_time.h"
 #include "mercury_atomic.h"
 #include "mercury_mem.h"
+#include "mercury_poll.h"
 
 #include <rdma/fabric.h>
 #include <rdma/fi_domain.h>
@@ -115,11 +116,18 @@
 #define NA_OFI_EXPECTED_TAG_FLAG (0x100000000ULL)
 #define NA_OFI_UNEXPECTED_TAG_IGNORE (0xFFFFFFFFULL)
 
-/* number of CQ event provided for fi_cq_read() */
+/* number of CQ event provided for fi_cq_read() (initial / min batch size) */
 #define NA_OFI_CQ_EVENT_NUM (16)
+/* max number of CQ event provided for fi_cq_read() when under load */
+#define NA_OFI_CQ_MAX_EVENT_NUM (256)
 /* CQ depth (the socket provider's default value is 256 */
 #define NA_OFI_CQ_DEPTH (8192)
 
+/* Max number of endpoints used for striping RMA operations */
+#define NA_OFI_RMA_STRIPE_MAX (16)
+/* Size of the chunks that RMA operations are striped into */
+#define NA_OFI_RMA_STRIPE_SIZE (1 << 20)
+
 /* The magic number for na_ofi_op_id verification */
 #define NA_OFI_OP_ID_MAGIC_1 (0x1928374655627384ULL)
 #define NA_OFI_OP_ID_MAGIC_2 (0x8171615141312111ULL)
@@ -196,6 +204,16 @@ struct na_ofi_domain {
     HG_LIST_ENTRY(na_ofi_domain) nod_entry; /* Entry in nog_domain_list */
 };
 
+/**
+ * Extra endpoint used for striping large RMA operations. Each stripe has
+ * its own CQ so that transfers are not serialized through the main endpoint,
+ * that CQ uses the same kind of wait object as the main CQ.
+ */
+struct na_ofi_rma_stripe {
+    struct fid_ep *nos_ep;      /* Endpoint used for RMA chunks */
+    struct fid_cq *nos_cq;      /* Completion queue of that endpoint */
+};
+
 struct na_ofi_endpoint {
     char *noe_node;             /* Fabric address */
     char *noe_service;          /* Service name */
@@ -205,6 +223,9 @@ struct na_ofi_endpoint {
     struct fid_wait *noe_wait;  /* Wait set handle, invalid for sep */
     /* Unexpected op queue for regular endpoint */
     struct na_ofi_queue *noe_unexpected_op_queue;
+    struct na_ofi_rma_stripe *noe_stripes; /* RMA stripes (NULL if none) */
+    na_uint8_t noe_stripe_count; /* Number of RMA stripes */
+    hg_poll_set_t *noe_poll_set; /* CQ and stripe CQ fds (NULL if none) */
     na_bool_t noe_sep;          /* True for SEP, false for basic EP */
 };
 
@@ -254,6 +275,8 @@ struct na_ofi_private_data {
     hg_thread_mutex_t nop_mutex;
     HG_QUEUE_HEAD(na_ofi_mem_pool) nop_buf_pool;    /* Msg buf pool head */
     hg_thread_spin_t nop_buf_pool_lock;             /* Buf pool lock */
+    hg_atomic_int32_t nop_stripe_ops; /* Number of striped RMA ops in flight */
+    hg_atomic_int32_t nop_stripe_next; /* Next stripe used (round-robin) */
     na_bool_t no_wait; /* Ignore wait object */
 };
 
@@ -266,6 +289,23 @@ struct na_ofi_context {
     /* Unexpected op queue per context for scalable endpoint, for regular
      * endpoint just a reference to per class op queue. */
     struct na_ofi_queue *noc_unexpected_op_queue;
+    /* Progress may be entered concurrently (e.g., from send on EAGAIN), batch
+     * size and stats are therefore atomic */
+    hg_atomic_int32_t noc_cq_batch;     /* Number of CQ events read at once */
+#ifdef NA_OFI_HAS_COLLECT_STATS
+    hg_atomic_int64_t noc_cq_reads;       /* Number of CQ reads */
+    hg_atomic_int64_t noc_cq_empty_reads; /* Reads that returned no event */
+    hg_atomic_int64_t noc_cq_full_reads;  /* Reads that filled the batch */
+    hg_atomic_int64_t noc_cq_events;      /* Number of CQ events read */
+    hg_atomic_int32_t noc_cq_batch_max;   /* Largest batch size reached */
+#endif
+};
+
+/* Completions collected while processing a batch of CQ events */
+struct na_ofi_completion_batch {
+    na_context_t *nocb_context; /* Context of the completion queue */
+    struct na_cb_completion_data *nocb_entries[NA_OFI_CQ_MAX_EVENT_NUM];
+    unsigned int nocb_count;    /* Number of entries */
 };
 
 struct na_ofi_queue {
@@ -308,6 +348,13 @@ struct na_ofi_info_recv_expected {
     na_tag_t noi_tag;
 };
 
+/* Chunk of a striped RMA operation */
+struct na_ofi_rma_chunk {
+    struct fi_context nrc_fi_ctx;       /* Context passed to fi_readv/writev */
+    struct na_ofi_op_id *nrc_op_id;     /* Parent operation ID */
+    struct fid_ep *nrc_ep;              /* Stripe endpoint used */
+};
+
 struct na_ofi_op_id {
     /* noo_magic_1 and noo_magic_2 are for data verification */
     na_uint64_t noo_magic_1;
@@ -327,6 +374,11 @@ struct na_ofi_op_id {
         struct na_ofi_info_recv_expected noo_recv_expected;
     } noo_info;
     struct na_cb_completion_data noo_completion_data;
+    struct na_ofi_rma_chunk *noo_chunks; /* Chunks of striped RMA */
+    na_size_t noo_chunk_count; /* Number of chunks allocated */
+    na_size_t noo_chunk_posted; /* Number of chunks posted */
+    hg_atomic_int32_t noo_chunks_pending; /* Number of chunks in flight */
+    na_return_t noo_chunk_ret; /* Return code of striped RMA */
     na_uint64_t noo_magic_2;
 };
 
@@ -386,6 +438,25 @@ na_ofi_with_reqhdr(const na_class_t *na_class)
     return na_ofi_with_sep(na_class) || domain->nod_prov_type != NA_OFI_PROV_PSM2;
 }
 
+/**
+ * Checks the magic number of the inline header and swaps byte order when
+ * needed. Magic number is swapped last so that decoding a header twice is
+ * harmless.
+ */
+static NA_INLINE na_return_t
+na_ofi_reqhdr_decode(struct na_ofi_reqhdr *hdr)
+{
+    if (hdr->fih_magic == na_ofi_bswap32(NA_OFI_HDR_MAGIC)) {
+        na_ofi_bswap32s(&hdr->fih_feats);
+        na_ofi_bswap32s(&hdr->fih_ip);
+        na_ofi_bswap32s(&hdr->fih_port);
+        hdr->fih_magic = NA_OFI_HDR_MAGIC;
+    } else if (hdr->fih_magic != NA_OFI_HDR_MAGIC)
+        return NA_PROTOCOL_ERROR;
+
+    return NA_SUCCESS;
+}
+
 /**
  * Converts the inline header to a 64 bits key to search corresponding FI addr.
  */
@@ -621,7 +692,8 @@ na_ofi_domain_close(struct na_ofi_domain *na_ofi_domain);
 static na_return_t
 na_ofi_endpoint_open(const struct na_ofi_domain *na_ofi_domain,
     const char *node, const char *service, na_bool_t no_wait,
-    na_uint8_t max_contexts, struct na_ofi_endpoint **na_ofi_endpoint_p);
+    na_uint8_t max_contexts, na_uint8_t stripe_count,
+    struct na_ofi_endpoint **na_ofi_endpoint_p);
 
 static na_return_t
 na_ofi_basic_ep_open(const struct na_ofi_domain *na_ofi_domain,
@@ -631,6 +703,17 @@ static na_return_t
 na_ofi_sep_open(const struct na_ofi_domain *na_ofi_domain,
     struct na_ofi_endpoint *na_ofi_endpoint);
 
+static na_return_t
+na_ofi_stripes_open(const struct na_ofi_domain *na_ofi_domain,
+    na_bool_t no_wait, na_uint8_t stripe_count,
+    struct na_ofi_endpoint *na_ofi_endpoint);
+
+static na_return_t
+na_ofi_stripes_poll_set_create(struct na_ofi_endpoint *na_ofi_endpoint);
+
+static na_return_t
+na_ofi_stripes_close(struct na_ofi_endpoint *na_ofi_endpoint);
+
 static na_return_t
 na_ofi_endpoint_close(struct na_ofi_endpoint *na_ofi_endpoint);
 
@@ -682,6 +765,17 @@ na_ofi_context_create(na_class_t *na_class, void **context, na_uint8_t id);
 static na_return_t
 na_ofi_context_destroy(na_class_t *na_class, void *context);
 
+/* context_get_stats */
+static na_return_t
+na_ofi_context_get_stats(na_class_t *na_class, na_context_t *context,
+    struct na_context_stats *stats);
+
+#ifdef NA_OFI_HAS_COLLECT_STATS
+/* Log CQ read stats of context (debug logging only) */
+static void
+na_ofi_context_log_stats(struct na_ofi_context *ctx);
+#endif
+
 /* op_create */
 static na_op_id_t
 na_ofi_op_create(na_class_t *na_class);
@@ -831,6 +925,27 @@ static na_return_t
 na_ofi_complete(struct na_ofi_addr *na_ofi_addr, struct na_ofi_op_id *na_ofi_op_id,
     na_return_t ret);
 
+/* Complete operation, completion is deferred to batch when batch is not NULL */
+static na_return_t
+na_ofi_complete_batch(struct na_ofi_addr *na_ofi_addr,
+    struct na_ofi_op_id *na_ofi_op_id, na_return_t ret,
+    struct na_ofi_completion_batch *batch);
+
+/* Post RMA operation as chunks striped across stripe endpoints */
+static na_return_t
+na_ofi_rma_stripe_post(na_class_t *na_class, struct na_ofi_op_id *na_ofi_op_id,
+    na_bool_t put, char *local_base, void *local_desc, na_uint64_t remote_base,
+    na_uint64_t rma_key, fi_addr_t fi_addr, na_size_t length);
+
+/* Retire one chunk of a striped RMA operation */
+static void
+na_ofi_rma_chunk_complete(na_class_t *na_class,
+    struct na_ofi_op_id *na_ofi_op_id, na_return_t chunk_ret);
+
+/* Poll stripe CQs (never blocks) */
+static na_return_t
+na_ofi_stripes_progress(na_class_t *na_class, unsigned int *count_p);
+
 static void
 na_ofi_release(void *arg);
 
@@ -851,6 +966,7 @@ const na_class_t na_ofi_class_g = {
     NULL,                                   /* cleanup */
     na_ofi_context_create,                  /* context_create */
     na_ofi_context_destroy,                 /* context_destroy */
+    na_ofi_context_get_stats,               /* context_get_stats */
     na_ofi_op_create,                       /* op_create */
     na_ofi_op_destroy,                      /* op_destroy */
     na_ofi_addr_lookup,                     /* addr_lookup */
@@ -1520,7 +1636,8 @@ out:
 static na_return_t
 na_ofi_endpoint_open(const struct na_ofi_domain *na_ofi_domain,
     const char *node, const char *service, na_bool_t no_wait,
-    na_uint8_t max_contexts, struct na_ofi_endpoint **na_ofi_endpoint_p)
+    na_uint8_t max_contexts, na_uint8_t stripe_count,
+    struct na_ofi_endpoint **na_ofi_endpoint_p)
 {
     struct na_ofi_endpoint *na_ofi_endpoint;
     na_return_t ret = NA_SUCCESS;
@@ -1581,6 +1698,18 @@ na_ofi_endpoint_open(const struct na_ofi_domain *na_ofi_domain,
             NA_LOG_ERROR("na_ofi_basic_ep_open failed, ret: %d.", ret);
             goto out;
         }
+
+        /* Extra endpoints for striping large RMA operations, failure to
+         * open them is not fatal, RMA will simply not be striped */
+        if (stripe_count > 1) {
+            ret = na_ofi_stripes_open(na_ofi_domain, no_wait, stripe_count,
+                na_ofi_endpoint);
+            if (ret != NA_SUCCESS) {
+                NA_LOG_WARNING("Could not open RMA stripes, ret: %d, "
+                    "RMA will not be striped", ret);
+                ret = NA_SUCCESS;
+            }
+        }
     }
 
     *na_ofi_endpoint_p = na_ofi_endpoint;
@@ -1725,6 +1854,205 @@ out:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_stripes_open(const struct na_ofi_domain *na_ofi_domain,
+    na_bool_t no_wait, na_uint8_t stripe_count,
+    struct na_ofi_endpoint *na_ofi_endpoint)
+{
+    struct fi_info *stripe_prov = NULL;
+    na_return_t ret = NA_SUCCESS;
+    na_uint8_t i;
+    int rc;
+
+    if (stripe_count > NA_OFI_RMA_STRIPE_MAX)
+        stripe_count = NA_OFI_RMA_STRIPE_MAX;
+
+    /* Stripes only issue RMA and do not need to be bound to a given source
+     * address, let the provider pick one */
+    stripe_prov = fi_dupinfo(na_ofi_endpoint->noe_prov);
+    if (!stripe_prov) {
+        NA_LOG_ERROR("fi_dupinfo failed");
+        ret = NA_NOMEM_ERROR;
+        goto out;
+    }
+    free(stripe_prov->src_addr);
+    stripe_prov->src_addr = NULL;
+    stripe_prov->src_addrlen = 0;
+
+    na_ofi_endpoint->noe_stripes = (struct na_ofi_rma_stripe *) calloc(
+        stripe_count, sizeof(struct na_ofi_rma_stripe));
+    if (!na_ofi_endpoint->noe_stripes) {
+        NA_LOG_ERROR("Could not allocate noe_stripes");
+        ret = NA_NOMEM_ERROR;
+        goto out;
+    }
+    na_ofi_endpoint->noe_stripe_count = stripe_count;
+
+    for (i = 0; i < stripe_count; i++) {
+        struct na_ofi_rma_stripe *stripe = &na_ofi_endpoint->noe_stripes[i];
+        struct fi_cq_attr cq_attr = {0};
+
+        rc = fi_endpoint(na_ofi_domain->nod_domain, stripe_prov,
+            &stripe->nos_ep, NULL);
+        if (rc != 0) {
+            NA_LOG_ERROR("fi_endpoint failed, rc: %d(%s).", rc,
+                fi_strerror(-rc));
+            ret = NA_PROTOCOL_ERROR;
+            goto out;
+        }
+
+        /* Stripe CQs signal completions through the main CQ wait set, or
+         * through their own fd that is added to the endpoint poll set */
+        if (no_wait)
+            cq_attr.wait_obj = FI_WAIT_NONE;
+        else if (na_ofi_endpoint->noe_wait) {
+            cq_attr.wait_obj = FI_WAIT_SET;
+            cq_attr.wait_set = na_ofi_endpoint->noe_wait;
+        } else
+            cq_attr.wait_obj = FI_WAIT_FD;
+        cq_attr.wait_cond = FI_CQ_COND_NONE;
+        cq_attr.format = FI_CQ_FORMAT_TAGGED;
+        cq_attr.size = NA_OFI_CQ_DEPTH;
+        rc = fi_cq_open(na_ofi_domain->nod_domain, &cq_attr, &stripe->nos_cq,
+            NULL);
+        if (rc != 0) {
+            NA_LOG_ERROR("fi_cq_open failed, rc: %d(%s).", rc,
+                fi_strerror(-rc));
+            ret = NA_PROTOCOL_ERROR;
+            goto out;
+        }
+
+        rc = fi_ep_bind(stripe->nos_ep, &stripe->nos_cq->fid,
+            FI_TRANSMIT | FI_RECV);
+        if (rc != 0) {
+            NA_LOG_ERROR("fi_ep_bind failed, rc: %d(%s).", rc,
+                fi_strerror(-rc));
+            ret = NA_PROTOCOL_ERROR;
+            goto out;
+        }
+
+        rc = fi_ep_bind(stripe->nos_ep, &na_ofi_domain->nod_av->fid, 0);
+        if (rc != 0) {
+            NA_LOG_ERROR("fi_ep_bind failed, rc: %d(%s).", rc,
+                fi_strerror(-rc));
+            ret = NA_PROTOCOL_ERROR;
+            goto out;
+        }
+
+        rc = fi_enable(stripe->nos_ep);
+        if (rc != 0) {
+            NA_LOG_ERROR("fi_enable failed, rc: %d(%s).", rc,
+                fi_strerror(-rc));
+            ret = NA_PROTOCOL_ERROR;
+            goto out;
+        }
+    }
+
+    if (!no_wait && !na_ofi_endpoint->noe_wait) {
+        ret = na_ofi_stripes_poll_set_create(na_ofi_endpoint);
+        if (ret != NA_SUCCESS)
+            goto out;
+    }
+
+out:
+    if (stripe_prov)
+        fi_freeinfo(stripe_prov);
+    if (ret != NA_SUCCESS)
+        na_ofi_stripes_close(na_ofi_endpoint);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_stripes_poll_set_create(struct na_ofi_endpoint *na_ofi_endpoint)
+{
+    na_return_t ret = NA_SUCCESS;
+    int i, rc;
+
+    na_ofi_endpoint->noe_poll_set = hg_poll_create();
+    if (!na_ofi_endpoint->noe_poll_set) {
+        NA_LOG_ERROR("Could not create poll set");
+        ret = NA_PROTOCOL_ERROR;
+        goto out;
+    }
+
+    /* Main CQ first, then stripe CQs. The poll set is only used to export
+     * a single fd, CQs are read by progress */
+    for (i = -1; i < (int) na_ofi_endpoint->noe_stripe_count; i++) {
+        struct fid_cq *cq_hdl = (i < 0) ? na_ofi_endpoint->noe_cq :
+            na_ofi_endpoint->noe_stripes[i].nos_cq;
+        int fd = -1;
+
+        rc = fi_control(&cq_hdl->fid, FI_GETWAIT, &fd);
+        if (rc != 0) {
+            NA_LOG_ERROR("fi_control() failed, rc: %d(%s).", rc,
+                fi_strerror(-rc));
+            ret = NA_PROTOCOL_ERROR;
+            goto out;
+        }
+        if (hg_poll_add(na_ofi_endpoint->noe_poll_set, fd, HG_POLLIN, NULL,
+            NULL) != HG_UTIL_SUCCESS) {
+            NA_LOG_ERROR("hg_poll_add() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto out;
+        }
+    }
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_stripes_close(struct na_ofi_endpoint *na_ofi_endpoint)
+{
+    na_return_t ret = NA_SUCCESS;
+    na_uint8_t i;
+    int rc;
+
+    if (na_ofi_endpoint->noe_poll_set) {
+        if (hg_poll_destroy(na_ofi_endpoint->noe_poll_set) != HG_UTIL_SUCCESS) {
+            NA_LOG_ERROR("hg_poll_destroy() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto out;
+        }
+        na_ofi_endpoint->noe_poll_set = NULL;
+    }
+
+    if (!na_ofi_endpoint->noe_stripes)
+        goto out;
+
+    for (i = 0; i < na_ofi_endpoint->noe_stripe_count; i++) {
+        struct na_ofi_rma_stripe *stripe = &na_ofi_endpoint->noe_stripes[i];
+
+        if (stripe->nos_ep) {
+            rc = fi_close(&stripe->nos_ep->fid);
+            if (rc != 0) {
+                NA_LOG_ERROR("fi_close stripe endpoint failed, rc: %d(%s).",
+                    rc, fi_strerror(-rc));
+                ret = NA_PROTOCOL_ERROR;
+            }
+            stripe->nos_ep = NULL;
+        }
+        if (stripe->nos_cq) {
+            rc = fi_close(&stripe->nos_cq->fid);
+            if (rc != 0) {
+                NA_LOG_ERROR("fi_close stripe CQ failed, rc: %d(%s).",
+                    rc, fi_strerror(-rc));
+                ret = NA_PROTOCOL_ERROR;
+            }
+            stripe->nos_cq = NULL;
+        }
+    }
+    free(na_ofi_endpoint->noe_stripes);
+    na_ofi_endpoint->noe_stripes = NULL;
+    na_ofi_endpoint->noe_stripe_count = 0;
+
+out:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_endpoint_close(struct na_ofi_endpoint *na_ofi_endpoint)
@@ -1748,6 +2076,11 @@ na_ofi_endpoint_close(struct na_ofi_endpoint *na_ofi_endpoint)
         free(na_ofi_endpoint->noe_unexpected_op_queue);
     }
 
+    /* Close RMA stripes */
+    ret = na_ofi_stripes_close(na_ofi_endpoint);
+    if (ret != NA_SUCCESS)
+        goto out;
+
     /* Close endpoint */
     if (na_ofi_endpoint->noe_ep) {
         rc = fi_close(&na_ofi_endpoint->noe_ep->fid);
@@ -2158,6 +2491,7 @@ na_ofi_initialize(na_class_t *na_class, const struct na_info *na_info,
     char *service = NULL;
     na_bool_t no_wait = NA_FALSE;
     na_uint8_t max_contexts = 1; /* Default */
+    na_uint8_t stripe_count = 0; /* Default (no striping) */
     const char *auth_key = NULL;
     na_return_t ret = NA_SUCCESS;
 
@@ -2198,6 +2532,8 @@ na_ofi_initialize(na_class_t *na_class, const struct na_info *na_info,
         max_contexts = na_info->na_init_info->max_contexts;
         /* Auth key */
         auth_key = na_info->na_init_info->auth_key;
+        /* Number of endpoints used for striping RMA */
+        stripe_count = na_info->na_init_info->rma_stripe_count;
     }
 
     /* Create private data */
@@ -2233,7 +2569,7 @@ na_ofi_initialize(na_class_t *na_class, const struct na_info *na_info,
     /* Create endpoint */
     ret = na_ofi_endpoint_open(NA_OFI_PRIVATE_DATA(na_class)->nop_domain,
         node, service, NA_OFI_PRIVATE_DATA(na_class)->no_wait,
-        NA_OFI_PRIVATE_DATA(na_class)->nop_max_contexts,
+        NA_OFI_PRIVATE_DATA(na_class)->nop_max_contexts, stripe_count,
         &NA_OFI_PRIVATE_DATA(na_class)->nop_endpoint);
     if (ret != NA_SUCCESS) {
         NA_LOG_ERROR("Could not create endpoint for %s, %s", node, service);
@@ -2333,6 +2669,14 @@ na_ofi_context_create(na_class_t *na_class, void **context, na_uint8_t id)
         goto out;
     }
     ctx->noc_idx = id;
+    hg_atomic_init32(&ctx->noc_cq_batch, NA_OFI_CQ_EVENT_NUM);
+#ifdef NA_OFI_HAS_COLLECT_STATS
+    hg_atomic_init64(&ctx->noc_cq_reads, 0);
+    hg_atomic_init64(&ctx->noc_cq_empty_reads, 0);
+    hg_atomic_init64(&ctx->noc_cq_full_reads, 0);
+    hg_atomic_init64(&ctx->noc_cq_events, 0);
+    hg_atomic_init32(&ctx->noc_cq_batch_max, NA_OFI_CQ_EVENT_NUM);
+#endif
 
     /* If not using SEP, just point to endpoint objects */
     hg_thread_mutex_lock(&priv->nop_mutex);
@@ -2552,11 +2896,74 @@ na_ofi_context_destroy(na_class_t *na_class, void *context)
     priv->nop_contexts--;
     hg_thread_mutex_unlock(&priv->nop_mutex);
 
+#ifdef NA_OFI_HAS_COLLECT_STATS
+    na_ofi_context_log_stats(ctx);
+#endif
+
     free(ctx);
 out:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+#ifdef NA_OFI_HAS_COLLECT_STATS
+static void
+na_ofi_context_log_stats(struct na_ofi_context NA_UNUSED *ctx)
+{
+    NA_UNUSED na_uint64_t reads =
+        (na_uint64_t) hg_atomic_get64(&ctx->noc_cq_reads);
+    NA_UNUSED na_uint64_t empty_reads =
+        (na_uint64_t) hg_atomic_get64(&ctx->noc_cq_empty_reads);
+    NA_UNUSED na_uint64_t events =
+        (na_uint64_t) hg_atomic_get64(&ctx->noc_cq_events);
+
+    NA_LOG_DEBUG("context %u CQ reads: %lu (empty: %lu, full: %lu), "
+        "events: %lu (%.2f per read), batch size: %d (max: %d)",
+        (unsigned int) ctx->noc_idx, (unsigned long) reads,
+        (unsigned long) empty_reads,
+        (unsigned long) hg_atomic_get64(&ctx->noc_cq_full_reads),
+        (unsigned long) events,
+        (reads - empty_reads) ?
+            (double) events / (double) (reads - empty_reads) : 0.,
+        hg_atomic_get32(&ctx->noc_cq_batch),
+        hg_atomic_get32(&ctx->noc_cq_batch_max));
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_ofi_stats_add(hg_atomic_int64_t *counter, hg_util_int64_t value)
+{
+    hg_util_int64_t old;
+
+    do {
+        old = hg_atomic_get64(counter);
+    } while (!hg_atomic_cas64(counter, old, old + value));
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_context_get_stats(na_class_t NA_UNUSED *na_class, na_context_t *context,
+    struct na_context_stats *stats)
+{
+    struct na_ofi_context *ctx = NA_OFI_CONTEXT(context);
+
+    memset(stats, 0, sizeof(*stats));
+    stats->cq_batch = (na_uint32_t) hg_atomic_get32(&ctx->noc_cq_batch);
+#ifdef NA_OFI_HAS_COLLECT_STATS
+    stats->cq_reads = (na_uint64_t) hg_atomic_get64(&ctx->noc_cq_reads);
+    stats->cq_empty_reads =
+        (na_uint64_t) hg_atomic_get64(&ctx->noc_cq_empty_reads);
+    stats->cq_full_reads =
+        (na_uint64_t) hg_atomic_get64(&ctx->noc_cq_full_reads);
+    stats->cq_events = (na_uint64_t) hg_atomic_get64(&ctx->noc_cq_events);
+    stats->cq_batch_max =
+        (na_uint32_t) hg_atomic_get32(&ctx->noc_cq_batch_max);
+#endif
+
+    return NA_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 na_ofi_op_id_addref(struct na_ofi_op_id *na_ofi_op_id)
@@ -2584,6 +2991,7 @@ na_ofi_op_id_decref(struct na_ofi_op_id *na_ofi_op_id)
     /* No more references, cleanup */
     na_ofi_op_id->noo_magic_1 = 0;
     na_ofi_op_id->noo_magic_2 = 0;
+    free(na_ofi_op_id->noo_chunks);
     free(na_ofi_op_id);
 
     return;
@@ -3637,6 +4045,17 @@ na_ofi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     fi_addr = na_ofi_with_sep(na_class) ?
         fi_rx_addr(na_ofi_addr->noa_addr, remote_id, NA_OFI_SEP_RX_CTX_BITS) :
         na_ofi_addr->noa_addr;
+
+    /* Stripe large transfers across stripe endpoints if available */
+    if (NA_OFI_PRIVATE_DATA(na_class)->nop_endpoint->noe_stripes
+        && length > NA_OFI_RMA_STRIPE_SIZE) {
+        ret = na_ofi_rma_stripe_post(na_class, na_ofi_op_id, NA_TRUE,
+            (char *) iov.iov_base, local_desc,
+            (na_uint64_t) ofi_remote_mem_handle->nom_base + remote_offset,
+            rma_key, fi_addr, length);
+        goto out;
+    }
+
     do {
         na_ofi_class_lock(na_class);
         rc = fi_writev(ep_hdl, &iov, &local_desc, 1 /* count */, fi_addr,
@@ -3725,6 +4144,17 @@ na_ofi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     fi_addr = na_ofi_with_sep(na_class) ?
         fi_rx_addr(na_ofi_addr->noa_addr, target_id, NA_OFI_SEP_RX_CTX_BITS) :
         na_ofi_addr->noa_addr;
+
+    /* Stripe large transfers across stripe endpoints if available */
+    if (NA_OFI_PRIVATE_DATA(na_class)->nop_endpoint->noe_stripes
+        && length > NA_OFI_RMA_STRIPE_SIZE) {
+        ret = na_ofi_rma_stripe_post(na_class, na_ofi_op_id, NA_FALSE,
+            (char *) iov.iov_base, local_desc,
+            (na_uint64_t) ofi_remote_mem_handle->nom_base + remote_offset,
+            rma_key, fi_addr, length);
+        goto out;
+    }
+
     do {
         na_ofi_class_lock(na_class);
         rc = fi_readv(ep_hdl, &iov, &local_desc, 1 /* count */, fi_addr,
@@ -3755,7 +4185,8 @@ out:
 /*---------------------------------------------------------------------------*/
 static void
 na_ofi_handle_send_event(na_class_t NA_UNUSED *class,
-    na_context_t NA_UNUSED *context, struct fi_cq_tagged_entry *cq_event)
+    na_context_t NA_UNUSED *context, struct fi_cq_tagged_entry *cq_event,
+    struct na_ofi_completion_batch *batch)
 {
     struct na_ofi_op_id *na_ofi_op_id;
     struct na_ofi_addr *na_ofi_addr;
@@ -3783,7 +4214,7 @@ na_ofi_handle_send_event(na_class_t NA_UNUSED *class,
 
     na_ofi_addr = (struct na_ofi_addr *)na_ofi_op_id->noo_addr;
 
-    ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, ret);
+    ret = na_ofi_complete_batch(na_ofi_addr, na_ofi_op_id, ret, batch);
     if (ret != NA_SUCCESS)
         NA_LOG_ERROR("Unable to complete send");
 
@@ -3793,7 +4224,8 @@ na_ofi_handle_send_event(na_class_t NA_UNUSED *class,
 /*---------------------------------------------------------------------------*/
 static void
 na_ofi_handle_recv_event(na_class_t *na_class, na_context_t *context,
-    fi_addr_t src_addr, struct fi_cq_tagged_entry *cq_event)
+    fi_addr_t src_addr, struct fi_cq_tagged_entry *cq_event,
+    struct na_ofi_completion_batch *batch)
 {
     struct na_ofi_domain *domain = NA_OFI_PRIVATE_DATA(na_class)->nop_domain;
     struct na_ofi_addr *peer_addr = NULL;
@@ -3852,19 +4284,19 @@ na_ofi_handle_recv_event(na_class_t *na_class, na_context_t *context,
 
             reqhdr = na_ofi_op_id->noo_info.noo_recv_unexpected.noi_buf;
             /* check magic number and swap byte order when needed */
-            if (reqhdr->fih_magic == na_ofi_bswap32(NA_OFI_HDR_MAGIC)) {
-                na_ofi_bswap32s(&reqhdr->fih_feats);
-                na_ofi_bswap32s(&reqhdr->fih_ip);
-                na_ofi_bswap32s(&reqhdr->fih_port);
-            } else if (reqhdr->fih_magic != NA_OFI_HDR_MAGIC) {
+            ret = na_ofi_reqhdr_decode(reqhdr);
+            if (ret != NA_SUCCESS) {
                 NA_LOG_ERROR("illegal magic number, 0x%x.", reqhdr->fih_magic);
-                ret = NA_PROTOCOL_ERROR;
                 goto out;
             }
-            ret = na_ofi_addr_ht_lookup(na_class, reqhdr, &src_addr);
-            if (ret != NA_SUCCESS) {
-                NA_LOG_ERROR("na_ofi_addr_ht_lookup failed, ret: %d.", ret);
-                goto out;
+            /* Address may not have been resolved with the rest of the batch */
+            if (src_addr == FI_ADDR_UNSPEC) {
+                ret = na_ofi_addr_ht_lookup(na_class, reqhdr, &src_addr);
+                if (ret != NA_SUCCESS) {
+                    NA_LOG_ERROR("na_ofi_addr_ht_lookup failed, ret: %d.",
+                        ret);
+                    goto out;
+                }
             }
 
             in.s_addr = reqhdr->fih_ip;
@@ -3887,7 +4319,7 @@ na_ofi_handle_recv_event(na_class_t *na_class, na_context_t *context,
     }
 
 out:
-    ret = na_ofi_complete(peer_addr, na_ofi_op_id, ret);
+    ret = na_ofi_complete_batch(peer_addr, na_ofi_op_id, ret, batch);
     if (ret != NA_SUCCESS)
         NA_LOG_ERROR("Unable to complete send");
 
@@ -3897,7 +4329,8 @@ out:
 /*---------------------------------------------------------------------------*/
 static void
 na_ofi_handle_rma_event(na_class_t NA_UNUSED *class,
-    na_context_t NA_UNUSED *context, struct fi_cq_tagged_entry *cq_event)
+    na_context_t NA_UNUSED *context, struct fi_cq_tagged_entry *cq_event,
+    struct na_ofi_completion_batch *batch)
 {
     struct na_ofi_op_id *na_ofi_op_id;
     struct na_ofi_addr *na_ofi_addr;
@@ -3925,13 +4358,90 @@ na_ofi_handle_rma_event(na_class_t NA_UNUSED *class,
 
     na_ofi_addr = (struct na_ofi_addr *)na_ofi_op_id->noo_addr;
 
-    ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, ret);
+    ret = na_ofi_complete_batch(na_ofi_addr, na_ofi_op_id, ret, batch);
     if (ret != NA_SUCCESS)
         NA_LOG_ERROR("Unable to complete send");
 
     return;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_resolve_src_addrs(na_class_t *na_class,
+    struct fi_cq_tagged_entry *cq_event, fi_addr_t *src_addr, ssize_t event_num)
+{
+    struct na_ofi_domain *domain = NA_OFI_PRIVATE_DATA(na_class)->nop_domain;
+    ssize_t i;
+
+    /* Look up source addresses of all unexpected messages under a single
+     * read lock, addresses that are not yet known are left to
+     * na_ofi_handle_recv_event() */
+    hg_thread_rwlock_rdlock(&domain->nod_rwlock);
+    for (i = 0; i < event_num; i++) {
+        struct na_ofi_op_id *na_ofi_op_id;
+        struct na_ofi_reqhdr *reqhdr;
+        na_uint64_t addr_key;
+        fi_addr_t *fi_addr;
+
+        src_addr[i] = FI_ADDR_UNSPEC;
+        if (!(cq_event[i].flags & FI_RECV)
+            || (cq_event[i].tag & ~NA_OFI_UNEXPECTED_TAG_IGNORE))
+            continue;
+
+        na_ofi_op_id = container_of(cq_event[i].op_context,
+            struct na_ofi_op_id, noo_fi_ctx);
+        if (!na_ofi_op_id_valid(na_ofi_op_id)
+            || na_ofi_op_id->noo_type != NA_CB_RECV_UNEXPECTED)
+            continue;
+
+        reqhdr = na_ofi_op_id->noo_info.noo_recv_unexpected.noi_buf;
+        if (na_ofi_reqhdr_decode(reqhdr) != NA_SUCCESS)
+            continue;
+
+        addr_key = na_ofi_reqhdr_2_key(reqhdr);
+        fi_addr = hg_hash_table_lookup(domain->nod_addr_ht, &addr_key);
+        if (fi_addr != HG_HASH_TABLE_NULL)
+            src_addr[i] = *fi_addr;
+    }
+    hg_thread_rwlock_release_rdlock(&domain->nod_rwlock);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_ofi_cq_batch_adapt(struct na_ofi_context *ctx, size_t cq_batch,
+    size_t event_num)
+{
+    size_t new_batch = cq_batch;
+#ifdef NA_OFI_HAS_COLLECT_STATS
+    hg_util_int32_t batch_max;
+#endif
+
+    /* Read larger batches when reads are saturated and shrink back once the
+     * load drops, so that completions are not held back behind a large batch
+     * when only a few events are available */
+    if (event_num == cq_batch) {
+        if (cq_batch < NA_OFI_CQ_MAX_EVENT_NUM)
+            new_batch = cq_batch << 1;
+    } else if (event_num < (cq_batch >> 2) && cq_batch > NA_OFI_CQ_EVENT_NUM)
+        new_batch = cq_batch >> 1;
+    if (new_batch == cq_batch)
+        return;
+
+    /* Leave batch size unchanged if concurrent progress already adapted it */
+    if (!hg_atomic_cas32(&ctx->noc_cq_batch, (hg_util_int32_t) cq_batch,
+        (hg_util_int32_t) new_batch))
+        return;
+
+#ifdef NA_OFI_HAS_COLLECT_STATS
+    do {
+        batch_max = hg_atomic_get32(&ctx->noc_cq_batch_max);
+        if ((hg_util_int32_t) new_batch <= batch_max)
+            break;
+    } while (!hg_atomic_cas32(&ctx->noc_cq_batch_max, batch_max,
+        (hg_util_int32_t) new_batch));
+#endif
+}
+
 /*---------------------------------------------------------------------------*/
 static int
 na_ofi_poll_get_fd(na_class_t *na_class, na_context_t *context)
@@ -3943,6 +4453,12 @@ na_ofi_poll_get_fd(na_class_t *na_class, na_context_t *context)
     if (priv->no_wait)
         goto out;
 
+    /* Stripe CQ fds are folded with the main CQ fd into a single poll set */
+    if (priv->nop_endpoint->noe_poll_set) {
+        fd = hg_poll_get_fd(priv->nop_endpoint->noe_poll_set);
+        goto out;
+    }
+
     rc = fi_control(&ctx->noc_cq->fid, FI_GETWAIT, &fd);
     if (rc == -FI_ENOSYS) {
         NA_LOG_WARNING("%s provider does not support retrieval of wait objects",
@@ -3961,13 +4477,19 @@ na_ofi_poll_try_wait(na_class_t *na_class, na_context_t *context)
 {
     struct na_ofi_private_data *priv = NA_OFI_PRIVATE_DATA(na_class);
     struct na_ofi_context *ctx = NA_OFI_CONTEXT(context);
-    struct fid *fids[1];
+    struct na_ofi_endpoint *endpoint = priv->nop_endpoint;
+    struct fid *fids[1 + NA_OFI_RMA_STRIPE_MAX];
+    int count = 0, i;
 
     if (priv->no_wait)
         return NA_TRUE;
 
-    fids[0] = &ctx->noc_cq->fid;
-    return (fi_trywait(priv->nop_domain->nod_fabric, fids, 1) == FI_SUCCESS);
+    fids[count++] = &ctx->noc_cq->fid;
+    for (i = 0; i < endpoint->noe_stripe_count; i++)
+        fids[count++] = &endpoint->noe_stripes[i].nos_cq->fid;
+
+    return (fi_trywait(priv->nop_domain->nod_fabric, fids, count)
+        == FI_SUCCESS);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -3983,8 +4505,10 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
     na_return_t ret = NA_TIMEOUT;
 
     do {
-        struct fi_cq_tagged_entry cq_event[NA_OFI_CQ_EVENT_NUM];
-        fi_addr_t src_addr[NA_OFI_CQ_EVENT_NUM] = {FI_ADDR_UNSPEC};
+        struct fi_cq_tagged_entry cq_event[NA_OFI_CQ_MAX_EVENT_NUM];
+        fi_addr_t src_addr[NA_OFI_CQ_MAX_EVENT_NUM];
+        struct na_ofi_completion_batch completion_batch;
+        size_t cq_batch = (size_t) hg_atomic_get32(&ctx->noc_cq_batch);
         ssize_t rc, i, event_num = 0;
         hg_time_t t1, t2;
 
@@ -3993,6 +4517,7 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
 
             hg_time_get_current(&t1);
 
+            /* Stripe CQs share the wait set of the main CQ */
             if (wait_hdl) {
                 int rc_wait = fi_wait(wait_hdl, (int) (remaining * 1000.0));
                 if (rc_wait == -FI_ETIMEDOUT)
@@ -4006,13 +4531,36 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
             }
         }
 
+        /* Retire completed chunks of striped RMA operations */
+        if (hg_atomic_get32(&priv->nop_stripe_ops)) {
+            unsigned int stripe_count = 0;
+            na_return_t stripe_ret;
+
+            stripe_ret = na_ofi_stripes_progress(na_class, &stripe_count);
+            if (stripe_ret != NA_SUCCESS) {
+                ret = stripe_ret;
+                break;
+            }
+            if (stripe_count)
+                ret = NA_SUCCESS;
+        }
+
         na_ofi_class_lock(na_class);
         if (na_ofi_with_reqhdr(na_class) == NA_FALSE) {
-            rc = fi_cq_readfrom(cq_hdl, cq_event, NA_OFI_CQ_EVENT_NUM,
-                                src_addr);
+            rc = fi_cq_readfrom(cq_hdl, cq_event, cq_batch, src_addr);
         } else
-            rc = fi_cq_read(cq_hdl, cq_event, NA_OFI_CQ_EVENT_NUM);
+            rc = fi_cq_read(cq_hdl, cq_event, cq_batch);
         na_ofi_class_unlock(na_class);
+#ifdef NA_OFI_HAS_COLLECT_STATS
+        hg_atomic_incr64(&ctx->noc_cq_reads);
+        if (rc == -FI_EAGAIN)
+            hg_atomic_incr64(&ctx->noc_cq_empty_reads);
+        else if (rc > 0) {
+            na_ofi_stats_add(&ctx->noc_cq_events, (hg_util_int64_t) rc);
+            if ((size_t) rc == cq_batch)
+                hg_atomic_incr64(&ctx->noc_cq_full_reads);
+        }
+#endif
         if (rc == -FI_EAGAIN) {
             if (timeout) {
                 hg_time_get_current(&t2);
@@ -4095,11 +4643,19 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
         } else {
             assert(rc > 0);
             event_num = rc;
+            na_ofi_cq_batch_adapt(ctx, cq_batch, (size_t) rc);
         }
 
         /* got at least one completion event */
         assert(event_num >= 1);
         ret = NA_SUCCESS;
+
+        /* Resolve source addresses for the whole batch */
+        if (na_ofi_with_reqhdr(na_class))
+            na_ofi_resolve_src_addrs(na_class, cq_event, src_addr, event_num);
+
+        completion_batch.nocb_context = context;
+        completion_batch.nocb_count = 0;
         for (i = 0; i < event_num; i++) {
             /*
             NA_LOG_ERROR("got cq event[%d/%d] flags: 0x%x, src_addr %d.",
@@ -4109,17 +4665,19 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
             case FI_SEND | FI_TAGGED:
             case FI_SEND | FI_MSG:
             case FI_SEND | FI_TAGGED | FI_MSG:
-                na_ofi_handle_send_event(na_class, context, &cq_event[i]);
+                na_ofi_handle_send_event(na_class, context, &cq_event[i],
+                                         &completion_batch);
                 break;
             case FI_RECV | FI_TAGGED:
             case FI_RECV | FI_MSG:
             case FI_RECV | FI_TAGGED | FI_MSG:
                 na_ofi_handle_recv_event(na_class, context, src_addr[i],
-                                         &cq_event[i]);
+                                         &cq_event[i], &completion_batch);
                 break;
             case FI_READ | FI_RMA:
             case FI_WRITE | FI_RMA:
-                na_ofi_handle_rma_event(na_class, context, &cq_event[i]);
+                na_ofi_handle_rma_event(na_class, context, &cq_event[i],
+                                        &completion_batch);
                 break;
             default:
                 NA_LOG_DEBUG("bad cq event[%d/%d] flags: 0x%x, src_addr %d.",
@@ -4128,15 +4686,220 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
             };
         }
 
+        /* Hand over completions of the batch at once */
+        if (na_cb_completion_add_batch(context, completion_batch.nocb_entries,
+            completion_batch.nocb_count) != NA_SUCCESS)
+            NA_LOG_ERROR("Could not add callbacks to completion queue");
+
     } while (remaining > 0 && ret != NA_SUCCESS);
 
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_stripes_progress(na_class_t *na_class, unsigned int *count_p)
+{
+    struct na_ofi_endpoint *endpoint =
+        NA_OFI_PRIVATE_DATA(na_class)->nop_endpoint;
+    unsigned int count = 0;
+    na_return_t ret = NA_SUCCESS;
+    na_uint8_t i;
+
+    for (i = 0; i < endpoint->noe_stripe_count; i++) {
+        struct fid_cq *cq_hdl = endpoint->noe_stripes[i].nos_cq;
+        struct fi_cq_tagged_entry cq_event[NA_OFI_CQ_EVENT_NUM];
+        struct na_ofi_rma_chunk *chunk;
+        ssize_t rc, j;
+
+        na_ofi_class_lock(na_class);
+        rc = fi_cq_read(cq_hdl, cq_event, NA_OFI_CQ_EVENT_NUM);
+        na_ofi_class_unlock(na_class);
+        if (rc == -FI_EAGAIN)
+            continue;
+        else if (rc == -FI_EAVAIL) {
+            struct fi_cq_err_entry cq_err;
+
+            memset(&cq_err, 0, sizeof(cq_err));
+
+            na_ofi_class_lock(na_class);
+            rc = fi_cq_readerr(cq_hdl, &cq_err, 0 /* flags */);
+            na_ofi_class_unlock(na_class);
+            if (rc != 1) {
+                NA_LOG_ERROR("fi_cq_readerr() failed, rc: %d(%s).",
+                             rc, fi_strerror((int) -rc));
+                ret = NA_PROTOCOL_ERROR;
+                goto out;
+            }
+            if (cq_err.err != FI_ECANCELED)
+                NA_LOG_ERROR("fi_cq_readerr got err: %d(%s), "
+                             "prov_errno: %d(%s).",
+                             cq_err.err, fi_strerror(cq_err.err),
+                             cq_err.prov_errno,
+                             fi_strerror(-cq_err.prov_errno));
+            chunk = (struct na_ofi_rma_chunk *) cq_err.op_context;
+            na_ofi_rma_chunk_complete(na_class, chunk->nrc_op_id,
+                (cq_err.err == FI_ECANCELED) ? NA_CANCELED :
+                    NA_PROTOCOL_ERROR);
+            count++;
+            continue;
+        } else if (rc <= 0) {
+            NA_LOG_ERROR("fi_cq_read() failed, rc: %d(%s).",
+                         rc, fi_strerror((int) -rc));
+            ret = NA_PROTOCOL_ERROR;
+            goto out;
+        }
+
+        for (j = 0; j < rc; j++) {
+            chunk = (struct na_ofi_rma_chunk *) cq_event[j].op_context;
+            na_ofi_rma_chunk_complete(na_class, chunk->nrc_op_id, NA_SUCCESS);
+        }
+        count += (unsigned int) rc;
+    }
+
+out:
+    if (count_p)
+        *count_p = count;
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_rma_stripe_post(na_class_t *na_class, struct na_ofi_op_id *na_ofi_op_id,
+    na_bool_t put, char *local_base, void *local_desc, na_uint64_t remote_base,
+    na_uint64_t rma_key, fi_addr_t fi_addr, na_size_t length)
+{
+    struct na_ofi_private_data *priv = NA_OFI_PRIVATE_DATA(na_class);
+    struct na_ofi_endpoint *endpoint = priv->nop_endpoint;
+    na_size_t chunk_count =
+        (length + NA_OFI_RMA_STRIPE_SIZE - 1) / NA_OFI_RMA_STRIPE_SIZE;
+    na_size_t i, offset = 0;
+    na_return_t ret = NA_SUCCESS;
+    ssize_t rc = 0;
+
+    if (hg_atomic_get32(&na_ofi_op_id->noo_chunks_pending)) {
+        NA_LOG_ERROR("Operation ID still has RMA chunks in flight");
+        ret = NA_PROTOCOL_ERROR;
+        goto out;
+    }
+
+    /* Chunk array is kept with the op ID so that it can be reused */
+    if (na_ofi_op_id->noo_chunk_count < chunk_count) {
+        struct na_ofi_rma_chunk *chunks = (struct na_ofi_rma_chunk *) realloc(
+            na_ofi_op_id->noo_chunks,
+            chunk_count * sizeof(struct na_ofi_rma_chunk));
+        if (!chunks) {
+            NA_LOG_ERROR("Could not allocate RMA chunks");
+            ret = NA_NOMEM_ERROR;
+            goto out;
+        }
+        na_ofi_op_id->noo_chunks = chunks;
+        na_ofi_op_id->noo_chunk_count = chunk_count;
+    }
+
+    /* Keep a reference on the op ID until all chunks are retired, the op may
+     * complete earlier if it is canceled */
+    na_ofi_op_id->noo_chunk_ret = NA_SUCCESS;
+    na_ofi_op_id->noo_chunk_posted = 0;
+    hg_atomic_set32(&na_ofi_op_id->noo_chunks_pending,
+        (hg_util_int32_t) chunk_count);
+    na_ofi_op_id_addref(na_ofi_op_id);
+    hg_atomic_incr32(&priv->nop_stripe_ops);
+
+    for (i = 0; i < chunk_count; i++) {
+        struct na_ofi_rma_chunk *chunk = &na_ofi_op_id->noo_chunks[i];
+        hg_util_int32_t next = hg_atomic_incr32(&priv->nop_stripe_next);
+        struct iovec iov;
+
+        chunk->nrc_op_id = na_ofi_op_id;
+        chunk->nrc_ep = endpoint->noe_stripes[
+            (na_uint32_t) next % endpoint->noe_stripe_count].nos_ep;
+        iov.iov_base = local_base + offset;
+        iov.iov_len = ((length - offset) < NA_OFI_RMA_STRIPE_SIZE) ?
+            (length - offset) : NA_OFI_RMA_STRIPE_SIZE;
+
+        do {
+            na_ofi_class_lock(na_class);
+            if (put)
+                rc = fi_writev(chunk->nrc_ep, &iov, &local_desc, 1 /* count */,
+                    fi_addr, remote_base + offset, rma_key,
+                    &chunk->nrc_fi_ctx);
+            else
+                rc = fi_readv(chunk->nrc_ep, &iov, &local_desc, 1 /* count */,
+                    fi_addr, remote_base + offset, rma_key,
+                    &chunk->nrc_fi_ctx);
+            na_ofi_class_unlock(na_class);
+            /* for EAGAIN, progress stripes and do it again */
+            if (rc == -FI_EAGAIN)
+                na_ofi_stripes_progress(na_class, NULL);
+            else
+                break;
+        } while (1);
+        if (rc) {
+            NA_LOG_ERROR("%s() with %s failed, rc: %d(%s)",
+                put ? "fi_writev" : "fi_readv",
+                ((struct na_ofi_addr *) na_ofi_op_id->noo_addr)->noa_uri, rc,
+                fi_strerror((int) -rc));
+            break;
+        }
+        offset += iov.iov_len;
+        na_ofi_op_id->noo_chunk_posted++;
+    }
+
+    if (i == 0) {
+        /* Nothing was posted, let the caller fail the operation */
+        hg_atomic_set32(&na_ofi_op_id->noo_chunks_pending, 0);
+        hg_atomic_decr32(&priv->nop_stripe_ops);
+        na_ofi_op_id_decref(na_ofi_op_id);
+        ret = NA_PROTOCOL_ERROR;
+    } else {
+        /* Retire chunks that could not be posted, the operation completes
+         * with an error once the posted ones are retired */
+        for (; i < chunk_count; i++)
+            na_ofi_rma_chunk_complete(na_class, na_ofi_op_id,
+                NA_PROTOCOL_ERROR);
+    }
+
+out:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_rma_chunk_complete(na_class_t *na_class,
+    struct na_ofi_op_id *na_ofi_op_id, na_return_t chunk_ret)
+{
+    if (chunk_ret != NA_SUCCESS)
+        na_ofi_op_id->noo_chunk_ret = chunk_ret;
+
+    /* Wait for remaining chunks */
+    if (hg_atomic_decr32(&na_ofi_op_id->noo_chunks_pending))
+        return;
+
+    hg_atomic_decr32(&NA_OFI_PRIVATE_DATA(na_class)->nop_stripe_ops);
+
+    /* Operation may have already been completed by na_ofi_cancel() */
+    if (!hg_atomic_get32(&na_ofi_op_id->noo_completed))
+        na_ofi_complete(na_ofi_op_id->noo_addr, na_ofi_op_id,
+            na_ofi_op_id->noo_chunk_ret);
+
+    /* Release reference taken in na_ofi_rma_stripe_post() */
+    na_ofi_op_id_decref(na_ofi_op_id);
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_complete(struct na_ofi_addr *na_ofi_addr,
     struct na_ofi_op_id *na_ofi_op_id, na_return_t op_ret)
+{
+    return na_ofi_complete_batch(na_ofi_addr, na_ofi_op_id, op_ret, NULL);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_complete_batch(struct na_ofi_addr *na_ofi_addr,
+    struct na_ofi_op_id *na_ofi_op_id, na_return_t op_ret,
+    struct na_ofi_completion_batch *batch)
 {
     struct na_cb_info *callback_info = NULL;
     na_return_t ret = NA_SUCCESS;
@@ -4193,6 +4956,14 @@ na_ofi_complete(struct na_ofi_addr *na_ofi_addr,
     na_ofi_op_id->noo_completion_data.plugin_callback = na_ofi_release;
     na_ofi_op_id->noo_completion_data.plugin_callback_args = na_ofi_op_id;
 
+    /* Defer to batch if completion goes to the same completion queue */
+    if (batch && batch->nocb_context == na_ofi_op_id->noo_context
+        && batch->nocb_count < NA_OFI_CQ_MAX_EVENT_NUM) {
+        batch->nocb_entries[batch->nocb_count++] =
+            &na_ofi_op_id->noo_completion_data;
+        goto out;
+    }
+
     ret = na_cb_completion_add(na_ofi_op_id->noo_context,
        &na_ofi_op_id->noo_completion_data);
     if (ret != NA_SUCCESS) {
@@ -4290,10 +5061,30 @@ na_ofi_cancel(na_class_t *na_class, na_context_t *context,
         na_ofi_addr = (struct na_ofi_addr *)na_ofi_op_id->noo_addr;
         ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, NA_CANCELED);
         break;
-    case NA_CB_SEND_UNEXPECTED:
-    case NA_CB_SEND_EXPECTED:
     case NA_CB_PUT:
     case NA_CB_GET:
+        /* Striped RMA, cancel chunks on their own stripe endpoint */
+        if (hg_atomic_get32(&na_ofi_op_id->noo_chunks_pending)) {
+            na_size_t i;
+
+            for (i = 0; i < na_ofi_op_id->noo_chunk_posted; i++) {
+                struct na_ofi_rma_chunk *chunk = &na_ofi_op_id->noo_chunks[i];
+
+                na_ofi_class_lock(na_class);
+                rc = fi_cancel(&chunk->nrc_ep->fid, &chunk->nrc_fi_ctx);
+                na_ofi_class_unlock(na_class);
+                if (rc != 0)
+                    NA_LOG_DEBUG("fi_cancel RMA chunk failed, rc: %d(%s).",
+                                 rc, fi_strerror((int) -rc));
+            }
+
+            na_ofi_addr = (struct na_ofi_addr *)na_ofi_op_id->noo_addr;
+            ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, NA_CANCELED);
+            break;
+        }
+        /* Fall through */
+    case NA_CB_SEND_UNEXPECTED:
+    case NA_CB_SEND_EXPECTED:
         ep_hdl = ctx->noc_tx;
         na_ofi_class_lock(na_class);
         rc = fi_cancel(&ep_hdl->fid, &na_ofi_op_id->noo_fi_ctx);
@@ -45,7 +45,6 @@ struct na_cb_completion_data {
     na_plugin_cb_t plugin_callback;     /* Callback which will be called after
                                          * the user callback returns. */
     void *plugin_callback_args;         /* Argument to plugin_callback */
-    HG_QUEUE_ENTRY(na_cb_completion_data) entry; /* Completion queue entry */
 };
 
 /* NA class definition */
@@ -83,6 +82,12 @@ struct na_class {
             na_class_t *na_class,
             void *plugin_context
             );
+    na_return_t
+    (*context_get_stats)(
+            na_class_t *na_class,
+            na_context_t *context,
+            struct na_context_stats *stats
+            );
     na_op_id_t
     (*op_create)(
             na_class_t *na_class
@@ -389,6 +394,24 @@ na_cb_completion_add(
         struct na_cb_completion_data *na_cb_completion_data
         );
 
+/**
+ * Add a batch of callbacks to context completion queue. Slots for the whole
+ * batch are reserved at once in the completion queue and threads waiting in
+ * NA_Trigger() are signaled only once.
+ *
+ * \param context [IN/OUT]              pointer to context of execution
+ * \param na_cb_completion_data [IN]    array of pointers to completion data
+ * \param count [IN]                    number of entries in array
+ *
+ * \return NA_SUCCESS or corresponding NA error code (failure is not an option)
+ */
+NA_EXPORT na_return_t
+na_cb_completion_add_batch(
+        na_context_t                 *context,
+        struct na_cb_completion_data *na_cb_completion_data[],
+        unsigned int                  count
+        );
+
 #ifdef __cplusplus
 }
 #endif
@@ -886,6 +886,7 @@ const na_class_t na_sm_class_g = {
     na_sm_cleanup,                          /* cleanup */
     NULL,                                   /* context_create */
     NULL,                                   /* context_destroy */
+    NULL,                                   /* context_get_stats */
     na_sm_op_create,                        /* op_create */
     na_sm_op_destroy,                       /* op_destroy */
     na_sm_addr_lookup,                      /* addr_lookup */
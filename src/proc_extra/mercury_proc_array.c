@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_proc_array.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(HG_HAS_XDR) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+# define HG_PROC_ARRAY_HAS_SSSE3
+# include <tmmintrin.h>
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+
+#ifdef HG_HAS_XDR
+/* XDR encodes big-endian data in units of 4 bytes */
+# define HG_PROC_ARRAY_PAD(size) \
+    (((size) + BYTES_PER_XDR_UNIT - 1) & ~((hg_size_t) BYTES_PER_XDR_UNIT - 1))
+#else
+# define HG_PROC_ARRAY_PAD(size) (size)
+#endif
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Check whether elements must be byte-swapped to and from the buffer.
+ */
+static HG_INLINE hg_bool_t
+hg_proc_array_swap(
+        size_t elem_size
+        );
+
+/**
+ * Copy count elements of elem_size bytes, byte-swapping them if swap is set.
+ */
+static void
+hg_proc_array_copy(
+        void *dest,
+        const void *src,
+        size_t count,
+        size_t elem_size,
+        hg_bool_t swap
+        );
+
+#ifdef HG_PROC_ARRAY_HAS_SSSE3
+/**
+ * Byte-swap elements sixteen bytes at a time, returns number of elements
+ * swapped.
+ */
+static size_t
+hg_proc_array_bswap_ssse3(
+        void *dest,
+        const void *src,
+        size_t count,
+        size_t elem_size
+        );
+#endif
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_proc_array_swap(size_t elem_size)
+{
+#ifdef HG_HAS_XDR
+    const hg_uint16_t one = 1;
+
+    /* Little-endian hosts must swap */
+    return (elem_size > 1 && *(const hg_uint8_t *) &one) ? HG_TRUE : HG_FALSE;
+#elif defined(HG_BIG_ENDIAN)
+    /* Elements are encoded little-endian */
+    return (elem_size > 1) ? HG_TRUE : HG_FALSE;
+#else
+    /* Elements are encoded in host order */
+    (void) elem_size;
+    return HG_FALSE;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+#ifdef HG_PROC_ARRAY_HAS_SSSE3
+__attribute__((target("ssse3")))
+static size_t
+hg_proc_array_bswap_ssse3(void *dest, const void *src, size_t count,
+    size_t elem_size)
+{
+    char *dest_ptr = (char *) dest;
+    const char *src_ptr = (const char *) src;
+    size_t size = count * elem_size, i;
+    __m128i mask;
+
+    switch (elem_size) {
+        case 2:
+            mask = _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3,
+                0, 1);
+            break;
+        case 4:
+            mask = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1,
+                2, 3);
+            break;
+        case 8:
+            mask = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5,
+                6, 7);
+            break;
+        default:
+            return 0;
+    }
+
+    for (i = 0; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (src_ptr + i));
+
+        _mm_storeu_si128((__m128i *) (dest_ptr + i),
+            _mm_shuffle_epi8(v, mask));
+    }
+
+    return i / elem_size;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_proc_array_copy(void *dest, const void *src, size_t count,
+    size_t elem_size, hg_bool_t swap)
+{
+    char *dest_ptr = (char *) dest;
+    const char *src_ptr = (const char *) src;
+    size_t i = 0;
+
+    if (!swap) {
+        memcpy(dest, src, count * elem_size);
+        return;
+    }
+
+#ifdef HG_PROC_ARRAY_HAS_SSSE3
+    if (__builtin_cpu_supports("ssse3"))
+        i = hg_proc_array_bswap_ssse3(dest, src, count, elem_size);
+#endif
+
+    /* Remaining elements */
+    for (; i < count; i++) {
+        const char *from = src_ptr + i * elem_size;
+        char *to = dest_ptr + i * elem_size;
+        size_t j;
+
+        for (j = 0; j < elem_size; j++)
+            to[j] = from[elem_size - 1 - j];
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_array(hg_proc_t proc, hg_uint64_t *count, void **data,
+    hg_bool_t *borrowed, size_t elem_size)
+{
+    hg_proc_op_t op = hg_proc_get_op(proc);
+    hg_size_t size;
+    void *buf;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (op == HG_FREE) {
+        if (!*borrowed)
+            free(*data);
+        *data = NULL;
+        *borrowed = HG_FALSE;
+        goto done;
+    }
+
+    /* Element count */
+    ret = hg_proc_uint64_t(proc, count);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Proc error");
+        goto done;
+    }
+    size = *count * elem_size;
+    if (size / elem_size != *count) {
+        HG_LOG_ERROR("Array of %llu elements is too large",
+            (unsigned long long) *count);
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+    if (op == HG_DECODE) {
+        *borrowed = HG_FALSE;
+        if (!size) {
+            *data = NULL;
+            goto done;
+        }
+        if (HG_PROC_ARRAY_PAD(size) > hg_proc_get_size_left(proc)) {
+            HG_LOG_ERROR("Array exceeds buffer size");
+            ret = HG_SIZE_ERROR;
+            goto done;
+        }
+    } else if (!size)
+        goto done;
+
+    /* Elements, all at once */
+    buf = hg_proc_save_ptr(proc, HG_PROC_ARRAY_PAD(size));
+    switch (op) {
+        case HG_ENCODE:
+            if (!buf) {
+                HG_LOG_ERROR("Could not reserve buffer space");
+                ret = HG_NOMEM_ERROR;
+                goto done;
+            }
+            hg_proc_array_copy(buf, *data, (size_t) *count, elem_size,
+                hg_proc_array_swap(elem_size));
+            memset((char *) buf + size, 0,
+                (size_t) (HG_PROC_ARRAY_PAD(size) - size));
+            break;
+        case HG_DECODE:
+            if (hg_proc_get_array_borrow(proc)
+                && !hg_proc_array_swap(elem_size)
+                && !((size_t) buf & (elem_size - 1))) {
+                *data = buf;
+                *borrowed = HG_TRUE;
+                break;
+            }
+            *data = malloc((size_t) size);
+            if (!*data) {
+                HG_LOG_ERROR("Could not allocate array");
+                ret = HG_NOMEM_ERROR;
+                goto done;
+            }
+            hg_proc_array_copy(*data, buf, (size_t) *count, elem_size,
+                hg_proc_array_swap(elem_size));
+            break;
+        default:
+            /* HG_SIZE only reserves space */
+            break;
+    }
+
+done:
+    return ret;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_PROC_ARRAY_H
+#define MERCURY_PROC_ARRAY_H
+
+#include "mercury_proc.h"
+
+/**
+ * Arrays of fixed-width elements, encoded as a 64-bit element count followed
+ * by the elements. Decoded arrays are allocated and released on HG_FREE,
+ * unless hg_proc_set_array_borrow() was set, in which case they may point
+ * into the processed buffer (borrowed is then set).
+ */
+#define HG_PROC_ARRAY_TYPEDEF(name, type)   \
+typedef struct {                            \
+    hg_uint64_t count;                      \
+    type *      data;                       \
+    hg_bool_t   borrowed;                   \
+} name
+
+HG_PROC_ARRAY_TYPEDEF(hg_array_uint8_t, hg_uint8_t);
+HG_PROC_ARRAY_TYPEDEF(hg_array_uint16_t, hg_uint16_t);
+HG_PROC_ARRAY_TYPEDEF(hg_array_uint32_t, hg_uint32_t);
+HG_PROC_ARRAY_TYPEDEF(hg_array_uint64_t, hg_uint64_t);
+HG_PROC_ARRAY_TYPEDEF(hg_array_float_t, float);
+HG_PROC_ARRAY_TYPEDEF(hg_array_double_t, double);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Process an array of count elements of elem_size bytes. Elements are
+ * copied with a single copy, and byte-swapped if the encoding requires it
+ * (XDR on little-endian hosts, generic encoding on big-endian hosts).
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param count [IN/OUT]        pointer to number of elements
+ * \param data [IN/OUT]         pointer to elements
+ * \param borrowed [IN/OUT]     pointer to boolean, set if decoded elements
+ *                              point into the processed buffer
+ * \param elem_size [IN]        element size (1, 2, 4 or 8)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+hg_proc_array(
+        hg_proc_t proc,
+        hg_uint64_t *count,
+        void **data,
+        hg_bool_t *borrowed,
+        size_t elem_size
+        );
+
+/* Generate proc for array type */
+#define HG_PROC_ARRAY(name, type)                                           \
+static HG_INLINE hg_return_t                                                \
+hg_proc_ ## name(hg_proc_t proc, void *data)                                \
+{                                                                           \
+    name *array = (name *) data;                                            \
+    void *array_data = array->data;                                         \
+    hg_return_t ret;                                                        \
+                                                                            \
+    ret = hg_proc_array(proc, &array->count, &array_data, &array->borrowed, \
+        sizeof(type));                                                      \
+    array->data = (type *) array_data;                                      \
+                                                                            \
+    return ret;                                                             \
+}
+
+/**
+ * Generic processing routines.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to array
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PROC_ARRAY(hg_array_uint8_t, hg_uint8_t)
+HG_PROC_ARRAY(hg_array_uint16_t, hg_uint16_t)
+HG_PROC_ARRAY(hg_array_uint32_t, hg_uint32_t)
+HG_PROC_ARRAY(hg_array_uint64_t, hg_uint64_t)
+HG_PROC_ARRAY(hg_array_float_t, float)
+HG_PROC_ARRAY(hg_array_double_t, double)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_PROC_ARRAY_H */
@@ -19,6 +19,25 @@
 typedef const char * hg_const_string_t;
 typedef char * hg_string_t;
 
+/* Inline storage of small strings, including terminating null character */
+#ifndef HG_SMALL_STRING_SIZE
+# define HG_SMALL_STRING_SIZE 64
+#endif
+
+/**
+ * String encoded as hg_string_t but decoded without malloc: strings of up to
+ * HG_SMALL_STRING_SIZE bytes are copied into buf, longer strings point into
+ * the processed buffer if hg_proc_set_array_borrow() was set or are
+ * allocated with hg_proc_arena_alloc(). Decoded strings are therefore only
+ * valid until the input or output is freed. Use hg_small_string_get() /
+ * hg_small_string_set() to access the string.
+ */
+typedef struct hg_small_string {
+    const char *data;                   /* String, if not stored inline */
+    hg_bool_t   is_inline;              /* String is stored in buf */
+    char        buf[HG_SMALL_STRING_SIZE];
+} hg_small_string_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -32,6 +51,35 @@ static HG_INLINE hg_return_t hg_proc_hg_string_t(
         hg_proc_t proc, void *data);
 static HG_INLINE hg_return_t hg_proc_hg_string_object_t(
         hg_proc_t proc, void *data);
+static HG_INLINE hg_return_t hg_proc_hg_small_string_t(
+        hg_proc_t proc, void *data);
+
+/**
+ * Get string of small string, NULL if not set.
+ *
+ * \param string [IN]           pointer to small string
+ *
+ * \return Pointer to string
+ */
+static HG_INLINE const char *
+hg_small_string_get(const hg_small_string_t *string)
+{
+    return string->is_inline ? string->buf : string->data;
+}
+
+/**
+ * Set small string to point to s, which is not copied and must remain valid
+ * while the small string is used.
+ *
+ * \param string [OUT]          pointer to small string
+ * \param s [IN]                pointer to string
+ */
+static HG_INLINE void
+hg_small_string_set(hg_small_string_t *string, const char *s)
+{
+    string->data = s;
+    string->is_inline = HG_FALSE;
+}
 
 /**
  * Generic processing routine.
@@ -50,6 +98,7 @@ hg_proc_hg_const_string_t(hg_proc_t proc, void *data)
 
     switch (hg_proc_get_op(proc)) {
         case HG_ENCODE:
+        case HG_SIZE:
             hg_string_object_init_const_char(&string, *strdata, 0);
             ret = hg_proc_hg_string_object_t(proc, &string);
             if (ret != HG_SUCCESS) {
@@ -100,6 +149,7 @@ hg_proc_hg_string_t(hg_proc_t proc, void *data)
 
     switch (hg_proc_get_op(proc)) {
         case HG_ENCODE:
+        case HG_SIZE:
             hg_string_object_init_char(&string, *strdata, 0);
             ret = hg_proc_hg_string_object_t(proc, &string);
             if (ret != HG_SUCCESS) {
@@ -150,6 +200,7 @@ hg_proc_hg_string_object_t(hg_proc_t proc, void *string)
 
     switch (hg_proc_get_op(proc)) {
         case HG_ENCODE:
+        case HG_SIZE:
             string_len = (strobj->data) ? strlen(strobj->data) + 1 : 0;
             ret = hg_proc_uint64_t(proc, &string_len);
             if (ret != HG_SUCCESS) {
@@ -216,6 +267,113 @@ done:
     return ret;
 }
 
+/**
+ * Generic processing routine.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to small string
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+hg_proc_hg_small_string_t(hg_proc_t proc, void *data)
+{
+    hg_small_string_t *string = (hg_small_string_t *) data;
+    const char *s;
+    char *buf;
+    hg_bool_t borrowed = HG_FALSE;
+    hg_uint64_t string_len = 0;
+    /* Same flags as hg_const_string_t, ignored on decode */
+    hg_uint8_t is_const = 1, is_owned = 0;
+    hg_return_t ret = HG_SUCCESS;
+
+    switch (hg_proc_get_op(proc)) {
+        case HG_ENCODE:
+        case HG_SIZE:
+            s = hg_small_string_get(string);
+            string_len = (s) ? strlen(s) + 1 : 0;
+            ret = hg_proc_uint64_t(proc, &string_len);
+            if (ret != HG_SUCCESS) {
+                HG_LOG_ERROR("Proc error");
+                goto done;
+            }
+            if (!string_len)
+                break;
+            ret = hg_proc_raw(proc, (void *) s, string_len);
+            if (ret != HG_SUCCESS) {
+                HG_LOG_ERROR("Proc error");
+                goto done;
+            }
+            break;
+        case HG_DECODE:
+            hg_small_string_set(string, NULL);
+            ret = hg_proc_uint64_t(proc, &string_len);
+            if (ret != HG_SUCCESS) {
+                HG_LOG_ERROR("Proc error");
+                goto done;
+            }
+            if (!string_len)
+                break;
+            if (string_len > hg_proc_get_size_left(proc)) {
+                HG_LOG_ERROR("String exceeds buffer size");
+                ret = HG_SIZE_ERROR;
+                goto done;
+            }
+            if (string_len <= HG_SMALL_STRING_SIZE) {
+                buf = string->buf;
+                string->is_inline = HG_TRUE;
+            } else if (hg_proc_get_array_borrow(proc)) {
+                buf = (char *) hg_proc_save_ptr(proc, string_len);
+                string->data = buf;
+                borrowed = HG_TRUE;
+            } else {
+                buf = (char *) hg_proc_arena_alloc(proc, string_len);
+                if (!buf) {
+                    HG_LOG_ERROR("Could not allocate string");
+                    ret = HG_NOMEM_ERROR;
+                    goto done;
+                }
+                string->data = buf;
+            }
+            if (!borrowed) {
+                ret = hg_proc_raw(proc, buf, string_len);
+                if (ret != HG_SUCCESS) {
+                    HG_LOG_ERROR("Proc error");
+                    goto done;
+                }
+            }
+            if (buf[string_len - 1] != '\0') {
+                HG_LOG_ERROR("String is not null-terminated");
+                hg_small_string_set(string, NULL);
+                ret = HG_PROTOCOL_ERROR;
+                goto done;
+            }
+            break;
+        case HG_FREE:
+            /* Memory is released with the proc */
+            hg_small_string_set(string, NULL);
+            goto done;
+        default:
+            goto done;
+    }
+
+    if (string_len) {
+        ret = hg_proc_hg_uint8_t(proc, &is_const);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Proc error");
+            goto done;
+        }
+        ret = hg_proc_hg_uint8_t(proc, &is_owned);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Proc error");
+            goto done;
+        }
+    }
+
+done:
+    return ret;
+}
+
 #ifdef __cplusplus
 }
 #endif
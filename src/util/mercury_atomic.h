@@ -244,7 +244,7 @@ hg_atomic_cas64(hg_atomic_int64_t *ptr, hg_util_int64_t compare_value,
     hg_util_int64_t swap_value);
 
 /**
- * Memory barrier.
+ * Full memory barrier, also orders stores before subsequent loads.
  *
  */
 static HG_UTIL_INLINE void
@@ -602,7 +602,7 @@ hg_atomic_fence()
 #elif defined(HG_UTIL_HAS_STDATOMIC_H)
 #ifdef __INTEL_COMPILER
 #else
-    atomic_thread_fence(memory_order_acq_rel);
+    atomic_thread_fence(memory_order_seq_cst);
 #endif
 #elif defined(__APPLE__)
     OSMemoryBarrier();
@@ -113,6 +113,21 @@ hg_atomic_queue_free(struct hg_atomic_queue *hg_atomic_queue);
 static HG_UTIL_INLINE int
 hg_atomic_queue_push(struct hg_atomic_queue *hg_atomic_queue, void *entry);
 
+/**
+ * Push up to \count entries to the queue. Slots for all the entries that
+ * can be pushed are reserved at once so that pushing a batch of entries
+ * only costs a single atomic compare-and-swap.
+ *
+ * \param hg_atomic_queue [IN/OUT]  pointer to queue
+ * \param entries [IN]              array of pointers to objects
+ * \param count [IN]                number of entries in array
+ *
+ * \return Number of entries pushed (less than \count if queue is full)
+ */
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_push_n(struct hg_atomic_queue *hg_atomic_queue,
+    void *entries[], unsigned int count);
+
 /**
  * Pop an entry from the queue (multi-consumer).
  *
@@ -123,6 +138,21 @@ hg_atomic_queue_push(struct hg_atomic_queue *hg_atomic_queue, void *entry);
 static HG_UTIL_INLINE void *
 hg_atomic_queue_pop_mc(struct hg_atomic_queue *hg_atomic_queue);
 
+/**
+ * Pop up to \max_count entries from the queue (multi-consumer). Entries are
+ * reserved at once so that popping a batch of entries only costs a single
+ * atomic compare-and-swap.
+ *
+ * \param hg_atomic_queue [IN/OUT]  pointer to queue
+ * \param entries [OUT]             array of pointers to popped objects
+ * \param max_count [IN]            maximum number of entries to pop
+ *
+ * \return Number of entries popped or 0 if queue is empty
+ */
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_pop_mc_n(struct hg_atomic_queue *hg_atomic_queue,
+    void *entries[], unsigned int max_count);
+
 /**
  * Pop an entry from the queue (single consumer).
  *
@@ -196,6 +226,60 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_push_n(struct hg_atomic_queue *hg_atomic_queue,
+    void *entries[], unsigned int count)
+{
+    hg_util_int32_t prod_head, prod_next, cons_tail;
+    unsigned int i, n = 0;
+
+    if (!count)
+        goto done;
+
+    do {
+        unsigned int free_count;
+
+        prod_head = hg_atomic_get32(&hg_atomic_queue->prod_head);
+        cons_tail = hg_atomic_get32(&hg_atomic_queue->cons_tail);
+        free_count = ((unsigned int) cons_tail - (unsigned int) prod_head - 1)
+            & hg_atomic_queue->prod_mask;
+
+        if (!free_count) {
+            hg_atomic_fence();
+            if (prod_head == hg_atomic_get32(&hg_atomic_queue->prod_head) &&
+                cons_tail == hg_atomic_get32(&hg_atomic_queue->cons_tail)) {
+                hg_atomic_queue->drops++;
+                /* Full */
+                n = 0;
+                goto done;
+            }
+            continue;
+        }
+        n = (count < free_count) ? count : free_count;
+        prod_next = (prod_head + (int) n) & (int) hg_atomic_queue->prod_mask;
+    } while (!hg_atomic_cas32(&hg_atomic_queue->prod_head, prod_head,
+        prod_next));
+
+    for (i = 0; i < n; i++)
+        hg_atomic_set64((hg_atomic_int64_t *) &hg_atomic_queue->ring[
+            ((unsigned int) prod_head + i) & hg_atomic_queue->prod_mask],
+            (hg_util_int64_t) entries[i]);
+
+    /*
+     * If there are other enqueues in progress
+     * that preceded us, we need to wait for them
+     * to complete
+     */
+    while (hg_atomic_get32(&hg_atomic_queue->prod_tail) != prod_head)
+        cpu_spinwait();
+
+    hg_atomic_set32(&hg_atomic_queue->prod_tail, prod_next);
+
+done:
+    return n;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE void *
 hg_atomic_queue_pop_mc(struct hg_atomic_queue *hg_atomic_queue)
@@ -229,6 +313,54 @@ done:
     return entry;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_pop_mc_n(struct hg_atomic_queue *hg_atomic_queue,
+    void *entries[], unsigned int max_count)
+{
+    hg_util_int32_t cons_head, cons_next, prod_tail;
+    unsigned int i, n = 0;
+
+    if (!max_count)
+        goto done;
+
+    do {
+        unsigned int count;
+
+        cons_head = hg_atomic_get32(&hg_atomic_queue->cons_head);
+        prod_tail = hg_atomic_get32(&hg_atomic_queue->prod_tail);
+        count = ((unsigned int) prod_tail - (unsigned int) cons_head)
+            & hg_atomic_queue->cons_mask;
+
+        if (!count) {
+            /* Empty */
+            n = 0;
+            goto done;
+        }
+        n = (max_count < count) ? max_count : count;
+        cons_next = (cons_head + (int) n) & (int) hg_atomic_queue->cons_mask;
+    } while (!hg_atomic_cas32(&hg_atomic_queue->cons_head, cons_head,
+        cons_next));
+
+    for (i = 0; i < n; i++)
+        entries[i] = (void *) hg_atomic_get64((hg_atomic_int64_t *)
+            &hg_atomic_queue->ring[((unsigned int) cons_head + i)
+            & hg_atomic_queue->cons_mask]);
+
+    /*
+     * If there are other dequeues in progress
+     * that preceded us, we need to wait for them
+     * to complete
+     */
+    while (hg_atomic_get32(&hg_atomic_queue->cons_tail) != cons_head)
+        cpu_spinwait();
+
+    hg_atomic_set32(&hg_atomic_queue->cons_tail, cons_next);
+
+done:
+    return n;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE void *
 hg_atomic_queue_pop_sc(struct hg_atomic_queue *hg_atomic_queue)
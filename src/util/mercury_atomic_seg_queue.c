@@ -0,0 +1,538 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#include "mercury_atomic_seg_queue.h"
+#include "mercury_atomic_queue.h" /* HG_UTIL_CACHE_ALIGNMENT */
+#include "mercury_util_error.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Epochs cycle through a multiple of both the number of active counters (2)
+ * and the number of retired lists (3) */
+#define HG_ATOMIC_SEG_QUEUE_EPOCHS  6
+
+/* Marks a slot given up by a consumer before its producer could fill it */
+#define HG_ATOMIC_SEG_QUEUE_TAKEN \
+    ((hg_util_int64_t) &hg_atomic_seg_queue_taken_g)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+struct hg_atomic_seg_queue_node {
+    hg_atomic_int32_t enq_index;        /* Next slot reserved by producers */
+    hg_atomic_int32_t deq_index __attribute__((aligned(HG_UTIL_CACHE_ALIGNMENT)));
+    hg_atomic_int64_t next;             /* Next segment */
+    struct hg_atomic_seg_queue_node *retired_next; /* Next in retired list */
+    hg_atomic_int64_t slots[1] __attribute__((aligned(HG_UTIL_CACHE_ALIGNMENT)));
+};
+
+struct hg_atomic_seg_queue {
+    hg_atomic_int64_t head;             /* Segment consumers pop from */
+    hg_atomic_int64_t tail __attribute__((aligned(HG_UTIL_CACHE_ALIGNMENT)));
+    hg_atomic_int32_t epoch __attribute__((aligned(HG_UTIL_CACHE_ALIGNMENT)));
+    hg_atomic_int32_t active[2];        /* Operations in progress per epoch */
+    hg_atomic_int64_t retired[3];       /* Unlinked segments per epoch */
+    hg_atomic_int64_t spare;            /* Reclaimed segment kept for reuse */
+    unsigned int seg_size;
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Enter an operation, return the epoch it is accounted to.
+ */
+static HG_UTIL_INLINE hg_util_int32_t
+hg_atomic_seg_queue_enter(
+        struct hg_atomic_seg_queue *hg_atomic_seg_queue
+        );
+
+/**
+ * Leave an operation entered in epoch.
+ */
+static HG_UTIL_INLINE void
+hg_atomic_seg_queue_leave(
+        struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+        hg_util_int32_t epoch
+        );
+
+/**
+ * Get a segment, either the spare one or a newly allocated one.
+ */
+static struct hg_atomic_seg_queue_node *
+hg_atomic_seg_queue_node_get(
+        struct hg_atomic_seg_queue *hg_atomic_seg_queue
+        );
+
+/**
+ * Release a segment that is no longer referenced.
+ */
+static void
+hg_atomic_seg_queue_node_put(
+        struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+        struct hg_atomic_seg_queue_node *node
+        );
+
+/**
+ * Add an unlinked segment to the retired list of the current epoch.
+ */
+static void
+hg_atomic_seg_queue_retire(
+        struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+        struct hg_atomic_seg_queue_node *node
+        );
+
+/**
+ * Try to advance the epoch and release segments retired two epochs ago.
+ */
+static void
+hg_atomic_seg_queue_reclaim(
+        struct hg_atomic_seg_queue *hg_atomic_seg_queue
+        );
+
+/**
+ * Push entry, must be called between enter and leave.
+ */
+static int
+hg_atomic_seg_queue_enqueue(
+        struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+        void *entry
+        );
+
+/**
+ * Pop entry, must be called between enter and leave. Set retired if a
+ * segment was unlinked.
+ */
+static void *
+hg_atomic_seg_queue_dequeue(
+        struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+        hg_util_bool_t *retired
+        );
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+static char hg_atomic_seg_queue_taken_g;
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE hg_util_int32_t
+hg_atomic_seg_queue_enter(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    hg_util_int32_t epoch;
+
+    for (;;) {
+        epoch = hg_atomic_get32(&hg_atomic_seg_queue->epoch);
+        hg_atomic_incr32(&hg_atomic_seg_queue->active[epoch & 1]);
+        /* Epoch must not have changed once we are accounted to it, otherwise
+         * a reclaim may have missed us */
+        hg_atomic_fence();
+        if (hg_atomic_get32(&hg_atomic_seg_queue->epoch) == epoch)
+            break;
+        hg_atomic_decr32(&hg_atomic_seg_queue->active[epoch & 1]);
+    }
+
+    return epoch;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_atomic_seg_queue_leave(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    hg_util_int32_t epoch)
+{
+    hg_atomic_decr32(&hg_atomic_seg_queue->active[epoch & 1]);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_atomic_seg_queue_node *
+hg_atomic_seg_queue_node_get(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    struct hg_atomic_seg_queue_node *node;
+
+    do {
+        node = (struct hg_atomic_seg_queue_node *) hg_atomic_get64(
+            &hg_atomic_seg_queue->spare);
+    } while (node && !hg_atomic_cas64(&hg_atomic_seg_queue->spare,
+        (hg_util_int64_t) node, 0));
+
+    if (!node) {
+        node = malloc(sizeof(struct hg_atomic_seg_queue_node)
+            + (hg_atomic_seg_queue->seg_size - 1) * sizeof(hg_atomic_int64_t));
+        if (!node) {
+            HG_UTIL_LOG_ERROR("Could not allocate queue segment");
+            goto done;
+        }
+    }
+
+    hg_atomic_init32(&node->enq_index, 0);
+    hg_atomic_init32(&node->deq_index, 0);
+    hg_atomic_init64(&node->next, 0);
+    node->retired_next = NULL;
+    memset(node->slots, 0,
+        hg_atomic_seg_queue->seg_size * sizeof(hg_atomic_int64_t));
+
+done:
+    return node;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_atomic_seg_queue_node_put(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    struct hg_atomic_seg_queue_node *node)
+{
+    if (!hg_atomic_cas64(&hg_atomic_seg_queue->spare, 0,
+        (hg_util_int64_t) node))
+        free(node);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_atomic_seg_queue_retire(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    struct hg_atomic_seg_queue_node *node)
+{
+    hg_atomic_int64_t *retired;
+    hg_util_int64_t first;
+
+    /* Unlink must be visible to operations of any later epoch */
+    hg_atomic_fence();
+    retired = &hg_atomic_seg_queue->retired[
+        hg_atomic_get32(&hg_atomic_seg_queue->epoch) % 3];
+    do {
+        first = hg_atomic_get64(retired);
+        node->retired_next = (struct hg_atomic_seg_queue_node *) first;
+    } while (!hg_atomic_cas64(retired, first, (hg_util_int64_t) node));
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_atomic_seg_queue_reclaim(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    hg_util_int32_t epoch = hg_atomic_get32(&hg_atomic_seg_queue->epoch);
+    hg_atomic_int64_t *retired;
+    struct hg_atomic_seg_queue_node *node;
+    hg_util_int64_t first;
+
+    /* Operations entered in previous epoch must have left */
+    if (hg_atomic_get32(&hg_atomic_seg_queue->active[(epoch + 1) & 1]))
+        return;
+    if (!hg_atomic_cas32(&hg_atomic_seg_queue->epoch, epoch,
+        (epoch + 1) % HG_ATOMIC_SEG_QUEUE_EPOCHS))
+        return;
+
+    /* Segments retired in previous epoch can no longer be referenced by any
+     * operation: those were unlinked before the current epoch started and
+     * operations of the previous epoch have all left */
+    retired = &hg_atomic_seg_queue->retired[(epoch + 2) % 3];
+    do {
+        first = hg_atomic_get64(retired);
+    } while (first && !hg_atomic_cas64(retired, first, 0));
+
+    node = (struct hg_atomic_seg_queue_node *) first;
+    while (node) {
+        struct hg_atomic_seg_queue_node *next = node->retired_next;
+
+        hg_atomic_seg_queue_node_put(hg_atomic_seg_queue, node);
+        node = next;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_atomic_seg_queue_enqueue(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void *entry)
+{
+    unsigned int seg_size = hg_atomic_seg_queue->seg_size;
+    int ret = HG_UTIL_SUCCESS;
+
+    for (;;) {
+        struct hg_atomic_seg_queue_node *tail =
+            (struct hg_atomic_seg_queue_node *) hg_atomic_get64(
+                &hg_atomic_seg_queue->tail);
+        struct hg_atomic_seg_queue_node *next, *node;
+        unsigned int index =
+            (unsigned int) hg_atomic_incr32(&tail->enq_index) - 1;
+
+        if (index < seg_size) {
+            /* Slot may have been given up by a consumer, try next one */
+            if (hg_atomic_cas64(&tail->slots[index], 0,
+                (hg_util_int64_t) entry))
+                break;
+            continue;
+        }
+
+        /* Segment is full */
+        if (tail != (struct hg_atomic_seg_queue_node *) hg_atomic_get64(
+            &hg_atomic_seg_queue->tail))
+            continue;
+        next = (struct hg_atomic_seg_queue_node *) hg_atomic_get64(
+            &tail->next);
+        if (next) {
+            hg_atomic_cas64(&hg_atomic_seg_queue->tail, (hg_util_int64_t) tail,
+                (hg_util_int64_t) next);
+            continue;
+        }
+
+        /* Append a new segment that already contains the entry */
+        node = hg_atomic_seg_queue_node_get(hg_atomic_seg_queue);
+        if (!node) {
+            ret = HG_UTIL_FAIL;
+            break;
+        }
+        hg_atomic_set64(&node->slots[0], (hg_util_int64_t) entry);
+        hg_atomic_set32(&node->enq_index, 1);
+        if (hg_atomic_cas64(&tail->next, 0, (hg_util_int64_t) node)) {
+            hg_atomic_cas64(&hg_atomic_seg_queue->tail, (hg_util_int64_t) tail,
+                (hg_util_int64_t) node);
+            break;
+        }
+        /* Another producer appended first, node was never published */
+        hg_atomic_seg_queue_node_put(hg_atomic_seg_queue, node);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void *
+hg_atomic_seg_queue_dequeue(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    hg_util_bool_t *retired)
+{
+    unsigned int seg_size = hg_atomic_seg_queue->seg_size;
+    void *entry = NULL;
+
+    for (;;) {
+        struct hg_atomic_seg_queue_node *head =
+            (struct hg_atomic_seg_queue_node *) hg_atomic_get64(
+                &hg_atomic_seg_queue->head);
+        struct hg_atomic_seg_queue_node *next;
+        unsigned int deq_index =
+            (unsigned int) hg_atomic_get32(&head->deq_index);
+        unsigned int index;
+        hg_util_int64_t slot;
+
+        /* Do not reserve slots when empty, producers would have to skip
+         * them */
+        if ((deq_index >= (unsigned int) hg_atomic_get32(&head->enq_index)
+            || deq_index >= seg_size) && !hg_atomic_get64(&head->next))
+            break;
+
+        index = (unsigned int) hg_atomic_incr32(&head->deq_index) - 1;
+        if (index >= seg_size) {
+            struct hg_atomic_seg_queue_node *tail;
+
+            /* Segment is consumed, move to next one */
+            next = (struct hg_atomic_seg_queue_node *) hg_atomic_get64(
+                &head->next);
+            if (!next)
+                break;
+            /* Tail must not be left behind on an unlinked segment */
+            tail = (struct hg_atomic_seg_queue_node *) hg_atomic_get64(
+                &hg_atomic_seg_queue->tail);
+            if (tail == head)
+                hg_atomic_cas64(&hg_atomic_seg_queue->tail,
+                    (hg_util_int64_t) head, (hg_util_int64_t) next);
+            if (hg_atomic_cas64(&hg_atomic_seg_queue->head,
+                (hg_util_int64_t) head, (hg_util_int64_t) next)) {
+                hg_atomic_seg_queue_retire(hg_atomic_seg_queue, head);
+                *retired = HG_UTIL_TRUE;
+            }
+            continue;
+        }
+
+        slot = hg_atomic_get64(&head->slots[index]);
+        if (!slot) {
+            /* Producer has reserved the slot but not filled it yet, give
+             * it up so that the producer moves on to another slot */
+            if (hg_atomic_cas64(&head->slots[index], 0,
+                HG_ATOMIC_SEG_QUEUE_TAKEN))
+                continue;
+            slot = hg_atomic_get64(&head->slots[index]);
+        }
+        entry = (void *) slot;
+        break;
+    }
+
+    return entry;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_atomic_seg_queue *
+hg_atomic_seg_queue_alloc(unsigned int seg_size)
+{
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue = NULL;
+    struct hg_atomic_seg_queue_node *node;
+    int i;
+
+    if (!seg_size) {
+        HG_UTIL_LOG_ERROR("Segment size must be non-zero");
+        goto done;
+    }
+
+    hg_atomic_seg_queue = malloc(sizeof(struct hg_atomic_seg_queue));
+    if (!hg_atomic_seg_queue) {
+        HG_UTIL_LOG_ERROR("Could not allocate atomic queue");
+        goto done;
+    }
+    hg_atomic_seg_queue->seg_size = seg_size;
+    hg_atomic_init32(&hg_atomic_seg_queue->epoch, 0);
+    for (i = 0; i < 2; i++)
+        hg_atomic_init32(&hg_atomic_seg_queue->active[i], 0);
+    for (i = 0; i < 3; i++)
+        hg_atomic_init64(&hg_atomic_seg_queue->retired[i], 0);
+    hg_atomic_init64(&hg_atomic_seg_queue->spare, 0);
+
+    node = hg_atomic_seg_queue_node_get(hg_atomic_seg_queue);
+    if (!node) {
+        free(hg_atomic_seg_queue);
+        hg_atomic_seg_queue = NULL;
+        goto done;
+    }
+    hg_atomic_init64(&hg_atomic_seg_queue->head, (hg_util_int64_t) node);
+    hg_atomic_init64(&hg_atomic_seg_queue->tail, (hg_util_int64_t) node);
+
+done:
+    return hg_atomic_seg_queue;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_atomic_seg_queue_free(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    struct hg_atomic_seg_queue_node *node;
+    int i;
+
+    if (!hg_atomic_seg_queue)
+        return;
+
+    node = (struct hg_atomic_seg_queue_node *) hg_atomic_get64(
+        &hg_atomic_seg_queue->head);
+    while (node) {
+        struct hg_atomic_seg_queue_node *next =
+            (struct hg_atomic_seg_queue_node *) hg_atomic_get64(&node->next);
+
+        free(node);
+        node = next;
+    }
+    for (i = 0; i < 3; i++) {
+        node = (struct hg_atomic_seg_queue_node *) hg_atomic_get64(
+            &hg_atomic_seg_queue->retired[i]);
+        while (node) {
+            struct hg_atomic_seg_queue_node *next = node->retired_next;
+
+            free(node);
+            node = next;
+        }
+    }
+    free((void *) hg_atomic_get64(&hg_atomic_seg_queue->spare));
+    free(hg_atomic_seg_queue);
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_atomic_seg_queue_push(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void *entry)
+{
+    hg_util_int32_t epoch = hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+    int ret = hg_atomic_seg_queue_enqueue(hg_atomic_seg_queue, entry);
+
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue, epoch);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+unsigned int
+hg_atomic_seg_queue_push_n(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void *entries[], unsigned int count)
+{
+    hg_util_int32_t epoch;
+    unsigned int i;
+
+    if (!count)
+        return 0;
+
+    epoch = hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+    for (i = 0; i < count; i++)
+        if (hg_atomic_seg_queue_enqueue(hg_atomic_seg_queue, entries[i])
+            != HG_UTIL_SUCCESS)
+            break;
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue, epoch);
+
+    return i;
+}
+
+/*---------------------------------------------------------------------------*/
+void *
+hg_atomic_seg_queue_pop(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    hg_util_bool_t retired = HG_UTIL_FALSE;
+    hg_util_int32_t epoch = hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+    void *entry = hg_atomic_seg_queue_dequeue(hg_atomic_seg_queue, &retired);
+
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue, epoch);
+    if (retired)
+        hg_atomic_seg_queue_reclaim(hg_atomic_seg_queue);
+
+    return entry;
+}
+
+/*---------------------------------------------------------------------------*/
+unsigned int
+hg_atomic_seg_queue_pop_n(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void *entries[], unsigned int max_count)
+{
+    hg_util_bool_t retired = HG_UTIL_FALSE;
+    hg_util_int32_t epoch;
+    unsigned int count = 0;
+
+    if (!max_count)
+        return 0;
+
+    epoch = hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+    while (count < max_count) {
+        void *entry = hg_atomic_seg_queue_dequeue(hg_atomic_seg_queue,
+            &retired);
+
+        if (!entry)
+            break;
+        entries[count++] = entry;
+    }
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue, epoch);
+    if (retired)
+        hg_atomic_seg_queue_reclaim(hg_atomic_seg_queue);
+
+    return count;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_util_bool_t
+hg_atomic_seg_queue_is_empty(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    hg_util_int32_t epoch = hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+    struct hg_atomic_seg_queue_node *head =
+        (struct hg_atomic_seg_queue_node *) hg_atomic_get64(
+            &hg_atomic_seg_queue->head);
+    unsigned int deq_index = (unsigned int) hg_atomic_get32(&head->deq_index);
+    hg_util_bool_t ret;
+
+    ret = (hg_util_bool_t) ((deq_index >= (unsigned int) hg_atomic_get32(
+        &head->enq_index) || deq_index >= hg_atomic_seg_queue->seg_size)
+        && !hg_atomic_get64(&head->next));
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue, epoch);
+
+    return ret;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_ATOMIC_SEG_QUEUE_H
+#define MERCURY_ATOMIC_SEG_QUEUE_H
+
+#include "mercury_atomic.h"
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/**
+ * Unbounded multi-producer / multi-consumer queue made of a linked list of
+ * fixed-size segments. Producers and consumers reserve slots within the
+ * tail and head segments with a single fetch-and-add, a new segment is
+ * appended when the tail segment is full. Segments that have been consumed
+ * are unlinked and reclaimed once no operation that may still reference them
+ * is in progress (epoch-based reclamation), so that push and pop never take
+ * a lock.
+ */
+struct hg_atomic_seg_queue;
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Allocate a new queue made of segments of \seg_size elements.
+ *
+ * \param seg_size [IN]             number of elements per segment
+ *
+ * \return pointer to allocated queue or NULL on failure
+ */
+HG_UTIL_EXPORT struct hg_atomic_seg_queue *
+hg_atomic_seg_queue_alloc(unsigned int seg_size);
+
+/**
+ * Free an existing queue. Entries that remain in the queue are not freed.
+ *
+ * \param hg_atomic_seg_queue [IN]  pointer to queue
+ */
+HG_UTIL_EXPORT void
+hg_atomic_seg_queue_free(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+/**
+ * Push an entry to the queue. Entry must not be NULL.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ * \param entry [IN]                    pointer to object
+ *
+ * \return Non-negative on success or negative on failure (a new segment
+ * could not be allocated)
+ */
+HG_UTIL_EXPORT int
+hg_atomic_seg_queue_push(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void *entry);
+
+/**
+ * Push \count entries to the queue.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ * \param entries [IN]                  array of pointers to objects
+ * \param count [IN]                    number of entries in array
+ *
+ * \return Number of entries pushed (less than \count only if a new segment
+ * could not be allocated)
+ */
+HG_UTIL_EXPORT unsigned int
+hg_atomic_seg_queue_push_n(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void *entries[], unsigned int count);
+
+/**
+ * Pop an entry from the queue.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ *
+ * \return Pointer to popped object or NULL if queue is empty
+ */
+HG_UTIL_EXPORT void *
+hg_atomic_seg_queue_pop(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+/**
+ * Pop up to \max_count entries from the queue.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ * \param entries [OUT]                 array of pointers to popped objects
+ * \param max_count [IN]                maximum number of entries to pop
+ *
+ * \return Number of entries popped or 0 if queue is empty
+ */
+HG_UTIL_EXPORT unsigned int
+hg_atomic_seg_queue_pop_n(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void *entries[], unsigned int max_count);
+
+/**
+ * Determine whether queue is empty. An entry whose push is still in progress
+ * may already be reported.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ *
+ * \return HG_UTIL_TRUE if empty, HG_UTIL_FALSE if not
+ */
+HG_UTIL_EXPORT hg_util_bool_t
+hg_atomic_seg_queue_is_empty(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_ATOMIC_SEG_QUEUE_H */
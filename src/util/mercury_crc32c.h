@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2013-2017 Argonne National Laboratory, Department of Energy,
+ *                    UChicago Argonne, LLC and The HDF Group.
+ * All rights reserved.
+ *
+ * The full copyright notice, including terms governing use, modification,
+ * and redistribution, is contained in the COPYING file that can be
+ * found at the root of the source code distribution tree.
+ */
+
+#ifndef MERCURY_CRC32C_H
+#define MERCURY_CRC32C_H
+
+#include "mercury_util_config.h"
+
+#include <stddef.h>
+
+/**
+ * Purpose: CRC32C (Castagnoli) checksum, uses the CRC32 instruction when
+ * the CPU provides it and a table otherwise.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Update checksum with size bytes of buf. Checksums start from 0 and the
+ * value returned is final, it can also be passed again to checksum data
+ * that follows.
+ *
+ * \param crc [IN]              checksum of preceding data or 0
+ * \param buf [IN]              pointer to data
+ * \param size [IN]             data size
+ *
+ * \return checksum
+ */
+HG_UTIL_EXPORT hg_util_uint32_t
+hg_crc32c(hg_util_uint32_t crc, const void *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_CRC32C_H */
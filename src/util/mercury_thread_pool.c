@@ -9,61 +9,387 @@
  */
 
 #include "mercury_thread_pool.h"
-#include "mercury_thread_condition.h"
+#include "mercury_atomic_queue.h"
+#include "mercury_thread_mutex.h"
+#include "mercury_mem.h"
 #include "mercury_util_error.h"
 
+#ifdef HG_UTIL_HAS_LINUX_FUTEX_H
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#else
+# include "mercury_thread_condition.h"
+#endif
+
+#include <limits.h>
 #include <stdlib.h>
+#include <string.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Capacity of worker deques and inboxes (must be a power of 2) */
+#define HG_THREAD_POOL_DEQUE_SIZE   1024
+#define HG_THREAD_POOL_INBOX_SIZE   1024
+
+/* Number of attempts to find work before parking, the first ones spin */
+#define HG_THREAD_POOL_SPIN_COUNT   64
+#define HG_THREAD_POOL_PAUSE_COUNT  16
+
+/* Maximum number of workers spinning at the same time, others park */
+#define HG_THREAD_POOL_MAX_SEARCHING 2
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Worker with its own deque: the owner pushes and pops at the bottom
+ * without locks, other workers steal from the top */
+struct hg_thread_pool_worker {
+    hg_atomic_int64_t top;              /* Index of oldest work */
+    hg_atomic_int64_t bottom __attribute__((aligned(HG_UTIL_CACHE_ALIGNMENT)));
+    hg_atomic_int64_t deque[HG_THREAD_POOL_DEQUE_SIZE];
+    struct hg_atomic_queue *inbox;      /* Work posted by other threads */
+    hg_thread_pool_t *pool;
+    unsigned int index;
+    hg_thread_t thread;
+} __attribute__((aligned(HG_UTIL_CACHE_ALIGNMENT)));
 
 struct hg_thread_pool {
-    unsigned int sleeping_worker_count;
+    hg_atomic_int32_t park_epoch;       /* Changed to wake parked workers */
+    hg_atomic_int32_t parked_count;     /* Number of parked workers */
+    hg_atomic_int32_t searching_count;  /* Number of spinning workers */
+    hg_atomic_int32_t shutdown;
+    hg_atomic_int32_t next_worker;      /* Inbox of next external post */
+    hg_atomic_int32_t overflow_count;   /* Number of works in overflow */
+    HG_QUEUE_HEAD(hg_thread_work) overflow_queue; /* When deques are full */
+    hg_thread_mutex_t overflow_mutex;
+#ifndef HG_UTIL_HAS_LINUX_FUTEX_H
+    hg_thread_mutex_t park_mutex;
+    hg_thread_cond_t park_cond;
+#endif
+    hg_thread_key_t worker_key;         /* Worker of calling thread */
+    struct hg_thread_pool_worker *workers;
     unsigned int thread_count;
-    hg_thread_t *threads;
-    HG_QUEUE_HEAD(hg_thread_work) queue;
-    int shutdown;
-    hg_thread_mutex_t mutex;
-    hg_thread_cond_t cond;
+    unsigned int started_count;
 };
 
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Push work to the bottom of the deque, only called by its owner.
+ */
+static HG_UTIL_INLINE int
+hg_thread_pool_deque_push(
+        struct hg_thread_pool_worker *worker,
+        struct hg_thread_work *work
+        );
+
+/**
+ * Pop work from the bottom of the deque, only called by its owner.
+ */
+static HG_UTIL_INLINE struct hg_thread_work *
+hg_thread_pool_deque_pop(
+        struct hg_thread_pool_worker *worker
+        );
+
+/**
+ * Steal work from the top of another worker's deque.
+ */
+static HG_UTIL_INLINE struct hg_thread_work *
+hg_thread_pool_deque_steal(
+        struct hg_thread_pool_worker *worker
+        );
+
+/**
+ * Find work, first from worker's own deque and inbox, then from other
+ * workers and finally from the overflow queue.
+ */
+static struct hg_thread_work *
+hg_thread_pool_find_work(
+        hg_thread_pool_t *pool,
+        struct hg_thread_pool_worker *worker
+        );
+
+/**
+ * Check whether any work is queued, without taking it.
+ */
+static hg_util_bool_t
+hg_thread_pool_has_work(
+        hg_thread_pool_t *pool
+        );
+
+/**
+ * Park worker until work is posted or pool is shut down.
+ */
+static void
+hg_thread_pool_park(
+        hg_thread_pool_t *pool
+        );
+
 /**
- * Worker thread run by the thread pool
+ * Wake up to count parked workers. A single worker is only woken up if no
+ * worker is already spinning, as that one will find the work.
+ */
+static void
+hg_thread_pool_wake(
+        hg_thread_pool_t *pool,
+        int count
+        );
+
+/**
+ * Worker thread run by the thread pool.
  */
 static HG_THREAD_RETURN_TYPE
+hg_thread_pool_worker(
+        void *args
+        );
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE int
+hg_thread_pool_deque_push(struct hg_thread_pool_worker *worker,
+    struct hg_thread_work *work)
+{
+    hg_util_int64_t bottom = hg_atomic_get64(&worker->bottom);
+    hg_util_int64_t top = hg_atomic_get64(&worker->top);
+
+    if (bottom - top >= HG_THREAD_POOL_DEQUE_SIZE)
+        return HG_UTIL_FAIL;
+
+    hg_atomic_set64(&worker->deque[bottom & (HG_THREAD_POOL_DEQUE_SIZE - 1)],
+        (hg_util_int64_t) work);
+    hg_atomic_set64(&worker->bottom, bottom + 1);
+
+    return HG_UTIL_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE struct hg_thread_work *
+hg_thread_pool_deque_pop(struct hg_thread_pool_worker *worker)
+{
+    hg_util_int64_t bottom = hg_atomic_get64(&worker->bottom) - 1;
+    hg_util_int64_t top;
+    struct hg_thread_work *work = NULL;
+
+    /* Reserve bottom work before looking at thieves */
+    hg_atomic_set64(&worker->bottom, bottom);
+    hg_atomic_fence();
+    top = hg_atomic_get64(&worker->top);
+
+    if (top <= bottom) {
+        work = (struct hg_thread_work *) hg_atomic_get64(
+            &worker->deque[bottom & (HG_THREAD_POOL_DEQUE_SIZE - 1)]);
+        if (top == bottom) {
+            /* Last work, race against thieves */
+            if (!hg_atomic_cas64(&worker->top, top, top + 1))
+                work = NULL;
+            hg_atomic_set64(&worker->bottom, bottom + 1);
+        }
+    } else
+        hg_atomic_set64(&worker->bottom, bottom + 1);
+
+    return work;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE struct hg_thread_work *
+hg_thread_pool_deque_steal(struct hg_thread_pool_worker *worker)
+{
+    hg_util_int64_t top = hg_atomic_get64(&worker->top);
+    hg_util_int64_t bottom;
+    struct hg_thread_work *work = NULL;
+
+    hg_atomic_fence();
+    bottom = hg_atomic_get64(&worker->bottom);
+
+    if (top < bottom) {
+        work = (struct hg_thread_work *) hg_atomic_get64(
+            &worker->deque[top & (HG_THREAD_POOL_DEQUE_SIZE - 1)]);
+        /* Lost race against owner or other thieves */
+        if (!hg_atomic_cas64(&worker->top, top, top + 1))
+            work = NULL;
+    }
+
+    return work;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_thread_work *
+hg_thread_pool_find_work(hg_thread_pool_t *pool,
+    struct hg_thread_pool_worker *worker)
+{
+    struct hg_thread_work *work;
+    unsigned int i;
+
+    work = hg_thread_pool_deque_pop(worker);
+    if (work)
+        goto done;
+    work = (struct hg_thread_work *) hg_atomic_queue_pop_mc(worker->inbox);
+    if (work)
+        goto done;
+
+    for (i = 1; i < pool->thread_count; i++) {
+        struct hg_thread_pool_worker *victim =
+            &pool->workers[(worker->index + i) % pool->thread_count];
+
+        work = hg_thread_pool_deque_steal(victim);
+        if (work)
+            goto done;
+        work = (struct hg_thread_work *) hg_atomic_queue_pop_mc(victim->inbox);
+        if (work)
+            goto done;
+    }
+
+    if (hg_atomic_get32(&pool->overflow_count)) {
+        hg_thread_mutex_lock(&pool->overflow_mutex);
+        work = HG_QUEUE_FIRST(&pool->overflow_queue);
+        if (work) {
+            HG_QUEUE_POP_HEAD(&pool->overflow_queue, entry);
+            hg_atomic_decr32(&pool->overflow_count);
+        }
+        hg_thread_mutex_unlock(&pool->overflow_mutex);
+    }
+
+done:
+    return work;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_util_bool_t
+hg_thread_pool_has_work(hg_thread_pool_t *pool)
+{
+    unsigned int i;
+
+    if (hg_atomic_get32(&pool->overflow_count))
+        return HG_UTIL_TRUE;
+
+    for (i = 0; i < pool->thread_count; i++) {
+        struct hg_thread_pool_worker *worker = &pool->workers[i];
+
+        if (hg_atomic_get64(&worker->bottom) > hg_atomic_get64(&worker->top)
+            || !hg_atomic_queue_is_empty(worker->inbox))
+            return HG_UTIL_TRUE;
+    }
+
+    return HG_UTIL_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_thread_pool_park(hg_thread_pool_t *pool)
+{
+    hg_util_int32_t epoch = hg_atomic_get32(&pool->park_epoch);
+
+    /* Posters wake us up once they see that we are parked, check for work
+     * again in case it was posted before that */
+    hg_atomic_incr32(&pool->parked_count);
+    hg_atomic_fence();
+    if (hg_thread_pool_has_work(pool) || hg_atomic_get32(&pool->shutdown))
+        goto done;
+
+#ifdef HG_UTIL_HAS_LINUX_FUTEX_H
+    /* Returns immediately if epoch has already changed */
+    syscall(SYS_futex, &pool->park_epoch, FUTEX_WAIT_PRIVATE, epoch, NULL,
+        NULL, 0);
+#else
+    hg_thread_mutex_lock(&pool->park_mutex);
+    while (hg_atomic_get32(&pool->park_epoch) == epoch)
+        hg_thread_cond_wait(&pool->park_cond, &pool->park_mutex);
+    hg_thread_mutex_unlock(&pool->park_mutex);
+#endif
+
+done:
+    hg_atomic_decr32(&pool->parked_count);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_thread_pool_wake(hg_thread_pool_t *pool, int count)
+{
+    /* Make posted work visible before looking for parked workers */
+    hg_atomic_fence();
+    if (!hg_atomic_get32(&pool->parked_count)
+        || (count == 1 && hg_atomic_get32(&pool->searching_count)))
+        return;
+
+    hg_atomic_incr32(&pool->park_epoch);
+#ifdef HG_UTIL_HAS_LINUX_FUTEX_H
+    syscall(SYS_futex, &pool->park_epoch, FUTEX_WAKE_PRIVATE, count, NULL,
+        NULL, 0);
+#else
+    hg_thread_mutex_lock(&pool->park_mutex);
+    if (count == 1)
+        hg_thread_cond_signal(&pool->park_cond);
+    else
+        hg_thread_cond_broadcast(&pool->park_cond);
+    hg_thread_mutex_unlock(&pool->park_mutex);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
 hg_thread_pool_worker(void *args)
 {
     hg_thread_ret_t ret = 0;
-    hg_thread_pool_t *pool = (hg_thread_pool_t*) args;
+    struct hg_thread_pool_worker *worker =
+        (struct hg_thread_pool_worker *) args;
+    hg_thread_pool_t *pool = worker->pool;
     struct hg_thread_work *work;
+    hg_util_bool_t searching = HG_UTIL_FALSE;
+    unsigned int spin = 0;
+
+    hg_thread_setspecific(pool->worker_key, worker);
 
     while (1) {
-        hg_thread_mutex_lock(&pool->mutex);
-
-        /* If not shutting down and nothing to do, worker sleeps */
-        while (!pool->shutdown && HG_QUEUE_IS_EMPTY(&pool->queue)) {
-            pool->sleeping_worker_count++;
-            if (hg_thread_cond_wait(&pool->cond, &pool->mutex) != HG_UTIL_SUCCESS) {
-                HG_UTIL_LOG_ERROR("Thread cannot wait on condition variable");
-                goto unlock;
+        work = hg_thread_pool_find_work(pool, worker);
+        if (work) {
+            /* Let another worker look for more work */
+            if (searching) {
+                searching = HG_UTIL_FALSE;
+                hg_atomic_decr32(&pool->searching_count);
+                hg_thread_pool_wake(pool, 1);
             }
-            pool->sleeping_worker_count--;
+            /* Get to work */
+            (*work->func)(work->args);
+            continue;
         }
 
-        if (pool->shutdown && HG_QUEUE_IS_EMPTY(&pool->queue)) {
-            goto unlock;
-        }
-
-        /* Grab our task */
-        work = HG_QUEUE_FIRST(&pool->queue);
-        HG_QUEUE_POP_HEAD(&pool->queue, entry);
+        /* Remaining work is processed before shutting down */
+        if (hg_atomic_get32(&pool->shutdown))
+            break;
 
-        /* Unlock */
-        hg_thread_mutex_unlock(&pool->mutex);
+        if (!searching) {
+            if (hg_atomic_get32(&pool->searching_count)
+                >= HG_THREAD_POOL_MAX_SEARCHING) {
+                hg_thread_pool_park(pool);
+                continue;
+            }
+            searching = HG_UTIL_TRUE;
+            hg_atomic_incr32(&pool->searching_count);
+            spin = 0;
+        }
 
-        /* Get to work */
-        (*work->func)(work->args);
+        /* Spin for a while before parking */
+        if (spin < HG_THREAD_POOL_PAUSE_COUNT) {
+            cpu_spinwait();
+        } else if (spin < HG_THREAD_POOL_SPIN_COUNT) {
+            hg_thread_yield();
+        } else {
+            searching = HG_UTIL_FALSE;
+            hg_atomic_decr32(&pool->searching_count);
+            hg_thread_pool_park(pool);
+            continue;
+        }
+        spin++;
     }
 
-unlock:
-    hg_thread_mutex_unlock(&pool->mutex);
+    if (searching)
+        hg_atomic_decr32(&pool->searching_count);
+
     hg_thread_exit(ret);
     return ret;
 }
@@ -88,38 +414,77 @@ hg_thread_pool_init(unsigned int thread_count, hg_thread_pool_t **pool)
         ret = HG_UTIL_FAIL;
         goto done;
     }
-    priv_pool->sleeping_worker_count = 0;
+    hg_atomic_init32(&priv_pool->park_epoch, 0);
+    hg_atomic_init32(&priv_pool->parked_count, 0);
+    hg_atomic_init32(&priv_pool->searching_count, 0);
+    hg_atomic_init32(&priv_pool->shutdown, 0);
+    hg_atomic_init32(&priv_pool->next_worker, 0);
+    hg_atomic_init32(&priv_pool->overflow_count, 0);
+    HG_QUEUE_INIT(&priv_pool->overflow_queue);
+    priv_pool->workers = NULL;
     priv_pool->thread_count = thread_count;
-    priv_pool->threads = NULL;
-    HG_QUEUE_INIT(&priv_pool->queue);
-    priv_pool->shutdown = 0;
+    priv_pool->started_count = 0;
 
-    if (hg_thread_mutex_init(&priv_pool->mutex) != HG_UTIL_SUCCESS) {
+    if (hg_thread_mutex_init(&priv_pool->overflow_mutex) != HG_UTIL_SUCCESS) {
         HG_UTIL_LOG_ERROR("Could not initialize mutex");
         ret = HG_UTIL_FAIL;
         goto done;
     }
-    if (hg_thread_cond_init(&priv_pool->cond) != HG_UTIL_SUCCESS) {
+#ifndef HG_UTIL_HAS_LINUX_FUTEX_H
+    if (hg_thread_mutex_init(&priv_pool->park_mutex) != HG_UTIL_SUCCESS) {
+        HG_UTIL_LOG_ERROR("Could not initialize mutex");
+        ret = HG_UTIL_FAIL;
+        goto done;
+    }
+    if (hg_thread_cond_init(&priv_pool->park_cond) != HG_UTIL_SUCCESS) {
         HG_UTIL_LOG_ERROR("Could not initialize thread condition");
         ret = HG_UTIL_FAIL;
         goto done;
     }
-
-    priv_pool->threads = (hg_thread_t*) malloc(thread_count * sizeof(hg_thread_t));
-    if (!priv_pool->threads) {
-        HG_UTIL_LOG_ERROR("Could not allocate thread pool array");
+#endif
+    if (hg_thread_key_create(&priv_pool->worker_key) != HG_UTIL_SUCCESS) {
+        HG_UTIL_LOG_ERROR("Could not create thread key");
         ret = HG_UTIL_FAIL;
         goto done;
     }
 
+    if (thread_count) {
+        priv_pool->workers = (struct hg_thread_pool_worker *)
+            hg_mem_aligned_alloc(HG_UTIL_CACHE_ALIGNMENT,
+                thread_count * sizeof(struct hg_thread_pool_worker));
+        if (!priv_pool->workers) {
+            HG_UTIL_LOG_ERROR("Could not allocate thread pool workers");
+            ret = HG_UTIL_FAIL;
+            goto done;
+        }
+        memset(priv_pool->workers, 0,
+            thread_count * sizeof(struct hg_thread_pool_worker));
+    }
+    for (i = 0; i < thread_count; i++) {
+        struct hg_thread_pool_worker *worker = &priv_pool->workers[i];
+
+        hg_atomic_init64(&worker->top, 0);
+        hg_atomic_init64(&worker->bottom, 0);
+        worker->pool = priv_pool;
+        worker->index = i;
+        worker->inbox = hg_atomic_queue_alloc(HG_THREAD_POOL_INBOX_SIZE);
+        if (!worker->inbox) {
+            HG_UTIL_LOG_ERROR("Could not allocate worker inbox");
+            ret = HG_UTIL_FAIL;
+            goto done;
+        }
+    }
+
     /* Start worker threads */
     for (i = 0; i < thread_count; i++) {
-        if (hg_thread_create(&priv_pool->threads[i], hg_thread_pool_worker,
-                (void*) priv_pool) != HG_UTIL_SUCCESS) {
+        if (hg_thread_create(&priv_pool->workers[i].thread,
+                hg_thread_pool_worker, (void*) &priv_pool->workers[i])
+            != HG_UTIL_SUCCESS) {
             HG_UTIL_LOG_ERROR("Could not create thread");
             ret = HG_UTIL_FAIL;
             goto done;
         }
+        priv_pool->started_count++;
     }
 
     *pool = priv_pool;
@@ -143,42 +508,44 @@ hg_thread_pool_destroy(hg_thread_pool_t *pool)
 
     if (!pool) goto done;
 
-    if (pool->threads) {
-        hg_thread_mutex_lock(&pool->mutex);
-
-        pool->shutdown = 1;
+    /* Workers process remaining work and exit */
+    hg_atomic_set32(&pool->shutdown, 1);
+    hg_thread_pool_wake(pool, INT_MAX);
 
-        if (hg_thread_cond_broadcast(&pool->cond) != HG_UTIL_SUCCESS) {
-            HG_UTIL_LOG_ERROR("Could not broadcast condition signal");
+    for (i = 0; i < pool->started_count; i++) {
+        if (hg_thread_join(pool->workers[i].thread) != HG_UTIL_SUCCESS) {
+            HG_UTIL_LOG_ERROR("Could not join thread");
             ret = HG_UTIL_FAIL;
-        }
-
-        hg_thread_mutex_unlock(&pool->mutex);
-
-        if (ret != HG_UTIL_SUCCESS) goto done;
-
-        for(i = 0; i < pool->thread_count; i++) {
-            if (hg_thread_join(pool->threads[i]) != HG_UTIL_SUCCESS) {
-                HG_UTIL_LOG_ERROR("Could not join thread");
-                ret = HG_UTIL_FAIL;
-                goto done;
-            }
+            goto done;
         }
     }
+    pool->started_count = 0;
 
-    free(pool->threads);
-    pool->threads = NULL;
+    if (pool->workers) {
+        for (i = 0; i < pool->thread_count; i++)
+            hg_atomic_queue_free(pool->workers[i].inbox);
+        hg_mem_aligned_free(pool->workers);
+        pool->workers = NULL;
+    }
 
-    if (hg_thread_mutex_destroy(&pool->mutex) != HG_UTIL_SUCCESS) {
+    hg_thread_key_delete(pool->worker_key);
+    if (hg_thread_mutex_destroy(&pool->overflow_mutex) != HG_UTIL_SUCCESS) {
         HG_UTIL_LOG_ERROR("Could not destroy mutex");
         ret = HG_UTIL_FAIL;
         goto done;
     }
-    if (hg_thread_cond_destroy(&pool->cond) != HG_UTIL_SUCCESS){
+#ifndef HG_UTIL_HAS_LINUX_FUTEX_H
+    if (hg_thread_mutex_destroy(&pool->park_mutex) != HG_UTIL_SUCCESS) {
+        HG_UTIL_LOG_ERROR("Could not destroy mutex");
+        ret = HG_UTIL_FAIL;
+        goto done;
+    }
+    if (hg_thread_cond_destroy(&pool->park_cond) != HG_UTIL_SUCCESS){
         HG_UTIL_LOG_ERROR("Could not destroy thread condition");
         ret = HG_UTIL_FAIL;
         goto done;
     }
+#endif
 
     free(pool);
 
@@ -190,6 +557,7 @@ done:
 int
 hg_thread_pool_post(hg_thread_pool_t *pool, struct hg_thread_work *work)
 {
+    struct hg_thread_pool_worker *worker;
     int ret = HG_UTIL_SUCCESS;
 
     if (!pool) {
@@ -210,28 +578,33 @@ hg_thread_pool_post(hg_thread_pool_t *pool, struct hg_thread_work *work)
         goto done;
     }
 
-    hg_thread_mutex_lock(&pool->mutex);
-
     /* Are we shutting down ? */
-    if (pool->shutdown) {
+    if (hg_atomic_get32(&pool->shutdown)) {
         HG_UTIL_LOG_ERROR("Pool is shutting down");
         ret = HG_UTIL_FAIL;
-        goto unlock;
+        goto done;
     }
 
-    /* Add task to task queue */
-    HG_QUEUE_PUSH_TAIL(&pool->queue, work, entry);
-
-    /* Wake up sleeping worker */
-    if (pool->sleeping_worker_count) {
-        if (hg_thread_cond_signal(&pool->cond) != HG_UTIL_SUCCESS) {
-            HG_UTIL_LOG_ERROR("Cannot signal pool condition");
-            ret = HG_UTIL_FAIL;
-        }
+    /* Workers push to their own deque, other threads to worker inboxes in
+     * turn, falling back to the overflow queue when these are full */
+    worker = (struct hg_thread_pool_worker *)
+        hg_thread_getspecific(pool->worker_key);
+    if (worker && hg_thread_pool_deque_push(worker, work) == HG_UTIL_SUCCESS)
+        goto wake;
+    if (pool->thread_count) {
+        worker = &pool->workers[(unsigned int)
+            hg_atomic_incr32(&pool->next_worker) % pool->thread_count];
+        if (hg_atomic_queue_push(worker->inbox, work) == HG_UTIL_SUCCESS)
+            goto wake;
     }
-
-unlock:
-    hg_thread_mutex_unlock(&pool->mutex);
+    hg_thread_mutex_lock(&pool->overflow_mutex);
+    HG_QUEUE_PUSH_TAIL(&pool->overflow_queue, work, entry);
+    hg_atomic_incr32(&pool->overflow_count);
+    hg_thread_mutex_unlock(&pool->overflow_mutex);
+
+wake:
+    /* Wake up parked worker */
+    hg_thread_pool_wake(pool, 1);
 
 done:
     return ret;
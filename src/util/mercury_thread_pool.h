@@ -50,7 +50,10 @@ hg_thread_pool_destroy(hg_thread_pool_t *pool);
 
 /**
  * Post work to the pool. Note that the operation may be queued depending on
- * the number of threads and number of tasks already running.
+ * the number of threads and number of tasks already running. Work posted from
+ * a worker of the pool is queued to that worker without locking and may be
+ * stolen by idle workers, work posted from other threads is distributed
+ * among workers.
  *
  * \param pool [IN/OUT]         pointer to pool object
  * \param work [IN]             pointer to work struct